@@ -0,0 +1,112 @@
+/**
+ * @file footprint.cpp
+ * @author joebarteam11
+ * @brief RAM taken per bus and per servo by the configuration of AX12Config.h
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ * On the board, with the footprint environment of platformio.ini (the link
+ * also reports the flash and the static RAM of the whole image) :
+ *   pio run -e footprint -t upload && pio device monitor
+ *
+ * On a host, with the same flags as the firmware (sizes differ a little from
+ * the ARM ABI but the scaling is the same) :
+ *   g++ -DAX12_CONFIG_SMALL -Iinclude examples/footprint/footprint.cpp -o footprint
+ *
+ * The code is shared by all the buses and servos: adding one only costs RAM.
+ */
+#include <stdio.h>
+
+#include "AX12Bus.h"
+#include "AX12MultiBus.h"
+#include "AX12Scheduler.h"
+#include "AX12Profile.h"
+#include "AX12Estimator.h"
+#include "AX12Transaction.h"
+#include "AX12Load.h"
+#include "AX12Stall.h"
+#include "AX12Kinematics.h"
+#include "AX12Odometry.h"
+#include "AX12Log.h"
+#include "AX12Teach.h"
+#include "AX12Watch.h"
+#include "AX12Batch.h"
+#include "AX12Sweep.h"
+#include "AX12Topology.h"
+#include "AX12Sequence.h"
+
+#if defined(__MBED__)
+#include "mbed.h"
+#include "AX12.h"
+#endif
+
+#ifndef FOOTPRINT_BUSES
+#define FOOTPRINT_BUSES 2
+#endif
+
+static void line(const char *name, unsigned bytes, const char *note)
+{
+    printf("  %-34s %6u  %s\n", name, bytes, note);
+}
+
+int main(void)
+{
+    printf("Configuration : packet %d, serial ring %d, %d buses, %d queued requests, %d joints\n",
+           AX12_BUS_PACKET_SIZE, AX12_SERIAL_BUF_SIZE, AX12_MAX_BUSES, AX12_SCHED_QUEUE_SIZE,
+           AX12_PROFILE_MAX_JOINTS);
+
+    unsigned bus = sizeof(AX12Bus);
+#if defined(__MBED__)
+    bus += sizeof(SerialHalfDuplex);
+#endif
+    unsigned scheduler = sizeof(AX12Scheduler);
+    unsigned profile = sizeof(AX12Profile) + 1;   // + ID
+    unsigned estimator = sizeof(AX12Estimator) + 1;
+    unsigned transaction = (sizeof(AX12Transaction) - sizeof(AX12TransactionStats)) / AX12_TRANSACTION_MAX_SERVOS;
+
+    printf("\nPer bus (bytes)\n");
+    line("AX12Bus", sizeof(AX12Bus), "packet buffer, AX12_BUS_MAX_QUARANTINE servos followed");
+#if defined(__MBED__)
+    line("SerialHalfDuplex", sizeof(SerialHalfDuplex), "receive ring included");
+#endif
+    line("AX12Scheduler", scheduler, "optional, requests belong to the caller");
+
+    printf("\nPer servo (bytes)\n");
+    line("AX12Profile", profile, "AX12ProfileGenerator");
+    line("AX12Estimator", estimator, "AX12Tracker");
+    line("staged write", transaction, "AX12Transaction");
+    line("AX12Request", sizeof(AX12Request), "AX12Scheduler, owned by the caller");
+#if defined(__MBED__)
+    line("AX12 (legacy class)", sizeof(AX12), "one SerialHalfDuplex each");
+#endif
+
+    printf("\nShared (bytes)\n");
+    line("AX12MultiBus", sizeof(AX12MultiBus), "placement map of the 254 IDs");
+    line("AX12ProfileGenerator", sizeof(AX12ProfileGenerator), "AX12_PROFILE_MAX_JOINTS joints");
+    line("AX12Tracker", sizeof(AX12Tracker), "AX12_TRACKER_MAX_JOINTS joints");
+    line("AX12Transaction", sizeof(AX12Transaction), "AX12_TRANSACTION_MAX_SERVOS servos");
+    line("AX12LoadSampler", sizeof(AX12LoadSampler), "optional, AX12_LOAD_MAX_JOINTS joints");
+    line("AX12StallDetector", sizeof(AX12StallDetector), "optional, AX12_STALL_MAX_JOINTS joints");
+    line("AX12Kinematics", sizeof(AX12Kinematics), "optional, AX12_KIN_MAX_LIMBS limbs");
+    line("AX12Odometry", sizeof(AX12Odometry), "optional, AX12_ODO_MAX_JOINTS joints");
+    line("AX12Log", sizeof(AX12Log), "with AX12_LOG_LEVEL > 0, AX12_LOG_SIZE events");
+    line("AX12Recorder", sizeof(AX12Recorder), "optional, AX12_TEACH_MAX_JOINTS joints, buffer of the caller");
+    line("AX12Watcher", sizeof(AX12Watcher), "optional, AX12_WATCH_MAX watches, AX12_WATCH_MAX_READS packets");
+    line("AX12WriteBatch", sizeof(AX12WriteBatch), "in AX12, entries of the caller");
+    line("AX12ReadSweep", sizeof(AX12ReadSweep), "optional, buffers of the caller");
+    line("AX12Topology", sizeof(AX12Topology), "optional, AX12_TOPOLOGY_MAX_SERVOS servos");
+    line("AX12Sequencer", sizeof(AX12Sequencer), "optional, AX12_SEQ_MAX_JOINTS joints, sequence of the caller");
+    line("AX12BatchEntry", sizeof(AX12BatchEntry), "per servo held, AX12_BATCH_SPAN bytes");
+
+    // The arrays are sized at compile time : the RAM of a chain is what the
+    // maxima reserve, the per servo cost tells how far they can be lowered
+    unsigned total = FOOTPRINT_BUSES * bus + sizeof(AX12MultiBus) + sizeof(AX12ProfileGenerator)
+                     + sizeof(AX12Tracker) + sizeof(AX12Transaction);
+    printf("\nMotion stack on %d buses (multibus, profiles, tracker, transaction) : %u bytes\n",
+           FOOTPRINT_BUSES, total);
+    printf("  + %u bytes per bus, + %u bytes per joint of AX12_*_MAX_JOINTS / _SERVOS\n",
+           bus, profile + estimator + transaction);
+    return 0;
+}
@@ -0,0 +1,185 @@
+/**
+ * @file batch_bench.cpp
+ * @author joebarteam11
+ * @brief Packets and bus time of the writes of a control loop, one by one or through AX12WriteBatch
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ * Host program, build it from the root of the library :
+ *   g++ -O2 -Iinclude src/AX12Bus.cpp src/AX12Clock.cpp src/AX12Batch.cpp \
+ *       src/AX12Emulator.cpp examples/host/batch_bench.cpp -o batch_bench
+ *
+ * Two emulated chains of 12 servos at 1 Mbps receive the same writes: each
+ * write is sent at once on the first chain, as SetGoal(), SetCRSpeed(),
+ * SetCWLimit()... do, and staged in an AX12WriteBatch flushed at the end of
+ * each 10 ms tick on the second. The control tables of both chains are
+ * compared after every tick.
+ *
+ * First SetMode() on every servo (CW limit, CCW limit, speed), then 10 s of
+ * a control loop writing goal and speed of every servo each tick and the
+ * torque limit of a few, then 20000 ticks of random writes of 1 or 2 bytes
+ * anywhere from 0x06 to 0x23 and in 0x2F-0x31, several per servo and tick,
+ * overlapping each other (the return delay and the status return level are
+ * left alone, the chains must keep answering). In between, 100 ticks write
+ * the CW limit, goal, punch and CCW limit of every servo, further apart than
+ * AX12_BATCH_SPAN. Add -DAX12_BATCH_SPAN=8 to the build to move the window of
+ * a servo for most writes.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "AX12Batch.h"
+#include "AX12Emulator.h"
+
+#define SERVOS 12
+#define TICK_US 10000
+
+struct Chains {
+    AX12VirtualClock clock[2];
+    AX12EmulatedBus *chain[2];
+    AX12Bus *bus[2];
+    AX12BatchEntry entries[SERVOS];
+    AX12WriteBatch *batch;
+    uint32_t packets[2];
+    int ticks;
+    int differ; // ticks after which the control tables differ
+
+    Chains()
+    {
+        for (int c = 0; c < 2; c++) {
+            chain[c] = new AX12EmulatedBus(clock[c], 1000000);
+            bus[c] = new AX12Bus(*chain[c], clock[c]);
+            bus[c]->SetReturnDelay(0);
+            for (int id = 1; id <= SERVOS; id++) {
+                chain[c]->Attach(id)->table[AX12_REG_RETURN_DELAY] = 0;
+            }
+        }
+        batch = new AX12WriteBatch(*bus[1], entries, SERVOS);
+        ticks = 0;
+        differ = 0;
+        start();
+    }
+
+    void start(void)
+    {
+        batch->ResetStats();
+        for (int c = 0; c < 2; c++) {
+            bus[c]->ResetStats();
+            packets[c] = 0;
+        }
+        ticks = 0;
+        differ = 0;
+    }
+
+    void write(int id, int reg, int length, const uint8_t *data)
+    {
+        bus[0]->Write(id, reg, length, data);
+        packets[0]++;
+        batch->Write(id, reg, length, data);
+    }
+
+    void word(int id, int reg, uint16_t value)
+    {
+        uint8_t data[2] = {(uint8_t)(value & 0xFF), (uint8_t)(value >> 8)};
+        write(id, reg, 2, data);
+    }
+
+    void tick(void)
+    {
+        batch->Flush();
+        ticks++;
+        for (int id = 1; id <= SERVOS; id++) {
+            const uint8_t *a = chain[0]->Servo(id)->table;
+            const uint8_t *b = chain[1]->Servo(id)->table;
+            if (memcmp(&a[AX12_REG_RETURN_DELAY], &b[AX12_REG_RETURN_DELAY], AX12_REG_POSITION - AX12_REG_RETURN_DELAY)
+                || memcmp(&a[AX12_REG_LOCK], &b[AX12_REG_LOCK], AX12_TABLE_SIZE - AX12_REG_LOCK)) {
+                differ++;
+                break;
+            }
+        }
+    }
+
+    void print(const char *name)
+    {
+        packets[1] = batch->Stats().packets;
+        printf("%-14s %8d %10lu %10lu %8.1f%% %10lu %8.1f%% %8lu %8lu %8d\n", name, ticks,
+               (unsigned long)batch->Stats().writes, (unsigned long)packets[0],
+               bus[0]->Stats().busy_us / (ticks * (TICK_US / 100.0)), (unsigned long)packets[1],
+               bus[1]->Stats().busy_us / (ticks * (TICK_US / 100.0)), (unsigned long)batch->Stats().syncs,
+               (unsigned long)batch->Stats().early, differ);
+    }
+};
+
+int main(void)
+{
+    Chains chains;
+
+    printf("%d servos at 1 Mbps, ticks of %d ms, the writes sent one by one or batched\n\n", SERVOS, TICK_US / 1000);
+    printf("%-14s %8s %10s %10s %9s %10s %9s %8s %8s %8s\n", "", "ticks", "writes", "one by one", "bus",
+           "batched", "bus", "SYNC", "early", "differ");
+
+    // SetMode(1) : CW limit, CCW limit, speed
+    for (int id = 1; id <= SERVOS; id++) {
+        chains.word(id, AX12_REG_CW_LIMIT, 0);
+        chains.word(id, AX12_REG_CCW_LIMIT, 0);
+        chains.word(id, AX12_REG_MOVING_SPEED, 0);
+    }
+    chains.tick();
+    chains.print("SetMode");
+
+    // SetGoal() and SetCRSpeed() of every servo, the torque limit of one servo in 4
+    chains.start();
+    for (int id = 1; id <= SERVOS; id++) {
+        chains.word(id, AX12_REG_CCW_LIMIT, 1023);
+    }
+    chains.tick();
+    chains.start();
+    for (int t = 0; t < 1000; t++) {
+        for (int id = 1; id <= SERVOS; id++) {
+            chains.word(id, AX12_REG_GOAL_POSITION, 512 + 300 * ((t + id) % 7) / 7);
+            chains.word(id, AX12_REG_MOVING_SPEED, 100 + (t * id) % 400);
+            if ((t + id) % 4 == 0) {
+                chains.word(id, AX12_REG_TORQUE_LIMIT, 600 + (t % 400));
+            }
+        }
+        chains.tick();
+    }
+    chains.print("control loop");
+
+    // Writes far apart in the table : the window of each servo moves back and forth
+    chains.start();
+    for (int t = 0; t < 100; t++) {
+        for (int id = 1; id <= SERVOS; id++) {
+            chains.word(id, AX12_REG_CW_LIMIT, t % 2);
+            chains.word(id, AX12_REG_GOAL_POSITION, 300 + 3 * t);
+            chains.word(id, AX12_REG_PUNCH, 32 + t);
+            chains.word(id, AX12_REG_CCW_LIMIT, 1023 - t % 2);
+        }
+        chains.tick();
+    }
+    chains.print("far apart");
+
+    // Random writes : the order and the last value of every byte must be kept
+    chains.start();
+    srand(3);
+    for (int t = 0; t < 20000; t++) {
+        int writes = 1 + rand() % 12;
+        for (int w = 0; w < writes; w++) {
+            int id = 1 + rand() % SERVOS;
+            int length = 1 + rand() % 2;
+            int reg = (rand() % 5 == 0) ? AX12_REG_LOCK + rand() % (AX12_TABLE_SIZE - AX12_REG_LOCK - length + 1)
+                                        : AX12_REG_CW_LIMIT + rand() % (AX12_REG_POSITION - AX12_REG_CW_LIMIT - length + 1);
+            if (reg <= AX12_REG_STATUS_RETURN && reg + length > AX12_REG_STATUS_RETURN) {
+                continue;
+            }
+            uint8_t data[2] = {(uint8_t)rand(), (uint8_t)rand()};
+            chains.write(id, reg, length, data);
+        }
+        chains.tick();
+    }
+    chains.print("random");
+    return 0;
+}
@@ -0,0 +1,73 @@
+/**
+ * @file baud_bench.cpp
+ * @author joebarteam11
+ * @brief Bit rate negotiation on emulated chains with lines of different quality
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ * Host program, build it from the root of the library :
+ *   g++ -O2 -Iinclude src/AX12Bus.cpp src/AX12Clock.cpp src/AX12Emulator.cpp src/AX12Baud.cpp \
+ *       examples/host/baud_bench.cpp -o baud_bench
+ *
+ * 6 servos start at 57142 bps (code 0x22). Each line corrupts bytes above a
+ * given bit rate, the negotiation must leave every servo at the fastest rate
+ * that line carries without errors.
+ */
+#include <stdio.h>
+
+#include "AX12Baud.h"
+#include "AX12Emulator.h"
+
+#define SERVOS 6
+#define START_CODE 0x22
+
+struct Line {
+    const char *name;
+    int clean_baud;
+    uint32_t ppm; // byte errors at 1Mbps
+};
+
+static const Line lines[] = {
+    {"short, terminated", 1000000, 0},
+    {"long cable", 450000, 20000},
+    {"noisy", 220000, 100000},
+};
+
+int main(void)
+{
+    const uint8_t ids[SERVOS] = {1, 2, 3, 4, 5, 6};
+
+    for (unsigned l = 0; l < sizeof(lines) / sizeof(lines[0]); l++) {
+        AX12VirtualClock clock;
+        AX12EmulatedBus chain(clock, AX12_BaudFromCode(START_CODE));
+        AX12Bus bus(chain, clock);
+        AX12BaudNegotiator negotiator(bus);
+
+        for (int i = 0; i < SERVOS; i++) {
+            chain.Attach(ids[i])->table[AX12_REG_BAUD] = START_CODE;
+        }
+        chain.SetLineQuality(lines[l].clean_baud, lines[l].ppm, 1 + l);
+
+        int r = negotiator.Negotiate(ids, SERVOS);
+
+        printf("\nLine \"%s\" : %d, code 0x%02X (%d bps) after %.1f ms\n", lines[l].name, r, negotiator.Code(),
+               AX12_BaudFromCode(negotiator.Code()), clock.Elapsed() / 1000.0);
+        printf("  code     bps  reads  errors  error rate  throughput\n");
+        for (int i = 0; i < negotiator.Steps(); i++) {
+            const AX12BaudStep &s = negotiator.Step(i);
+            printf("  0x%02X %7d  %5d  %6d  %8.2f %%  %6u B/s  %s\n", s.code, s.baud, s.attempts, s.errors,
+                   s.error_ppm / 10000.0, s.throughput, s.passed ? "ok" : "failed");
+        }
+
+        // Every servo must now be at the negotiated rate and answer
+        chain.Update();
+        int right = 0;
+        for (int i = 0; i < SERVOS; i++) {
+            right += (chain.ServoAt(i).table[AX12_REG_BAUD] == negotiator.Code() && bus.Ping(ids[i]) == AX12_OK);
+        }
+        printf("  %d/%d servos answer at the new rate\n", right, SERVOS);
+    }
+    return 0;
+}
@@ -0,0 +1,111 @@
+/**
+ * @file coroutine_demo.cpp
+ * @author joebarteam11
+ * @brief Sequences of moves and reads written as coroutines, sharing one bus
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ * Host program (C++20), build it from the root of the library :
+ *   g++ -std=c++20 -O2 -Iinclude src/AX12Bus.cpp src/AX12Clock.cpp src/AX12Emulator.cpp \
+ *       src/AX12Coroutine.cpp examples/host/coroutine_demo.cpp -o coroutine_demo
+ *
+ * Three sequences "move A, then read B, then light C" run at the same time as
+ * a telemetry loop, on one emulated bus and one thread. The coroutine frames
+ * come from a fixed pool.
+ */
+#include <stdio.h>
+
+#include "AX12Coroutine.h"
+#include "AX12Emulator.h"
+
+#define SERVOS 6
+
+static AX12VirtualClock clock_;
+static bool finished = false;
+
+// Move a servo and wait until it stops, polling every 10 ms
+static AX12Task reach(AX12Executor &ex, int id, uint16_t goal)
+{
+    uint8_t data[4] = {(uint8_t)(goal & 0xff), (uint8_t)(goal >> 8), 0x00, 0x01}; // speed 256
+    uint8_t moving = 1;
+
+    int r = co_await ex.Write(id, AX12_REG_GOAL_POSITION, 4, data);
+    while (r == AX12_OK && moving) {
+        co_await ex.Sleep(10000);
+        r = co_await ex.Read(id, AX12_REG_MOVING, 1, &moving);
+    }
+    co_return r;
+}
+
+static AX12Task sequence(AX12Executor &ex, int a, int b, int c, uint16_t goal)
+{
+    uint8_t position[2];
+    uint8_t on = 1;
+
+    if (co_await ex.Ping(a, 5000) != AX12_OK) {
+        co_return AX12_ERR_TIMEOUT;
+    }
+    int r = co_await reach(ex, a, goal);
+    if (r == AX12_OK) {
+        r = co_await ex.Read(b, AX12_REG_POSITION, 2, position);
+    }
+    if (r == AX12_OK) {
+        r = co_await ex.Write(c, AX12_REG_LED, 1, &on);
+    }
+    printf("%8.1f ms  sequence %d-%d-%d : %d, position of %d = %d\n", clock_.Elapsed() / 1000.0, a, b, c, r,
+           b, position[0] | (position[1] << 8));
+    co_return r;
+}
+
+// Temperatures every 20 ms, giving up a read that cannot start within 2 ms
+static AX12Task telemetry(AX12Executor &ex, int *reads, int *late)
+{
+    while (!finished) {
+        for (int id = 1; id <= SERVOS; id++) {
+            uint8_t temperature;
+            int r = co_await ex.Read(id, AX12_REG_TEMP, 1, &temperature, 2000);
+            *reads += (r == AX12_OK);
+            *late += (r == AX12_ERR_DEADLINE);
+        }
+        co_await ex.Sleep(20000);
+    }
+    co_return AX12_OK;
+}
+
+static AX12Task main_sequence(AX12Executor &ex)
+{
+    AX12Task s1 = sequence(ex, 1, 2, 3, 800);
+    AX12Task s2 = sequence(ex, 4, 5, 6, 200);
+    co_await s1;
+    co_await s2;
+    co_await sequence(ex, 2, 1, 4, 300);
+    finished = true;
+    co_return AX12_OK;
+}
+
+int main(void)
+{
+    static AX12FramePool<512, 16> pool;
+    AX12FrameAllocator::current = &pool;
+
+    AX12EmulatedBus chain(clock_, 1000000);
+    AX12Bus bus(chain, clock_);
+    AX12Executor ex(bus);
+    int reads = 0, late = 0;
+
+    bus.SetReturnDelay(0);
+    for (int id = 1; id <= SERVOS; id++) {
+        chain.Attach(id)->table[AX12_REG_RETURN_DELAY] = 0;
+    }
+
+    ex.Spawn(telemetry(ex, &reads, &late));
+    ex.Spawn(main_sequence(ex));
+    ex.Run();
+
+    printf("%8.1f ms  done, %lu transactions, %d telemetry reads (%d given up)\n", clock_.Elapsed() / 1000.0,
+           (unsigned long)bus.Stats().transactions, reads, late);
+    printf("frames : %d at most in the pool, %lu from the heap\n", pool.Peak(), (unsigned long)pool.Fallbacks());
+    return 0;
+}
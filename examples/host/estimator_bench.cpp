@@ -0,0 +1,103 @@
+/**
+ * @file estimator_bench.cpp
+ * @author joebarteam11
+ * @brief Position reads saved by AX12Tracker, and its error against the emulator
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ * Host program, build it from the root of the library :
+ *   g++ -O2 -Iinclude src/AX12Bus.cpp src/AX12Clock.cpp src/AX12MultiBus.cpp \
+ *       src/AX12Emulator.cpp src/AX12Profile.cpp src/AX12Estimator.cpp \
+ *       examples/host/estimator_bench.cpp -o estimator_bench
+ *
+ * Joints follow random S-curve moves at 100 Hz. The emulated servos are a few
+ * percent slower or faster than their moving speed says, the tracker has to
+ * learn it, and half way the load of every servo changes (10 % slower) and
+ * the tracker has to learn again. The error is checked just before every
+ * tick, when it is the largest.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+
+#include "AX12Estimator.h"
+#include "AX12Profile.h"
+#include "AX12Emulator.h"
+
+#define JOINTS 6
+#define PERIOD_US 10000
+#define TICKS 6000 // 60 s
+#define TOLERANCE 3.0f
+
+int main(void)
+{
+    AX12VirtualClock clock;
+    AX12EmulatedBus chain(clock, 1000000);
+    AX12Bus bus(chain, clock);
+    AX12MultiBus joints(clock);
+    AX12ProfileGenerator legs(joints, PERIOD_US);
+    AX12Tracker tracker(joints, TOLERANCE);
+    int hold[JOINTS] = {0};
+
+    srand(1);
+    joints.AddBus(bus);
+    for (int i = 0; i < JOINTS; i++) {
+        AX12EmulatedServo *servo = chain.Attach(i + 1);
+        servo->speed_scale = 0.9f + 0.15f * i / (JOINTS - 1);
+        joints.Place(i + 1, 0);
+        legs.Add(i + 1, servo->Word(AX12_REG_POSITION));
+        tracker.Add(i + 1);
+    }
+
+    double sum = 0, worst = 0;
+    long samples = 0, outside = 0;
+    uint64_t next = clock.Elapsed();
+
+    for (int t = 0; t < TICKS; t++) {
+        if (t == TICKS / 2) {
+            for (int i = 0; i < JOINTS; i++) {
+                chain.ServoAt(i).speed_scale *= 0.9f;
+            }
+        }
+        for (int i = 0; i < JOINTS; i++) {
+            if (!legs.Joint(i).Moving() && hold[i]-- <= 0) {
+                legs.Move(i, 100 + rand() % 824, 300 + rand() % 400, 3000, 40000);
+                hold[i] = rand() % 50;
+            }
+        }
+        legs.Tick();
+        for (int i = 0; i < JOINTS; i++) {
+            if (legs.Joint(i).Moving()) {
+                tracker.Command(i, legs.Joint(i).Position(), legs.Joint(i).Speed());
+            }
+        }
+        tracker.Refresh();
+
+        next += PERIOD_US;
+        clock.wait_us((uint32_t)(next - clock.Elapsed()));
+        chain.Update();
+
+        for (int i = 0; i < JOINTS; i++) {
+            uint32_t now = clock.now_us();
+            double error = fabs(tracker.Joint(i).Position(now) - chain.ServoAt(i).Word(AX12_REG_POSITION));
+            sum += error;
+            worst = (error > worst) ? error : worst;
+            samples++;
+            // One tick of rounding of the present position register
+            outside += (error > tracker.Joint(i).Uncertainty(now) + 1);
+        }
+    }
+
+    long every = (long)JOINTS * TICKS;
+    printf("reads      : %lu (%ld when reading every joint every tick, %.1fx less)\n",
+           (unsigned long)tracker.Reads(), every, (double)every / tracker.Reads());
+    printf("error      : mean %.2f ticks, max %.2f ticks (tolerance %.1f)\n", sum / samples, worst, TOLERANCE);
+    printf("over bound : %ld of %ld samples\n", outside, samples);
+    for (int i = 0; i < JOINTS; i++) {
+        printf("joint %d    : speed scale %.3f, gain learnt %.3f, error %.3f\n", i,
+               chain.ServoAt(i).speed_scale, tracker.Joint(i).Gain(), tracker.Joint(i).Error());
+    }
+    return 0;
+}
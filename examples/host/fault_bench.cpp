@@ -0,0 +1,134 @@
+/**
+ * @file fault_bench.cpp
+ * @author joebarteam11
+ * @brief Cost of a dead servo and of a noisy line on the healthy servos of a chain
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ * Host program, build it from the root of the library :
+ *   g++ -O2 -Iinclude src/AX12Bus.cpp src/AX12Clock.cpp src/AX12MultiBus.cpp \
+ *       src/AX12Emulator.cpp examples/host/fault_bench.cpp -o fault_bench
+ *
+ * 8 servos on one emulated chain at 1 Mbps are read every 10 ms for 4 s.
+ * Servo 6 is unplugged from 1 s to 3 s. The reads end on the timeout only
+ * (as before), on the silence of the line, then on the silence with the
+ * quarantine and a PING in the idle time of each cycle. Last, single reads
+ * on a noisy line: how long a failed transaction holds the bus.
+ */
+#include <stdio.h>
+
+#include "AX12MultiBus.h"
+#include "AX12Emulator.h"
+
+#define SERVOS 8
+#define DEAD 6
+#define PERIOD_US 10000
+#define CYCLES 400
+#define NOISY_READS 20000
+
+static const char *phases[3] = {"all plugged", "servo 6 unplugged", "plugged back"};
+
+int main(void)
+{
+    AX12VirtualClock clock;
+    AX12EmulatedBus chain(clock, 1000000);
+    AX12Bus bus(chain, clock);
+    AX12MultiBus joints(clock);
+    uint8_t ids[SERVOS];
+
+    joints.AddBus(bus);
+    bus.SetReturnDelay(0);
+    for (int i = 0; i < SERVOS; i++) {
+        ids[i] = 1 + i;
+        chain.Attach(ids[i])->table[AX12_REG_RETURN_DELAY] = 0;
+        joints.Place(ids[i], 0);
+    }
+
+    printf("%-22s %-18s %10s %10s %12s %10s\n", "reads end on", "", "cycle mean", "cycle max", "healthy ok", "back after");
+    for (int mode = 0; mode < 3; mode++) {
+        const char *names[3] = {"timeout (2 ms)", "silence", "silence + quarantine"};
+        bus.SetSilence(mode ? AX12_BUS_SILENCE_US : 0);
+        bus.Release(DEAD);
+        bus.ResetStats();
+
+        uint64_t sum[3] = {0};
+        uint32_t worst[3] = {0};
+        int ok[3] = {0}, reads[3] = {0};
+        int back = -1;
+        uint32_t start = clock.now_us();
+        for (int c = 0; c < CYCLES; c++) {
+            int phase = (c < 100) ? 0 : (c < 300) ? 1 : 2;
+            chain.Servo(DEAD)->unplugged = (phase == 1);
+
+            uint32_t before = clock.now_us();
+            uint8_t data[2 * SERVOS];
+            int results[SERVOS];
+            joints.ReadAll(AX12_REG_POSITION, 2, ids, data, results, SERVOS);
+            if (mode == 2) {
+                if (bus.Probe() == AX12_BUSY) {
+                    bus.Wait();
+                }
+            } else {
+                bus.Release(DEAD); // no quarantine
+            }
+            uint32_t spent = clock.now_us() - before;
+
+            sum[phase] += spent;
+            worst[phase] = (spent > worst[phase]) ? spent : worst[phase];
+            for (int i = 0; i < SERVOS; i++) {
+                if (ids[i] != DEAD) {
+                    ok[phase] += (results[i] == AX12_OK);
+                    reads[phase]++;
+                }
+            }
+            if (phase == 2 && back < 0 && results[DEAD - 1] == AX12_OK) {
+                back = (c - 300) * PERIOD_US;
+            }
+            clock.wait_us(start + (c + 1) * PERIOD_US - clock.now_us());
+        }
+
+        for (int p = 0; p < 3; p++) {
+            printf("%-22s %-18s %7llu us %7lu us %10.1f %%", p ? "" : names[mode], phases[p],
+                   (unsigned long long)(sum[p] / (p == 1 ? 200 : 100)), (unsigned long)worst[p], 100.0 * ok[p] / reads[p]);
+            if (p == 2) {
+                printf(" %7.0f ms", back / 1000.0);
+            }
+            printf("\n");
+        }
+        const AX12BusStats &stats = bus.Stats();
+        printf("%-22s %lu timeouts, %lu refused, %lu PING\n\n", "", (unsigned long)stats.timeouts,
+               (unsigned long)stats.refused, (unsigned long)stats.probes);
+    }
+
+    // Noisy line : every failed read, from its start to the next transaction. The
+    // noise may turn a READ into a WRITE that changes an ID : same servos and noise for both
+    printf("%-22s %8s %8s %8s %8s %16s\n", "noisy line, reads end", "ok", "timeout", "line", "reply", "failed read mean");
+    for (int mode = 0; mode < 2; mode++) {
+        bus.SetSilence(mode ? AX12_BUS_SILENCE_US : 0);
+        chain.SetLineQuality(500000, 20000);
+        for (int i = 0; i < SERVOS; i++) {
+            chain.ServoAt(i).Reset(ids[i]);
+            chain.ServoAt(i).table[AX12_REG_RETURN_DELAY] = 0;
+        }
+        int count[4] = {0};
+        uint64_t failed_us = 0;
+        for (int n = 0; n < NOISY_READS; n++) {
+            uint8_t data[2];
+            uint32_t before = clock.now_us();
+            int r = bus.Read(1 + n % SERVOS, AX12_REG_POSITION, 2, data);
+            bus.Release(1 + n % SERVOS); // noise is not a dead servo
+            int kind = (r == AX12_OK) ? 0 : (r == AX12_ERR_TIMEOUT) ? 1 : (r == AX12_ERR_LINE) ? 2 : 3;
+            count[kind]++;
+            if (kind) {
+                failed_us += clock.now_us() - before;
+            }
+            clock.wait_us(100);
+        }
+        int failed = NOISY_READS - count[0];
+        printf("%-22s %8d %8d %8d %8d %13.0f us\n", mode ? "on the silence" : "on the timeout", count[0], count[1],
+               count[2], count[3], failed ? (double)failed_us / failed : 0.0);
+    }
+    return 0;
+}
@@ -0,0 +1,239 @@
+/**
+ * @file kinematics_bench.cpp
+ * @author joebarteam11
+ * @brief Accuracy and solves per second of AX12Kinematics against float trigonometry
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ * Host program, build it from the root of the library :
+ *   g++ -O2 -Iinclude src/AX12Bus.cpp src/AX12Clock.cpp src/AX12MultiBus.cpp \
+ *       src/AX12Emulator.cpp src/AX12Kinematics.cpp examples/host/kinematics_bench.cpp -o kinematics_bench
+ *
+ * A hexapod leg (coxa 52 mm, femur 66 mm, tibia 133 mm) is put at random
+ * joint angles (coxa +/- 75 degrees, femur +/- 80, knee -9 to -132), its
+ * foot position computed in double, then solved back by the fixed point
+ * inverse and by a float one written as in the applications (atan2f, acosf,
+ * sqrtf). The host has an FPU: on a Cortex-M0 or M3 the float
+ * version runs through the software float library and the gap is far wider.
+ * Last, 6 legs are solved and sent every tick to 2 emulated buses.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <chrono>
+
+#include "AX12Kinematics.h"
+#include "AX12Emulator.h"
+
+#define COXA 52.0
+#define FEMUR 66.0
+#define TIBIA 133.0
+#define SAMPLES 100000
+#define LEGS 6
+
+static double radians(int ticks)
+{
+    return (ticks - 512) * (300.0 / 1023.0) * M_PI / 180.0;
+}
+
+// Foot of the leg, limb frame, mm
+static void forward(const uint16_t *ticks, double *x, double *y, double *z)
+{
+    double yaw = radians(ticks[0]), femur = radians(ticks[1]), tibia = femur + radians(ticks[2]);
+    double d = COXA + FEMUR * cos(femur) + TIBIA * cos(tibia);
+    *x = d * cos(yaw);
+    *y = d * sin(yaw);
+    *z = FEMUR * sin(femur) + TIBIA * sin(tibia);
+}
+
+// Inverse as the applications write it, knee down
+static int inverse_float(float x, float y, float z, uint16_t *ticks)
+{
+    float yaw = atan2f(y, x);
+    float d = sqrtf(x * x + y * y) - (float)COXA;
+    float r2 = d * d + z * z;
+    float c = (r2 - (float)(FEMUR * FEMUR) - (float)(TIBIA * TIBIA)) / (float)(2 * FEMUR * TIBIA);
+    if (c < -1 || c > 1) {
+        return -1;
+    }
+    float knee = -acosf(c);
+    float femur = atan2f(z, d) - atan2f((float)TIBIA * sinf(knee), (float)FEMUR + (float)TIBIA * cosf(knee));
+    float angles[3] = {yaw, femur, knee};
+    for (int i = 0; i < 3; i++) {
+        ticks[i] = (uint16_t)lroundf(512 + angles[i] * (180.0f / (float)M_PI) * (1023.0f / 300.0f));
+    }
+    return 0;
+}
+
+static double seconds(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+int main(void)
+{
+    AX12Limb leg;
+    leg.SetLayout(AX12_KIN_LEG3, AX12_KIN_MM(COXA), AX12_KIN_MM(FEMUR), AX12_KIN_MM(TIBIA));
+
+    // Trigonometry
+    double sin_error = 0, atan_error = 0, norm_error = 0;
+    for (int a = 0; a < AX12_KIN_TURN; a += 7) {
+        double e = fabs(AX12_Sin(a) / 32768.0 - sin(a * 2 * M_PI / AX12_KIN_TURN));
+        sin_error = (e > sin_error) ? e : sin_error;
+    }
+    for (int i = 0; i < 100000; i++) {
+        int64_t x = rand() % 200001 - 100000, y = rand() % 200001 - 100000, m;
+        int32_t a = AX12_Atan2(y, x, &m);
+        double e = fabs(remainder(a * 360.0 / AX12_KIN_TURN - atan2((double)y, (double)x) * 180 / M_PI, 360));
+        atan_error = (e > atan_error) ? e : atan_error;
+        e = fabs(m - hypot((double)x, (double)y));
+        norm_error = (e > norm_error) ? e : norm_error;
+    }
+    printf("sin : worst error %.1e   atan2 : worst error %.4f degree   magnitude : worst error %.1f\n\n",
+           sin_error, atan_error, norm_error);
+
+    // Random feet, knee down, in front of the coxa axis (behind it the coxa would turn round)
+    static AX12Point feet[SAMPLES];
+    static float floats[SAMPLES][3];
+    static uint16_t truth[SAMPLES][3];
+    for (int i = 0; i < SAMPLES; i++) {
+        double x, y, z;
+        do {
+            truth[i][0] = 512 + rand() % 513 - 256;
+            truth[i][1] = 512 + rand() % 545 - 272;
+            truth[i][2] = 512 - 30 - rand() % 420;
+            forward(truth[i], &x, &y, &z);
+        } while (x * cos(radians(truth[i][0])) + y * sin(radians(truth[i][0])) < 20);
+        feet[i].x = lround(x * 16);
+        feet[i].y = lround(y * 16);
+        feet[i].z = lround(z * 16);
+        floats[i][0] = x;
+        floats[i][1] = y;
+        floats[i][2] = z;
+    }
+
+    int worst_ticks = 0, worst_float = 0, worst_reference = 0, failed = 0;
+    double worst_mm = 0;
+    for (int i = 0; i < SAMPLES; i++) {
+        uint16_t ticks[3], reference[3];
+        if (leg.Inverse(feet[i], ticks) != AX12_OK) {
+            failed++;
+            continue;
+        }
+        inverse_float(floats[i][0], floats[i][1], floats[i][2], reference);
+        double x, y, z;
+        forward(ticks, &x, &y, &z);
+        double mm = sqrt(pow(x - floats[i][0], 2) + pow(y - floats[i][1], 2) + pow(z - floats[i][2], 2));
+        worst_mm = (mm > worst_mm) ? mm : worst_mm;
+        for (int j = 0; j < 3; j++) {
+            int e = abs(ticks[j] - truth[i][j]);
+            worst_ticks = (e > worst_ticks) ? e : worst_ticks;
+            e = abs(ticks[j] - reference[j]);
+            worst_float = (e > worst_float) ? e : worst_float;
+            e = abs(reference[j] - truth[i][j]);
+            worst_reference = (e > worst_reference) ? e : worst_reference;
+        }
+    }
+    printf("inverse of %d feet : %d failed, worst %d tick from the angles (float inverse : %d),"
+           " %d tick from the float inverse, foot within %.2f mm\n", SAMPLES, failed, worst_ticks, worst_reference,
+           worst_float, worst_mm);
+
+    AX12Point end;
+    double worst_forward = 0;
+    for (int i = 0; i < SAMPLES; i++) {
+        leg.Forward(truth[i], end);
+        double e = sqrt(pow(end.x / 16.0 - floats[i][0], 2) + pow(end.y / 16.0 - floats[i][1], 2) +
+                        pow(end.z / 16.0 - floats[i][2], 2));
+        worst_forward = (e > worst_forward) ? e : worst_forward;
+    }
+    printf("forward of %d poses : foot within %.2f mm\n\n", SAMPLES, worst_forward);
+
+    // Solves per second
+    volatile unsigned sink = 0; // wraps, only keeps the results alive
+    uint16_t ticks[3];
+    int rounds = 20;
+    auto start = std::chrono::steady_clock::now();
+    for (int r = 0; r < rounds; r++) {
+        for (int i = 0; i < SAMPLES; i++) {
+            sink += leg.Inverse(feet[i], ticks) + ticks[0];
+        }
+    }
+    double fixed = rounds * SAMPLES / seconds(start);
+    start = std::chrono::steady_clock::now();
+    for (int r = 0; r < rounds; r++) {
+        for (int i = 0; i < SAMPLES; i++) {
+            sink += inverse_float(floats[i][0], floats[i][1], floats[i][2], ticks) + ticks[0];
+        }
+    }
+    double flt = rounds * SAMPLES / seconds(start);
+    start = std::chrono::steady_clock::now();
+    for (int r = 0; r < rounds; r++) {
+        for (int i = 0; i < SAMPLES; i++) {
+            leg.Forward(truth[i], end);
+            sink += end.x;
+        }
+    }
+    double fwd = rounds * SAMPLES / seconds(start);
+    printf("inverse, fixed point : %6.2f M solves/s\n", fixed / 1e6);
+    printf("inverse, float       : %6.2f M solves/s (host FPU)\n", flt / 1e6);
+    printf("forward, fixed point : %6.2f M solves/s\n\n", fwd / 1e6);
+
+    // Hexapod : 6 legs solved and sent every tick
+    AX12VirtualClock clock;
+    AX12EmulatedBus left(clock, 1000000), right(clock, 1000000);
+    AX12Bus bus0(left, clock), bus1(right, clock);
+    AX12MultiBus joints(clock);
+    AX12Kinematics body(joints);
+    AX12Point standing[LEGS];
+    joints.AddBus(bus0);
+    joints.AddBus(bus1);
+
+    for (int l = 0; l < LEGS; l++) {
+        int32_t yaw = AX12_KIN_DEG(30 + 60 * l);
+        AX12Point origin = {(int32_t)(AX12_Cos(yaw) * (int64_t)AX12_KIN_MM(70) >> 15),
+                            (int32_t)(AX12_Sin(yaw) * (int64_t)AX12_KIN_MM(70) >> 15), 0};
+        leg.SetMount(origin, yaw);
+        for (int j = 0; j < 3; j++) {
+            int id = 1 + 3 * l + j;
+            leg.SetJoint(j, id, 512, false, 0, 1023);
+            (l < 3 ? left : right).Attach(id)->table[AX12_REG_RETURN_DELAY] = 0;
+            joints.Place(id, l < 3 ? 0 : 1);
+        }
+        body.Add(leg);
+        leg.Forward(truth[0], standing[l]);
+        standing[l].x = origin.x + (int32_t)(AX12_Cos(yaw) * (int64_t)AX12_KIN_MM(120) >> 15);
+        standing[l].y = origin.y + (int32_t)(AX12_Sin(yaw) * (int64_t)AX12_KIN_MM(120) >> 15);
+        standing[l].z = AX12_KIN_MM(-90);
+    }
+
+    // Body swaying in a circle of 20 mm, 100 Hz
+    int ticks_run = 500, mismatches = 0, unsolved = 0;
+    uint32_t bus_us = 0;
+    double solve_s = 0;
+    for (int t = 0; t < ticks_run; t++) {
+        AX12Point targets[LEGS];
+        int32_t phase = t * AX12_KIN_TURN / 100;
+        for (int l = 0; l < LEGS; l++) {
+            targets[l] = standing[l];
+            targets[l].x -= (int32_t)(AX12_Cos(phase) * (int64_t)AX12_KIN_MM(20) >> 15);
+            targets[l].y -= (int32_t)(AX12_Sin(phase) * (int64_t)AX12_KIN_MM(20) >> 15);
+        }
+        start = std::chrono::steady_clock::now();
+        unsolved += LEGS - body.Solve(targets);
+        solve_s += seconds(start);
+        uint32_t before = clock.now_us();
+        body.Send();
+        bus_us += clock.now_us() - before;
+        clock.wait_us(2000);
+        for (int k = 0; k < body.Joints(); k++) {
+            AX12EmulatedBus &chain = (k < 9) ? left : right;
+            mismatches += chain.Servo(body.Ids()[k])->Word(AX12_REG_GOAL_POSITION) != body.Goals()[k];
+        }
+    }
+    printf("hexapod, %d ticks : %.2f us to solve 6 legs (host), %.0f us on the buses per tick,"
+           " %d legs unsolved, %d goals differing in the servos\n", ticks_run, solve_s * 1e6 / ticks_run,
+           (double)bus_us / ticks_run, unsolved, mismatches);
+    return sink == 12345678;
+}
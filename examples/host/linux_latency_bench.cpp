@@ -0,0 +1,141 @@
+/**
+ * @file linux_latency_bench.cpp
+ * @author joebarteam11
+ * @brief Round trip time of AX12LinuxPort against per byte I/O
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ * Linux host program, build it from the root of the library :
+ *   g++ -O2 -pthread -Iinclude src/AX12Bus.cpp src/AX12Clock.cpp src/AX12Emulator.cpp \
+ *       src/AX12LinuxPort.cpp src/AX12PtyChain.cpp \
+ *       examples/host/linux_latency_bench.cpp -o linux_latency_bench
+ *
+ * Reads the present position of a servo emulated behind a pty (with the local
+ * echo of a half duplex adapter), or of a real servo on the device given as
+ * argument:
+ *   ./linux_latency_bench [/dev/ttyUSB0 [id]]
+ *
+ * The per byte path is the one of the mbed driver: one write() per byte, then
+ * one read() per byte with a 100 us sleep when nothing came in. AX12Bus runs
+ * twice: sleeping in poll() until the reply (the default), then with
+ * SetSleep(false), waking every byte time. The CPU column is the time the
+ * thread ran per transaction, the rest of the round trip was left to others.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <time.h>
+#include <algorithm>
+#include <chrono>
+
+#include "AX12Bus.h"
+#include "AX12LinuxPort.h"
+#include "AX12PtyChain.h"
+
+#define TRANSACTIONS 2000
+#define BAUD 1000000
+
+typedef std::chrono::steady_clock Clock;
+
+// CPU time of the calling thread
+static double cpu_us(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return ts.tv_sec * 1e6 + ts.tv_nsec / 1e3;
+}
+
+static void report(const char *name, double *t, double cpu, int errors)
+{
+    std::sort(t, t + TRANSACTIONS);
+    double sum = 0;
+    for (int i = 0; i < TRANSACTIONS; i++) {
+        sum += t[i];
+    }
+    printf("%-16s mean %7.1f us  median %7.1f us  p99 %7.1f us  CPU %6.1f us  errors %d\n", name,
+           sum / TRANSACTIONS, t[TRANSACTIONS / 2], t[TRANSACTIONS * 99 / 100], cpu / TRANSACTIONS, errors);
+}
+
+// READ of the present position, one byte per syscall
+static int perByte(int fd, int id, bool echo)
+{
+    uint8_t packet[8] = {0xFF, 0xFF, (uint8_t)id, 4, AX12_INST_READ, AX12_REG_POSITION, 2, 0};
+    packet[7] = AX12_Checksum(packet, 8);
+    for (int i = 0; i < 8; i++) {
+        if (write(fd, &packet[i], 1) != 1) {
+            return AX12_ERR_ARG;
+        }
+    }
+
+    uint8_t reply[8];
+    int expected = 8 + (echo ? 8 : 0);
+    int got = 0;
+    Clock::time_point deadline = Clock::now() + std::chrono::milliseconds(10);
+    while (got < expected) {
+        uint8_t c;
+        if (read(fd, &c, 1) == 1) {
+            if (got >= expected - 8) {
+                reply[got - (expected - 8)] = c;
+            }
+            got++;
+        } else if (Clock::now() > deadline) {
+            return AX12_ERR_TIMEOUT;
+        } else {
+            usleep(100);
+        }
+    }
+    return (reply[7] == AX12_Checksum(reply, 8)) ? AX12_OK : AX12_ERR_CHECKSUM;
+}
+
+int main(int argc, char **argv)
+{
+    AX12PtyChain chain(BAUD, true);
+    const char *path = (argc > 1) ? argv[1] : chain.Path();
+    int id = (argc > 2) ? atoi(argv[2]) : 1;
+    bool echo = (argc <= 1);
+
+    if (argc <= 1) {
+        chain.Emulator().Attach(id)->table[AX12_REG_RETURN_DELAY] = 0;
+        chain.Start();
+    }
+
+    AX12LinuxPort tty;
+    if (!path || tty.Open(path, BAUD, AX12_LINUX_LOW_LATENCY | (echo ? AX12_LINUX_ECHO : 0)) != AX12_OK) {
+        perror("open");
+        return 1;
+    }
+    AX12Bus bus(tty);
+    bus.SetReturnDelay(echo ? 0 : AX12_DEFAULT_RETURN_DELAY_US);
+    bus.SetTimeout(10000);
+
+    static double times[TRANSACTIONS];
+    uint8_t position[2];
+    int errors;
+    double cpu;
+
+    for (int sleep = 1; sleep >= 0; sleep--) {
+        bus.SetSleep(sleep);
+        errors = 0;
+        cpu = cpu_us();
+        for (int i = 0; i < TRANSACTIONS; i++) {
+            Clock::time_point start = Clock::now();
+            errors += (bus.Read(id, AX12_REG_POSITION, 2, position) != AX12_OK);
+            times[i] = std::chrono::duration<double, std::micro>(Clock::now() - start).count();
+        }
+        report(sleep ? "AX12Bus" : "AX12Bus, polling", times, cpu_us() - cpu, errors);
+    }
+
+    errors = 0;
+    cpu = cpu_us();
+    for (int i = 0; i < TRANSACTIONS; i++) {
+        Clock::time_point start = Clock::now();
+        errors += (perByte(tty.Fd(), id, echo) != AX12_OK);
+        times[i] = std::chrono::duration<double, std::micro>(Clock::now() - start).count();
+    }
+    report("per byte", times, cpu_us() - cpu, errors);
+
+    chain.Stop();
+    return 0;
+}
@@ -0,0 +1,155 @@
+/**
+ * @file load_bench.cpp
+ * @author joebarteam11
+ * @brief Load estimate of AX12LoadSampler against one raw read every 100 ms
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ * Host program, build it from the root of the library :
+ *   g++ -O2 -Iinclude src/AX12Bus.cpp src/AX12Clock.cpp src/AX12MultiBus.cpp \
+ *       src/AX12Emulator.cpp src/AX12Load.cpp examples/host/load_bench.cpp -o load_bench
+ *
+ * 12 servos on 2 emulated buses. Their load reads are noisy (+/- 80) and 2 %
+ * of them are wild values. A gripper closes at 0.53 s: its load steps from 0
+ * to 400. The consumer takes the filtered values at 100 Hz.
+ */
+#include <stdio.h>
+#include <math.h>
+
+#include "AX12Load.h"
+#include "AX12Emulator.h"
+
+#define JOINTS 12
+#define BUSES 2
+#define GRIPPER 0
+#define STEP_US 530000
+#define DURATION_US 2000000
+#define CONSUMER_US 10000
+
+static AX12VirtualClock clock_;
+static AX12EmulatedBus chains[BUSES] = {AX12EmulatedBus(clock_, 1000000), AX12EmulatedBus(clock_, 1000000)};
+
+// Load actually on a joint
+static int truth(int joint, uint32_t t)
+{
+    if (joint == GRIPPER) {
+        return (t >= STEP_US) ? 400 : 0;
+    }
+    return -150 + 10 * joint;
+}
+
+static void apply(uint32_t t)
+{
+    for (int i = 0; i < JOINTS; i++) {
+        chains[i % BUSES].Servo(1 + i)->load = truth(i, t);
+    }
+}
+
+struct Score {
+    double sum;
+    double worst;
+    long count;
+    uint32_t settled; // first time the gripper is within 10 % of its new load, after the step
+
+    void add(int joint, uint32_t t, int value)
+    {
+        // The 50 ms after the step are the response time, not an error
+        if (t < STEP_US || t > STEP_US + 50000 || joint != GRIPPER) {
+            double e = value - truth(joint, t);
+            sum += e * e;
+            worst = (fabs(e) > worst) ? fabs(e) : worst;
+            count++;
+        }
+        if (joint == GRIPPER && t >= STEP_US && !settled && value > 360 && value < 440) {
+            settled = t;
+        }
+    }
+
+    void print(const char *name, long reads)
+    {
+        printf("%-30s %6ld reads  rms error %5.1f  worst %5.0f  step seen after %5.1f ms\n", name, reads,
+               sqrt(sum / count), worst, (settled - STEP_US) / 1000.0);
+    }
+};
+
+int main(void)
+{
+    AX12Bus buses[BUSES] = {AX12Bus(chains[0], clock_), AX12Bus(chains[1], clock_)};
+    AX12MultiBus joints(clock_);
+
+    for (int b = 0; b < BUSES; b++) {
+        joints.AddBus(buses[b]);
+        buses[b].SetReturnDelay(0);
+    }
+    for (int i = 0; i < JOINTS; i++) {
+        AX12EmulatedServo *servo = chains[i % BUSES].Attach(1 + i);
+        servo->table[AX12_REG_RETURN_DELAY] = 0;
+        servo->load_noise = 80;
+        servo->load_spikes = 20000;
+        joints.Place(1 + i, i % BUSES);
+    }
+
+    // One raw read per joint every 100 ms, as GetLoad() in main.cpp
+    Score raw = {};
+    long reads = 0;
+    uint32_t start = clock_.now_us();
+    for (uint32_t t = 0; t < DURATION_US; t += 100000) {
+        clock_.wait_us(start + t - clock_.now_us());
+        apply(t);
+        for (int i = 0; i < JOINTS; i++) {
+            uint8_t data[2];
+            if (buses[i % BUSES].Read(1 + i, AX12_REG_LOAD, 2, data) == AX12_OK) {
+                raw.add(i, clock_.now_us() - start, AX12_LoadFromRegister(data[0] | (data[1] << 8)));
+                reads++;
+            }
+        }
+    }
+    raw.print("raw read every 100 ms", reads);
+
+    // Sampler, the consumer pops at 100 Hz
+    AX12LoadSampler sampler(joints);
+    for (int i = 0; i < JOINTS; i++) {
+        sampler.Add(1 + i);
+    }
+    sampler.SetFilter(5, 2, 4);
+
+    int budgets[2] = {100, 30};
+    for (int k = 0; k < 2; k++) {
+        Score filtered = {};
+        uint32_t samples = sampler.Samples();
+        uint32_t consumer = 0;
+        AX12LoadSample s;
+
+        sampler.SetBudget(budgets[k]);
+        for (int i = 0; i < JOINTS; i++) {
+            while (sampler.Pop(i, s)) {
+            }
+            sampler.Filter(i).Reset();
+        }
+        start = clock_.now_us();
+        while (clock_.now_us() - start < DURATION_US) {
+            uint32_t t = clock_.now_us() - start;
+            apply(t);
+            sampler.Poll();
+            if (t >= consumer) {
+                for (int i = 0; i < JOINTS; i++) {
+                    while (sampler.Pop(i, s)) {
+                        filtered.add(i, s.time - start, s.load);
+                    }
+                }
+                consumer += CONSUMER_US;
+            }
+            uint32_t due = sampler.Due();
+            uint32_t wait = (due < consumer - t) ? due : consumer - t;
+            clock_.wait_us(wait ? wait : 1);
+        }
+        char name[40];
+        snprintf(name, sizeof(name), "sampler, %d %% of the bus", budgets[k]);
+        filtered.print(name, (long)(sampler.Samples() - samples));
+        printf("%-30s %6lu batches/s, %lu outputs overwritten\n", "", (unsigned long)sampler.Rate(),
+               (unsigned long)sampler.Overruns());
+    }
+    return 0;
+}
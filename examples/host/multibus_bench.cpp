@@ -0,0 +1,84 @@
+/**
+ * @file multibus_bench.cpp
+ * @author joebarteam11
+ * @brief Control rate of 18 servos spread over 1 to 4 emulated UARTs
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ * Host program, build it from the root of the library :
+ *   g++ -O2 -Iinclude src/AX12Bus.cpp src/AX12Clock.cpp src/AX12MultiBus.cpp \
+ *       src/AX12Emulator.cpp examples/host/multibus_bench.cpp -o multibus_bench
+ *
+ * One control cycle writes the goal of every joint (SYNC_WRITE) then reads
+ * back every present position.
+ */
+#include <stdio.h>
+
+#include "AX12MultiBus.h"
+#include "AX12Emulator.h"
+
+#define JOINTS 18
+#define CYCLES 1000
+#define BAUD 1000000
+#define RETURN_DELAY 0 // AX12_REG_RETURN_DELAY set to 0 on every servo
+
+int main(void)
+{
+    uint8_t ids[JOINTS];
+    uint16_t goals[JOINTS];
+    uint16_t positions[JOINTS];
+    double single = 0;
+
+    for (int i = 0; i < JOINTS; i++) {
+        ids[i] = i + 1;
+    }
+
+    printf("buses  cycle (us)  rate (Hz)  speedup\n");
+
+    for (int buses = 1; buses <= AX12_MAX_BUSES; buses++) {
+        AX12VirtualClock clock;
+        AX12EmulatedBus chains[AX12_MAX_BUSES] = {
+            AX12EmulatedBus(clock, BAUD), AX12EmulatedBus(clock, BAUD),
+            AX12EmulatedBus(clock, BAUD), AX12EmulatedBus(clock, BAUD)
+        };
+        AX12Bus *bus[AX12_MAX_BUSES];
+        AX12MultiBus joints(clock);
+
+        for (int b = 0; b < buses; b++) {
+            bus[b] = new AX12Bus(chains[b], clock);
+            bus[b]->SetReturnDelay(RETURN_DELAY * 2);
+            joints.AddBus(*bus[b]);
+        }
+        joints.Balance(ids, JOINTS);
+
+        // Wire each emulated servo on the chain it was placed on
+        for (int i = 0; i < JOINTS; i++) {
+            AX12EmulatedServo *servo = chains[joints.BusOf(ids[i])].Attach(ids[i]);
+            servo->table[AX12_REG_RETURN_DELAY] = RETURN_DELAY;
+        }
+
+        int errors = 0;
+        uint64_t start = clock.Elapsed();
+        for (int c = 0; c < CYCLES; c++) {
+            for (int i = 0; i < JOINTS; i++) {
+                goals[i] = (c * 7 + i * 50) % 1024;
+            }
+            errors += (joints.SetGoals(ids, goals, JOINTS) != AX12_OK);
+            errors += JOINTS - joints.GetPositions(ids, positions, JOINTS);
+        }
+        double cycle = (double)(clock.Elapsed() - start) / CYCLES;
+        if (buses == 1) {
+            single = cycle;
+        }
+
+        printf("%5d  %10.1f  %9.1f  %7.2f%s\n", buses, cycle, 1e6 / cycle, single / cycle,
+               errors ? "  (errors)" : "");
+
+        for (int b = 0; b < buses; b++) {
+            delete bus[b];
+        }
+    }
+    return 0;
+}
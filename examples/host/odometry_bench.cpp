@@ -0,0 +1,162 @@
+/**
+ * @file odometry_bench.cpp
+ * @author joebarteam11
+ * @brief Distance counted by AX12Odometry on servos in wheel mode, against a fixed rate unwrap
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ * Host program, build it from the root of the library :
+ *   g++ -O2 -Iinclude src/AX12Bus.cpp src/AX12Clock.cpp src/AX12MultiBus.cpp \
+ *       src/AX12Emulator.cpp src/AX12Odometry.cpp examples/host/odometry_bench.cpp -o odometry_bench
+ *
+ * 8 conveyor servos on 2 emulated buses turn for 2 minutes with their dead
+ * zone (the position reads anything over 60 degrees of the turn), at speeds
+ * from full to stopped, each 0.85 to 1.1 times the nominal speed. The last
+ * one reverses every 3 s. The distance counted is compared with the ticks
+ * the emulated servos actually turned, then with a read of every servo every
+ * 10 ms unwrapped over 1024 ticks.
+ */
+#include <stdio.h>
+#include <math.h>
+
+#include "AX12Odometry.h"
+#include "AX12Emulator.h"
+
+#define JOINTS 8
+#define BUSES 2
+#define DURATION_US 120000000
+#define FIXED_US 10000
+
+static AX12VirtualClock clock_;
+static AX12EmulatedBus chains[BUSES] = {AX12EmulatedBus(clock_, 1000000), AX12EmulatedBus(clock_, 1000000)};
+static const float speeds[JOINTS] = {1.0f, 0.6f, -0.4f, 0.2f, 0.05f, -0.02f, 0, 0.7f};
+
+// Brought up to the clock : the emulated servos only move on bus activity
+static AX12EmulatedServo *servo(int joint)
+{
+    chains[joint % BUSES].Update();
+    return chains[joint % BUSES].Servo(1 + joint);
+}
+
+// Every servo back to the middle of its range, stopped, in wheel mode
+static void reset(void)
+{
+    for (int i = 0; i < JOINTS; i++) {
+        AX12EmulatedServo *s = servo(i);
+        s->SetWord(AX12_REG_MOVING_SPEED, 0);
+        s->SetWord(AX12_REG_CW_LIMIT, 0);
+        s->SetWord(AX12_REG_CCW_LIMIT, 0);
+        s->SetWord(AX12_REG_POSITION, 512);
+        s->travel = 0;
+        s->speed_scale = 0.85f + 0.25f * ((i * 3) % JOINTS) / (JOINTS - 1);
+    }
+}
+
+int main(void)
+{
+    AX12Bus buses[BUSES] = {AX12Bus(chains[0], clock_), AX12Bus(chains[1], clock_)};
+    AX12MultiBus joints(clock_);
+    uint8_t ids[JOINTS];
+
+    for (int b = 0; b < BUSES; b++) {
+        joints.AddBus(buses[b]);
+        buses[b].SetReturnDelay(0);
+    }
+    for (int i = 0; i < JOINTS; i++) {
+        AX12EmulatedServo *s = chains[i % BUSES].Attach(1 + i);
+        s->table[AX12_REG_RETURN_DELAY] = 0;
+        s->dead_zone = true;
+        ids[i] = 1 + i;
+        joints.Place(1 + i, i % BUSES);
+    }
+
+    // AX12Odometry
+    reset();
+    AX12Odometry odometry(joints);
+    for (int i = 0; i < JOINTS; i++) {
+        odometry.Add(1 + i);
+        odometry.SetSpeed(i, speeds[i]);
+    }
+    double worst[JOINTS] = {0};
+    uint32_t start = clock_.now_us();
+    uint32_t check = 0, reverse = 3000000;
+    int direction = 1;
+    while (clock_.now_us() - start < DURATION_US) {
+        uint32_t t = clock_.now_us() - start;
+        if (t >= reverse) {
+            direction = -direction;
+            odometry.SetSpeed(JOINTS - 1, direction * speeds[JOINTS - 1]);
+            reverse += 3000000;
+        }
+        odometry.Poll();
+        // Extrapolated count against the truth every 10 ms
+        if (t >= check) {
+            for (int i = 0; i < JOINTS; i++) {
+                double e = fabs(odometry.Ticks(i) - servo(i)->travel);
+                worst[i] = (e > worst[i]) ? e : worst[i];
+            }
+            check += 10000;
+        }
+        uint32_t due = odometry.Due();
+        uint32_t next = check - (clock_.now_us() - start);
+        clock_.wait_us((due < next) ? (due ? due : 1) : next);
+    }
+
+    printf("%-6s %6s %6s %12s %12s %8s %10s %10s %7s %6s\n", "servo", "speed", "scale", "truth", "counted", "error",
+           "worst", "ticks/s", "gain", "");
+    for (int i = 0; i < JOINTS; i++) {
+        AX12EmulatedServo *s = servo(i);
+        printf("%-6d %6.2f %6.3f %12.0f %12lld %8.0f %10.0f %10.1f %7.3f\n", 1 + i, speeds[i], s->speed_scale,
+               s->travel, (long long)odometry.Ticks(i), odometry.Ticks(i) - s->travel, worst[i],
+               odometry.Velocity(i), odometry.Gain(i));
+    }
+    printf("AX12Odometry : %lu reads in %d s (%.1f per servo per second), %lu not trusted\n\n",
+           (unsigned long)odometry.Reads(), DURATION_US / 1000000, odometry.Reads() / (DURATION_US / 1e6) / JOINTS,
+           (unsigned long)odometry.Rejected());
+
+    // Fixed rate : every servo every 10 ms, the shortest way round 1024 ticks
+    reset();
+    long long counted[JOINTS] = {0};
+    int last[JOINTS];
+    long reads = 0;
+    for (int i = 0; i < JOINTS; i++) {
+        last[i] = 512;
+        uint8_t data[2];
+        int value = (int)(0x3ff * fabs(speeds[i])) | ((speeds[i] < 0) ? AX12_SPEED_CW : 0);
+        data[0] = value & 0xff;
+        data[1] = value >> 8;
+        joints.Bus(i % BUSES).Write(1 + i, AX12_REG_MOVING_SPEED, 2, data);
+    }
+    start = clock_.now_us();
+    reverse = 3000000;
+    direction = 1;
+    for (uint32_t t = 0; t < DURATION_US; t = clock_.now_us() - start) {
+        if (t >= reverse) {
+            direction = -direction;
+            int value = (int)(0x3ff * speeds[JOINTS - 1]) | ((direction < 0) ? AX12_SPEED_CW : 0);
+            uint8_t data[2] = {(uint8_t)(value & 0xff), (uint8_t)(value >> 8)};
+            joints.Bus((JOINTS - 1) % BUSES).Write(JOINTS, AX12_REG_MOVING_SPEED, 2, data);
+            reverse += 3000000;
+        }
+        uint16_t positions[JOINTS];
+        int results[JOINTS];
+        joints.ReadAll(AX12_REG_POSITION, 2, ids, (uint8_t *)positions, results, JOINTS);
+        for (int i = 0; i < JOINTS; i++) {
+            int delta = ((positions[i] - last[i]) % 1024 + 1536) % 1024 - 512;
+            counted[i] += delta;
+            last[i] = positions[i];
+            reads++;
+        }
+        clock_.wait_us(FIXED_US - (clock_.now_us() - start) % FIXED_US);
+    }
+    printf("%-6s %6s %12s %12s %8s\n", "servo", "speed", "truth", "unwrapped", "error");
+    for (int i = 0; i < JOINTS; i++) {
+        printf("%-6d %6.2f %12.0f %12lld %8.0f\n", 1 + i, speeds[i], servo(i)->travel, counted[i],
+               counted[i] - servo(i)->travel);
+    }
+    printf("fixed rate : %ld reads in %d s (%.1f per servo per second)\n", reads, DURATION_US / 1000000,
+           reads / (DURATION_US / 1e6) / JOINTS);
+    return 0;
+}
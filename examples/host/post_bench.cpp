@@ -0,0 +1,183 @@
+/**
+ * @file post_bench.cpp
+ * @author joebarteam11
+ * @brief Many threads reading servos of one bus : AX12Scheduler::Post() against a mutex around the bus
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ * Host program, build it from the root of the library :
+ *   g++ -O2 -pthread -Iinclude src/AX12Bus.cpp src/AX12Clock.cpp src/AX12Scheduler.cpp \
+ *       src/AX12Emulator.cpp examples/host/post_bench.cpp -o post_bench
+ *
+ * 1 to 16 client threads read the position of 8 emulated servos as fast as
+ * they can for half a second. Each servo holds its own position, so a reply
+ * given to the wrong thread or mixed with another one shows. The bus first
+ * belongs to one thread that takes the requests with Post() and wakes each
+ * client when its read is over, then every client locks a mutex around
+ * AX12Bus::Read(), the usual way to share it. The bus is emulated on a
+ * virtual clock: the reads per second measure the host time spent to pass
+ * the bus around, and the fewest and most reads of a client how evenly.
+ */
+#include <stdio.h>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <thread>
+
+#include "AX12Scheduler.h"
+#include "AX12Emulator.h"
+
+#define SERVOS 8
+#define RUN_MS 500
+#define MAX_CLIENTS 16
+
+static uint16_t expected(int id)
+{
+    return 100 + 10 * id;
+}
+
+struct Run {
+    double per_second;
+    int fewest, most; // reads of a client
+    int wrong;
+    int failed;
+};
+
+static Run count(const int *reads, int clients, double s, int wrong, int failed)
+{
+    Run run = {0, reads[0], reads[0], wrong, failed};
+    long total = 0;
+    for (int c = 0; c < clients; c++) {
+        total += reads[c];
+        run.fewest = (reads[c] < run.fewest) ? reads[c] : run.fewest;
+        run.most = (reads[c] > run.most) ? reads[c] : run.most;
+    }
+    run.per_second = total / s;
+    return run;
+}
+
+static Run posted(int clients)
+{
+    AX12VirtualClock clock;
+    AX12EmulatedBus chain(clock, 1000000);
+    AX12Bus bus(chain, clock);
+    AX12Scheduler sched(bus);
+    std::atomic<bool> running(true), clients_running(true);
+    std::atomic<int> wrong(0), failed(0);
+    int reads[MAX_CLIENTS] = {0};
+
+    bus.SetReturnDelay(0);
+    for (int id = 1; id <= SERVOS; id++) {
+        chain.Attach(id)->SetWord(AX12_REG_POSITION, expected(id));
+        chain.Servo(id)->table[AX12_REG_RETURN_DELAY] = 0;
+    }
+
+    // The thread owning the bus
+    std::thread owner([&]() {
+        while (running) {
+            if (sched.Poll() > 0) {
+                clock.wait_us(bus.WireTime(1));
+            } else {
+                sched.Idle(1000);
+            }
+        }
+    });
+
+    auto start = std::chrono::steady_clock::now();
+    std::thread threads[MAX_CLIENTS];
+    for (int c = 0; c < clients; c++) {
+        threads[c] = std::thread([&, c]() {
+            AX12Request request;
+            uint8_t data[2];
+            for (int n = 0; clients_running; n++) {
+                int id = 1 + (c + n) % SERVOS;
+                request.Read(id, AX12_REG_POSITION, 2, data);
+                sched.Post(request);
+                if (request.Wait() != AX12_OK) {
+                    failed++;
+                } else if ((data[0] | data[1] << 8) != expected(id)) {
+                    wrong++;
+                }
+                reads[c]++;
+            }
+        });
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(RUN_MS));
+    clients_running = false;
+    for (int c = 0; c < clients; c++) {
+        threads[c].join();
+    }
+    double s = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    running = false;
+    owner.join();
+
+    return count(reads, clients, s, wrong, failed);
+}
+
+static Run locked(int clients)
+{
+    AX12VirtualClock clock;
+    AX12EmulatedBus chain(clock, 1000000);
+    AX12Bus bus(chain, clock);
+    std::mutex lock;
+    std::atomic<bool> clients_running(true);
+    std::atomic<int> wrong(0), failed(0);
+    int reads[MAX_CLIENTS] = {0};
+
+    bus.SetReturnDelay(0);
+    for (int id = 1; id <= SERVOS; id++) {
+        chain.Attach(id)->SetWord(AX12_REG_POSITION, expected(id));
+        chain.Servo(id)->table[AX12_REG_RETURN_DELAY] = 0;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    std::thread threads[MAX_CLIENTS];
+    for (int c = 0; c < clients; c++) {
+        threads[c] = std::thread([&, c]() {
+            uint8_t data[2];
+            for (int n = 0; clients_running; n++) {
+                int id = 1 + (c + n) % SERVOS;
+                int result;
+                {
+                    std::lock_guard<std::mutex> hold(lock);
+                    result = bus.Read(id, AX12_REG_POSITION, 2, data);
+                }
+                if (result != AX12_OK) {
+                    failed++;
+                } else if ((data[0] | data[1] << 8) != expected(id)) {
+                    wrong++;
+                }
+                reads[c]++;
+            }
+        });
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(RUN_MS));
+    clients_running = false;
+    for (int c = 0; c < clients; c++) {
+        threads[c].join();
+    }
+    double s = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    return count(reads, clients, s, wrong, failed);
+}
+
+int main(void)
+{
+    printf("%d emulated servos read for %d ms per run, %u host threads\n\n", SERVOS, RUN_MS,
+           std::thread::hardware_concurrency());
+    printf("%-8s | %-40s | %-40s\n", "", "Post(), one thread owns the bus", "mutex around AX12Bus::Read()");
+    printf("%-8s | %10s %16s %6s %6s | %10s %16s %6s %6s\n", "clients", "reads/s", "per client", "wrong",
+           "failed", "reads/s", "per client", "wrong", "failed");
+    for (int clients = 1; clients <= MAX_CLIENTS; clients *= 2) {
+        Run p = posted(clients);
+        Run m = locked(clients);
+        char pc[32], mc[32];
+        snprintf(pc, sizeof(pc), "%d-%d", p.fewest, p.most);
+        snprintf(mc, sizeof(mc), "%d-%d", m.fewest, m.most);
+        printf("%-8d | %10.0f %16s %6d %6d | %10.0f %16s %6d %6d\n", clients, p.per_second, pc, p.wrong, p.failed,
+               m.per_second, mc, m.wrong, m.failed);
+    }
+    return 0;
+}
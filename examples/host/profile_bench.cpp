@@ -0,0 +1,65 @@
+/**
+ * @file profile_bench.cpp
+ * @author joebarteam11
+ * @brief Cost of AX12Profile::Step() and check of the profiles
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ * Host program, build it from the root of the library :
+ *   g++ -O2 -Iinclude src/AX12Bus.cpp src/AX12Clock.cpp src/AX12MultiBus.cpp \
+ *       src/AX12Profile.cpp examples/host/profile_bench.cpp -o profile_bench
+ *
+ * 18 joints at 100 Hz need 1800 steps per second, the F303K8 (72 MHz) has
+ * 40000 cycles per step at that rate.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <chrono>
+
+#include "AX12Profile.h"
+
+#define PERIOD_US 10000
+#define MOVES 20000
+
+int main(void)
+{
+    const char *names[2] = {"trapezoid", "S-curve"};
+    const float velocity = 600;       // ticks/s
+    const float acceleration = 3000;  // ticks/s^2
+    const float jerk = 40000;         // ticks/s^3
+    const float T = PERIOD_US * 1e-6f;
+
+    srand(1);
+
+    for (int type = 0; type < 2; type++) {
+        AX12Profile profile;
+        long steps = 0;
+        double worst_v = 0;
+        int errors = 0;
+        std::chrono::nanoseconds spent(0);
+
+        for (int m = 0; m < MOVES; m++) {
+            int from = rand() % 1024;
+            int to = rand() % 1024;
+            profile.Plan(from, to, velocity, acceleration, type ? jerk : 0, PERIOD_US);
+
+            uint16_t goal, speed;
+            int last = from;
+            auto start = std::chrono::steady_clock::now();
+            while (profile.Step(&goal, &speed)) {
+                steps++;
+                double v = abs(goal - last) / T; // 1 tick of rounding
+                worst_v = (v > worst_v) ? v : worst_v;
+                last = goal;
+            }
+            spent += std::chrono::steady_clock::now() - start;
+            errors += (last != to);
+        }
+
+        printf("%-9s : %6.1f ns/step, max %.0f ticks/s (limit %.0f + %.0f of rounding), %d missed targets\n",
+               names[type], (double)spent.count() / steps, worst_v, velocity, 1 / T, errors);
+    }
+    return 0;
+}
@@ -0,0 +1,120 @@
+/**
+ * @file provision_bench.cpp
+ * @author joebarteam11
+ * @brief EEPROM provisioning of a robot: one call per setting against AX12Provisioner
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ * Host program, build it from the root of the library :
+ *   g++ -O2 -Iinclude src/AX12Bus.cpp src/AX12Clock.cpp src/AX12Emulator.cpp src/AX12Provision.cpp \
+ *       examples/host/provision_bench.cpp -o provision_bench
+ *
+ * 12 servos with factory settings get joint limits, a torque limit, a return
+ * delay and an alarm configuration. The profiles are applied a first time,
+ * then again on the configured robot (nothing to write), then with a new ID
+ * for one servo and an ID already taken for another.
+ */
+#include <stdio.h>
+
+#include "AX12Provision.h"
+#include "AX12Emulator.h"
+
+#define SERVOS 12
+
+static AX12VirtualClock clock_;
+static AX12EmulatedBus chain(clock_, 1000000);
+static AX12Bus bus(chain, clock_);
+
+struct Setting {
+    uint8_t reg;
+    uint8_t length;
+};
+
+static const Setting settings[] = {{AX12_REG_RETURN_DELAY, 1}, {AX12_REG_MAX_TORQUE, 2}, {AX12_REG_TEMP_LIMIT, 1},
+                                   {AX12_REG_ALARM_SHUTDOWN, 1}, {AX12_REG_CW_LIMIT, 2}, {AX12_REG_CCW_LIMIT, 2}};
+#define SETTINGS (int)(sizeof(settings) / sizeof(settings[0]))
+
+// Legs : hips and knees have their own range, every leg the same
+static int value(int joint, int setting)
+{
+    static const int common[SETTINGS] = {0, 818, 70, 0x25, 0, 0}; // 0us, 80%, factory value, + angle limit
+    switch (settings[setting].reg) {
+    case AX12_REG_CW_LIMIT:
+        return (1023 * ((joint % 2) ? 60 : 90)) / 300;
+    case AX12_REG_CCW_LIMIT:
+        return (1023 * ((joint % 2) ? 240 : 210)) / 300;
+    default:
+        return common[setting];
+    }
+}
+
+static void profiles(AX12EepromProfile *joints)
+{
+    for (int i = 0; i < SERVOS; i++) {
+        joints[i] = AX12EepromProfile(1 + i);
+        for (int s = 0; s < SETTINGS; s++) {
+            if (settings[s].length == 2) {
+                joints[i].SetWord(settings[s].reg, value(i, s));
+            } else {
+                joints[i].Set(settings[s].reg, value(i, s));
+            }
+        }
+    }
+}
+
+static void print(const char *name, int r, const AX12ProvisionReport &report)
+{
+    printf("%-28s %3d  %2d/%d verified, %3d registers, %2d WRITE + %2d SYNC_WRITE, %2d reads, %6.1f ms\n", name,
+           r, report.verified, report.servos, report.changed, report.writes, report.sync_writes, report.reads,
+           report.elapsed_us / 1000.0);
+}
+
+int main(void)
+{
+    AX12EepromProfile joints[SERVOS];
+    AX12Provisioner provisioner(bus);
+    AX12ProvisionReport report;
+
+    for (int i = 0; i < SERVOS; i++) {
+        chain.Attach(1 + i);
+    }
+    profiles(joints);
+
+    // One blocking call per setting, like SetCWLimit(), SetMaxTorque()... of the AX12 class
+    uint32_t start = clock_.now_us();
+    int packets = 0;
+    for (int i = 0; i < SERVOS; i++) {
+        for (int s = 0; s < SETTINGS; s++) {
+            uint8_t data[2] = {(uint8_t)(value(i, s) & 0xff), (uint8_t)(value(i, s) >> 8)};
+            bus.Write(1 + i, settings[s].reg, settings[s].length, data);
+            packets++;
+        }
+    }
+    printf("%-28s      %d calls of 100 ms : %d ms\n", "AX12 class", packets, packets * 100);
+    printf("%-28s      %d WRITE, every register written, %6.1f ms\n", "AX12Bus, one call per setting", packets,
+           (clock_.now_us() - start) / 1000.0);
+
+    // Back to factory settings, then the provisioner
+    for (int i = 0; i < SERVOS; i++) {
+        chain.ServoAt(i).Reset(1 + i);
+    }
+    bus.SetReturnDelay(AX12_DEFAULT_RETURN_DELAY_US);
+    int r = provisioner.Apply(joints, SERVOS, report);
+    print("AX12Provisioner", r, report);
+    bus.SetReturnDelay(0);
+
+    profiles(joints);
+    r = provisioner.Apply(joints, SERVOS, report);
+    print("again, robot configured", r, report);
+
+    profiles(joints);
+    joints[SERVOS - 1].SetID(20);
+    joints[SERVOS - 2].SetID(1);
+    r = provisioner.Apply(joints, SERVOS, report);
+    print("new IDs (one already taken)", r, report);
+    printf("  servo %d is now %d (%d), servo %d : %d\n", SERVOS, joints[SERVOS - 1].Id(), joints[SERVOS - 1].result,
+           SERVOS - 1, joints[SERVOS - 2].result);
+    return 0;
+}
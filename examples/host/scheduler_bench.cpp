@@ -0,0 +1,148 @@
+/**
+ * @file scheduler_bench.cpp
+ * @author joebarteam11
+ * @brief Deadlines met, missed and dropped by AX12Scheduler, checked against the requests themselves
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ * Host program, build it from the root of the library :
+ *   g++ -O2 -Iinclude src/AX12Bus.cpp src/AX12Clock.cpp src/AX12Emulator.cpp src/AX12Scheduler.cpp \
+ *       examples/host/scheduler_bench.cpp -o scheduler_bench
+ *
+ * 6 emulated servos at 1 Mbps, a control tick every 5 ms for 2 s of virtual
+ * time. Each tick submits, the next tick being reserved for motion:
+ *   - motion : a goal to each servo, to be done within 1.5 ms
+ *   - config : one write within 0.4 ms, never dropped : it comes after the
+ *     motion and is late every tick
+ *   - telemetry : 8 bytes read from each servo within 2 ms, dropped when
+ *     they can no longer make it
+ * The completed, missed, dropped counts and the largest lateness of
+ * AX12Scheduler::Stats() are compared per class with what the requests say
+ * (result, finished, deadline). Then a queued request with a done callback is
+ * cancelled.
+ */
+#include <stdio.h>
+#include <string.h>
+
+#include "AX12Scheduler.h"
+#include "AX12Emulator.h"
+
+#define SERVOS 6
+#define TICK_US 5000
+#define TICKS 400
+
+static const char *names[AX12_PRIO_CLASSES] = {"motion", "config", "telemetry"};
+
+struct Count {
+    uint32_t completed;
+    uint32_t missed;
+    uint32_t dropped;
+    uint32_t max_late_us;
+};
+
+static int cancelled = 0;
+
+static void done(AX12Request *request, int result, void *context)
+{
+    (void)request;
+    (void)context;
+    cancelled += (result == AX12_ERR_ARG);
+}
+
+int main(void)
+{
+    AX12VirtualClock clock;
+    AX12EmulatedBus chain(clock, 1000000);
+    AX12Bus bus(chain, clock);
+    AX12Scheduler sched(bus);
+
+    bus.SetReturnDelay(0);
+    for (int i = 0; i < SERVOS; i++) {
+        chain.Attach(i + 1)->table[AX12_REG_RETURN_DELAY] = 0;
+    }
+
+    static AX12Request goals[SERVOS], reads[SERVOS], config;
+    static uint8_t goal[SERVOS][2], telemetry[SERVOS][8], slope[1] = {32};
+    Count count[AX12_PRIO_CLASSES];
+    int unfinished = 0;
+    memset(count, 0, sizeof(count));
+
+    // What the requests of a tick say once over
+    auto tally = [&](AX12Request &r) {
+        Count &c = count[r.priority];
+        if (r.result == AX12_BUSY) {
+            unfinished++;
+        } else if (r.result == AX12_ERR_DEADLINE) {
+            c.dropped++;
+        } else {
+            c.completed++;
+            if (!AX12Clock::reached(r.deadline, r.finished)) {
+                uint32_t late = r.finished - r.deadline;
+                c.missed++;
+                c.max_late_us = (late > c.max_late_us) ? late : c.max_late_us;
+            }
+        }
+    };
+
+    uint32_t tick = clock.now_us();
+    for (int n = 0; n < TICKS; n++) {
+        sched.Reserve(tick + TICK_US, AX12_PRIO_MOTION);
+        for (int i = 0; i < SERVOS; i++) {
+            uint16_t g = 312 + (n * 7 + i * 50) % 400;
+            goal[i][0] = g & 0xff;
+            goal[i][1] = g >> 8;
+            goals[i].Write(i + 1, AX12_REG_GOAL_POSITION, 2, goal[i], AX12_PRIO_MOTION);
+            goals[i].Before(tick, 1500);
+            reads[i].Read(i + 1, AX12_REG_POSITION, 8, telemetry[i], AX12_PRIO_TELEMETRY);
+            reads[i].Before(tick, 2000);
+            sched.Submit(reads[i]);
+        }
+        config.Write(1 + n % SERVOS, 0x1C, 1, slope, AX12_PRIO_CONFIG);
+        config.Before(tick, 400);
+        sched.Submit(config);
+        for (int i = 0; i < SERVOS; i++) {
+            sched.Submit(goals[i]);
+        }
+
+        tick += TICK_US;
+        while (!AX12Clock::reached(clock.now_us(), tick)) {
+            sched.Poll();
+            clock.wait_us(bus.WireTime(1));
+        }
+        for (int i = 0; i < SERVOS; i++) {
+            tally(goals[i]);
+            tally(reads[i]);
+        }
+        tally(config);
+    }
+
+    const AX12SchedulerStats &stats = sched.Stats();
+    int differ = 0;
+    printf("%d ticks of %d us, %d servos at 1 Mbps, %d requests left over at the next tick\n\n", TICKS, TICK_US,
+           SERVOS, unfinished);
+    printf("%-10s %21s %21s %21s %25s\n", "class", "completed", "missed", "dropped", "max late (us)");
+    printf("%-10s %10s %10s %10s %10s %10s %10s %12s %12s\n", "", "stats", "requests", "stats", "requests", "stats",
+           "requests", "stats", "requests");
+    for (int p = 0; p < AX12_PRIO_CLASSES; p++) {
+        const Count &c = count[p];
+        printf("%-10s %10lu %10lu %10lu %10lu %10lu %10lu %12lu %12lu\n", names[p],
+               (unsigned long)stats.completed[p], (unsigned long)c.completed, (unsigned long)stats.missed[p],
+               (unsigned long)c.missed, (unsigned long)stats.dropped[p], (unsigned long)c.dropped,
+               (unsigned long)stats.max_late_us[p], (unsigned long)c.max_late_us);
+        differ += (stats.completed[p] != c.completed) + (stats.missed[p] != c.missed)
+                  + (stats.dropped[p] != c.dropped) + (stats.max_late_us[p] != c.max_late_us);
+    }
+    printf("\n%d counters differ, largest estimate error %ld us\n", differ, (long)stats.max_estimate_error_us);
+
+    // Cancelled before it starts : the callback hears of it
+    AX12Request late;
+    uint8_t data[2];
+    late.Read(1, AX12_REG_POSITION, 2, data);
+    late.done = done;
+    sched.Submit(late);
+    int r = sched.Cancel(late);
+    printf("cancel : %d, result %d, done called %d time(s)\n", r, late.result, cancelled);
+    return 0;
+}
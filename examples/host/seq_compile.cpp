@@ -0,0 +1,84 @@
+/**
+ * @file seq_compile.cpp
+ * @author joebarteam11
+ * @brief Compile the text of a sequence for AX12Sequencer, to a binary file or a C array
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ * Host program, build it from the root of the library :
+ *   g++ -O2 -Iinclude src/AX12Bus.cpp src/AX12Clock.cpp src/AX12MultiBus.cpp src/AX12Sequence.cpp \
+ *       examples/host/seq_compile.cpp -o seq_compile
+ *
+ * Usage :
+ *   seq_compile wave.txt wave.bin         sent to the board as it is (serial link, SD card)
+ *   seq_compile -c wave wave.txt wave.h   static const uint8_t wave[] = {...}, built into the firmware
+ */
+#include <stdio.h>
+#include <string.h>
+
+#include "AX12Sequence.h"
+
+#define MAX_TEXT 65536
+#define MAX_SEQUENCE 16384
+
+static char text[MAX_TEXT + 1];
+static uint8_t sequence[MAX_SEQUENCE];
+
+int main(int argc, char **argv)
+{
+    const char *name = 0;
+    if (argc == 5 && !strcmp(argv[1], "-c")) {
+        name = argv[2];
+        argv += 2;
+        argc -= 2;
+    }
+    if (argc != 3) {
+        fprintf(stderr, "usage : %s [-c name] text output\n", argv[0]);
+        return 2;
+    }
+
+    FILE *in = fopen(argv[1], "rb");
+    if (!in) {
+        perror(argv[1]);
+        return 1;
+    }
+    size_t length = fread(text, 1, MAX_TEXT + 1, in);
+    fclose(in);
+    if (length > MAX_TEXT) {
+        fprintf(stderr, "%s : longer than %d bytes\n", argv[1], MAX_TEXT);
+        return 1;
+    }
+    text[length] = 0;
+
+    AX12SequenceError error;
+    int size = AX12_CompileSequence(text, sequence, sizeof(sequence), &error);
+    if (size == AX12_ERR_LENGTH) {
+        fprintf(stderr, "%s : sequence longer than %d bytes\n", argv[1], MAX_SEQUENCE);
+        return 1;
+    }
+    if (size < 0) {
+        fprintf(stderr, "%s:%d: %s\n", argv[1], error.line, error.message);
+        return 1;
+    }
+
+    FILE *out = fopen(argv[2], name ? "w" : "wb");
+    if (!out) {
+        perror(argv[2]);
+        return 1;
+    }
+    if (name) {
+        fprintf(out, "// Compiled from %s by seq_compile, %d bytes\n", argv[1], size);
+        fprintf(out, "static const uint8_t %s[] = {", name);
+        for (int i = 0; i < size; i++) {
+            fprintf(out, "%s0x%02X,", (i % 12) ? " " : "\n    ", sequence[i]);
+        }
+        fprintf(out, "\n};\n");
+    } else {
+        fwrite(sequence, 1, size, out);
+    }
+    fclose(out);
+    printf("%s : %d bytes of text, %d bytes of sequence\n", argv[1], (int)length, size);
+    return 0;
+}
@@ -0,0 +1,214 @@
+/**
+ * @file sequence_bench.cpp
+ * @author joebarteam11
+ * @brief Size of a compiled sequence, packets sent by AX12Sequencer, streamed and swapped sequences
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ * Host program, build it from the root of the library :
+ *   g++ -O2 -Iinclude src/AX12Bus.cpp src/AX12Clock.cpp src/AX12MultiBus.cpp \
+ *       src/AX12Emulator.cpp src/AX12Sequence.cpp examples/host/sequence_bench.cpp -o sequence_bench
+ *
+ * 6 emulated servos on 2 buses play a sequence at 100 Hz:
+ *   - whole : the sequence in RAM, compiled beforehand
+ *   - streamed : received from a 9600 bps link (10 bytes per tick of 10 ms),
+ *     the sequencer started on its first bytes
+ *   - swapped : another sequence played halfway, the first one queued after
+ * The goals sent each tick, the lag of the servos behind them and the
+ * positions at the end are compared. Allocations are counted while playing.
+ * Then a few wrong texts, with the line and the reason given by the compiler.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <new>
+
+#include "AX12Sequence.h"
+#include "AX12Emulator.h"
+
+#define JOINTS 6
+#define LINK_BYTES 10 // per tick
+
+static const char *wave = "# Wave of two arms of 3 joints, at 100 Hz\n"
+                          "period 10\n"
+                          "joints 1 2 3 4 5 6\n"
+                          "speed all=200\n"
+                          "torque all=900\n"
+                          "key 800 smooth all=512          # home\n"
+                          "settle 1s all\n"
+                          "repeat 3\n"
+                          "    key 500 smooth 1=300 2=600 4=300 5=600\n"
+                          "    key 500 smooth 1=700 2=400 4=700 5=400\n"
+                          "end\n"
+                          "key 0 step 3=100deg 6=200deg     # grippers at once, at the speed given above\n"
+                          "settle 2s 3 6\n"
+                          "key 1000 linear 1=512 2=512 4=512 5=512\n"
+                          "wait 200\n"
+                          "free 3 6\n";
+
+static const char *rest = "joints 1 2 4 5\n"
+                          "key 600 smooth 1=200 2=800 4=200 5=800\n"
+                          "wait 100\n";
+
+static long allocations = 0;
+
+void *operator new(size_t size)
+{
+    allocations++;
+    void *p = malloc(size ? size : 1);
+    if (!p) {
+        throw std::bad_alloc();
+    }
+    return p;
+}
+
+void operator delete(void *p) noexcept
+{
+    free(p);
+}
+
+void operator delete(void *p, size_t) noexcept
+{
+    free(p);
+}
+
+struct Arm {
+    AX12VirtualClock clock;
+    AX12EmulatedBus left, right;
+    AX12Bus bus0, bus1;
+    AX12MultiBus joints;
+
+    Arm()
+        : left(clock, 1000000), right(clock, 1000000), bus0(left, clock), bus1(right, clock), joints(clock)
+    {
+        joints.AddBus(bus0);
+        joints.AddBus(bus1);
+        for (int id = 1; id <= JOINTS; id++) {
+            AX12EmulatedServo *s = (id <= 3 ? left : right).Attach(id);
+            s->SetWord(AX12_REG_POSITION, 200 + 100 * id);
+            s->SetWord(AX12_REG_GOAL_POSITION, 200 + 100 * id);
+            joints.Place(id, id <= 3 ? 0 : 1);
+        }
+    }
+
+    AX12EmulatedServo &servo(int id)
+    {
+        left.Update();
+        right.Update();
+        return *(id <= 3 ? left : right).Servo(id);
+    }
+};
+
+struct Result {
+    int ticks;
+    uint32_t writes;
+    uint32_t starved;
+    uint32_t late;
+    int jump;  // largest goal change between two ticks, ticks
+    int lag;   // largest distance from the position to the goal during linear and smooth keyframes
+    long allocations;
+    uint16_t end[JOINTS];
+};
+
+// \p link : bytes received per tick, 0 for the whole sequence; \p swap : tick at which \p other is played
+static Result play(const uint8_t *sequence, int size, int link, const uint8_t *other, int other_size, int swap)
+{
+    Arm arm;
+    AX12Sequencer sequencer(arm.joints);
+    Result r;
+    uint16_t previous[JOINTS];
+    memset(&r, 0, sizeof(r));
+
+    for (int j = 0; j < JOINTS; j++) {
+        previous[j] = arm.servo(j + 1).Word(AX12_REG_GOAL_POSITION);
+    }
+    int received = link ? AX12_SEQ_HEADER + JOINTS : size;
+    long before = allocations;
+    sequencer.Play(sequence, received);
+    while (true) {
+        arm.clock.wait_us(sequencer.Due());
+        if (link && received < size) {
+            received = (received + link > size) ? size : received + link;
+            sequencer.Extend(received);
+        }
+        if (swap && r.ticks == swap) {
+            sequencer.Play(other, other_size);
+            sequencer.Queue(sequence, size);
+        }
+        if (sequencer.Step() < 0) {
+            break;
+        }
+        r.ticks++;
+        for (int j = 0; j < JOINTS; j++) {
+            AX12EmulatedServo &s = arm.servo(j + 1);
+            int goal = s.Word(AX12_REG_GOAL_POSITION);
+            int jump = abs(goal - previous[j]);
+            int lag = abs(goal - s.Word(AX12_REG_POSITION));
+            r.jump = (jump > r.jump && j % 3 != 2) ? jump : r.jump; // the grippers step on purpose
+            r.lag = (lag > r.lag && j % 3 != 2) ? lag : r.lag;
+            previous[j] = goal;
+        }
+    }
+    r.allocations = allocations - before;
+    r.writes = sequencer.Stats().writes;
+    r.starved = sequencer.Stats().starved;
+    r.late = sequencer.Stats().late;
+    for (int j = 0; j < JOINTS; j++) {
+        r.end[j] = arm.servo(j + 1).Word(AX12_REG_POSITION);
+    }
+    return r;
+}
+
+static void print(const char *name, const Result &r, const Result &reference)
+{
+    int off = 0;
+    for (int j = 0; j < JOINTS; j++) {
+        int d = abs(r.end[j] - reference.end[j]);
+        off = (d > off) ? d : off;
+    }
+    printf("%-10s %6d %8u %10.2f %8u %6u %6d tk %6d tk %10d tk %12ld\n", name, r.ticks, r.writes,
+           (double)r.writes / r.ticks, r.starved, r.late, r.jump, r.lag, off, r.allocations);
+}
+
+int main(void)
+{
+    static uint8_t sequence[512], other[128];
+    AX12SequenceError error;
+
+    int size = AX12_CompileSequence(wave, sequence, sizeof(sequence), &error);
+    int other_size = AX12_CompileSequence(rest, other, sizeof(other), &error);
+    if (size < 0 || other_size < 0) {
+        printf("line %d : %s\n", error.line, error.message);
+        return 1;
+    }
+    printf("%d joints on 2 buses, text %d bytes, compiled %d bytes\n\n", JOINTS, (int)strlen(wave), size);
+
+    printf("%-10s %6s %8s %10s %8s %6s %9s %9s %13s %12s\n", "", "ticks", "writes", "per tick", "starved", "late",
+           "jump", "lag", "end off", "allocations");
+    Result whole = play(sequence, size, 0, 0, 0, 0);
+    print("whole", whole, whole);
+    print("streamed", play(sequence, size, LINK_BYTES, 0, 0, 0), whole);
+    print("swapped", play(sequence, size, 0, other, other_size, 250), whole);
+
+    printf("\nend positions :");
+    for (int j = 0; j < JOINTS; j++) {
+        printf(" %d", whole.end[j]);
+    }
+
+    static const char *wrong[] = {
+        "joints 1 2\nkey 100 1=512\nkey 100 smooth 3=512\n",
+        "joints 1 2\nrepeat 0\n  speed all=100\nend\n",
+        "joints 1 2\nrepeat 2\n  key 100 1=400deg\nend\n",
+        "joints 1 1\n",
+        "key 100 1=512\n",
+        "joints 1 2\nrepeat 2\n  wait 10\n",
+    };
+    printf("\n\nwrong texts :\n");
+    for (unsigned k = 0; k < sizeof(wrong) / sizeof(wrong[0]); k++) {
+        int r = AX12_CompileSequence(wrong[k], sequence, sizeof(sequence), &error);
+        printf("  %d, line %d : %s\n", r, error.line, error.message);
+    }
+    return 0;
+}
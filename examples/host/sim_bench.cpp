@@ -0,0 +1,256 @@
+/**
+ * @file sim_bench.cpp
+ * @author joebarteam11
+ * @brief Compliance slope of an arm tuned over a batch of simulations, faster than real time
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ * Host program, build it from the root of the library :
+ *   g++ -O2 -pthread -Iinclude src/AX12Bus.cpp src/AX12Clock.cpp src/AX12MultiBus.cpp src/AX12Emulator.cpp \
+ *       src/AX12Simulation.cpp src/AX12Sequence.cpp examples/host/sim_bench.cpp -o sim_bench
+ *
+ * First the model alone: speed in wheel mode, a blocked horn, a weight held
+ * too long. Then 6 simulated AX-12A on 2 buses, each carrying a weight drawn
+ * from the seed of the run (its torque following the angle of the joint),
+ * play a sequence forever at 100 Hz through AX12Sequencer for 2 minutes of
+ * virtual time. 8 seeds for each of 5 compliance slopes: 40 runs on every
+ * core. The tracking error (set point of the sequence against the angle of
+ * the horn), the temperatures and the alarms are compared per slope. The
+ * runs of one seed are then played again on another number of threads, and
+ * must end in the same state to the bit.
+ */
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include <chrono>
+
+#include "AX12Simulation.h"
+#include "AX12Sequence.h"
+
+#define JOINTS 6
+#define SECONDS 120
+#define SEEDS 8
+
+static const int slopes[] = {8, 16, 32, 64, 128};
+#define SLOPES ((int)(sizeof(slopes) / sizeof(slopes[0])))
+
+static const char *motion = "period 10\n"
+                            "joints 1 2 3 4 5 6\n"
+                            "speed all=300\n"
+                            "key 1000 smooth all=512\n"
+                            "repeat 0\n"
+                            "    key 700 smooth 1=300 2=650 3=400 4=700 5=380 6=600\n"
+                            "    key 700 smooth 1=700 2=380 3=620 4=320 5=640 6=420\n"
+                            "    wait 300\n"
+                            "end\n";
+
+static uint8_t sequence[256];
+static int sequence_size;
+
+struct Run {
+    double rms;        // tracking error, ticks
+    double worst;      // ticks
+    float hottest;     // degrees C
+    uint8_t alarms;    // every alarm seen
+    uint32_t state;    // hash of the end state
+};
+
+static Run results[SLOPES * SEEDS];
+
+struct Arm {
+    AX12VirtualClock clock;
+    AX12EmulatedBus left, right;
+    AX12Bus bus0, bus1;
+    AX12MultiBus joints;
+    AX12ServoDynamics dynamics[JOINTS];
+    AX12EmulatedServo *servos[JOINTS];
+
+    Arm(uint32_t seed)
+        : left(clock, 1000000), right(clock, 1000000), bus0(left, clock), bus1(right, clock), joints(clock)
+    {
+        joints.AddBus(bus0);
+        joints.AddBus(bus1);
+        for (int j = 0; j < JOINTS; j++) {
+            servos[j] = (j < JOINTS / 2 ? left : right).Attach(j + 1);
+            servos[j]->table[AX12_REG_RETURN_DELAY] = 0;
+            joints.Place(j + 1, j < JOINTS / 2 ? 0 : 1);
+            dynamics[j] = AX12ServoDynamics(AX12_MOTOR_AX12A, seed * 64 + j + 1, 0.05f);
+            dynamics[j].noise = 1;
+            dynamics[j].Attach(*servos[j]);
+        }
+        bus0.SetReturnDelay(0);
+        bus1.SetReturnDelay(0);
+    }
+
+    void update(void)
+    {
+        left.Update();
+        right.Update();
+    }
+};
+
+static uint32_t hash(uint32_t h, const void *data, int size)
+{
+    const uint8_t *p = (const uint8_t *)data;
+    for (int i = 0; i < size; i++) {
+        h = (h ^ p[i]) * 16777619u; // FNV-1a
+    }
+    return h;
+}
+
+static void simulate(int index, void *context)
+{
+    (void)context;
+    int slope = slopes[index / SEEDS];
+    uint32_t seed = index % SEEDS + 1;
+    Arm arm(seed);
+    AX12Sequencer sequencer(arm.joints);
+    float weight[JOINTS];
+    Run r;
+    memset(&r, 0, sizeof(r));
+
+    // Weight on each horn, 0.1 to 0.9 N.m at the horizontal, the same for every slope of a seed
+    uint32_t x = seed * 2654435761u;
+    for (int j = 0; j < JOINTS; j++) {
+        x ^= x << 13;
+        x ^= x >> 17;
+        x ^= x << 5;
+        weight[j] = 0.1f + (x % 801) / 1000.0f;
+        arm.servos[j]->table[0x1C] = slope; // CW and CCW compliance slopes
+        arm.servos[j]->table[0x1D] = slope;
+    }
+
+    double squares = 0;
+    long samples = 0;
+    sequencer.Play(sequence, sequence_size);
+    while (arm.clock.Elapsed() < SECONDS * 1000000ULL) {
+        arm.clock.wait_us(sequencer.Due());
+        sequencer.Step();
+        arm.update();
+        for (int j = 0; j < JOINTS; j++) {
+            AX12ServoDynamics &d = arm.dynamics[j];
+            double error = sequencer.Goal(j) - d.Position();
+            squares += error * error;
+            r.worst = (fabs(error) > r.worst) ? fabs(error) : r.worst;
+            r.hottest = (d.Temperature() > r.hottest) ? d.Temperature() : r.hottest;
+            r.alarms |= arm.servos[j]->alarms;
+            d.external = -weight[j] * cosf((d.Position() - 512) * AX12_SIM_TICK_RAD); // horizontal at 512
+        }
+        samples += JOINTS;
+    }
+    r.rms = sqrt(squares / samples);
+
+    r.state = 2166136261u;
+    for (int j = 0; j < JOINTS; j++) {
+        float state[3] = {arm.dynamics[j].Position(), arm.dynamics[j].Velocity(), arm.dynamics[j].Temperature()};
+        r.state = hash(r.state, state, sizeof(state));
+        r.state = hash(r.state, arm.servos[j]->table, AX12_TABLE_SIZE);
+    }
+    results[index] = r;
+}
+
+static void first_seed(int index, void *context)
+{
+    simulate(index * SEEDS, context);
+}
+
+// The model alone, one servo
+static void model(void)
+{
+    AX12VirtualClock clock;
+    AX12EmulatedBus chain(clock);
+    AX12ServoDynamics dynamics;
+    AX12EmulatedServo *s = chain.Attach(1);
+    dynamics.Attach(*s);
+
+    // Wheel mode, full output, no load
+    s->SetWord(AX12_REG_CW_LIMIT, 0);
+    s->SetWord(AX12_REG_CCW_LIMIT, 0);
+    s->SetWord(AX12_REG_MOVING_SPEED, 1023);
+    s->table[AX12_REG_ENABLE_TORQUE] = 1;
+    clock.wait_us(1000000);
+    chain.Update();
+    printf("wheel mode, full output       : %.1f rpm, %.2f A (datasheet 59 rpm)\n",
+           dynamics.Velocity() * AX12_SIM_TICK_RAD * 60 / (2 * M_PI), dynamics.Current());
+
+    // Blocked horn : overload, the torque limit drops to 0
+    s->SetWord(AX12_REG_MOVING_SPEED, 0);
+    s->SetWord(AX12_REG_CCW_LIMIT, 1023);
+    s->SetWord(AX12_REG_GOAL_POSITION, 512);
+    clock.wait_us(2000000);
+    chain.Update();
+    s->resistance = 1;
+    s->SetWord(AX12_REG_GOAL_POSITION, 800);
+    uint64_t start = clock.Elapsed();
+    while (!(s->alarms & AX12_ERROR_OVERLOAD) && clock.Elapsed() - start < 5000000) {
+        clock.wait_us(1000);
+        chain.Update();
+    }
+    printf("blocked horn                  : overload after %.0f ms, torque limit set to %d\n",
+           (clock.Elapsed() - start) / 1000.0, s->Word(AX12_REG_TORQUE_LIMIT));
+
+    // A weight of 1.3 N.m held at the horizontal, the overload alarm left out
+    s->resistance = 0;
+    s->table[AX12_REG_ALARM_SHUTDOWN] = AX12_ERROR_OVERHEAT;
+    s->SetWord(AX12_REG_TORQUE_LIMIT, 1023);
+    s->SetWord(AX12_REG_GOAL_POSITION, 512);
+    dynamics.external = -1.3f;
+    start = clock.Elapsed();
+    int sag = 0;
+    while (s->Word(AX12_REG_TORQUE_LIMIT) != 0 && clock.Elapsed() - start < 3600000000ULL) {
+        sag = 512 - s->Word(AX12_REG_POSITION);
+        clock.wait_us(10000);
+        chain.Update();
+    }
+    printf("1.3 N.m held                  : %d ticks below the goal, overheating after %.0f s, torque limit set to %d\n",
+           sag, (clock.Elapsed() - start) / 1e6, s->Word(AX12_REG_TORQUE_LIMIT));
+}
+
+int main(void)
+{
+    AX12SequenceError error;
+    sequence_size = AX12_CompileSequence(motion, sequence, sizeof(sequence), &error);
+    if (sequence_size < 0) {
+        printf("line %d : %s\n", error.line, error.message);
+        return 1;
+    }
+
+    model();
+
+    int runs = SLOPES * SEEDS;
+    auto start = std::chrono::steady_clock::now();
+    int threads = AX12_RunSimulations(runs, simulate, 0);
+    double wall = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    printf("\n%d runs of %d s of %d joints on %d threads : %.0f s simulated in %.1f s, %.0f times real time\n\n",
+           runs, SECONDS, JOINTS, threads, (double)runs * SECONDS, wall, runs * SECONDS / wall);
+    printf("%6s %12s %12s %14s %10s %10s\n", "slope", "error, rms", "worst", "hottest, C", "overload", "overheat");
+    for (int k = 0; k < SLOPES; k++) {
+        double rms = 0, worst = 0;
+        float hottest = 0;
+        int overload = 0, overheat = 0;
+        for (int i = k * SEEDS; i < (k + 1) * SEEDS; i++) {
+            rms += results[i].rms / SEEDS;
+            worst = (results[i].worst > worst) ? results[i].worst : worst;
+            hottest = (results[i].hottest > hottest) ? results[i].hottest : hottest;
+            overload += (results[i].alarms & AX12_ERROR_OVERLOAD) != 0;
+            overheat += (results[i].alarms & AX12_ERROR_OVERHEAT) != 0;
+        }
+        printf("%6d %9.1f tk %9.1f tk %14.1f %10d %10d\n", slopes[k], rms, worst, hottest, overload, overheat);
+    }
+
+    // Seed 1 of each slope again, on another number of threads
+    int differ = 0;
+    Run batch[SLOPES];
+    for (int k = 0; k < SLOPES; k++) {
+        batch[k] = results[k * SEEDS];
+    }
+    int again = AX12_RunSimulations(SLOPES, first_seed, 0, (threads == 1) ? 4 : 1);
+    for (int k = 0; k < SLOPES; k++) {
+        differ += (results[k * SEEDS].state != batch[k].state);
+    }
+    printf("\nseed 1 of each slope played again on %d threads : %d of %d end states differ\n", again, differ, SLOPES);
+    return 0;
+}
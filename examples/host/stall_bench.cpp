@@ -0,0 +1,233 @@
+/**
+ * @file stall_bench.cpp
+ * @author joebarteam11
+ * @brief Detection latency and false events of AX12StallDetector
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ * Host program, build it from the root of the library :
+ *   g++ -O2 -Iinclude src/AX12Bus.cpp src/AX12Clock.cpp src/AX12MultiBus.cpp \
+ *       src/AX12Emulator.cpp src/AX12Stall.cpp examples/host/stall_bench.cpp -o stall_bench
+ *
+ * 12 servos on 2 emulated buses, all of them turning, one Tick() every 5 ms.
+ * Their load reads are noisy (+/- 80) and 2 % of them are wild values. The
+ * servo 1 meets an obstacle at a different time in each run:
+ *  - hard object : the resistance steps to the torque limit, it stops at once;
+ *  - soft object : the resistance grows to the torque limit in 100 ms;
+ *  - partial obstacle : the resistance steps to 0.5, it goes on more slowly;
+ *  - the same three in position mode.
+ * The latency is counted from the moment the servo is actually slowed down
+ * below 40 % of its speed (or from the contact when it is not). "other" is
+ * the runs that saw the other event, "others" the events of the servos that
+ * met no obstacle. Then every servo turns freely, with new speeds every 2 s,
+ * for 10 min to count the events without any obstacle.
+ */
+#include <stdio.h>
+
+#include "AX12Stall.h"
+#include "AX12Emulator.h"
+
+#define JOINTS 12
+#define BUSES 2
+#define TICK_US 5000
+#define RUNS 50
+#define FREE_US 600000000ULL
+
+static AX12VirtualClock clock_;
+static AX12EmulatedBus chains[BUSES] = {AX12EmulatedBus(clock_, 1000000), AX12EmulatedBus(clock_, 1000000)};
+
+static AX12EmulatedServo *servo(int joint)
+{
+    return chains[joint % BUSES].Servo(1 + joint);
+}
+
+struct Scenario {
+    const char *name;
+    bool wheel;
+    float resistance; // final resistance
+    uint32_t ramp;    // us to reach it
+    int expected;     // event
+};
+
+static const Scenario scenarios[] = {
+    {"hard object, wheel", true, 1.0f, 0, AX12_STALL_COLLISION},
+    {"soft object, wheel", true, 1.0f, 100000, AX12_STALL_STALLED},
+    {"partial obstacle, wheel", true, 0.5f, 0, AX12_STALL_COLLISION},
+    {"hard object, position", false, 1.0f, 0, AX12_STALL_COLLISION},
+    {"soft object, position", false, 1.0f, 100000, AX12_STALL_STALLED},
+    {"partial obstacle, position", false, 0.5f, 0, AX12_STALL_COLLISION},
+};
+
+static float resistance(const Scenario &s, uint32_t since)
+{
+    if (s.ramp == 0 || since >= s.ramp) {
+        return s.resistance;
+    }
+    return s.resistance * since / s.ramp;
+}
+
+// Every servo free, in wheel mode or in position mode from the middle
+static void reset(bool wheel)
+{
+    for (int i = 0; i < JOINTS; i++) {
+        AX12EmulatedServo *s = servo(i);
+        s->resistance = 0;
+        s->load = 0;
+        s->table[AX12_REG_ENABLE_TORQUE] = 0;
+        s->SetWord(AX12_REG_MOVING_SPEED, 0);
+        s->SetWord(AX12_REG_CW_LIMIT, 0);
+        s->SetWord(AX12_REG_CCW_LIMIT, wheel ? 0 : 1023);
+        s->SetWord(AX12_REG_POSITION, 100);
+        s->SetWord(AX12_REG_GOAL_POSITION, 100);
+    }
+}
+
+// Speeds of the servos, some of them CW
+static void start(AX12StallDetector &contact, bool wheel, int seed)
+{
+    for (int i = 0; i < JOINTS; i++) {
+        float speed = 0.3f + 0.05f * ((i + seed) % 8);
+        if (wheel) {
+            contact.SetSpeed(i, (i % 3 == 2) ? -speed : speed);
+        } else {
+            contact.Move(i, 1000, (int)(speed * 1023));
+        }
+    }
+}
+
+static const char *reaction(int joint)
+{
+    AX12EmulatedServo *s = servo(joint);
+    bool wheel = s->Word(AX12_REG_CCW_LIMIT) == 0;
+    int speed = s->Word(AX12_REG_MOVING_SPEED);
+
+    if (!s->table[AX12_REG_ENABLE_TORQUE]) {
+        return "torque off";
+    }
+    if (wheel) {
+        return (speed & 0x3FF) == 0 ? "speed 0" : (speed & AX12_SPEED_CW) ? "turning CW" : "turning CCW";
+    }
+    int position = s->Word(AX12_REG_POSITION);
+    int goal = s->Word(AX12_REG_GOAL_POSITION);
+    return (goal == position) ? "holding its position" : (goal < position) ? "moving back" : "moving on";
+}
+
+int main(void)
+{
+    AX12Bus buses[BUSES] = {AX12Bus(chains[0], clock_), AX12Bus(chains[1], clock_)};
+    AX12MultiBus joints(clock_);
+
+    for (int b = 0; b < BUSES; b++) {
+        joints.AddBus(buses[b]);
+        buses[b].SetReturnDelay(0);
+    }
+    for (int i = 0; i < JOINTS; i++) {
+        AX12EmulatedServo *s = chains[i % BUSES].Attach(1 + i);
+        s->table[AX12_REG_RETURN_DELAY] = 0;
+        s->load_noise = 80;
+        s->load_spikes = 20000;
+        joints.Place(1 + i, i % BUSES);
+    }
+
+    printf("%-28s %5s %8s %6s %14s %14s %7s\n", "scenario", "runs", "detected", "other", "latency ms", "ticks",
+           "others");
+    for (unsigned k = 0; k < sizeof(scenarios) / sizeof(scenarios[0]); k++) {
+        const Scenario &sc = scenarios[k];
+        int detected = 0, wrong = 0, others = 0;
+        double sum = 0, worst = 0, ticks = 0, worst_ticks = 0;
+        int actions[2] = {AX12_STALL_CUT_TORQUE, sc.wheel ? AX12_STALL_REVERSE : AX12_STALL_HOLD};
+
+        for (int r = 0; r < RUNS; r++) {
+            AX12StallDetector contact(joints);
+            for (int i = 0; i < JOINTS; i++) {
+                contact.Add(1 + i);
+            }
+            contact.SetAction(actions[r % 2]);
+            reset(sc.wheel);
+            start(contact, sc.wheel, r);
+
+            // Contact after 100 to 250 ms, slowed down below 40 % when free motion is at 0.6 of the limit
+            uint32_t t0 = clock_.now_us();
+            uint32_t at = 100000 + 3000 * r;
+            uint32_t onset = at + ((sc.resistance >= 0.6f) ? (uint32_t)(sc.ramp * 0.6f / sc.resistance) : 0);
+            uint32_t next = 0;
+            uint32_t seen_tick = 0, onset_tick = 0;
+            for (uint32_t t = 0; t < at + 400000 && contact.Event(0) == AX12_STALL_NONE; t = clock_.now_us() - t0) {
+                servo(0)->resistance = (t >= at) ? resistance(sc, t - at) : 0;
+                onset_tick = (t < onset) ? contact.Ticks() + 1 : onset_tick;
+                if (t >= next) {
+                    contact.Tick();
+                    next += TICK_US;
+                }
+                clock_.wait_us(500);
+            }
+            seen_tick = contact.Ticks();
+            for (int i = 1; i < JOINTS; i++) {
+                others += contact.Event(i) != AX12_STALL_NONE;
+            }
+            if (contact.Event(0) != sc.expected) {
+                wrong += contact.Event(0) != AX12_STALL_NONE;
+                continue;
+            }
+            detected++;
+            double latency = ((int32_t)(contact.EventTime(0) - t0 - onset)) / 1000.0;
+            sum += latency;
+            worst = (latency > worst) ? latency : worst;
+            ticks += seen_tick - onset_tick + 1;
+            worst_ticks = (seen_tick - onset_tick + 1 > worst_ticks) ? seen_tick - onset_tick + 1 : worst_ticks;
+
+            // Let the reaction act, then show it once per action
+            clock_.wait_us(20000);
+            if (r < 2) {
+                printf("    %-24s -> %s\n", actions[r % 2] == AX12_STALL_CUT_TORQUE ? "cut torque" :
+                       actions[r % 2] == AX12_STALL_REVERSE ? "reverse" : "hold", reaction(0));
+            }
+        }
+        printf("%-28s %5d %8d %6d %6.1f (%5.1f) %6.1f (%5.0f) %7d\n", sc.name, RUNS, detected, wrong,
+               detected ? sum / detected : 0, worst, detected ? ticks / detected : 0, worst_ticks, others);
+    }
+
+    // No obstacle at all
+    for (int w = 0; w < 2; w++) {
+        AX12StallDetector contact(joints);
+        for (int i = 0; i < JOINTS; i++) {
+            contact.Add(1 + i);
+        }
+        reset(w == 0);
+        uint32_t t0 = clock_.now_us();
+        uint64_t elapsed = 0;
+        uint32_t last = t0;
+        uint32_t events = 0;
+        for (int n = 0; elapsed < FREE_US; n++) {
+            // New speeds every 2 s, back and forth in position mode
+            if (n % 400 == 0) {
+                for (int i = 0; i < JOINTS; i++) {
+                    float speed = 0.3f + 0.05f * ((i + n / 400) % 8);
+                    if (w == 0) {
+                        contact.SetSpeed(i, ((i + n / 400) % 3 == 2) ? -speed : speed);
+                    } else {
+                        contact.Move(i, ((n / 400) % 2) ? 100 : 1000, (int)(speed * 1023));
+                    }
+                }
+            }
+            contact.Tick();
+            for (int i = 0; i < JOINTS; i++) {
+                if (contact.Event(i) != AX12_STALL_NONE) {
+                    events++;
+                    contact.Clear(i);
+                }
+            }
+            clock_.wait_us(TICK_US - (clock_.now_us() - last) % TICK_US);
+            uint32_t now = clock_.now_us();
+            elapsed += now - last;
+            last = now;
+        }
+        double hours = (double)elapsed * JOINTS / 3600e6;
+        printf("free motion, %-8s %lu ticks, %.1f servo-hours, %lu false events (%.1f per servo-hour)\n",
+               w == 0 ? "wheel" : "position", (unsigned long)contact.Ticks(), hours, (unsigned long)events,
+               events / hours);
+    }
+    return 0;
+}
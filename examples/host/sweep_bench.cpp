@@ -0,0 +1,112 @@
+/**
+ * @file sweep_bench.cpp
+ * @author joebarteam11
+ * @brief Servos read per second by AX12ReadSweep at each bit rate
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ * Host program, build it from the root of the library :
+ *   g++ -O2 -Iinclude src/AX12Bus.cpp src/AX12Clock.cpp src/AX12Sweep.cpp \
+ *       src/AX12Emulator.cpp examples/host/sweep_bench.cpp -o sweep_bench
+ *
+ * The positions of 18 servos on one emulated chain, read over and over for
+ * 1 s at each bit rate of the AX-12 from 57142 to 1000000 bps:
+ *   - wire limit : the READ_DATA and the status packet alone, back to back
+ *   - sweep : return delay 0, then the factory one (500 us)
+ *   - 1 missing : servo 18 unplugged, with the silence detection off (a USB
+ *     adapter whose latency hides the quiet line): an AX12Bus::Read() loop
+ *     waits for the timeout of the bus, the sweep for its margin. The servo
+ *     is released before each sweep, as a quarantined one would cost nothing.
+ * The values are checked against the control tables.
+ */
+#include <stdio.h>
+
+#include "AX12Sweep.h"
+#include "AX12Emulator.h"
+
+#define SERVOS 18
+#define SECONDS 1
+
+// Codes of AX12_REG_BAUD : 57142, 117647, 200000, 250000, 400000, 500000 and 1000000 bps
+static const int codes[] = {34, 16, 9, 7, 4, 3, 1};
+
+struct Run {
+    double per_second; // servos read per second
+    int wrong;         // values differing from the control tables
+};
+
+// \p loop : AX12Bus::Read() one by one instead of the sweep
+static Run run(int code, int return_delay_us, bool missing, bool loop)
+{
+    AX12VirtualClock clock;
+    AX12EmulatedBus chain(clock, AX12_BaudFromCode(code));
+    AX12Bus bus(chain, clock);
+    AX12ReadSweep sweep(bus);
+    uint8_t ids[SERVOS];
+    uint8_t data[SERVOS * 2];
+    int results[SERVOS];
+    Run r = {0, 0};
+
+    bus.SetReturnDelay(return_delay_us);
+    for (int i = 0; i < SERVOS; i++) {
+        ids[i] = i + 1;
+        if (missing && i == SERVOS - 1) {
+            continue;
+        }
+        AX12EmulatedServo *s = chain.Attach(ids[i]);
+        s->table[AX12_REG_BAUD] = code;
+        s->table[AX12_REG_RETURN_DELAY] = return_delay_us / 2;
+        s->SetWord(AX12_REG_POSITION, 100 + 37 * i);
+    }
+    if (missing) {
+        bus.SetSilence(0);
+    }
+
+    uint32_t reads = 0;
+    uint64_t end = clock.Elapsed() + SECONDS * 1000000ULL;
+    while (clock.Elapsed() < end) {
+        bus.Release(SERVOS);
+        if (loop) {
+            for (int i = 0; i < SERVOS; i++) {
+                results[i] = bus.Read(ids[i], AX12_REG_POSITION, 2, &data[2 * i]);
+            }
+        } else {
+            sweep.Read(ids, SERVOS, AX12_REG_POSITION, 2, data, results);
+        }
+        for (int i = 0; i < SERVOS; i++) {
+            if (results[i] < 0) {
+                continue;
+            }
+            reads++;
+            r.wrong += ((data[2 * i] | data[2 * i + 1] << 8) != chain.Servo(ids[i])->Word(AX12_REG_POSITION));
+        }
+    }
+    r.per_second = reads * 1000000.0 / clock.Elapsed();
+    return r;
+}
+
+int main(void)
+{
+    printf("%d servos, position (2 bytes), servos read per second\n\n", SERVOS);
+    printf("%8s %10s %10s %14s %16s %16s %8s\n", "bps", "wire limit", "sweep", "sweep, 500 us", "1 missing, Read",
+           "1 missing, sweep", "wrong");
+
+    for (unsigned c = 0; c < sizeof(codes) / sizeof(codes[0]); c++) {
+        AX12VirtualClock clock;
+        AX12EmulatedBus chain(clock, AX12_BaudFromCode(codes[c]));
+        AX12Bus bus(chain, clock);
+        bus.SetReturnDelay(0);
+        double limit = 1000000.0 / bus.Estimate(1, AX12_INST_READ, 2, 2);
+
+        Run fast = run(codes[c], 0, false, false);
+        Run factory = run(codes[c], AX12_DEFAULT_RETURN_DELAY_US, false, false);
+        Run loop = run(codes[c], 0, true, true);
+        Run missing = run(codes[c], 0, true, false);
+        printf("%8d %10.0f %10.0f %14.0f %16.0f %16.0f %8d\n", AX12_BaudFromCode(codes[c]), limit,
+               fast.per_second, factory.per_second, loop.per_second, missing.per_second,
+               fast.wrong + factory.wrong + loop.wrong + missing.wrong);
+    }
+    return 0;
+}
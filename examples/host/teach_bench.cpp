@@ -0,0 +1,189 @@
+/**
+ * @file teach_bench.cpp
+ * @author joebarteam11
+ * @brief Size of AX12Recorder recordings of hand posed motions, and their replay
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ * Host program, build it from the root of the library :
+ *   g++ -O2 -Iinclude src/AX12Bus.cpp src/AX12Clock.cpp src/AX12MultiBus.cpp \
+ *       src/AX12Emulator.cpp src/AX12Teach.cpp examples/host/teach_bench.cpp -o teach_bench
+ *
+ * 18 emulated servos on 2 buses are posed by hand for 3 minutes: a few
+ * joints at a time move smoothly to a new angle in 0.5 to 3 s, with pauses
+ * in between, and the potentiometers read 1 tick off now and then. The
+ * motion is recorded at 50 and 100 Hz, played back on the servos, then
+ * decoded alone to time it.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <chrono>
+
+#include "AX12Teach.h"
+#include "AX12Emulator.h"
+
+#define JOINTS 18
+#define SECONDS 180
+#define BUFFER 16384
+#define MAX_FRAMES (SECONDS * 100 + 2)
+
+// Hand posed motion : truth of each joint at time t
+struct Hand {
+    double from[JOINTS], to[JOINTS], start[JOINTS], length[JOINTS];
+    double next; // time of the next gesture
+
+    void init(void)
+    {
+        for (int j = 0; j < JOINTS; j++) {
+            from[j] = to[j] = 300 + rand() % 400;
+            start[j] = 0;
+            length[j] = 1;
+        }
+        next = 1;
+    }
+
+    // A gesture : 1 to 4 joints to new angles, then a pause
+    void update(double t)
+    {
+        if (t < next) {
+            return;
+        }
+        int moved = 1 + rand() % 4;
+        double longest = 0;
+        for (int m = 0; m < moved; m++) {
+            int j = rand() % JOINTS;
+            from[j] = at(j, t);
+            to[j] = 100 + rand() % 824;
+            start[j] = t;
+            length[j] = 0.5 + (rand() % 250) / 100.0;
+            longest = (length[j] > longest) ? length[j] : longest;
+        }
+        next = t + longest + 0.5 + (rand() % 150) / 100.0;
+    }
+
+    // Smooth : minimum jerk from one angle to the other
+    double at(int j, double t)
+    {
+        double s = (t - start[j]) / length[j];
+        s = (s < 0) ? 0 : (s > 1) ? 1 : s;
+        return from[j] + (to[j] - from[j]) * s * s * s * (10 - 15 * s + 6 * s * s);
+    }
+};
+
+static uint16_t recorded[MAX_FRAMES][JOINTS];
+
+int main(void)
+{
+    AX12VirtualClock clock;
+    AX12EmulatedBus left(clock, 1000000), right(clock, 1000000);
+    AX12Bus bus0(left, clock), bus1(right, clock);
+    AX12MultiBus joints(clock);
+    AX12Recorder recorder(joints);
+    uint8_t ids[JOINTS];
+    static uint8_t motion[BUFFER];
+
+    joints.AddBus(bus0);
+    joints.AddBus(bus1);
+    bus0.SetReturnDelay(0);
+    bus1.SetReturnDelay(0);
+    for (int j = 0; j < JOINTS; j++) {
+        ids[j] = 1 + j;
+        (j < JOINTS / 2 ? left : right).Attach(ids[j])->table[AX12_REG_RETURN_DELAY] = 0;
+        joints.Place(ids[j], j < JOINTS / 2 ? 0 : 1);
+    }
+
+    printf("%d joints posed by hand for %d s, %d bytes of buffer, dead band %d tick\n\n", JOINTS, SECONDS, BUFFER,
+           AX12_TEACH_DEADBAND);
+    printf("%-8s %8s %8s %8s %10s %12s %12s %10s %10s\n", "rate", "frames", "seconds", "bytes", "bytes/min",
+           "raw (2 B)", "worst error", "replayed", "goals off");
+    for (int hz = 50; hz <= 100; hz += 50) {
+        srand(7);
+        Hand hand;
+        hand.init();
+        for (int j = 0; j < JOINTS; j++) {
+            AX12EmulatedServo *s = joints.BusOf(ids[j]) ? right.Servo(ids[j]) : left.Servo(ids[j]);
+            s->SetWord(AX12_REG_POSITION, (uint16_t)lround(hand.at(j, 0)));
+        }
+
+        // Teach : the servos are moved from outside between the samples
+        uint64_t t0 = clock.Elapsed();
+        recorder.Teach(ids, JOINTS, motion, BUFFER, 1000000 / hz);
+        int worst = 0, frames = 0;
+        for (int j = 0; j < JOINTS; j++) {
+            recorded[0][j] = recorder.Positions()[j];
+        }
+        frames = 1;
+        while (recorder.Recording()) {
+            clock.wait_us(recorder.Due());
+            double t = (clock.Elapsed() - t0) / 1e6;
+            if (t >= SECONDS) {
+                break;
+            }
+            hand.update(t);
+            int truth[JOINTS];
+            for (int j = 0; j < JOINTS; j++) {
+                truth[j] = (int)lround(hand.at(j, t));
+                int noise = (rand() % 8 == 0) ? (rand() % 2 ? 1 : -1) : 0;
+                AX12EmulatedServo *s = joints.BusOf(ids[j]) ? right.Servo(ids[j]) : left.Servo(ids[j]);
+                s->SetWord(AX12_REG_POSITION, truth[j] + noise);
+            }
+            if (recorder.Sample() == 1) {
+                for (int j = 0; j < JOINTS; j++) {
+                    int e = abs(recorder.Positions()[j] - truth[j]);
+                    worst = (e > worst) ? e : worst;
+                    recorded[frames][j] = recorder.Positions()[j];
+                }
+                frames++;
+            }
+        }
+        bool full = !recorder.Recording();
+        int size = recorder.Stop();
+        double seconds = (double)recorder.Frames() / hz;
+
+        // Replay : every frame is one SYNC_WRITE per bus, the goals of the servos are checked after each
+        recorder.Play(motion, size);
+        clock.wait_us(500000);
+        int played = 1, off = 0;
+        while (true) {
+            clock.wait_us(recorder.Due());
+            int r = recorder.Step();
+            if (r < 0) {
+                break;
+            }
+            for (int j = 0; j < JOINTS; j++) {
+                AX12EmulatedServo *s = joints.BusOf(ids[j]) ? right.Servo(ids[j]) : left.Servo(ids[j]);
+                off += (s->Word(AX12_REG_GOAL_POSITION) != recorded[played][j]);
+            }
+            played++;
+        }
+
+        char rate[16];
+        snprintf(rate, sizeof(rate), "%d Hz", hz);
+        printf("%-8s %8d %8.1f %8d %10.0f %12d %9d tk %10d %10d%s\n", rate, recorder.Frames(), seconds, size,
+               size * 60 / seconds, recorder.Frames() * JOINTS * 2, worst, played, off, full ? "  (buffer full)" : "");
+
+        // Decoding alone : no bus behind the joints
+        AX12VirtualClock idle;
+        AX12MultiBus none(idle);
+        AX12Recorder player(none);
+        int rounds = 20;
+        long steps = 0;
+        auto start = std::chrono::steady_clock::now();
+        for (int n = 0; n < rounds; n++) {
+            player.Play(motion, size);
+            while (true) {
+                idle.wait_us(player.Due());
+                if (player.Step() < 0) {
+                    break;
+                }
+                steps++;
+            }
+        }
+        double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+        printf("%-8s decoding : %.0f ns per frame of %d joints (host)\n\n", "", ns / steps, JOINTS);
+    }
+    return 0;
+}
@@ -0,0 +1,119 @@
+/**
+ * @file topology_bench.cpp
+ * @author joebarteam11
+ * @brief Time from boot to ready with the topology cache, checked or searched again
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ * Host program, build it from the root of the library :
+ *   g++ -O2 -Iinclude src/AX12Bus.cpp src/AX12Clock.cpp src/AX12Sweep.cpp src/AX12Topology.cpp \
+ *       src/AX12Emulator.cpp examples/host/topology_bench.cpp -o topology_bench
+ *
+ * An emulated chain of 12 servos at 1 Mbps (IDs 1 to 12) and 2 servos left
+ * at 57142 bps (IDs 20 and 21), booted several times. The cache is kept in
+ * RAM between the boots, as the flash sector would be: first boot with an
+ * empty storage, reboots, a limit written since the last boot, a servo
+ * unplugged, a corrupted storage. Each boot starts at 1 Mbps with a new bus,
+ * as after a reset of the board.
+ */
+#include <stdio.h>
+#include <string.h>
+
+#include "AX12Topology.h"
+#include "AX12Emulator.h"
+
+// Stands for the flash sector
+class RamStorage : public AX12Storage {
+
+public:
+    uint8_t data[1024];
+    uint32_t size;
+    int writes;
+
+    RamStorage()
+    {
+        memset(data, 0xFF, sizeof(data)); // erased flash
+        size = 0;
+        writes = 0;
+    }
+
+    virtual int read(void *to, uint32_t n)
+    {
+        if (n > sizeof(data)) {
+            return -1;
+        }
+        memcpy(to, data, n);
+        return 0;
+    }
+
+    virtual int write(const void *from, uint32_t n)
+    {
+        if (n > sizeof(data)) {
+            return -1;
+        }
+        memcpy(data, from, n);
+        size = n;
+        writes++;
+        return 0;
+    }
+};
+
+static int boot(const char *name, AX12VirtualClock &clock, AX12EmulatedBus &chain, RamStorage &storage)
+{
+    chain.set_baudrate(1000000);
+    AX12Bus bus(chain, clock);
+    AX12Topology topology(bus, storage);
+    AX12TopologyReport report;
+    int writes = storage.writes;
+
+    int r = topology.Start(report);
+    printf("%-22s %4d %8s %8d %8d %10.1f %8d %6s\n", name, r, report.cached ? "yes" : "no", report.servos,
+           report.updated, report.elapsed_us / 1000.0, report.packets, (storage.writes > writes) ? "yes" : "no");
+
+    // Every servo of the chain, and nothing else
+    int wrong = 0;
+    for (int i = 0; i < chain.Servos(); i++) {
+        AX12EmulatedServo &s = chain.ServoAt(i);
+        int k = topology.Find(s.Id());
+        wrong += s.unplugged ? (k >= 0) : (k < 0 || memcmp(topology.Servo(k).eeprom, s.table, AX12_EEPROM_SIZE) != 0);
+    }
+    return wrong;
+}
+
+int main(void)
+{
+    AX12VirtualClock clock;
+    AX12EmulatedBus chain(clock, 1000000);
+    RamStorage storage;
+    int wrong = 0;
+
+    for (int id = 1; id <= 12; id++) {
+        chain.Attach(id);
+    }
+    for (int id = 20; id <= 21; id++) {
+        chain.Attach(id)->table[AX12_REG_BAUD] = 0x22;
+    }
+
+    printf("%-22s %4s %8s %8s %8s %10s %8s %6s\n", "", "r", "cached", "servos", "updated", "ready, ms", "packets",
+           "write");
+    wrong += boot("first boot", clock, chain, storage);
+    wrong += boot("reboot", clock, chain, storage);
+    wrong += boot("reboot", clock, chain, storage);
+
+    chain.Servo(3)->SetWord(AX12_REG_CW_LIMIT, 200);
+    wrong += boot("CW limit of 3 changed", clock, chain, storage);
+    wrong += boot("reboot", clock, chain, storage);
+
+    chain.Servo(7)->unplugged = true;
+    wrong += boot("servo 7 unplugged", clock, chain, storage);
+    wrong += boot("reboot", clock, chain, storage);
+
+    storage.data[40] ^= 0x10;
+    wrong += boot("storage corrupted", clock, chain, storage);
+    wrong += boot("reboot", clock, chain, storage);
+
+    printf("\n%d bytes of storage, %d servos wrong in the cache\n", (int)storage.size, wrong);
+    return 0;
+}
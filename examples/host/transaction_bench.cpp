@@ -0,0 +1,137 @@
+/**
+ * @file transaction_bench.cpp
+ * @author joebarteam11
+ * @brief Skew between joints with plain WRITEs and with AX12Transaction
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ * Host program, build it from the root of the library :
+ *   g++ -O2 -Iinclude src/AX12Bus.cpp src/AX12Clock.cpp src/AX12MultiBus.cpp \
+ *       src/AX12Emulator.cpp src/AX12Transaction.cpp \
+ *       examples/host/transaction_bench.cpp -o transaction_bench
+ *
+ * 18 servos on 2 emulated buses receive different writes (goal and speed, or
+ * goal, speed and torque limit). The skew is the time between the first and
+ * the last servo executing its write, measured by the emulator.
+ */
+#include <stdio.h>
+
+#include "AX12Transaction.h"
+#include "AX12Emulator.h"
+
+#define JOINTS 18
+#define BUSES 2
+#define BAUD 1000000
+
+static AX12VirtualClock clock_;
+static AX12EmulatedBus chains[BUSES] = {AX12EmulatedBus(clock_, BAUD), AX12EmulatedBus(clock_, BAUD)};
+
+static uint32_t skew(void)
+{
+    uint64_t first = ~0ULL, last = 0;
+    for (int b = 0; b < BUSES; b++) {
+        for (int i = 0; i < chains[b].Servos(); i++) {
+            uint64_t t = chains[b].ServoAt(i).written;
+            first = (t < first) ? t : first;
+            last = (t > last) ? t : last;
+        }
+    }
+    return (uint32_t)((last - first) / 1000);
+}
+
+// Write of joint i: goal and speed, plus the torque limit for odd joints
+static int payload(int i, uint8_t *data)
+{
+    uint16_t goal = 200 + 30 * i;
+    data[0] = goal & 0xff;
+    data[1] = goal >> 8;
+    data[2] = 100;
+    data[3] = 0;
+    data[4] = 0xff;
+    data[5] = 0x03;
+    return (i & 1) ? 6 : 4;
+}
+
+int main(void)
+{
+    AX12Bus *bus[BUSES];
+    AX12MultiBus joints(clock_);
+    uint8_t ids[JOINTS];
+    uint8_t data[6];
+
+    for (int b = 0; b < BUSES; b++) {
+        bus[b] = new AX12Bus(chains[b], clock_);
+        bus[b]->SetReturnDelay(0);
+        joints.AddBus(*bus[b]);
+    }
+    for (int i = 0; i < JOINTS; i++) {
+        ids[i] = i + 1;
+    }
+    joints.Balance(ids, JOINTS);
+    for (int i = 0; i < JOINTS; i++) {
+        chains[joints.BusOf(ids[i])].Attach(ids[i])->table[AX12_REG_RETURN_DELAY] = 0;
+    }
+
+    printf("mode                        skew (us)  stats (us)  REG_WRITEs (us)\n");
+
+    // One WRITE after the other
+    uint64_t start = clock_.Elapsed();
+    for (int i = 0; i < JOINTS; i++) {
+        int n = payload(i, data);
+        joints.Bus(joints.BusOf(ids[i])).Write(ids[i], AX12_REG_GOAL_POSITION, n, data);
+    }
+    printf("WRITE per servo             %9u  %10s  %15s   (%u us in all)\n", skew(), "-", "-",
+           (unsigned)(clock_.Elapsed() - start));
+
+    AX12Transaction move(joints);
+    const char *modes[2] = {"transaction, status level 2", "transaction, status level 1"};
+    for (int level = 2; level >= 1; level--) {
+        for (int b = 0; b < BUSES; b++) {
+            bus[b]->SetStatusReturn(level);
+            for (int i = 0; i < chains[b].Servos(); i++) {
+                chains[b].ServoAt(i).table[AX12_REG_STATUS_RETURN] = level;
+            }
+        }
+        for (int i = 0; i < JOINTS; i++) {
+            int n = payload(i, data);
+            data[0] += level; // a new goal
+            move.Stage(ids[i], AX12_REG_GOAL_POSITION, n, data);
+        }
+        int r = move.Commit();
+        printf("%s %9u  %10u  %15u%s\n", modes[2 - level], skew(), (unsigned)move.Stats().skew_us,
+               (unsigned)move.Stats().prepare_us, r == AX12_OK ? "" : "  (error)");
+    }
+
+    // An aborted transaction leaves the servos untouched, even after an ACTION
+    uint16_t goals[BUSES][JOINTS];
+    for (int b = 0; b < BUSES; b++) {
+        for (int i = 0; i < chains[b].Servos(); i++) {
+            goals[b][i] = chains[b].ServoAt(i).Word(AX12_REG_GOAL_POSITION);
+        }
+    }
+    for (int i = 0; i < JOINTS; i++) {
+        int n = payload(i, data);
+        data[0] = 0; // would move every servo
+        move.Stage(ids[i], AX12_REG_GOAL_POSITION, n, data);
+    }
+    move.Prepare();
+    move.Abort();
+    for (int b = 0; b < BUSES; b++) {
+        bus[b]->Action();
+    }
+    int changed = 0;
+    for (int b = 0; b < BUSES; b++) {
+        chains[b].Update();
+        for (int i = 0; i < chains[b].Servos(); i++) {
+            changed += (chains[b].ServoAt(i).Word(AX12_REG_GOAL_POSITION) != goals[b][i]);
+        }
+    }
+    printf("abort: %d servos changed by the next ACTION\n", changed);
+
+    for (int b = 0; b < BUSES; b++) {
+        delete bus[b];
+    }
+    return 0;
+}
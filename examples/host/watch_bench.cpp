@@ -0,0 +1,133 @@
+/**
+ * @file watch_bench.cpp
+ * @author joebarteam11
+ * @brief Packets and bus time of the registers watched by several consumers, joined or read one by one
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ * Host program, build it from the root of the library :
+ *   g++ -O2 -Iinclude src/AX12Bus.cpp src/AX12Clock.cpp src/AX12Scheduler.cpp \
+ *       src/AX12Watch.cpp src/AX12Emulator.cpp examples/host/watch_bench.cpp -o watch_bench
+ *
+ * 5 servos on one emulated chain at 1 Mbps, 10 s. Each servo is watched by
+ * the control loop (position, 100 Hz), a motion monitor (moving and speed,
+ * 50 Hz), the load sampler (load, 50 Hz) and a health check (voltage and
+ * temperature, 1 Hz): 30 watches, what the GetPosition(), isMoving(),
+ * GetLoad(), GetVolts() and GetTemp() of the consumers asked the bus one by
+ * one. They are read joined, then one packet per watch (SetMaxGap(-1)). The
+ * values handed to the watches are checked against the control tables.
+ */
+#include <stdio.h>
+
+#include "AX12Watch.h"
+#include "AX12Emulator.h"
+
+#define SERVOS 5
+#define SECONDS 10
+
+struct Consumer {
+    const char *name;
+    uint8_t reg;
+    uint8_t length;
+    uint32_t period_us;
+};
+
+static const Consumer consumers[] = {
+    {"position", AX12_REG_POSITION, 2, 10000},
+    {"moving", AX12_REG_MOVING, 1, 20000},
+    {"speed", AX12_REG_SPEED, 2, 20000},
+    {"load", AX12_REG_LOAD, 2, 20000},
+    {"volts", AX12_REG_VOLTS, 1, 1000000},
+    {"temp", AX12_REG_TEMP, 1, 1000000},
+};
+#define CONSUMERS (int)(sizeof(consumers) / sizeof(consumers[0]))
+
+struct Check {
+    AX12VirtualClock *clock;
+    AX12EmulatedBus *chain;
+    int wrong;
+    uint32_t last[SERVOS + 1]; // time of the last position
+    uint32_t worst;            // longest time between two positions of a servo
+};
+
+static void checked(uint8_t id, uint8_t reg, uint16_t value, void *context)
+{
+    Check *check = (Check *)context;
+    AX12EmulatedServo *s = check->chain->Servo(id);
+    uint16_t expected = (reg == AX12_REG_TEMP || reg == AX12_REG_MOVING) ? s->table[reg] : s->Word(reg);
+    check->wrong += (value != expected);
+
+    if (reg == AX12_REG_POSITION) {
+        uint32_t now = check->clock->now_us();
+        if (check->last[id] && now - check->last[id] > check->worst) {
+            check->worst = now - check->last[id];
+        }
+        check->last[id] = now;
+    }
+}
+
+int main(void)
+{
+    printf("%d servos, %d watches, %d s at 1 Mbps\n\n", SERVOS, SERVOS * CONSUMERS, SECONDS);
+    printf("%-10s %10s %10s %10s %12s %10s %14s %8s %8s\n", "", "packets/s", "values/s", "saved/s", "bytes/packet",
+           "bus time", "position every", "errors", "wrong");
+
+    for (int joined = 1; joined >= 0; joined--) {
+        AX12VirtualClock clock;
+        AX12EmulatedBus chain(clock, 1000000);
+        AX12Bus bus(chain, clock);
+        AX12Scheduler sched(bus);
+        AX12Watcher watch(sched);
+        Check check = {&clock, &chain, 0, {0}, 0};
+        volatile uint16_t volts[SERVOS];
+
+        bus.SetReturnDelay(0);
+        for (int id = 1; id <= SERVOS; id++) {
+            AX12EmulatedServo *s = chain.Attach(id);
+            s->table[AX12_REG_RETURN_DELAY] = 0;
+            s->SetWord(AX12_REG_POSITION, 200 + 100 * id);
+            s->SetWord(AX12_REG_SPEED, 10 * id);
+            s->SetWord(AX12_REG_LOAD, 1024 + id);
+            s->table[AX12_REG_VOLTS] = 110 + id;
+            s->table[AX12_REG_TEMP] = 30 + id;
+            s->table[AX12_REG_MOVING] = id & 1;
+            for (int c = 0; c < CONSUMERS; c++) {
+                const Consumer &k = consumers[c];
+                if (k.reg == AX12_REG_VOLTS) {
+                    watch.Watch(id, k.reg, k.length, k.period_us, &volts[id - 1]);
+                } else {
+                    watch.Watch(id, k.reg, k.length, k.period_us, checked, &check);
+                }
+            }
+        }
+        watch.SetMaxGap(joined ? AX12_WATCH_MAX_GAP : -1);
+
+        uint32_t start = clock.now_us();
+        while (!AX12Clock::reached(clock.now_us(), start + SECONDS * 1000000)) {
+            if (watch.Due() == 0) {
+                watch.Poll();
+            }
+            if (sched.Poll() > 0) {
+                clock.wait_us(bus.WireTime(1));
+            } else {
+                uint32_t wait = watch.Due();
+                clock.wait_us(wait ? wait : 1);
+            }
+        }
+        sched.Flush();
+        watch.Poll();
+
+        int wrong = check.wrong;
+        for (int id = 1; id <= SERVOS; id++) {
+            wrong += (volts[id - 1] != chain.Servo(id)->table[AX12_REG_VOLTS]);
+        }
+        const AX12WatchStats &st = watch.Stats();
+        const AX12BusStats &bs = bus.Stats();
+        printf("%-10s %10u %10u %10u %12.1f %9.1f%% %11.1f ms %8u %8d\n", joined ? "joined" : "one by one",
+               st.packets / SECONDS, st.reads / SECONDS, st.saved / SECONDS, (double)st.bytes / st.packets,
+               bs.busy_us / (SECONDS * 10000.0), check.worst / 1000.0, st.errors, wrong);
+    }
+    return 0;
+}
@@ -28,28 +28,15 @@
 #define MBED_AX12_H
 
 #include "SerialHalfDuplex.h"
+#include "AX12Protocol.h"
+#include "AX12Bus.h"
+#include "AX12Batch.h"
+#include "AX12Log.h"
 #include "mbed.h"
 
-#define AX12_WRITE_DEBUG 0
-#define AX12_READ_DEBUG 0
-#define AX12_TRIGGER_DEBUG 0
-#define AX12_DEBUG 0
+// Debug output : -DAX12_LOG_LEVEL=2 (commands) or 3 (every read and write), see AX12Log.h
 #define AX12_CALIB 0
 
-#define AX12_REG_ID 0x3
-#define AX12_REG_BAUD 0x4
-#define AX12_REG_CW_LIMIT 0x06
-#define AX12_REG_CCW_LIMIT 0x08
-#define AX12_REG_ENABLE_TORQUE 0x18
-#define AX12_REG_MAX_TORQUE 0xE
-#define AX12_REG_LOAD 0x28
-#define AX12_REG_GOAL_POSITION 0x1E
-#define AX12_REG_MOVING_SPEED 0x20
-#define AX12_REG_VOLTS 0x2A
-#define AX12_REG_TEMP 0x2B
-#define AX12_REG_MOVING 0x2E
-#define AX12_REG_POSITION 0x24
-
 #define AX12_MODE_POSITION  0
 #define AX12_MODE_ROTATION  1
 
@@ -57,6 +44,11 @@
 #define AX12_CCW 0
 #define AX12_BAUDRATE 115200
 /** Servo control class, based on a PwmOut
+ *
+ * Every command takes a PlatformMutex (nothing without the RTOS) for all of
+ * its packets: threads sharing one object, as the Motor of main.h, take turns
+ * by whole commands. Not from an interrupt, which posts an AX12Request to an
+ * AX12Scheduler instead. Two objects built on the same pins do not share it.
  *
  * Example:
  * @code
@@ -216,19 +208,33 @@ public:
 
     /** Get the current load (torque) on the servo
      * 
-     * @returns float load (percentage)
-     * @attention not very accurate
-     */
-    ////////////////////////////////////////////////////////////////////////////////////////////////
-    //
-    //                                   !!!  NOT WORKING !!!
-    //
-    ////////////////////////////////////////////////////////////////////////////////////////////////
+     * @returns float load, -1.0 (CCW) to 1.0 (CW) of the maximum torque
+     * @attention one raw sample, noisy : AX12LoadSampler filters a stream of samples
+     */
     float GetLoad(void);
+
+    /** Hold the writes of the Set functions, see AX12WriteBatch
+     *
+     * The writes held are merged and sent by Flush(), or before the next
+     * read, REG_WRITE, reset or trigger(). SetMode() always sends its three
+     * writes in two packets.
+     */
+    void SetBatching(bool on);
+
+    /** Send the writes held
+     *
+     * @returns 0 or the first error
+     */
+    int Flush(void);
    
 private :
   
     SerialHalfDuplex _ax12;
+    AX12Bus _bus;
+    AX12BatchEntry _held;
+    AX12WriteBatch _batch;
+    bool _batching;
+    PlatformMutex _lock; // recursive : SetMode() calls the other commands
     int _ID;
     int _baud;
     int read(int ID, int start, int length, char* data);
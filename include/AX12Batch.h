@@ -0,0 +1,138 @@
+/**
+ * @file AX12Batch.h
+ * @author joebarteam11
+ * @brief Register writes gathered during a control tick, sent in the fewest packets
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+#ifndef MBED_AX12BATCH_H
+#define MBED_AX12BATCH_H
+
+#include "AX12Bus.h"
+
+/** Counters, reset with AX12WriteBatch::ResetStats()
+ */
+struct AX12BatchStats {
+    uint32_t writes;  // writes staged
+    uint32_t packets; // WRITE_DATA and SYNC_WRITE sent
+    uint32_t syncs;   // of which SYNC_WRITE
+    uint32_t saved;   // packets the writes would have taken one by one, less the ones sent
+    uint32_t early;   // flushes of one servo, to keep the order of its writes
+};
+
+/** Registers of one servo held by an AX12WriteBatch, storage of the caller
+ */
+struct AX12BatchEntry {
+    uint8_t id;
+    bool used;
+    uint8_t base;   // register of data[0]
+    uint32_t known; // bit per byte of data
+    uint32_t dirty; // staged, not sent
+    uint8_t data[AX12_BATCH_SPAN];
+};
+
+/** Holds the register writes of a control tick and merges them
+ *
+ * Write() stages bytes of the control table of a servo instead of sending
+ * them. Flush() (at the end of the tick, or from Poll() once the oldest
+ * staged write is SetWindow() old) sends each servo the range from its
+ * first to its last staged byte in one WRITE_DATA, and the servos whose
+ * ranges are the same in one SYNC_WRITE. CW and CCW limits (0x06-0x09), or
+ * goal, speed and torque limit (0x1E-0x23), are one packet per servo, and
+ * one packet for all the servos that changed the same registers.
+ *
+ * A range may have holes: the bytes in between are written again with the
+ * value the batch knows they have, from an earlier write or from Learn(),
+ * except the EEPROM (0x00-0x17), the torque enable and torque limit (an
+ * alarm clears them), goal, speed and the read only registers.
+ * A write that would leave a hole of unknown bytes first sends what the
+ * servo has staged, so every register still receives its writes in order
+ * and the last value staged for a byte is the one it ends with.
+ *
+ * The ID and baud rate registers, and writes to the broadcast ID, are never
+ * held: everything staged is sent first, then the write itself.
+ *
+ * Each servo with writes staged takes an AX12BatchEntry of the array given
+ * to the constructor (at most AX12_BATCH_MAX_SERVOS are used); when they are
+ * all taken, the next servo flushes the batch.
+ *
+ * Example:
+ * @code
+ * AX12BatchEntry entries[12];
+ * AX12WriteBatch batch(bus, entries, 12);
+ *
+ * batch.WriteWord(3, AX12_REG_GOAL_POSITION, goal);
+ * batch.WriteWord(3, AX12_REG_MOVING_SPEED, speed);    // same WRITE_DATA
+ * batch.WriteWord(4, AX12_REG_GOAL_POSITION, goal4);
+ * batch.WriteWord(4, AX12_REG_MOVING_SPEED, speed4);   // one SYNC_WRITE for 3 and 4
+ * batch.Flush();                                       // end of the tick
+ * @endcode
+ */
+class AX12WriteBatch {
+
+public:
+    AX12WriteBatch(AX12Bus &bus, AX12BatchEntry *entries, int count);
+
+    /** Stage a write
+     *
+     * @returns AX12_OK, the result of the packets sent first to keep the
+     *          order, or AX12_ERR_ARG
+     */
+    int Write(int id, int start, int length, const uint8_t *data);
+
+    /** Stage a 2 bytes register, little endian
+     */
+    int WriteWord(int id, int start, uint16_t value);
+
+    /** Send everything staged
+     *
+     * @returns AX12_OK or the first error, the writes are dropped either way
+     */
+    int Flush(void);
+
+    /** Flush once the oldest staged write is \p us old, checked by Poll() (0, by default, leaves it to Flush())
+     */
+    void SetWindow(uint32_t us);
+
+    /** Flush if the window is over
+     *
+     * @returns AX12_OK, or the result of Flush()
+     */
+    int Poll(void);
+
+    /** Give the values of registers read from a servo, so that a range can go over them
+     */
+    void Learn(int id, int start, int length, const uint8_t *data);
+
+    /** Forget what is known of a servo (reset, written outside the batch), its staged writes are dropped
+     */
+    void Forget(int id);
+
+    /** @returns number of servos with writes staged
+     */
+    int Pending(void);
+
+    const AX12BatchStats &Stats(void);
+    void ResetStats(void);
+
+private :
+
+    typedef AX12BatchEntry Entry;
+
+    AX12Bus &_bus;
+    Entry *_entries;
+    int _count;
+    int _staged;      // writes staged since the last flush
+    uint32_t _first;  // time of the oldest one
+    uint32_t _window;
+    AX12BatchStats _stats;
+
+    Entry *find(int id, bool create);
+    int flush(Entry &e);
+    int send(Entry **group, int count, int lo, int hi);
+};
+
+#endif
@@ -0,0 +1,131 @@
+/**
+ * @file AX12Baud.h
+ * @author joebarteam11
+ * @brief Negotiation of the fastest reliable bit rate of a chain
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+#ifndef MBED_AX12BAUD_H
+#define MBED_AX12BAUD_H
+
+#include "AX12Bus.h"
+
+#ifndef AX12_BAUD_PROBE_READS
+#define AX12_BAUD_PROBE_READS 16 // reads per servo at each step
+#endif
+
+#ifndef AX12_BAUD_SETTLE_US
+#define AX12_BAUD_SETTLE_US 2000 // after a change of bit rate, EEPROM write of the servos
+#endif
+
+#define AX12_BAUD_CODES 9 // standard baud register codes, 0xCF (9600bps) to 0x01 (1Mbps)
+
+/** Result of the probe of one bit rate
+ */
+struct AX12BaudStep {
+    uint8_t code;        // AX12_REG_BAUD value
+    int baud;            // bps
+    uint16_t attempts;   // reads sent
+    uint16_t errors;     // reads without a valid reply
+    uint32_t error_ppm;  // errors per million reads
+    uint32_t throughput; // control table bytes read per second
+    bool passed;
+};
+
+/** Moves a chain to the fastest bit rate it runs at without errors
+ *
+ * From the bit rate of the port, the servos are switched to each faster
+ * standard baud code in turn (one SYNC_WRITE of AX12_REG_BAUD, no reply), the
+ * port follows, and AX12_BAUD_PROBE_READS reads of the EEPROM area of every
+ * servo measure the error rate. The first step above the threshold ends the
+ * negotiation: the servos are sent back to the last good code, and if some
+ * of them missed that packet, the revert is repeated at every standard bit
+ * rate until they all answer again.
+ *
+ * The port must support AX12Port::set_baudrate(). The new code is stored in
+ * the EEPROM of the servos, it is kept after a power cycle.
+ *
+ * Example:
+ * @code
+ * SerialHalfDuplex serial(TX, RX, 57600);
+ * AX12Bus bus(serial);
+ * AX12BaudNegotiator negotiator(bus);
+ * const uint8_t ids[3] = {1, 2, 3};
+ *
+ * if (negotiator.Negotiate(ids, 3) == AX12_OK) {
+ *     printf("Chain at %d bps\n", serial.baudrate());
+ * }
+ * @endcode
+ */
+class AX12BaudNegotiator {
+
+public:
+    AX12BaudNegotiator(AX12Bus &bus);
+
+    /** Error rate a bit rate must not exceed to be kept, errors per million reads (0 by default)
+     */
+    void SetThreshold(uint32_t ppm);
+
+    /** Reads per servo at each step
+     */
+    void SetProbeReads(int reads);
+
+    /** Fastest code tried, 0x01 (1Mbps) by default
+     */
+    void SetFastest(int code);
+
+    /** Bring the servos \p ids to the fastest reliable bit rate
+     *
+     * @param ids servos of the chain, all at the bit rate of the port
+     * @param count number of servos
+     * @returns AX12_OK with the chain and the port at Code(), AX12_ERR_TIMEOUT
+     *          if the chain does not pass at its present bit rate or if a
+     *          servo could not be brought back, AX12_ERR_ARG if the port
+     *          cannot change its bit rate
+     */
+    int Negotiate(const uint8_t *ids, int count);
+
+    /** Measure the error rate and throughput at the present bit rate of the port
+     *
+     * @param step filled with the result, code and baud of the port
+     */
+    void Probe(const uint8_t *ids, int count, AX12BaudStep &step);
+
+    /** Switch the servos and the port to a baud code, without any check
+     *
+     * @returns AX12_OK, AX12_ERR_ARG if the port refused the bit rate
+     */
+    int Switch(const uint8_t *ids, int count, int code);
+
+    /** @returns the code the chain was left at by Negotiate()
+     */
+    int Code(void);
+
+    /** Steps of the last negotiation, the present bit rate first
+     */
+    int Steps(void);
+    const AX12BaudStep &Step(int index);
+
+    /** @returns the baud code closest to \p baud
+     */
+    static int CodeOf(int baud);
+
+private :
+
+    AX12Bus &_bus;
+    uint32_t _threshold;
+    int _reads;
+    int _fastest;
+    int _code;
+    AX12BaudStep _steps[AX12_BAUD_CODES + 1];
+    int _count;
+
+    void send(const uint8_t *ids, int count, int code);
+    bool answer(const uint8_t *ids, int count);
+    int recover(const uint8_t *ids, int count, int code);
+};
+
+#endif
@@ -0,0 +1,283 @@
+/**
+ * @file AX12Bus.h
+ * @author joebarteam11
+ * @brief Packet layer of one Dynamixel chain (Protocol 1.0)
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+#ifndef MBED_AX12BUS_H
+#define MBED_AX12BUS_H
+
+#include "AX12Protocol.h"
+#include "AX12Port.h"
+#include "AX12Clock.h"
+
+#ifndef AX12_BUS_TIMEOUT_US
+#define AX12_BUS_TIMEOUT_US 2000 // margin added to the computed reply time
+#endif
+
+#ifndef AX12_BUS_SILENCE_US
+#define AX12_BUS_SILENCE_US 300 // line quiet for this long after the return delay or a byte : the reply is over
+#endif
+
+#ifndef AX12_BUS_FAILURES
+#define AX12_BUS_FAILURES 3 // replies missed in a row before a servo is quarantined
+#endif
+
+#ifndef AX12_BUS_BACKOFF_US
+#define AX12_BUS_BACKOFF_US 20000 // first wait before a quarantined servo is pinged, doubled at each failure
+#endif
+
+#ifndef AX12_BUS_BACKOFF_MAX_US
+#define AX12_BUS_BACKOFF_MAX_US 1000000
+#endif
+
+#define AX12_DEFAULT_RETURN_DELAY_US 500 // factory value of AX12_REG_RETURN_DELAY (250 * 2us)
+
+/** Counters of a bus, reset with AX12Bus::ResetStats()
+ */
+struct AX12BusStats {
+    uint32_t transactions;
+    uint32_t timeouts; // no reply at all
+    uint32_t errors;   // checksum, length or ID mismatch in a status packet, partial reply
+    uint32_t line_errors; // echo differing from the packet sent, bytes lost by the port
+    uint32_t refused;  // transactions not sent to a quarantined servo
+    uint32_t probes;   // PING sent to quarantined servos
+    uint32_t tx_bytes;
+    uint32_t rx_bytes;
+    uint32_t busy_us;  // time spent with a transaction in flight
+    uint32_t idle_us;  // part of it Wait() gave to other threads or to sleep, asleep in the port
+};
+
+/** One half-duplex chain of AX12 servos
+ *
+ * A transaction is a packet sent on the port followed by the status packet of
+ * the servo, if one is expected. Transactions can be driven without blocking
+ * (Packet(), Start() then Poll()) so that several buses run at the same time,
+ * or with the blocking helpers (Read(), Write(), ...).
+ *
+ * The status packet is parsed byte by byte as it arrives: a transaction ends
+ * as soon as its last byte is received instead of after a fixed delay.
+ *
+ * A failed transaction ends within one packet time as well: the line quiet
+ * for AX12_BUS_SILENCE_US after the return delay is a servo that does not
+ * answer, quiet in the middle of a reply is a partial reply, and a packet
+ * whose echo differs from what was sent ends as soon as it is out. The
+ * receive side is flushed at once so no byte leaks into the next transaction.
+ *
+ * A servo that misses AX12_BUS_FAILURES replies in a row is quarantined: its
+ * transactions end at once with AX12_ERR_UNREACHABLE instead of waiting for
+ * a reply that will not come. Probe() pings it in the idle time of the bus,
+ * after a back-off doubling from AX12_BUS_BACKOFF_US at each failed ping,
+ * and lets it back in as soon as it answers.
+ *
+ * Example:
+ * @code
+ * SerialHalfDuplex serial(TX, RX, 1000000);
+ * AX12Bus bus(serial);
+ *
+ * uint8_t data[2];
+ * if (bus.Read(1, AX12_REG_POSITION, 2, data) == AX12_OK) {
+ *     printf("Position : %d\n", data[0] | (data[1] << 8));
+ * }
+ * @endcode
+ */
+class AX12Bus {
+
+public:
+    /** Create a bus on a port
+     *
+     * @param port transport of the chain
+     * @param clock time base used for the timeouts
+     */
+    AX12Bus(AX12Port &port, AX12Clock &clock = AX12Clock::system());
+
+    /** Begin a new instruction packet in the transmit buffer
+     *
+     * @param id servo ID, AX12_BROADCAST_ID for all servos
+     * @param instruction one of AX12_INST_*
+     * @param count number of parameters
+     * @returns where the \p count parameters must be written, 0 if the bus is busy or the packet too large
+     */
+    uint8_t *Packet(int id, int instruction, int count);
+
+    /** Send the packet prepared with Packet()
+     *
+     * @param reply where the parameters of the status packet are copied (READ only)
+     * @param reply_length number of parameters expected in the status packet
+     * @returns AX12_BUSY, or a negative error if nothing was sent (AX12_ERR_LINE if
+     *          the port refused the packet), given by Poll() as well
+     */
+    int Start(uint8_t *reply = 0, int reply_length = 0);
+
+    /** Make the current transaction progress, never blocks
+     *
+     * @returns AX12_BUSY while in flight, then the servo error byte (>= 0) or an AX12_ERR_* code
+     */
+    int Poll(void);
+
+    /** @returns true while a transaction is in flight
+     */
+    bool Busy(void);
+
+    /** Block until the current transaction is over
+     *
+     * The calling thread sleeps in the port (AX12Port::wait()) between the
+     * bytes and until the deadlines, unless SetSleep(false).
+     *
+     * @returns same as Poll()
+     */
+    int Wait(void);
+
+    /** Sleep in the port during Wait() (default), or poll the clock a byte time at a time
+     *
+     * Stats() tells the CPU time of a transaction either way: busy_us - idle_us.
+     */
+    void SetSleep(bool sleep);
+
+    /** Check that a servo answers
+     */
+    int Ping(int id);
+
+    /** Read \p length bytes of the control table of a servo from \p start
+     */
+    int Read(int id, int start, int length, uint8_t *data);
+
+    /** Write \p length bytes to the control table of a servo from \p start
+     *
+     * @param registered true to send a REG_WRITE, executed on the next ACTION
+     */
+    int Write(int id, int start, int length, const uint8_t *data, bool registered = false);
+
+    /** Write the same registers of several servos with one SYNC_WRITE packet
+     *
+     * @param start first register
+     * @param length bytes per servo
+     * @param ids IDs of the servos
+     * @param data \p count blocks of \p length bytes, in the order of \p ids
+     * @param count number of servos
+     */
+    int SyncWrite(int start, int length, const uint8_t *ids, const uint8_t *data, int count);
+
+    /** Broadcast ACTION, executing the registered writes of every servo
+     */
+    int Action(void);
+
+    /** Return delay configured in the servos (AX12_REG_RETURN_DELAY * 2us)
+     */
+    void SetReturnDelay(uint32_t us);
+
+    /** Status return level configured in the servos (AX12_REG_STATUS_RETURN)
+     *
+     * @param level
+     *    0 = reply to PING only
+     *    1 = reply to PING and READ
+     *    2 = reply to every instruction, default
+     */
+    void SetStatusReturn(int level);
+
+    /** Time allowed on top of the computed reply time before a timeout
+     *
+     * The latency of the port is added to it when a reply is expected.
+     */
+    void SetTimeout(uint32_t us);
+    uint32_t Timeout(void);
+
+    /** Quiet time of the line that ends a reply, AX12_BUS_SILENCE_US by default
+     *
+     * The latency of the port (USB adapters) is added to it. 0 waits for the timeout.
+     */
+    void SetSilence(uint32_t us);
+
+    /** Ping one quarantined servo whose back-off is over, if the bus is idle
+     *
+     * Call it when the bus has nothing else to do, then Poll() the PING
+     * like any transaction.
+     *
+     * @returns AX12_BUSY if a PING was started, AX12_OK if none is due or the bus is in use,
+     *          AX12_ERR_LINE if the port refused it
+     */
+    int Probe(void);
+
+    /** @returns true if the transactions to \p id are refused, see Probe()
+     */
+    bool Quarantined(int id);
+
+    /** Let a servo back in at once, after it was plugged back for instance
+     */
+    void Release(int id);
+
+    /** @returns the time needed to shift \p bytes on the wire (8N1)
+     */
+    uint32_t WireTime(int bytes);
+
+    /** Time a transaction keeps the bus, from the first byte sent to the last byte of the reply
+     *
+     * @param id servo ID
+     * @param instruction one of AX12_INST_*
+     * @param count number of parameters of the instruction packet
+     * @param reply_length number of parameters of the status packet
+     */
+    uint32_t Estimate(int id, int instruction, int count, int reply_length = 0);
+
+    /** @returns true if a servo answers \p instruction sent to \p id, see SetStatusReturn()
+     */
+    bool ExpectsReply(int id, int instruction);
+
+    const AX12BusStats &Stats(void);
+    void ResetStats(void);
+
+    AX12Port &Port(void);
+    AX12Clock &Clock(void);
+
+private :
+
+    enum State { IDLE, SENDING, RECEIVING };
+    enum Parser { RX_HEADER1, RX_HEADER2, RX_ID, RX_LENGTH, RX_ERROR, RX_PARAMS, RX_CHECKSUM };
+
+    struct Quarantine {
+        uint8_t id;
+        uint8_t failures; // replies missed in a row, 0 for a free entry
+        uint8_t backoff;  // doublings of AX12_BUS_BACKOFF_US
+        uint32_t probe;   // time of the next PING
+    };
+
+    AX12Port &_port;
+    AX12Clock &_clock;
+    uint8_t _tx[AX12_BUS_PACKET_SIZE];
+    int _tx_length;
+    uint8_t *_reply;
+    int _reply_length;
+    bool _expect_reply;
+    State _state;
+    Parser _parser;
+    uint8_t _rx_id;
+    uint8_t _rx_error;
+    uint8_t _rx_sum;
+    int _rx_count;
+    int _rx_params;
+    int _result;
+    uint32_t _start;
+    uint32_t _deadline;
+    uint32_t _heard;  // last byte received, or start of the reply
+    bool _replied;    // a byte came back since the packet was sent
+    uint32_t _return_delay;
+    uint32_t _timeout;
+    uint32_t _silence;
+    bool _sleep;
+    int _status_return;
+    AX12BusStats _stats;
+    Quarantine _quarantine[AX12_BUS_MAX_QUARANTINE];
+
+    int transmit(uint8_t *reply, int reply_length);
+    bool parse(uint8_t c);
+    void finish(int result);
+    void track(int id, int result);
+    uint32_t quiet(void);
+    uint32_t until(void);
+};
+
+#endif
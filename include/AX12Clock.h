@@ -0,0 +1,49 @@
+/**
+ * @file AX12Clock.h
+ * @author joebarteam11
+ * @brief Microsecond time base used by the AX12 bus layer
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+#ifndef MBED_AX12CLOCK_H
+#define MBED_AX12CLOCK_H
+
+#include <stdint.h>
+
+/** Time base shared by the bus transactions
+ *
+ * The system clock follows the us ticker on mbed targets and the steady clock
+ * on a host. The emulator replaces it with a virtual clock so bus timing can be
+ * measured without hardware.
+ *
+ * Timestamps wrap after ~71 minutes, always compare them with reached().
+ */
+class AX12Clock {
+
+public:
+    virtual ~AX12Clock() {}
+
+    /** @returns the current time in microseconds
+     */
+    virtual uint32_t now_us(void) = 0;
+
+    /** Let at least \p us microseconds pass
+     */
+    virtual void wait_us(uint32_t us) = 0;
+
+    /** @returns true if \p deadline is in the past of \p now
+     */
+    static bool reached(uint32_t now, uint32_t deadline)
+    {
+        return (int32_t)(now - deadline) >= 0;
+    }
+
+    /** @returns the clock of the board (or host)
+     */
+    static AX12Clock &system(void);
+};
+
+#endif
@@ -0,0 +1,235 @@
+/**
+ * @file AX12Config.h
+ * @author joebarteam11
+ * @brief Size of every buffer, queue and table of the library
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ * All the memory of the library is sized here at compile time, nothing is
+ * allocated on the heap. Override any value with a -D flag (build_flags of
+ * platformio.ini, "macros" of mbed_app.json), or put them all in a header of
+ * the project given by -DAX12_CONFIG_FILE=\"ax12_config.h\".
+ *
+ * -DAX12_CONFIG_SMALL lowers the defaults for the parts with a few KB of RAM
+ * (F303K8 : 12 KB). examples/footprint/footprint.cpp prints the RAM taken per
+ * bus and per servo by a configuration.
+ */
+#ifndef MBED_AX12CONFIG_H
+#define MBED_AX12CONFIG_H
+
+#ifdef AX12_CONFIG_FILE
+#include AX12_CONFIG_FILE
+#endif
+
+#ifdef AX12_CONFIG_SMALL
+#ifndef AX12_BUS_PACKET_SIZE
+#define AX12_BUS_PACKET_SIZE 64 // a 4 bytes SYNC_WRITE to 11 servos
+#endif
+#ifndef AX12_BUS_MAX_QUARANTINE
+#define AX12_BUS_MAX_QUARANTINE 4
+#endif
+#ifndef AX12_MAX_BUSES
+#define AX12_MAX_BUSES 2
+#endif
+#ifndef AX12_SCHED_QUEUE_SIZE
+#define AX12_SCHED_QUEUE_SIZE 8
+#endif
+#ifndef AX12_PROFILE_MAX_JOINTS
+#define AX12_PROFILE_MAX_JOINTS 8
+#endif
+#ifndef AX12_TRACKER_MAX_JOINTS
+#define AX12_TRACKER_MAX_JOINTS 8
+#endif
+#ifndef AX12_TRANSACTION_MAX_SERVOS
+#define AX12_TRANSACTION_MAX_SERVOS 8
+#endif
+#ifndef AX12_EMU_MAX_SERVOS
+#define AX12_EMU_MAX_SERVOS 8
+#endif
+#ifndef AX12_LOAD_MAX_JOINTS
+#define AX12_LOAD_MAX_JOINTS 8
+#endif
+#ifndef AX12_LOAD_RING_SIZE
+#define AX12_LOAD_RING_SIZE 8
+#endif
+#ifndef AX12_STALL_MAX_JOINTS
+#define AX12_STALL_MAX_JOINTS 8
+#endif
+#ifndef AX12_KIN_MAX_LIMBS
+#define AX12_KIN_MAX_LIMBS 4
+#endif
+#ifndef AX12_ODO_MAX_JOINTS
+#define AX12_ODO_MAX_JOINTS 8
+#endif
+#ifndef AX12_LOG_SIZE
+#define AX12_LOG_SIZE 16
+#endif
+#ifndef AX12_TEACH_MAX_JOINTS
+#define AX12_TEACH_MAX_JOINTS 8
+#endif
+#ifndef AX12_WATCH_MAX
+#define AX12_WATCH_MAX 12
+#endif
+#ifndef AX12_WATCH_MAX_READS
+#define AX12_WATCH_MAX_READS 4
+#endif
+#ifndef AX12_BATCH_MAX_SERVOS
+#define AX12_BATCH_MAX_SERVOS 8
+#endif
+#ifndef AX12_TOPOLOGY_MAX_SERVOS
+#define AX12_TOPOLOGY_MAX_SERVOS 8
+#endif
+#ifndef AX12_SEQ_MAX_JOINTS
+#define AX12_SEQ_MAX_JOINTS 8
+#endif
+#endif
+
+// SerialHalfDuplex : receive ring, bytes (one is kept free)
+#ifndef AX12_SERIAL_BUF_SIZE
+#define AX12_SERIAL_BUF_SIZE 32 // a whole EEPROM block read, 30 bytes
+#endif
+
+// AX12Bus : instruction packet, bytes
+#ifndef AX12_BUS_PACKET_SIZE
+#define AX12_BUS_PACKET_SIZE 128 // enough for a 4 bytes SYNC_WRITE to 24 servos
+#endif
+
+// AX12Bus : servos followed for missed replies, per bus
+#ifndef AX12_BUS_MAX_QUARANTINE
+#define AX12_BUS_MAX_QUARANTINE 8
+#endif
+
+// AX12MultiBus : number of chains
+#ifndef AX12_MAX_BUSES
+#define AX12_MAX_BUSES 4
+#endif
+
+// AX12Scheduler : requests waiting per bus
+#ifndef AX12_SCHED_QUEUE_SIZE
+#define AX12_SCHED_QUEUE_SIZE 16
+#endif
+
+// AX12ProfileGenerator, AX12Tracker, AX12Transaction : servos handled
+#ifndef AX12_PROFILE_MAX_JOINTS
+#define AX12_PROFILE_MAX_JOINTS 18
+#endif
+#ifndef AX12_TRACKER_MAX_JOINTS
+#define AX12_TRACKER_MAX_JOINTS 18
+#endif
+#ifndef AX12_TRANSACTION_MAX_SERVOS
+#define AX12_TRANSACTION_MAX_SERVOS 18
+#endif
+#ifndef AX12_TRANSACTION_MAX_LENGTH
+#define AX12_TRANSACTION_MAX_LENGTH 8 // bytes staged per servo, 0x1E-0x25 covers goal, speed and torque limit
+#endif
+
+// AX12LoadSampler : servos sampled, filtered samples kept per servo
+#ifndef AX12_LOAD_MAX_JOINTS
+#define AX12_LOAD_MAX_JOINTS 18
+#endif
+#ifndef AX12_LOAD_RING_SIZE
+#define AX12_LOAD_RING_SIZE 16
+#endif
+
+// AX12StallDetector : servos watched
+#ifndef AX12_STALL_MAX_JOINTS
+#define AX12_STALL_MAX_JOINTS 18
+#endif
+
+// AX12Kinematics : legs or arms of 2 or 3 joints
+#ifndef AX12_KIN_MAX_LIMBS
+#define AX12_KIN_MAX_LIMBS 6
+#endif
+
+// AX12Odometry : servos in wheel mode counted
+#ifndef AX12_ODO_MAX_JOINTS
+#define AX12_ODO_MAX_JOINTS 18
+#endif
+
+// AX12Recorder : joints recorded together
+#ifndef AX12_TEACH_MAX_JOINTS
+#define AX12_TEACH_MAX_JOINTS 18
+#endif
+
+// AX12Watcher : watched registers, packets in flight, bytes read by one packet (its reply goes through the serial ring)
+#ifndef AX12_WATCH_MAX
+#define AX12_WATCH_MAX 32
+#endif
+#ifndef AX12_WATCH_MAX_READS
+#define AX12_WATCH_MAX_READS 8
+#endif
+#ifndef AX12_WATCH_MAX_SPAN
+#define AX12_WATCH_MAX_SPAN 16
+#endif
+
+// AX12WriteBatch : most servos with writes held, registers known per servo (8 to 32 bytes)
+#ifndef AX12_BATCH_MAX_SERVOS
+#define AX12_BATCH_MAX_SERVOS 18
+#endif
+#ifndef AX12_BATCH_SPAN
+#define AX12_BATCH_SPAN 32
+#endif
+
+// AX12Topology : servos kept in the cache, 24 bytes each in RAM and in the storage
+#ifndef AX12_TOPOLOGY_MAX_SERVOS
+#define AX12_TOPOLOGY_MAX_SERVOS 32
+#endif
+
+// AX12Sequencer : joints of a sequence
+#ifndef AX12_SEQ_MAX_JOINTS
+#define AX12_SEQ_MAX_JOINTS 18
+#endif
+
+// AX12Log : verbosity kept at compile time (0 leaves the log out, 3 keeps every event), events in the ring
+#ifndef AX12_LOG_LEVEL
+#define AX12_LOG_LEVEL 0
+#endif
+#ifndef AX12_LOG_SIZE
+#define AX12_LOG_SIZE 64
+#endif
+
+// AX12Executor (host, C++20) : tasks running at once
+#ifndef AX12_CORO_MAX_TASKS
+#define AX12_CORO_MAX_TASKS 32
+#endif
+
+// AX12EmulatedBus : servos per emulated chain
+#ifndef AX12_EMU_MAX_SERVOS
+#define AX12_EMU_MAX_SERVOS 32
+#endif
+
+// AX12ServoDynamics (host) : integration step of the motor, threads of AX12_RunSimulations()
+#ifndef AX12_SIM_STEP_US
+#define AX12_SIM_STEP_US 100
+#endif
+#ifndef AX12_SIM_MAX_THREADS
+#define AX12_SIM_MAX_THREADS 64
+#endif
+
+#if AX12_BATCH_SPAN < 8 || AX12_BATCH_SPAN > 32
+#error "AX12_BATCH_SPAN out of range"
+#endif
+
+// A SYNC_WRITE of AX12WriteBatch carries at least one servo : 6 bytes of packet, start and length, ID and span
+#if AX12_BUS_PACKET_SIZE < 6 + 2 + 1 + AX12_BATCH_SPAN
+#error "AX12_BUS_PACKET_SIZE too small for a SYNC_WRITE of AX12_BATCH_SPAN bytes"
+#endif
+
+#if AX12_BUS_PACKET_SIZE < 16 || AX12_SERIAL_BUF_SIZE > 0x7FFF
+#error "AX12_BUS_PACKET_SIZE or AX12_SERIAL_BUF_SIZE out of range"
+#endif
+
+// The status packets read by the library fit in the receive ring whatever the time
+// AX12Bus::Poll() takes to drain it : the 24 bytes of EEPROM of AX12Provision and
+// AX12Topology, a watched range. 6 bytes of header, error and checksum on top.
+#if AX12_SERIAL_BUF_SIZE < 6 + 24 + 1
+#error "AX12_SERIAL_BUF_SIZE smaller than the EEPROM block read by AX12Provision and AX12Topology"
+#endif
+
+#if AX12_SERIAL_BUF_SIZE < 6 + AX12_WATCH_MAX_SPAN + 1
+#error "AX12_SERIAL_BUF_SIZE smaller than a range of AX12_WATCH_MAX_SPAN bytes read by AX12Watcher"
+#endif
+
+#endif
@@ -0,0 +1,290 @@
+/**
+ * @file AX12Coroutine.h
+ * @author joebarteam11
+ * @brief C++20 coroutines over AX12Bus, for host controllers
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ * Only built with -std=c++20 (or later), the header is empty otherwise.
+ */
+#ifndef MBED_AX12COROUTINE_H
+#define MBED_AX12COROUTINE_H
+
+#if defined(__cpp_impl_coroutine) && __cplusplus >= 202002L
+
+#include <coroutine>
+#include <cstddef>
+#include <exception>
+
+#include "AX12Bus.h"
+
+#define AX12_CORO_IDLE 0xFFFFFFFF // AX12Executor::Step() : nothing to wait for
+
+/** Where the coroutine frames of AX12Task come from
+ *
+ * Frames are taken from AX12FrameAllocator::current when the coroutine is
+ * called, from the heap if it is 0. Each frame remembers its allocator, so
+ * the current one can change at any time.
+ */
+class AX12FrameAllocator {
+
+public:
+    virtual ~AX12FrameAllocator() {}
+
+    virtual void *allocate(size_t size) = 0;
+    virtual void deallocate(void *p, size_t size) = 0;
+
+    static inline AX12FrameAllocator *current = 0;
+};
+
+/** Fixed pool of \p COUNT frames of at most \p BLOCK bytes
+ *
+ * Larger frames, or frames asked for when the pool is empty, come from the
+ * heap and are counted in Fallbacks() so the pool can be sized.
+ */
+template <size_t BLOCK, int COUNT>
+class AX12FramePool : public AX12FrameAllocator {
+
+public:
+    AX12FramePool()
+    {
+        _free = 0;
+        for (int i = COUNT - 1; i >= 0; i--) {
+            void **block = (void **)&_arena[i * BLOCK];
+            *block = _free;
+            _free = block;
+        }
+        _used = 0;
+        _peak = 0;
+        _fallbacks = 0;
+    }
+
+    virtual void *allocate(size_t size)
+    {
+        if (size > BLOCK || !_free) {
+            _fallbacks++;
+            return ::operator new(size);
+        }
+        void *p = _free;
+        _free = *(void **)p;
+        _peak = (++_used > _peak) ? _used : _peak;
+        return p;
+    }
+
+    virtual void deallocate(void *p, size_t size)
+    {
+        unsigned char *c = (unsigned char *)p;
+        if (c < _arena || c >= _arena + sizeof(_arena)) {
+            ::operator delete(p, size);
+            return;
+        }
+        *(void **)p = _free;
+        _free = p;
+        _used--;
+    }
+
+    /** @returns frames in use, most frames used at once, frames taken from the heap
+     */
+    int Used(void) { return _used; }
+    int Peak(void) { return _peak; }
+    uint32_t Fallbacks(void) { return _fallbacks; }
+
+private :
+
+    alignas(std::max_align_t) unsigned char _arena[BLOCK * COUNT];
+    void *_free;
+    int _used;
+    int _peak;
+    uint32_t _fallbacks;
+};
+
+/** Coroutine returning a result code (AX12_OK, servo error bits or AX12_ERR_*)
+ *
+ * A task does nothing until it is given to AX12Executor::Spawn() or awaited
+ * by another task, which then gets its co_return value.
+ */
+class AX12Task {
+
+public:
+    struct promise_type {
+        int result = AX12_OK;
+        std::coroutine_handle<> continuation;
+
+        AX12Task get_return_object() { return AX12Task(std::coroutine_handle<promise_type>::from_promise(*this)); }
+        std::suspend_always initial_suspend() noexcept { return {}; }
+
+        struct Final {
+            bool await_ready() noexcept { return false; }
+            std::coroutine_handle<> await_suspend(std::coroutine_handle<promise_type> h) noexcept
+            {
+                std::coroutine_handle<> next = h.promise().continuation;
+                return next ? next : std::noop_coroutine();
+            }
+            void await_resume() noexcept {}
+        };
+        Final final_suspend() noexcept { return {}; }
+
+        void return_value(int r) { result = r; }
+        void unhandled_exception() { std::terminate(); }
+
+        static void *operator new(size_t size);
+        static void operator delete(void *p, size_t size);
+    };
+
+    typedef std::coroutine_handle<promise_type> Handle;
+
+    AX12Task(AX12Task &&other) noexcept : _handle(other._handle) { other._handle = nullptr; }
+    AX12Task(const AX12Task &) = delete;
+    AX12Task &operator=(const AX12Task &) = delete;
+    ~AX12Task();
+
+    // Awaited by another task : run it, then resume the caller with its result
+    bool await_ready() { return !_handle || _handle.done(); }
+    std::coroutine_handle<> await_suspend(std::coroutine_handle<> caller)
+    {
+        _handle.promise().continuation = caller;
+        return _handle;
+    }
+    int await_resume() { return _handle ? _handle.promise().result : AX12_ERR_ARG; }
+
+private :
+
+    friend class AX12Executor;
+
+    explicit AX12Task(Handle h) : _handle(h) {}
+    Handle _handle;
+};
+
+class AX12Executor;
+
+/** One bus transaction or one sleep, awaited by a task
+ *
+ * Made by the functions of AX12Executor, co_await it right away.
+ */
+class AX12Operation {
+
+public:
+    bool await_ready() { return false; }
+    void await_suspend(std::coroutine_handle<> h);
+    int await_resume() { return _result; }
+
+private :
+
+    friend class AX12Executor;
+
+    enum Kind { PING, READ, WRITE, SYNC_WRITE, SLEEP };
+
+    AX12Operation(AX12Executor &executor, Kind kind) : _executor(executor), _kind(kind) {}
+
+    AX12Executor &_executor;
+    Kind _kind;
+    uint8_t _id = 0;
+    uint8_t _start = 0;
+    uint8_t _length = 0;
+    uint8_t *_data = 0;
+    const uint8_t *_source = 0;
+    const uint8_t *_ids = 0;
+    int _count = 0;
+    bool _has_deadline = false;
+    uint32_t _deadline = 0; // latest start of the transaction, or end of the sleep
+    int _result = AX12_OK;
+    std::coroutine_handle<> _handle;
+    AX12Operation *_next = 0;
+};
+
+/** Runs many tasks on one bus, from one thread
+ *
+ * Transactions are started in the order they are awaited, one at a time, and
+ * each task is resumed when its own transaction is over. Step() never blocks:
+ * it can be called from the poll loop of the application (the Linux port
+ * gives its file descriptor with AX12LinuxPort::Fd()), or Run() does the
+ * loop and sleeps in the port between the events.
+ *
+ * Example:
+ * @code
+ * AX12Executor ex(bus);
+ *
+ * AX12Task lift(AX12Executor &ex)
+ * {
+ *     uint8_t goal[2] = {0x00, 0x02};
+ *     uint8_t moving = 1, on = 1;
+ *     co_await ex.Write(1, AX12_REG_GOAL_POSITION, 2, goal);
+ *     while (moving) {
+ *         co_await ex.Sleep(5000);
+ *         if (co_await ex.Read(1, AX12_REG_MOVING, 1, &moving) != AX12_OK) {
+ *             co_return AX12_ERR_TIMEOUT;
+ *         }
+ *     }
+ *     co_return co_await ex.Write(2, AX12_REG_LED, 1, &on);
+ * }
+ *
+ * ex.Spawn(lift(ex));
+ * ex.Run();
+ * @endcode
+ */
+class AX12Executor {
+
+public:
+    AX12Executor(AX12Bus &bus);
+    ~AX12Executor();
+
+    /** Take a task and run it up to its first co_await
+     *
+     * @returns AX12_OK, AX12_ERR_ARG if AX12_CORO_MAX_TASKS tasks are running
+     */
+    int Spawn(AX12Task task);
+
+    /** Awaitable transactions, same parameters as the functions of AX12Bus
+     *
+     * The result is the one of the transaction, or AX12_ERR_DEADLINE if the
+     * bus was not free before \p within_us (0 : no limit).
+     */
+    AX12Operation Ping(int id, uint32_t within_us = 0);
+    AX12Operation Read(int id, int start, int length, uint8_t *data, uint32_t within_us = 0);
+    AX12Operation Write(int id, int start, int length, const uint8_t *data, uint32_t within_us = 0);
+    AX12Operation SyncWrite(int start, int length, const uint8_t *ids, const uint8_t *data, int count,
+                            uint32_t within_us = 0);
+
+    /** Awaitable pause of \p us microseconds, the bus keeps serving the other tasks
+     */
+    AX12Operation Sleep(uint32_t us);
+
+    /** Do everything that is ready, without blocking
+     *
+     * @returns microseconds until the next call is useful, 0 to call again
+     *          at once, AX12_CORO_IDLE if nothing is pending
+     */
+    uint32_t Step(void);
+
+    /** Step() until every task is over, sleeping in between
+     */
+    void Run(void);
+
+    /** @returns number of tasks not over yet
+     */
+    int Tasks(void);
+
+    AX12Bus &Bus(void);
+
+private :
+
+    friend class AX12Operation;
+
+    AX12Bus &_bus;
+    AX12Task::Handle _tasks[AX12_CORO_MAX_TASKS];
+    AX12Operation *_head;     // waiting for the bus
+    AX12Operation *_tail;
+    AX12Operation *_current;  // on the bus
+    AX12Operation *_sleeping;
+    AX12Operation *_ready;    // over, task to resume
+
+    void enqueue(AX12Operation *op);
+    int start(AX12Operation *op);
+    void done(AX12Operation *op, int result);
+};
+
+#endif
+
+#endif
@@ -0,0 +1,235 @@
+/**
+ * @file AX12Emulator.h
+ * @author joebarteam11
+ * @brief Host emulation of a chain of AX12 servos, on a virtual clock
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+#ifndef MBED_AX12EMULATOR_H
+#define MBED_AX12EMULATOR_H
+
+#include "AX12Protocol.h"
+#include "AX12Port.h"
+#include "AX12Clock.h"
+
+#define AX12_EMU_PACKET_SIZE 260 // largest Protocol 1.0 packet (length byte 255)
+
+class AX12EmulatedServo;
+
+/** Physical model of a servo, in place of the ideal one of AX12EmulatedServo::Advance()
+ */
+class AX12ServoPhysics {
+
+public:
+    virtual ~AX12ServoPhysics() {}
+
+    /** Let \p servo move for \p ns nanoseconds, its control table in and out
+     */
+    virtual void Advance(AX12EmulatedServo &servo, uint64_t ns) = 0;
+};
+
+/** Clock that only moves when someone waits on it
+ *
+ * Everything waiting on the same virtual clock shares the same timeline, so a
+ * bus cycle of several milliseconds is emulated in a few microseconds.
+ */
+class AX12VirtualClock : public AX12Clock {
+
+public:
+    AX12VirtualClock();
+
+    virtual uint32_t now_us(void);
+    virtual void wait_us(uint32_t us);
+
+    /** @returns the time elapsed since the creation of the clock, without wrapping
+     */
+    uint64_t Elapsed(void);
+
+private :
+
+    uint64_t _now;
+};
+
+/** Control table of one emulated AX12
+ */
+class AX12EmulatedServo {
+
+public:
+    AX12EmulatedServo();
+
+    /** Restore the factory control table
+     *
+     * @param id ID given to the servo (factory value is 1)
+     */
+    void Reset(int id = 1);
+
+    /** @returns the bus ID of the servo
+     */
+    int Id(void);
+
+    /** @returns the bit rate of the servo, from AX12_REG_BAUD
+     */
+    int Baudrate(void);
+
+    /** @returns the 16 bits register at \p reg
+     */
+    uint16_t Word(int reg);
+    void SetWord(int reg, uint16_t value);
+
+    /** Let the servo move for \p ns nanoseconds of emulated time
+     *
+     * In position mode, with the torque enabled, the servo travels towards
+     * its goal at its moving speed (0 is full speed) and updates its present
+     * position, present speed and moving registers. In wheel mode (both
+     * angle limits at 0) it turns at its moving speed, CW if bit 10 is set,
+     * over 1024 ticks or over a whole turn with dead_zone.
+     *
+     * While it drives, resistance slows it down (it stalls once resistance
+     * reaches the torque limit) and load follows: friction plus resistance.
+     *
+     * With \p physics set, the servo moves as that model says instead (see
+     * AX12ServoDynamics).
+     */
+    void Advance(uint64_t ns);
+
+    uint8_t table[AX12_TABLE_SIZE];
+
+    uint32_t packets;  // instruction packets addressed to this servo
+    float speed_scale; // actual speed / nominal speed of the moving speed register, 1.0 by default
+    uint64_t written;  // emulated time the last write was executed, ns
+
+    // Present load given by each read of AX12_REG_LOAD
+    int load;            // torque on the horn, -1023 (CCW) to 1023 (CW), computed while the servo drives
+    int load_noise;      // uniform noise added, +/- ticks
+    uint32_t load_spikes; // reads per million giving a wrong value anywhere in the range
+    float resistance;    // obstacle against the motion, 0 (free) to 1 (maximum torque)
+
+    bool unplugged;      // off the chain : neither executes nor answers packets
+    uint8_t alarms;      // AX12_ERROR_* bits added to every status packet, set by the physics
+    AX12ServoPhysics *physics; // 0 for the ideal servo above
+
+    // Wheel mode over a whole turn (1228.8 ticks) : in the 60 degrees past 1023 the position reads anything
+    bool dead_zone;
+    double travel;       // ticks turned in wheel mode, CCW positive
+
+private :
+
+    friend class AX12EmulatedBus;
+    friend class AX12ServoDynamics;
+
+    uint32_t _noise;
+    bool _driving;
+    void sampleLoad(void);
+    void samplePosition(void);
+
+    float _position; // present position with the fraction of tick
+
+    uint8_t _registered[AX12_TABLE_SIZE]; // pending REG_WRITE : start, data...
+    int _registered_length;
+};
+
+/** An AX12 chain emulated behind the AX12Port interface
+ *
+ * Packets are executed by the servos when their last byte has been shifted
+ * out, and the status packets come back byte per byte after the return delay
+ * of the servo, all timed from the bit rate and the virtual clock.
+ *
+ * Example:
+ * @code
+ * AX12VirtualClock clock;
+ * AX12EmulatedBus chain(clock, 1000000);
+ * AX12Bus bus(chain, clock);
+ *
+ * chain.Attach(1);
+ * bus.Ping(1); // AX12_OK, clock.Elapsed() is now ~620us
+ * @endcode
+ */
+class AX12EmulatedBus : public AX12Port {
+
+public:
+    /** Create an empty chain
+     *
+     * @param clock virtual clock shared with the AX12Bus driving this chain
+     * @param baud bit rate of the port
+     */
+    AX12EmulatedBus(AX12VirtualClock &clock, int baud = 1000000);
+
+    /** Connect a servo with factory settings to the chain
+     *
+     * @param id ID of the new servo
+     * @returns the servo, 0 if AX12_EMU_MAX_SERVOS is reached
+     */
+    AX12EmulatedServo *Attach(int id);
+
+    /** @returns the servo with ID \p id, 0 if none
+     */
+    AX12EmulatedServo *Servo(int id);
+
+    /** @returns the servo at \p index (0 to Servos() - 1)
+     */
+    AX12EmulatedServo &ServoAt(int index);
+
+    /** @returns number of servos connected
+     */
+    int Servos(void);
+
+    /** Bring the servos and the port up to the time of the clock
+     *
+     * Called by every AX12Port function, call it before looking at the
+     * control tables directly.
+     */
+    void Update(void);
+
+    /** Corrupt bytes on the wire above a bit rate, as a long or badly terminated line does
+     *
+     * A byte sent or received has one bit flipped with a probability rising
+     * linearly from 0 at \p clean_baud to \p ppm per million at 1 Mbps.
+     *
+     * @param clean_baud fastest bit rate without errors, 1000000 (default) for a perfect line
+     * @param ppm byte error rate at 1 Mbps
+     * @param seed start of the pseudo-random sequence, runs are repeatable
+     */
+    void SetLineQuality(int clean_baud, uint32_t ppm, uint32_t seed = 1);
+
+    virtual int send(const uint8_t *data, int length);
+    virtual bool sending(void);
+    virtual int receive(uint8_t *data, int length);
+    virtual void flush(void);
+    virtual int baudrate(void);
+    virtual int set_baudrate(int baud);
+    virtual bool line_error(void);
+
+private :
+
+    AX12VirtualClock &_clock;
+    int _baud;
+    int _clean_baud;
+    uint32_t _noise_ppm;
+    uint32_t _noise;
+    AX12EmulatedServo _servos[AX12_EMU_MAX_SERVOS];
+    int _count;
+
+    uint8_t _tx[AX12_EMU_PACKET_SIZE];
+    int _tx_length;
+    uint64_t _tx_end;
+    bool _pending;
+    bool _line_error; // a byte of the packet sent was corrupted, its echo would differ
+
+    uint8_t _rx[AX12_EMU_PACKET_SIZE];
+    int _rx_length;
+    int _rx_read;
+    uint64_t _rx_start;
+    uint64_t _physics; // time the servos have been advanced to
+
+    void advance(uint64_t until);
+    void corrupt(uint8_t *data, int length);
+    uint64_t byteTime(void);
+    void execute(const uint8_t *packet, int length);
+    int write(AX12EmulatedServo &servo, int start, const uint8_t *data, int length);
+    void reply(AX12EmulatedServo &servo, int error, const uint8_t *params, int count);
+};
+
+#endif
@@ -0,0 +1,153 @@
+/**
+ * @file AX12Estimator.h
+ * @author joebarteam11
+ * @brief Prediction of the servo positions between two reads
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+#ifndef MBED_AX12ESTIMATOR_H
+#define MBED_AX12ESTIMATOR_H
+
+#include "AX12MultiBus.h"
+
+#define AX12_ESTIMATOR_BASE 2.0f        // ticks, compliance margin and rounding of a fresh read
+#define AX12_ESTIMATOR_MIN_ERROR 0.02f  // smallest relative speed error assumed
+#define AX12_ESTIMATOR_INIT_ERROR 0.25f // relative speed error before any learning
+
+/** Position of one servo predicted from its commands
+ *
+ * Between two reads the servo is assumed to travel towards its last goal at
+ * its last moving speed, scaled by a gain learnt from the reads (load and
+ * supply voltage change the actual speed). The uncertainty is the error of
+ * the last read plus the relative speed error times the distance predicted
+ * since, the relative error being learnt from the reads too. Once the servo
+ * has had the time to reach its goal even at the slowest speed assumed, the
+ * uncertainty falls back to AX12_ESTIMATOR_BASE.
+ *
+ * Times are AX12Clock times in microseconds.
+ */
+class AX12Estimator {
+
+public:
+    AX12Estimator();
+
+    /** A new goal and moving speed were sent to the servo
+     *
+     * @param goal goal position, ticks
+     * @param speed moving speed register (0 = full speed)
+     */
+    void Command(uint32_t now, int goal, int speed);
+
+    /** Present position (and speed) read from the servo
+     *
+     * @param position present position, ticks
+     * @param speed present speed register, -1 if not read
+     */
+    void Measure(uint32_t now, int position, int speed = -1);
+
+    /** @returns the predicted position, ticks
+     */
+    float Position(uint32_t now);
+
+    /** @returns the bound of the error of Position(), ticks
+     */
+    float Uncertainty(uint32_t now);
+
+    /** @returns true if a read is needed to keep the error under \p tolerance ticks
+     */
+    bool NeedsRead(uint32_t now, float tolerance);
+
+    /** @returns actual speed / commanded speed learnt from the reads
+     */
+    float Gain(void);
+
+    /** @returns relative speed error learnt from the reads
+     */
+    float Error(void);
+
+private :
+
+    bool _known;       // at least one read
+    float _origin;     // predicted position at _since
+    float _bound;      // uncertainty at _since
+    uint32_t _since;
+    int _goal;
+    float _speed;      // commanded speed, ticks/us (gain not applied)
+    float _gain;
+    float _error;
+
+    // Since the last read
+    float _read;       // position read
+    float _predicted;  // signed travel predicted
+    bool _reached;     // the prediction stopped on a goal
+
+    float travel(uint32_t now, bool *reached);
+    void roll(uint32_t now);
+};
+
+/** Positions of many servos, read only when the prediction is not good enough
+ *
+ * Example:
+ * @code
+ * AX12Tracker tracker(joints, 3.0f);     // +/- 3 ticks
+ * int knee = tracker.Add(5);
+ *
+ * tracker.Command(knee, goal, speed);     // after each goal update
+ * tracker.Refresh();                      // once per cycle, one batch of reads
+ * float p = tracker.Position(knee);       // no bus access
+ * @endcode
+ */
+class AX12Tracker {
+
+public:
+    /** @param joints buses the servos are placed on
+     *  @param tolerance largest error accepted, ticks
+     */
+    AX12Tracker(AX12MultiBus &joints, float tolerance);
+
+    /** Track a servo
+     *
+     * @returns index of the joint, -1 if AX12_TRACKER_MAX_JOINTS is reached
+     */
+    int Add(int id);
+
+    /** Report the goal and moving speed sent to a joint
+     */
+    void Command(int joint, int goal, int speed);
+
+    /** Read every joint whose uncertainty exceeds the tolerance, in one batch
+     *
+     * @returns number of joints read
+     */
+    int Refresh(void);
+
+    /** @returns the position of a joint, read first if the prediction is not good enough
+     */
+    float Position(int joint);
+
+    /** @returns the uncertainty of Position()
+     */
+    float Uncertainty(int joint);
+
+    AX12Estimator &Joint(int joint);
+
+    /** @returns number of servos read since the creation of the tracker
+     */
+    uint32_t Reads(void);
+
+private :
+
+    AX12MultiBus &_joints;
+    float _tolerance;
+    int _count;
+    uint8_t _ids[AX12_TRACKER_MAX_JOINTS];
+    AX12Estimator _estimators[AX12_TRACKER_MAX_JOINTS];
+    uint32_t _reads;
+
+    int read(const bool *selected);
+};
+
+#endif
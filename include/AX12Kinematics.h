@@ -0,0 +1,225 @@
+/**
+ * @file AX12Kinematics.h
+ * @author joebarteam11
+ * @brief Forward and inverse kinematics of legs and arms in fixed point, in servo ticks
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+#ifndef MBED_AX12KINEMATICS_H
+#define MBED_AX12KINEMATICS_H
+
+#include "AX12MultiBus.h"
+
+// Angles are binary : AX12_KIN_TURN for one turn, an int32_t wraps like the angle
+#define AX12_KIN_TURN 65536
+#define AX12_KIN_DEG(deg) ((int32_t)((deg) * (AX12_KIN_TURN / 360.0)))
+
+// sin and cos are Q15 : AX12_KIN_ONE is 1.0
+#define AX12_KIN_ONE 32768
+
+// Lengths and positions are 1/16 mm
+#define AX12_KIN_MM(mm) ((int32_t)((mm) * 16))
+
+// Layouts
+#define AX12_KIN_PLANAR2 0 // 2 pitch joints : femur, tibia, in the x-z plane of the limb
+#define AX12_KIN_LEG3 1    // a yaw joint (coxa), then 2 pitch joints : hexapod leg, 3 DOF arm
+
+/** @returns sin(angle), Q15, from a quarter wave table with interpolation
+ */
+int32_t AX12_Sin(int32_t angle);
+int32_t AX12_Cos(int32_t angle);
+
+/** Angle of a vector, CORDIC in 16 iterations of shifts and adds
+ *
+ * @param magnitude length of the vector, if not 0
+ * @returns angle, -AX12_KIN_TURN / 2 to AX12_KIN_TURN / 2
+ */
+int32_t AX12_Atan2(int64_t y, int64_t x, int64_t *magnitude = 0);
+
+/** Angle of a joint to a number of servo ticks (300 degrees for 1023 ticks), and back
+ */
+int AX12_AngleToTicks(int32_t angle);
+int32_t AX12_TicksToAngle(int ticks);
+
+/** A position, 1/16 mm
+ */
+struct AX12Point {
+    int32_t x; // forward
+    int32_t y; // left
+    int32_t z; // up
+};
+
+/** One leg or arm : a serial chain of 2 or 3 servos
+ *
+ * The limb is mounted on the body at an origin and a yaw, its x axis points
+ * outwards at a coxa angle of 0 and its pitch joints turn in the vertical
+ * plane of the limb: the femur angle is counted from the horizontal, the
+ * tibia angle from the femur, up positive. Each joint is at angle 0 at its
+ * center tick (512 by default) and may be mounted reversed.
+ *
+ * Forward() and Inverse() take and give body frame positions and servo
+ * ticks. The inverse is analytical: the coxa turns towards the target, then
+ * the law of cosines gives the knee from the half angle tangent, all in
+ * integers and square roots. There is no division by a length and no
+ * floating point.
+ */
+class AX12Limb {
+
+public:
+    AX12Limb();
+
+    /** @param layout AX12_KIN_PLANAR2 or AX12_KIN_LEG3
+     *  @param coxa length from the yaw axis to the femur joint, ignored by AX12_KIN_PLANAR2
+     *  @param femur, tibia lengths of the two pitch segments, AX12_KIN_MM()
+     */
+    void SetLayout(int layout, int32_t coxa, int32_t femur, int32_t tibia);
+
+    /** Place the limb on the body
+     *
+     * @param origin position of its first joint in the body frame
+     * @param yaw direction of its x axis, AX12_KIN_DEG()
+     */
+    void SetMount(const AX12Point &origin, int32_t yaw);
+
+    /** Bend of the knee in the inverse : down (tibia below the femur, default) or up
+     */
+    void SetKneeUp(bool up);
+
+    /** Servo of a joint
+     *
+     * @param joint 0 to Joints() - 1, from the body outwards
+     * @param center tick at which the joint is at angle 0
+     * @param reversed true if the servo turns CW for a positive angle
+     * @param min, max ticks the joint may reach
+     */
+    void SetJoint(int joint, int id, int center = 512, bool reversed = false, int min = 0, int max = 1023);
+
+    /** @returns number of joints of the layout
+     */
+    int Joints(void);
+
+    /** @returns ID of the servo of a joint
+     */
+    int Id(int joint);
+
+    /** Position of the end of the limb
+     *
+     * @param ticks present position of each joint
+     * @param end position in the body frame
+     */
+    void Forward(const uint16_t *ticks, AX12Point &end);
+
+    /** Goal of each joint to put the end of the limb at a position
+     *
+     * @param end position in the body frame
+     * @param ticks goal of each joint, untouched unless AX12_OK
+     * @returns AX12_OK, AX12_ERROR_RANGE if out of reach, AX12_ERROR_ANGLE if a joint would leave its limits
+     */
+    int Inverse(const AX12Point &end, uint16_t *ticks);
+
+private :
+
+    struct Joint {
+        uint8_t id;
+        bool reversed;
+        int16_t center;
+        int16_t min;
+        int16_t max;
+    };
+
+    uint8_t _layout;
+    bool _knee_up;
+    int32_t _coxa;
+    int32_t _femur;
+    int32_t _tibia;
+    AX12Point _origin;
+    int32_t _cos; // of the yaw of the mount, Q15
+    int32_t _sin;
+    Joint _joints[3];
+
+    int angle(int joint, int ticks);
+};
+
+/** All the limbs of a robot, solved together and sent in one SYNC_WRITE per bus
+ *
+ * Example:
+ * @code
+ * AX12Kinematics body(joints);
+ * AX12Limb leg;
+ * AX12Point origin = {AX12_KIN_MM(60), AX12_KIN_MM(40), 0};
+ *
+ * leg.SetLayout(AX12_KIN_LEG3, AX12_KIN_MM(52), AX12_KIN_MM(66), AX12_KIN_MM(133));
+ * leg.SetMount(origin, AX12_KIN_DEG(45));
+ * leg.SetJoint(0, 1);
+ * leg.SetJoint(1, 2);
+ * leg.SetJoint(2, 3, 512, true);
+ * body.Add(leg);                // ... 6 legs
+ *
+ * while (true) {
+ *     gait(feet);               // AX12Point feet[6], body frame
+ *     body.Tick(feet);          // 18 goals, one SYNC_WRITE per bus
+ *     ThisThread::sleep_for(10ms);
+ * }
+ * @endcode
+ */
+class AX12Kinematics {
+
+public:
+    /** @param joints buses the servos are placed on
+     */
+    AX12Kinematics(AX12MultiBus &joints);
+
+    /** Add a limb, copied
+     *
+     * @returns index of the limb, -1 if AX12_KIN_MAX_LIMBS is reached
+     */
+    int Add(const AX12Limb &limb);
+
+    AX12Limb &Limb(int limb);
+
+    /** Solve the inverse of every limb
+     *
+     * A limb that can not reach its target keeps its previous goals.
+     *
+     * @param ends target of each limb, body frame
+     * @returns number of limbs solved
+     */
+    int Solve(const AX12Point *ends);
+
+    /** Send the goals of every limb solved at least once, one SYNC_WRITE per bus
+     */
+    int Send(void);
+
+    /** Solve() then Send()
+     *
+     * @returns result of the SYNC_WRITE
+     */
+    int Tick(const AX12Point *ends);
+
+    /** @returns result of the last Inverse() of a limb
+     */
+    int Result(int limb);
+
+    /** Goals of the joints, limb after limb, in the order of the joints
+     */
+    int Joints(void);
+    const uint8_t *Ids(void);
+    const uint16_t *Goals(void);
+
+private :
+
+    AX12MultiBus &_joints;
+    AX12Limb _limbs[AX12_KIN_MAX_LIMBS];
+    int8_t _results[AX12_KIN_MAX_LIMBS];
+    uint8_t _first[AX12_KIN_MAX_LIMBS];  // index of the first joint of each limb
+    bool _solved[AX12_KIN_MAX_LIMBS];
+    int _count;
+    int _joint_count;
+    uint8_t _ids[3 * AX12_KIN_MAX_LIMBS];
+    uint16_t _goals[3 * AX12_KIN_MAX_LIMBS];
+};
+
+#endif
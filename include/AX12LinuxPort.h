@@ -0,0 +1,96 @@
+/**
+ * @file AX12LinuxPort.h
+ * @author joebarteam11
+ * @brief AX12Port on a Linux tty (USB-serial half duplex adapter)
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+#ifndef MBED_AX12LINUXPORT_H
+#define MBED_AX12LINUXPORT_H
+
+#if defined(__linux__)
+
+#include "AX12Port.h"
+
+// Options of AX12LinuxPort::Open()
+#define AX12_LINUX_LOW_LATENCY 0x1 // ASYNC_LOW_LATENCY and 1 ms latency timer of the FTDI adapters
+#define AX12_LINUX_ECHO 0x2        // the adapter sends back every byte written, drop them
+
+#define AX12_LINUX_PACKET_SIZE 260 // largest Protocol 1.0 packet (length byte 255)
+
+/** Linux serial port in raw mode, for AX12Bus
+ *
+ * A packet is handed to the kernel in one write(), the replies are read
+ * without blocking, and wait() sleeps in ppoll() until a byte comes in or the
+ * deadline of the transaction, so AX12Bus::Wait() does not spin.
+ *
+ * The standard rates use the usual termios speeds, the others (the rates of
+ * AX12_BaudFromCode() such as 117647 bps) are set with BOTHER.
+ *
+ * Use it with AX12Clock::system(), the time base of the kernel.
+ *
+ * Example:
+ * @code
+ * AX12LinuxPort tty;
+ * tty.Open("/dev/ttyUSB0", 1000000, AX12_LINUX_LOW_LATENCY);
+ * AX12Bus bus(tty);
+ * bus.Ping(1);
+ * @endcode
+ */
+class AX12LinuxPort : public AX12Port {
+
+public:
+    AX12LinuxPort();
+    virtual ~AX12LinuxPort();
+
+    /** Open and configure a tty
+     *
+     * @param path device, /dev/ttyUSB0...
+     * @param baud bit rate, up to 1000000
+     * @param options AX12_LINUX_* flags
+     * @returns AX12_OK, AX12_ERR_ARG if the device cannot be opened or
+     *          configured (errno tells why)
+     */
+    int Open(const char *path, int baud, int options = 0);
+
+    void Close(void);
+
+    /** Change the bit rate of an open port
+     */
+    int SetBaudrate(int baud);
+
+    /** @returns the file descriptor, -1 if closed
+     */
+    int Fd(void);
+
+    virtual int send(const uint8_t *data, int length);
+    virtual bool sending(void);
+    virtual int receive(uint8_t *data, int length);
+    virtual void flush(void);
+    virtual int baudrate(void);
+    virtual int set_baudrate(int baud);
+    virtual bool wait(uint32_t us);
+    virtual uint32_t latency(void);
+
+private :
+
+    int _fd;
+    int _baud;
+    int _options;
+
+    const uint8_t *_tx;
+    int _tx_length;
+    int _tx_written;
+    uint64_t _tx_end; // ns, CLOCK_MONOTONIC, last bit out of the adapter
+    int _echo;        // bytes of local echo still to drop
+
+    void lowLatency(const char *path);
+    uint64_t now(void);
+};
+
+#endif
+
+#endif
@@ -0,0 +1,176 @@
+/**
+ * @file AX12Load.h
+ * @author joebarteam11
+ * @brief Load (torque) sampling of many servos, filtered and decimated in fixed point
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+#ifndef MBED_AX12LOAD_H
+#define MBED_AX12LOAD_H
+
+#include "AX12MultiBus.h"
+
+#define AX12_LOAD_MEDIAN_MAX 7 // largest median window
+
+/** One filtered load value
+ */
+struct AX12LoadSample {
+    uint32_t time; // AX12Clock time of the last raw sample it includes, us
+    int16_t load;  // -1023 (CCW) to 1023 (CW)
+};
+
+/** Median, then exponential average, then decimation, on integers only
+ *
+ * The median drops the isolated wrong values the servos sometimes return,
+ * the average (y += (x - y) / 2^shift, 8 bits of fraction) smooths the noise
+ * and the decimation keeps one output every \p decimation samples.
+ */
+class AX12LoadFilter {
+
+public:
+    AX12LoadFilter();
+
+    /** @param median window of the median, odd, 1 (no median) to AX12_LOAD_MEDIAN_MAX
+     *  @param shift weight of a new sample in the average is 1 / 2^shift, 0 for no average
+     *  @param decimation samples per output
+     */
+    void Configure(int median, int shift, int decimation);
+
+    /** Forget the samples, the next one starts the filter again
+     */
+    void Reset(void);
+
+    /** Filter a raw sample
+     *
+     * @param load signed load, see AX12_LoadFromRegister()
+     * @param output filtered value, set when the function returns true
+     * @returns true when the decimation gives an output
+     */
+    bool Push(int load, int &output);
+
+    /** @returns the output of the average, updated by every sample
+     */
+    int Value(void);
+
+private :
+
+    int16_t _window[AX12_LOAD_MEDIAN_MAX];
+    uint8_t _median;
+    uint8_t _filled;
+    uint8_t _next;
+    uint8_t _shift;
+    uint16_t _decimation;
+    uint16_t _phase;
+    bool _primed;
+    int32_t _average; // 8 bits of fraction
+};
+
+/** Samples the present load of many servos as fast as the bus budget allows
+ *
+ * Each Poll() that is due reads AX12_REG_LOAD of every servo in one batch
+ * (in parallel on the buses), decodes the direction bit and pushes each
+ * sample through the filter of its servo. The decimated outputs are kept in
+ * a ring of AX12_LOAD_RING_SIZE values per servo, read at the pace of the
+ * consumer with Pop(); the oldest ones are overwritten if it is too slow.
+ * Latest() gives the output of the average at once, for the lowest latency.
+ *
+ * The next batch is due when the previous one has used the share of the bus
+ * time given by SetBudget(): at 100 % the reads run back to back.
+ *
+ * Example:
+ * @code
+ * AX12LoadSampler loads(joints);
+ * int gripper = loads.Add(7);
+ * AX12LoadSample s;
+ *
+ * loads.SetFilter(5, 2, 4);        // median of 5, average 1/4, 1 output every 4 samples
+ * loads.SetBudget(50);             // half of the bus time
+ * while (true) {
+ *     loads.Poll();                // from the control loop
+ *     while (loads.Pop(gripper, s)) {
+ *         printf("%lu : %d\n", s.time, s.load);
+ *     }
+ * }
+ * @endcode
+ */
+class AX12LoadSampler {
+
+public:
+    /** @param joints buses the servos are placed on
+     */
+    AX12LoadSampler(AX12MultiBus &joints);
+
+    /** Sample a servo
+     *
+     * @returns index of the joint, -1 if AX12_LOAD_MAX_JOINTS is reached
+     */
+    int Add(int id);
+
+    /** Filter of every joint, see AX12LoadFilter::Configure() (default 3, 2, 4)
+     */
+    void SetFilter(int median, int shift, int decimation);
+    AX12LoadFilter &Filter(int joint);
+
+    /** Share of the bus time used by the sampling, 1 to 100 %
+     */
+    void SetBudget(int percent);
+
+    /** Read every joint once if the budget allows it
+     *
+     * @returns number of joints read, 0 if not due yet
+     */
+    int Poll(void);
+
+    /** @returns time until the next batch is due, us
+     */
+    uint32_t Due(void);
+
+    /** @returns filtered outputs waiting in the ring of a joint
+     */
+    int Available(int joint);
+
+    /** Take the oldest filtered output of a joint
+     *
+     * @returns false if there is none
+     */
+    bool Pop(int joint, AX12LoadSample &sample);
+
+    /** @returns the output of the average of a joint, updated by every sample
+     */
+    int Latest(int joint);
+
+    /** @returns batches per second measured over the last batches
+     */
+    uint32_t Rate(void);
+
+    uint32_t Samples(void);  // raw samples received
+    uint32_t Errors(void);   // reads without reply
+    uint32_t Overruns(void); // outputs overwritten before Pop()
+
+private :
+
+    struct Ring {
+        AX12LoadSample samples[AX12_LOAD_RING_SIZE];
+        uint8_t head;
+        uint8_t count;
+    };
+
+    AX12MultiBus &_joints;
+    int _count;
+    uint8_t _ids[AX12_LOAD_MAX_JOINTS];
+    AX12LoadFilter _filters[AX12_LOAD_MAX_JOINTS];
+    Ring _rings[AX12_LOAD_MAX_JOINTS];
+    int _budget;
+    bool _started;
+    uint32_t _last;   // start of the last batch
+    uint32_t _next;
+    uint32_t _period; // average time between two batches, us, 4 bits of fraction
+    uint32_t _samples;
+    uint32_t _errors;
+    uint32_t _overruns;
+};
+
+#endif
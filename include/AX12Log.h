@@ -0,0 +1,155 @@
+/**
+ * @file AX12Log.h
+ * @author joebarteam11
+ * @brief Binary event log, recorded in RAM from the hot path and formatted later
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+#ifndef MBED_AX12LOG_H
+#define MBED_AX12LOG_H
+
+#include <stdint.h>
+
+#include "AX12Config.h"
+#include "AX12Clock.h"
+
+// Verbosity, compile time (AX12_LOG_LEVEL) and run time (AX12Log::SetLevel())
+#define AX12_LOG_OFF 0
+#define AX12_LOG_ERROR 1 // failed transactions, quarantine
+#define AX12_LOG_INFO 2  // commands of the AX12 class
+#define AX12_LOG_DEBUG 3 // every read and write of the AX12 class, with its result
+
+// Events : the servo ID, a 16 bits argument and a 32 bits value each
+enum AX12LogEvent {
+    AX12_EV_NONE = 0,
+    AX12_EV_BUS_FAILED,    // id, instruction, result
+    AX12_EV_QUARANTINE,    // id, failures, back-off (us)
+    AX12_EV_FACTORY_RESET, // id
+    AX12_EV_SET_BAUD,      // id, baud code
+    AX12_EV_SET_ID,        // current id, new id
+    AX12_EV_SET_GOAL,      // id, goal (ticks)
+    AX12_EV_SET_CW_LIMIT,  // id, limit (ticks)
+    AX12_EV_SET_CCW_LIMIT, // id, limit (ticks)
+    AX12_EV_SET_TORQUE,    // id, on
+    AX12_EV_SET_MAX_TORQUE, // id, limit
+    AX12_EV_TRIGGER,       // broadcast ACTION
+    AX12_EV_LOAD,          // id, 0, load (CCW negative)
+    AX12_EV_READ,          // id, start | bytes << 8
+    AX12_EV_READ_DONE,     // id, first two bytes, result
+    AX12_EV_WRITE,         // id, start | bytes << 8, flag
+    AX12_EV_WRITE_DONE,    // id, 0, result
+    AX12_EV_COUNT
+};
+
+/** One event of the log, 16 bytes, the same on the board and on a host
+ */
+struct AX12LogEntry {
+    uint32_t seq;   // position in the log + 1, 0 while being written
+    uint32_t time;  // us, clock of the log
+    uint8_t event;  // AX12LogEvent
+    uint8_t id;
+    uint16_t arg;
+    int32_t value;
+};
+
+/** Event log of the library, replacing the printf of the AX12_*_DEBUG flags
+ *
+ * A record is a few stores into a ring of AX12_LOG_SIZE entries: no
+ * formatting, no lock, no blocking, safe from interrupts and from several
+ * threads (one atomic increment reserves the slot). When the ring is full
+ * the oldest events are overwritten, Lost() counts the ones a reader
+ * missed. Read() takes the events out from a single reader, a low priority
+ * thread or the idle time of the main loop, and Format() turns them into
+ * text. The entries can as well be sent raw and formatted on a host, with
+ * the same Format().
+ *
+ * AX12_LOG_LEVEL chooses at compile time what is kept: the AX12_LOG() of a
+ * higher level compile to nothing, and with 0 (the default) the log is
+ * left out. SetLevel() lowers it at run time.
+ *
+ * Example:
+ * @code
+ * // -DAX12_LOG_LEVEL=3
+ * AX12Log::system().SetLevel(AX12_LOG_ERROR);
+ * ...
+ * AX12LogEntry entries[8];
+ * char text[64];
+ * int n = AX12Log::system().Read(entries, 8);   // low priority thread
+ * for (int i = 0; i < n; i++) {
+ *     AX12Log::Format(entries[i], text, sizeof(text));
+ *     printf("%s\n", text);
+ * }
+ * @endcode
+ */
+class AX12Log {
+
+public:
+    AX12Log();
+
+    /** @returns the log the library records into
+     */
+    static AX12Log &system(void);
+
+    /** Keep the events up to \p level, AX12_LOG_OFF to keep none
+     */
+    void SetLevel(int level);
+
+    int Level(void)
+    {
+        return _level;
+    }
+
+    /** Time stamp the events on \p clock instead of the system clock (emulator)
+     */
+    void SetClock(AX12Clock &clock);
+
+    /** Add an event, from any context
+     */
+    void Record(uint8_t event, uint8_t id, uint16_t arg, int32_t value);
+
+    /** Take out the events recorded since the last call, oldest first
+     *
+     * @returns number of entries copied to \p entries
+     */
+    int Read(AX12LogEntry *entries, int max);
+
+    /** @returns events overwritten before Read() took them
+     */
+    uint32_t Lost(void);
+
+    /** Events recorded so far
+     */
+    uint32_t Recorded(void);
+
+    /** Write an entry as text: time, event and arguments
+     *
+     * @returns the length of the text, as snprintf()
+     */
+    static int Format(const AX12LogEntry &entry, char *text, int size);
+
+private :
+
+    AX12LogEntry _ring[AX12_LOG_SIZE];
+    volatile uint32_t _head; // events reserved
+    uint32_t _tail;          // next event to read
+    uint32_t _lost;
+    volatile uint8_t _level;
+    AX12Clock *_clock;
+};
+
+#if AX12_LOG_LEVEL > 0
+#define AX12_LOG(level, event, id, arg, value)                                                          \
+    do {                                                                                                \
+        AX12Log &ax12_log = AX12Log::system();                                                          \
+        if ((level) <= AX12_LOG_LEVEL && (level) <= ax12_log.Level()) {                                 \
+            ax12_log.Record((event), (uint8_t)(id), (uint16_t)(arg), (int32_t)(value));                 \
+        }                                                                                               \
+    } while (0)
+#else
+#define AX12_LOG(level, event, id, arg, value) do {} while (0)
+#endif
+
+#endif
@@ -0,0 +1,131 @@
+/**
+ * @file AX12MultiBus.h
+ * @author joebarteam11
+ * @brief Several AX12 chains driven in parallel from one controller
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+#ifndef MBED_AX12MULTIBUS_H
+#define MBED_AX12MULTIBUS_H
+
+#include "AX12Bus.h"
+
+#define AX12_UNPLACED 0xFF
+
+/** Controller of up to AX12_MAX_BUSES chains, each on its own UART
+ *
+ * Every servo ID is placed on one bus. A call on a set of servos is split into
+ * one packet (or one sequence of packets) per bus, and all the buses are
+ * driven at the same time: the cycle takes as long as the busiest bus instead
+ * of the sum of all of them.
+ *
+ * Example:
+ * @code
+ * SerialHalfDuplex left(PA_9, PA_10, 1000000);
+ * SerialHalfDuplex right(PA_2, PA_3, 1000000);
+ * AX12Bus bus0(left), bus1(right);
+ * AX12MultiBus joints;
+ *
+ * joints.AddBus(bus0);
+ * joints.AddBus(bus1);
+ * joints.Balance(ids, 18);          // 9 servos per bus
+ * joints.SetGoals(ids, goals, 18);  // one SYNC_WRITE on each bus, sent together
+ * @endcode
+ */
+class AX12MultiBus {
+
+public:
+    /** Create a controller with no bus
+     *
+     * @param clock time base used while waiting for the buses
+     */
+    AX12MultiBus(AX12Clock &clock = AX12Clock::system());
+
+    /** Add a bus
+     *
+     * @returns index of the bus, or -1 if AX12_MAX_BUSES is reached
+     */
+    int AddBus(AX12Bus &bus);
+
+    /** @returns number of buses
+     */
+    int Buses(void);
+
+    /** @returns the bus at \p index
+     */
+    AX12Bus &Bus(int index);
+
+    /** @returns the time base of the controller
+     */
+    AX12Clock &Clock(void);
+
+    /** Place a servo on a bus
+     *
+     * @param id servo ID 0-253
+     * @param bus index of the bus, AX12_UNPLACED to remove the servo
+     */
+    int Place(int id, int bus);
+
+    /** @returns index of the bus of a servo, -1 if it is not placed
+     */
+    int BusOf(int id);
+
+    /** Spread servos over the buses so that each one carries the same load
+     *
+     * Servos are placed heaviest first on the least loaded bus.
+     *
+     * @param ids servos to place
+     * @param count number of servos
+     * @param weights relative cost of each servo (bytes per cycle...), 0 for the same cost
+     */
+    int Balance(const uint8_t *ids, int count, const uint8_t *weights = 0);
+
+    /** Write the same registers of many servos, one SYNC_WRITE per bus
+     *
+     * @param start first register
+     * @param length bytes per servo
+     * @param ids IDs of the servos
+     * @param data \p count blocks of \p length bytes, in the order of \p ids
+     * @param count number of servos
+     * @returns AX12_OK, AX12_ERR_ARG if a servo is on no bus (the others are written), or the first error of a bus
+     */
+    int SyncWrite(int start, int length, const uint8_t *ids, const uint8_t *data, int count);
+
+    /** Update the goal position of many servos
+     *
+     * @param goals goal positions in ticks (0-1023)
+     */
+    int SetGoals(const uint8_t *ids, const uint16_t *goals, int count);
+
+    /** Read the same registers of many servos, the buses being read in parallel
+     *
+     * @param start first register
+     * @param length bytes per servo
+     * @param ids IDs of the servos
+     * @param data \p count blocks of \p length bytes, in the order of \p ids
+     * @param results per servo result (error byte or AX12_ERR_*), may be 0
+     * @param count number of servos
+     * @returns number of servos read without error
+     */
+    int ReadAll(int start, int length, const uint8_t *ids, uint8_t *data, int *results, int count);
+
+    /** Read the present position of many servos, in ticks
+     */
+    int GetPositions(const uint8_t *ids, uint16_t *positions, int count);
+
+private :
+
+    friend class AX12Transaction;
+
+    AX12Clock &_clock;
+    AX12Bus *_buses[AX12_MAX_BUSES];
+    int _count;
+    uint8_t _placement[AX12_BROADCAST_ID];
+
+    uint32_t step(void);
+};
+
+#endif
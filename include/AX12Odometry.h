@@ -0,0 +1,147 @@
+/**
+ * @file AX12Odometry.h
+ * @author joebarteam11
+ * @brief Distance turned by servos in wheel mode, across the dead zone of the position
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+#ifndef MBED_AX12ODOMETRY_H
+#define MBED_AX12ODOMETRY_H
+
+#include "AX12MultiBus.h"
+
+#ifndef AX12_ODO_TURN
+#define AX12_ODO_TURN 12288 // one turn of the horn, 1/10 tick (1023 ticks for 300 degrees)
+#endif
+
+#ifndef AX12_ODO_STEP
+#define AX12_ODO_STEP 256 // ticks a servo may turn between two reads
+#endif
+
+#ifndef AX12_ODO_MIN_US
+#define AX12_ODO_MIN_US 5000 // shortest period between two reads of a servo
+#endif
+
+#ifndef AX12_ODO_MAX_US
+#define AX12_ODO_MAX_US 500000 // period of a stopped servo, to see it turned by hand
+#endif
+
+#ifndef AX12_ODO_MARGIN
+#define AX12_ODO_MARGIN 32 // ticks on each side of the dead zone where a read is not trusted
+#endif
+
+/** Odometry of servos in wheel mode (AX12::SetMode(1))
+ *
+ * The position register only covers 300 degrees of the turn: in the other
+ * 60 it reads anything. Each servo is read often enough to see it a few
+ * times per turn (every AX12_ODO_STEP ticks at its speed), the turns are
+ * counted by choosing, among the readings one turn apart, the one the
+ * commanded speed predicts. The reads predicted in or near the dead zone
+ * are dropped, and a read far from the prediction is only trusted if the
+ * next one confirms it.
+ *
+ * The commanded speed (given with SetSpeed() or Command()) times a gain
+ * learnt from the trusted reads fills the gaps: Ticks() is extrapolated
+ * between reads and across the dead zone. A stopped servo is read every
+ * AX12_ODO_MAX_US only, so slow axes cost almost no bus time.
+ *
+ * Directions follow the position register: CCW (positive speed) counts up.
+ *
+ * Example:
+ * @code
+ * AX12Odometry odometry(joints);
+ * int belt = odometry.Add(4);
+ *
+ * odometry.SetSpeed(belt, 0.5);     // AX12::SetCRSpeed(0.5)
+ * while (true) {
+ *     odometry.Poll();              // from the control loop
+ *     printf("%lld ticks, %.0f ticks/s\n", odometry.Ticks(belt), odometry.Velocity(belt));
+ * }
+ * @endcode
+ */
+class AX12Odometry {
+
+public:
+    /** @param joints buses the servos are placed on
+     */
+    AX12Odometry(AX12MultiBus &joints);
+
+    /** Count the turns of a servo
+     *
+     * @returns index of the joint, -1 if AX12_ODO_MAX_JOINTS is reached
+     */
+    int Add(int id);
+
+    /** Turn a joint, same value as AX12::SetCRSpeed()
+     *
+     * @param speed -1.0 (CW) to 1.0 (CCW), 0 to stop
+     * @returns the result of the write
+     */
+    int SetSpeed(int joint, float speed);
+
+    /** Report a speed written by other means, AX12_REG_MOVING_SPEED value
+     */
+    void Command(int joint, int speed);
+
+    /** Read the servos that are due
+     *
+     * @returns number of servos read, 0 if none was due
+     */
+    int Poll(void);
+
+    /** @returns time until the next read is due, us
+     */
+    uint32_t Due(void);
+
+    /** @returns ticks turned since Add(), extrapolated to now, 64 bits
+     */
+    int64_t Ticks(int joint);
+
+    /** @returns ticks turned at the last trusted read
+     */
+    int64_t Measured(int joint);
+
+    /** @returns velocity measured between the trusted reads, ticks/s
+     */
+    float Velocity(int joint);
+
+    /** @returns actual speed / commanded speed, learnt
+     */
+    float Gain(int joint);
+
+    uint32_t Reads(void);    // servos read
+    uint32_t Rejected(void); // reads not trusted : dead zone, no reply, far from the prediction
+
+private :
+
+    struct Joint {
+        uint8_t id;
+        bool known;       // a first read was trusted
+        bool suspect;     // the previous read was far from the prediction
+        int16_t command;  // signed moving speed, CCW positive
+        int16_t gain;     // Q12
+        uint16_t position; // last trusted read, ticks
+        int64_t count;    // 1/10 tick
+        int32_t velocity; // 1/10 tick/s
+        int32_t carried;  // travel predicted at the previous speeds since the last trusted read, 1/10 tick
+        uint32_t time;    // of the last trusted read
+        uint32_t since;   // of the last trusted read or speed change
+        uint32_t next;
+    };
+
+    AX12MultiBus &_joints;
+    Joint _list[AX12_ODO_MAX_JOINTS];
+    int _count;
+    uint32_t _reads;
+    uint32_t _rejected;
+
+    int32_t speed(const Joint &j);
+    int64_t predict(const Joint &j, uint32_t now);
+    void update(Joint &j, int position, uint32_t now);
+    void schedule(Joint &j, uint32_t now);
+};
+
+#endif
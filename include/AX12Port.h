@@ -0,0 +1,81 @@
+/**
+ * @file AX12Port.h
+ * @author joebarteam11
+ * @brief Byte transport of one half-duplex Dynamixel chain
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+#ifndef MBED_AX12PORT_H
+#define MBED_AX12PORT_H
+
+#include <stdint.h>
+
+/** Non-blocking byte transport used by AX12Bus
+ *
+ * SerialHalfDuplex implements it on the STM32 boards, the emulator implements
+ * it on a host. Every call returns immediately so that one thread can drive
+ * several chains at once.
+ */
+class AX12Port {
+
+public:
+    virtual ~AX12Port() {}
+
+    /** Start the transmission of a packet
+     *
+     * @param data bytes to send, must stay valid until sending() returns false
+     * @param length number of bytes
+     * @returns length, or a negative value if the port is busy
+     */
+    virtual int send(const uint8_t *data, int length) = 0;
+
+    /** @returns true while the last packet is still being shifted out
+     */
+    virtual bool sending(void) = 0;
+
+    /** Copy the received bytes
+     *
+     * @param data destination buffer
+     * @param length size of the destination buffer
+     * @returns number of bytes copied (0 if nothing was received)
+     */
+    virtual int receive(uint8_t *data, int length) = 0;
+
+    /** Drop everything received so far
+     */
+    virtual void flush(void) = 0;
+
+    /** @returns the bit rate of the port in bps
+     */
+    virtual int baudrate(void) = 0;
+
+    /** Change the bit rate of the port
+     *
+     * @returns 0, or a negative value if the port cannot run at \p baud
+     */
+    virtual int set_baudrate(int baud) { (void)baud; return -1; }
+
+    /** Sleep until a byte is received, the packet is sent or \p us elapsed
+     *
+     * Ports that cannot sleep on their own return false at once, the caller
+     * then waits on its clock.
+     *
+     * @returns true if the port waited
+     */
+    virtual bool wait(uint32_t us) { (void)us; return false; }
+
+    /** @returns true if the line was disturbed since the last send(): the echo
+     *           of a byte sent differed from it (collision, framing error) or
+     *           received bytes were lost (overrun). Ports that cannot tell return false.
+     */
+    virtual bool line_error(void) { return false; }
+
+    /** @returns longest delay between a byte leaving the wire and receive() returning it, us
+     */
+    virtual uint32_t latency(void) { return 0; }
+};
+
+#endif
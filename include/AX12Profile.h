@@ -0,0 +1,160 @@
+/**
+ * @file AX12Profile.h
+ * @author joebarteam11
+ * @brief Trapezoidal and S-curve velocity profiles streamed to the servos
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+#ifndef MBED_AX12PROFILE_H
+#define MBED_AX12PROFILE_H
+
+#include "AX12MultiBus.h"
+
+#define AX12_PROFILE_TRAPEZOID 0
+#define AX12_PROFILE_SCURVE 1
+
+// Headroom given to the servo over the speed of the profile : speed + speed / 8 + AX12_PROFILE_MIN_SPEED
+#define AX12_PROFILE_MIN_SPEED 8
+
+/** Motion profile of one joint, from its current position to a target
+ *
+ * The move is planned once (a few floating point operations), then every
+ * Step() gives the goal position and moving speed of the next control tick.
+ * Steps only use integer arithmetic on Q16 ticks : the position in the
+ * acceleration and deceleration phases is a closed form of the tick number
+ * (trapezoid) or an interpolation in a precomputed table of the jerk limited
+ * S ramp, and the cruise phase is linear.
+ *
+ * The phases last a whole number of ticks and the cruise speed is adjusted
+ * so that the last step lands exactly on the target, the limits given to
+ * Plan() are never exceeded.
+ *
+ * Units are those of the control table : ticks (0-1023, 0.29 degree) for
+ * positions, ticks/s, ticks/s^2 and ticks/s^3 for the limits.
+ */
+class AX12Profile {
+
+public:
+    AX12Profile();
+
+    /** Plan a move
+     *
+     * @param from current position, ticks
+     * @param to target position, ticks
+     * @param velocity max velocity, ticks/s
+     * @param acceleration max acceleration, ticks/s^2
+     * @param jerk max jerk for an S-curve, ticks/s^3, 0 for a trapezoid
+     * @param period_us period of the control tick
+     */
+    void Plan(int from, int to, float velocity, float acceleration, float jerk, uint32_t period_us);
+
+    /** Compute the set point of the next tick
+     *
+     * @param goal goal position to send, ticks
+     * @param speed moving speed to send (AX12_REG_MOVING_SPEED units, never 0)
+     * @returns false if the move was already over (outputs untouched)
+     */
+    bool Step(uint16_t *goal, uint16_t *speed);
+
+    /** @returns true until the last step has been given
+     */
+    bool Moving(void);
+
+    /** @returns duration of the move in ticks
+     */
+    int Duration(void);
+
+    /** @returns position reached by the last step, ticks
+     */
+    int Position(void);
+
+    /** @returns moving speed sent with the last step
+     */
+    int Speed(void);
+
+    int Target(void);
+    int Type(void);
+
+private :
+
+    int32_t _from;      // Q16 ticks
+    int32_t _distance;  // Q16 ticks, always >= 0
+    int8_t _direction;
+    uint8_t _type;
+    int32_t _velocity;  // cruise velocity, Q16 ticks per tick
+    uint16_t _accel;    // ticks spent accelerating (and decelerating)
+    uint16_t _total;
+    uint16_t _n;
+    int32_t _last;      // Q16 ticks travelled at step _n
+    uint16_t _speed;
+    uint32_t _speed_factor;
+
+    int32_t ramp(uint32_t n);
+};
+
+/** Streams the profiles of many joints through one SYNC_WRITE per bus and per tick
+ *
+ * Goal position (0x1E) and moving speed (0x20) are contiguous, each joint in
+ * motion costs 5 bytes of the SYNC_WRITE packet of its bus.
+ *
+ * Example:
+ * @code
+ * AX12ProfileGenerator legs(joints, 10000);   // 100 Hz
+ * for (int i = 0; i < 18; i++) {
+ *     legs.Add(ids[i], positions[i]);
+ * }
+ * legs.Move(0, 800, 600, 3000, 30000);        // joint 0 to 800 ticks, S-curve
+ * while (legs.Moving()) {
+ *     legs.Tick();
+ *     ThisThread::sleep_for(10ms);
+ * }
+ * @endcode
+ */
+class AX12ProfileGenerator {
+
+public:
+    /** @param joints buses the joints are placed on
+     *  @param period_us period at which Tick() is called
+     */
+    AX12ProfileGenerator(AX12MultiBus &joints, uint32_t period_us);
+
+    /** Add a joint
+     *
+     * @param id servo ID
+     * @param position current position, ticks
+     * @returns index of the joint, -1 if AX12_PROFILE_MAX_JOINTS is reached
+     */
+    int Add(int id, int position);
+
+    /** Start a move of a joint from the position of its last step
+     *
+     * @param joint index returned by Add()
+     * @param jerk 0 for a trapezoid
+     */
+    int Move(int joint, int target, float velocity, float acceleration, float jerk = 0);
+
+    /** Send the next set point of every moving joint
+     *
+     * @returns result of the SYNC_WRITE (AX12_OK when no joint moves)
+     */
+    int Tick(void);
+
+    /** @returns true while a joint is moving
+     */
+    bool Moving(void);
+
+    AX12Profile &Joint(int joint);
+
+private :
+
+    AX12MultiBus &_joints;
+    uint32_t _period;
+    int _count;
+    uint8_t _ids[AX12_PROFILE_MAX_JOINTS];
+    AX12Profile _profiles[AX12_PROFILE_MAX_JOINTS];
+};
+
+#endif
@@ -0,0 +1,129 @@
+/**
+ * @file AX12Protocol.h
+ * @author joebarteam11
+ * @brief Dynamixel Protocol 1.0 constants shared by the AX12 bus layer
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ * This header has no dependency on mbed so that the packet layer can also be
+ * built on a host (emulator, Linux controllers).
+ */
+#ifndef MBED_AX12PROTOCOL_H
+#define MBED_AX12PROTOCOL_H
+
+#include <stdint.h>
+
+#include "AX12Config.h"
+
+// Instructions
+#define AX12_INST_PING 0x01
+#define AX12_INST_READ 0x02
+#define AX12_INST_WRITE 0x03
+#define AX12_INST_REG_WRITE 0x04
+#define AX12_INST_ACTION 0x05
+#define AX12_INST_RESET 0x06
+#define AX12_INST_SYNC_WRITE 0x83
+
+#define AX12_BROADCAST_ID 0xFE
+
+// Control table (EEPROM)
+#define AX12_REG_MODEL 0x0
+#define AX12_REG_FIRMWARE 0x2
+#define AX12_REG_ID 0x3
+#define AX12_REG_BAUD 0x4
+#define AX12_REG_RETURN_DELAY 0x5
+#define AX12_REG_CW_LIMIT 0x06
+#define AX12_REG_CCW_LIMIT 0x08
+#define AX12_REG_TEMP_LIMIT 0xB
+#define AX12_REG_MIN_VOLTS 0xC
+#define AX12_REG_MAX_VOLTS 0xD
+#define AX12_REG_MAX_TORQUE 0xE
+#define AX12_REG_STATUS_RETURN 0x10
+#define AX12_REG_ALARM_LED 0x11
+#define AX12_REG_ALARM_SHUTDOWN 0x12
+
+// Control table (RAM)
+#define AX12_REG_ENABLE_TORQUE 0x18
+#define AX12_REG_LED 0x19
+#define AX12_REG_GOAL_POSITION 0x1E
+#define AX12_REG_MOVING_SPEED 0x20
+#define AX12_REG_TORQUE_LIMIT 0x22
+#define AX12_REG_POSITION 0x24
+#define AX12_REG_SPEED 0x26
+#define AX12_REG_LOAD 0x28
+#define AX12_REG_VOLTS 0x2A
+#define AX12_REG_TEMP 0x2B
+#define AX12_REG_REGISTERED 0x2C
+#define AX12_REG_MOVING 0x2E
+#define AX12_REG_LOCK 0x2F
+#define AX12_REG_PUNCH 0x30
+
+#define AX12_TABLE_SIZE 0x32
+#define AX12_EEPROM_SIZE 0x18
+
+// Speed unit of AX12_REG_MOVING_SPEED and AX12_REG_SPEED is 0.111rpm, a turn
+// being 1228.8 ticks : 2.2733 ticks/s. Bit 10 of AX12_REG_SPEED is set for CW.
+#define AX12_SPEED_UNIT_TICKS 2.2733f
+#define AX12_SPEED_CW 0x400
+
+// AX12_REG_LOAD : bits 0-9 ratio of the maximum torque (0 to 1023), bit 10 set for a CW load
+#define AX12_LOAD_CW 0x400
+
+// Status packet error bits
+#define AX12_ERROR_VOLTAGE 0x01
+#define AX12_ERROR_ANGLE 0x02
+#define AX12_ERROR_OVERHEAT 0x04
+#define AX12_ERROR_RANGE 0x08
+#define AX12_ERROR_CHECKSUM 0x10
+#define AX12_ERROR_OVERLOAD 0x20
+#define AX12_ERROR_INSTRUCTION 0x40
+
+// Bus level results, servo error bits above are always >= 0
+#define AX12_OK 0
+#define AX12_BUSY -1
+#define AX12_ERR_TIMEOUT -2
+#define AX12_ERR_CHECKSUM -3
+#define AX12_ERR_ID -4
+#define AX12_ERR_LENGTH -5
+#define AX12_ERR_ARG -6
+#define AX12_ERR_DEADLINE -7
+#define AX12_ERR_LINE -8        // echo differing from the packet sent, bytes lost or refused by the port
+#define AX12_ERR_UNREACHABLE -9 // servo quarantined by AX12Bus, nothing sent
+
+// A packet is header(2) + ID + length + instruction + params + checksum
+#define AX12_PACKET_OVERHEAD 6
+
+/** Bit rate of a baud register code: 2000000 / (code + 1)
+ *
+ * @param code value of the AX12_REG_BAUD register (0x01 = 1Mbps, 0xCF = 9600bps)
+ */
+inline int AX12_BaudFromCode(int code)
+{
+    return 2000000 / (code + 1);
+}
+
+/** Signed load of a AX12_REG_LOAD value: -1023 (CCW) to 1023 (CW)
+ */
+inline int AX12_LoadFromRegister(uint16_t value)
+{
+    int magnitude = value & 0x3FF;
+    return (value & AX12_LOAD_CW) ? magnitude : -magnitude;
+}
+
+/** Protocol 1.0 checksum: inverted low byte of the sum of ID to last parameter
+ *
+ * @param packet complete packet, starting at the first 0xFF header
+ * @param length packet length including header and checksum
+ */
+inline uint8_t AX12_Checksum(const uint8_t *packet, int length)
+{
+    uint8_t sum = 0;
+    for (int i = 2; i < length - 1; i++) {
+        sum += packet[i];
+    }
+    return 0xFF - sum;
+}
+
+#endif
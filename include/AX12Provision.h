@@ -0,0 +1,145 @@
+/**
+ * @file AX12Provision.h
+ * @author joebarteam11
+ * @brief Declarative EEPROM configuration of many servos, only the differences are written
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+#ifndef MBED_AX12PROVISION_H
+#define MBED_AX12PROVISION_H
+
+#include "AX12Bus.h"
+
+#ifndef AX12_PROVISION_ROUNDS
+#define AX12_PROVISION_ROUNDS 3 // read, write the differences, verify ; retried for the servos that do not match
+#endif
+
+#ifndef AX12_PROVISION_SETTLE_US
+#define AX12_PROVISION_SETTLE_US 10000 // EEPROM write time of the servos before they are read back
+#endif
+
+/** EEPROM configuration wanted for one servo
+ *
+ * Only the registers set in the profile are checked and written, the others
+ * are left as they are. After AX12Provisioner::Apply(), result and changed
+ * tell what happened to this servo.
+ */
+class AX12EepromProfile {
+
+public:
+    /** @param id present ID of the servo
+     */
+    AX12EepromProfile(int id = 1);
+
+    /** Set one byte register, AX12_REG_ID to AX12_REG_ALARM_SHUTDOWN
+     *
+     * @returns AX12_OK, AX12_ERR_ARG for a read only or reserved register
+     */
+    int Set(int reg, int value);
+
+    /** Set a 16 bits register (AX12_REG_CW_LIMIT, AX12_REG_CCW_LIMIT, AX12_REG_MAX_TORQUE)
+     */
+    int SetWord(int reg, int value);
+
+    // Same values as the functions of the AX12 class
+    int SetID(int id) { return Set(AX12_REG_ID, id); }
+    int SetBaud(int code) { return Set(AX12_REG_BAUD, code); }
+    int SetReturnDelay(int us) { return Set(AX12_REG_RETURN_DELAY, us / 2); }
+    int SetCWLimit(int degrees) { return SetWord(AX12_REG_CW_LIMIT, (1023 * degrees) / 300); }
+    int SetCCWLimit(int degrees) { return SetWord(AX12_REG_CCW_LIMIT, (1023 * degrees) / 300); }
+    int SetMaxTorque(float percentage) { return SetWord(AX12_REG_MAX_TORQUE, (int)(1023 * percentage)); }
+    int SetStatusReturn(int level) { return Set(AX12_REG_STATUS_RETURN, level); }
+
+    /** @returns true if the profile sets register \p reg
+     */
+    bool Has(int reg);
+
+    /** @returns the ID the servo has on the bus, the new one once it is written
+     */
+    int Id(void);
+
+    /** AX12_OK once the EEPROM is read back equal to the profile, AX12_ERR_TIMEOUT if the
+     *  servo does not answer, AX12_ERR_ID if its new ID is taken, AX12_ERROR_RANGE if it
+     *  kept other values (EEPROM locked, value out of range)
+     */
+    int result;
+    uint8_t changed; // registers that had to be written
+
+private :
+
+    friend class AX12Provisioner;
+
+    uint8_t _id;
+    uint8_t _origin;   // ID before a new one is written
+    bool _taken;       // new ID already on the bus
+    uint8_t _values[AX12_EEPROM_SIZE];
+    uint32_t _mask;    // registers set, one bit each
+    uint32_t _pending; // registers differing from the servo
+};
+
+/** Totals of AX12Provisioner::Apply()
+ */
+struct AX12ProvisionReport {
+    int servos;
+    int verified;          // servos read back equal to their profile
+    uint16_t changed;      // registers written, all servos
+    uint16_t writes;       // WRITE packets
+    uint16_t sync_writes;  // SYNC_WRITE packets
+    uint16_t reads;        // EEPROM reads, verification included
+    uint32_t elapsed_us;
+};
+
+/** Brings the EEPROM of many servos to their profiles with the fewest packets
+ *
+ * The EEPROM block of each servo is read in one transaction and compared to
+ * its profile. The registers that differ are grouped in contiguous ranges:
+ * a range shared by several servos (same start and length, any values) is
+ * written with one SYNC_WRITE, the others with one WRITE each. Registers that
+ * already have the right value are never written, which spares the EEPROM.
+ * The servos are then read back, and written again if they do not match, up
+ * to AX12_PROVISION_ROUNDS reads.
+ *
+ * ID and baud rate are written last. A new ID already answering on the bus
+ * is refused (the servo gets AX12_ERR_ID). A new baud code must be the same
+ * for every profile; the port follows it once it is written.
+ *
+ * Example:
+ * @code
+ * AX12EepromProfile joints[2] = {AX12EepromProfile(1), AX12EepromProfile(2)};
+ * AX12Provisioner provisioner(bus);
+ * AX12ProvisionReport report;
+ *
+ * for (int i = 0; i < 2; i++) {
+ *     joints[i].SetReturnDelay(0);
+ *     joints[i].SetMaxTorque(0.8);
+ * }
+ * joints[1].SetCWLimit(60);
+ * provisioner.Apply(joints, 2, report);
+ * printf("%d/%d servos verified\n", report.verified, report.servos);
+ * @endcode
+ */
+class AX12Provisioner {
+
+public:
+    AX12Provisioner(AX12Bus &bus);
+
+    /** Configure the servos of \p profiles
+     *
+     * @returns AX12_OK if every servo is verified, AX12_ERR_ARG if the
+     *          profiles ask for different baud codes (nothing is written),
+     *          the error of the first servo not verified otherwise
+     */
+    int Apply(AX12EepromProfile *profiles, int count, AX12ProvisionReport &report);
+
+private :
+
+    AX12Bus &_bus;
+
+    int read(AX12EepromProfile &profile, AX12ProvisionReport &report);
+    void write(AX12EepromProfile *profiles, int count, uint32_t registers, AX12ProvisionReport &report);
+};
+
+#endif
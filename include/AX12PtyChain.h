@@ -0,0 +1,80 @@
+/**
+ * @file AX12PtyChain.h
+ * @author joebarteam11
+ * @brief Emulated AX12 chain behind a pseudo-terminal, stand-in for a USB adapter
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+#ifndef MBED_AX12PTYCHAIN_H
+#define MBED_AX12PTYCHAIN_H
+
+#if defined(__linux__)
+
+#include "AX12Emulator.h"
+
+#include <atomic>
+#include <thread>
+
+/** Emulated servos answering on the slave side of a pty
+ *
+ * A thread reads the packets written to the pty, executes them on an
+ * AX12EmulatedBus whose virtual clock follows the real time, and writes the
+ * status packets back when the emulator releases them. Open the path given by
+ * Path() with AX12LinuxPort like a real adapter.
+ *
+ * Example:
+ * @code
+ * AX12PtyChain chain(1000000);
+ * chain.Emulator().Attach(1);
+ * chain.Start();
+ *
+ * AX12LinuxPort tty;
+ * tty.Open(chain.Path(), 1000000);
+ * AX12Bus bus(tty);
+ * bus.Ping(1);
+ * @endcode
+ */
+class AX12PtyChain {
+
+public:
+    /** @param baud bit rate of the emulated servos
+     *  @param echo true to send back every byte received, like the half duplex adapters
+     */
+    AX12PtyChain(int baud = 1000000, bool echo = false);
+    ~AX12PtyChain();
+
+    /** @returns path of the slave side, 0 if the pty could not be created
+     */
+    const char *Path(void);
+
+    /** Emulated chain, attach servos before Start()
+     */
+    AX12EmulatedBus &Emulator(void);
+
+    /** Start serving in a thread
+     */
+    int Start(void);
+
+    /** Stop the thread
+     */
+    void Stop(void);
+
+private :
+
+    AX12VirtualClock _clock;
+    AX12EmulatedBus _chain;
+    bool _echo;
+    int _master;
+    char _path[64];
+    std::atomic<bool> _running;
+    std::thread _thread;
+
+    void serve(void);
+};
+
+#endif
+
+#endif
@@ -0,0 +1,250 @@
+/**
+ * @file AX12Scheduler.h
+ * @author joebarteam11
+ * @brief Priority and deadline aware scheduling of the transactions of a bus
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+#ifndef MBED_AX12SCHEDULER_H
+#define MBED_AX12SCHEDULER_H
+
+#include "AX12Bus.h"
+
+// Priority classes, lower is more urgent
+#define AX12_PRIO_MOTION 0     // goal / speed updates of the control loop
+#define AX12_PRIO_CONFIG 1     // limits, torque, modes...
+#define AX12_PRIO_TELEMETRY 2  // temperature, voltage, load polling
+#define AX12_PRIO_CLASSES 3
+
+#ifndef AX12_SCHED_THREAD_FLAG
+#define AX12_SCHED_THREAD_FLAG (1UL << 30) // thread flag of the RTOS set when a posted request is over
+#endif
+
+/** One transaction waiting for the bus
+ *
+ * The request belongs to the caller and must stay alive until \p result is
+ * no longer AX12_BUSY.
+ *
+ * Parameters sent for each instruction :
+ *    PING, ACTION : none
+ *    READ : start, length, the reply is copied to \p data
+ *    WRITE, REG_WRITE : start, then \p length bytes of \p data
+ *    SYNC_WRITE : start, length, then \p count blocks of ID + \p length bytes of \p data
+ */
+struct AX12Request {
+    uint8_t id;
+    uint8_t instruction;
+    uint8_t start;
+    uint8_t length;
+    uint8_t count;
+    uint8_t priority;
+    uint8_t *data;
+
+    bool has_deadline;
+    uint32_t deadline;  // latest end of the transaction (AX12Clock time)
+
+    /** Called from AX12Scheduler::Poll() once the request is over, just before \p result is set, may be 0
+     */
+    void (*done)(AX12Request *request, int result, void *context);
+    void *context;
+
+    volatile int result;  // AX12_BUSY while queued, then same as AX12Bus::Poll() or AX12_ERR_DEADLINE
+    uint32_t finished;    // time of completion
+
+    AX12Request();
+
+    /** Fill the request for a READ
+     */
+    void Read(int id, int start, int length, uint8_t *data, int priority = AX12_PRIO_TELEMETRY);
+
+    /** Fill the request for a WRITE (REG_WRITE if \p registered)
+     */
+    void Write(int id, int start, int length, uint8_t *data, int priority = AX12_PRIO_MOTION, bool registered = false);
+
+    /** Give the request a deadline, relative to \p now
+     */
+    void Before(uint32_t now, uint32_t us);
+
+    /** @returns true once the request is over, its reply copied to \p data
+     */
+    bool Done(void);
+
+    /** Block until a request given to AX12Scheduler::Post() is over
+     *
+     * The thread that posted the request sleeps until the thread owning the
+     * bus completes it, any other thread polls. On mbed it needs the RTOS.
+     * The request may be reused or freed once it returns, its \p done
+     * callback has returned by then.
+     *
+     * @returns the result of the request
+     */
+    int Wait(void);
+
+private :
+
+    friend class AX12Scheduler;
+    AX12Request *_next; // list of the posted requests
+    void *_waiter;      // thread that posted the request, woken when it is over
+    uint32_t _sequence;
+    uint32_t _estimate;
+    uint32_t _started;
+    bool _deferred;
+};
+
+/** Counters per priority class, reset with AX12Scheduler::ResetStats()
+ */
+struct AX12SchedulerStats {
+    uint32_t completed[AX12_PRIO_CLASSES];
+    uint32_t missed[AX12_PRIO_CLASSES];    // completed after their deadline
+    uint32_t dropped[AX12_PRIO_CLASSES];   // never sent, deadline could not be met
+    uint32_t deferred[AX12_PRIO_CLASSES];  // held back to keep a reserved slot free
+    uint32_t max_late_us[AX12_PRIO_CLASSES];
+    int32_t max_estimate_error_us;         // largest |measured - estimated| bus time
+};
+
+/** Shares one bus between the control loop, configuration and telemetry
+ *
+ * Requests are executed one whole transaction at a time (never preempted), the
+ * next one being chosen each time the bus becomes free : most urgent priority
+ * class first, then earliest deadline, then first submitted.
+ *
+ * Before a request is started its bus time is estimated from the bit rate and
+ * the size of the packets (AX12Bus::Estimate()). A request that can no longer
+ * meet its deadline is dropped if its class allows it (telemetry by default),
+ * and a request of a lower class is deferred if it would still hold the bus
+ * when a slot reserved with Reserve() begins.
+ *
+ * When the queue is empty and no slot is reserved, Poll() lets the bus ping
+ * its quarantined servos (AX12Bus::Probe()).
+ *
+ * One thread owns the bus: it alone calls Poll(), Submit() and the rest.
+ * Other threads and interrupts give it requests with Post(), which never
+ * blocks nor takes a lock: the request is pushed on a list with one
+ * compare and swap, and the next Poll() moves the list into the queue.
+ * The posting thread then sleeps in AX12Request::Wait() until its request
+ * is over, woken by a thread flag, while the owner sleeps in Idle() when
+ * there is nothing to do.
+ *
+ * Example:
+ * @code
+ * AX12Scheduler sched(bus);
+ * AX12Request goal, temp;
+ *
+ * temp.Read(3, AX12_REG_TEMP, 1, &t);             // telemetry, whenever possible
+ * goal.Write(3, AX12_REG_GOAL_POSITION, 2, g);    // motion
+ * goal.Before(clock.now_us(), 2000);              // must be done within 2ms
+ * sched.Submit(temp);
+ * sched.Submit(goal);                             // sent first
+ * sched.Flush();
+ * @endcode
+ */
+class AX12Scheduler {
+
+public:
+    /** Create a scheduler, it must be the only user of \p bus
+     */
+    AX12Scheduler(AX12Bus &bus);
+
+    /** Queue a request, from the thread owning the bus
+     *
+     * @returns AX12_OK, or AX12_BUSY if the queue is full
+     */
+    int Submit(AX12Request &request);
+
+    /** Queue a request from any thread or interrupt, lock free
+     *
+     * Posted requests are taken by the next Poll() in the order they were
+     * posted. There is no limit to their number : the ones that do not fit
+     * in the queue wait for room in a list linked through the requests.
+     *
+     * @returns AX12_OK, or AX12_ERR_ARG if the priority is not a class
+     */
+    int Post(AX12Request &request);
+
+    /** Sleep until a request is posted or \p us have passed, from the thread owning the bus
+     */
+    void Idle(uint32_t us);
+
+    /** Remove a request that has not been started yet
+     *
+     * The request ends with AX12_ERR_ARG, its \p done callback is called.
+     *
+     * @returns AX12_OK, or AX12_ERR_ARG if it is not in the queue
+     */
+    int Cancel(AX12Request &request);
+
+    /** Make the bus progress, starting the next request when it is free. Never blocks.
+     *
+     * @returns number of requests queued or in flight
+     */
+    int Poll(void);
+
+    /** Submit a request and block until it is over
+     *
+     * @returns the result of the request
+     */
+    int Run(AX12Request &request);
+
+    /** Block until every queued request is over
+     */
+    void Flush(void);
+
+    /** Keep the bus free for a class from a given time
+     *
+     * Requests of a less urgent class that would not be over at \p at are not
+     * started. The reservation ends once \p at is reached.
+     *
+     * @param at beginning of the slot (AX12Clock time), typically the next control tick
+     * @param priority class the slot is kept for
+     */
+    void Reserve(uint32_t at, int priority = AX12_PRIO_MOTION);
+
+    /** Choose if a class drops the requests that can no longer meet their deadline
+     *
+     * By default only telemetry is dropped, the other classes are sent late.
+     */
+    void SetDropLate(int priority, bool drop);
+
+    /** @returns estimated bus time of a request in us
+     */
+    uint32_t Estimate(const AX12Request &request);
+
+    /** @returns number of requests queued or in flight
+     */
+    int Pending(void);
+
+    AX12Bus &Bus(void);
+
+    const AX12SchedulerStats &Stats(void);
+    void ResetStats(void);
+
+private :
+
+    AX12Bus &_bus;
+    AX12Request *_queue[AX12_SCHED_QUEUE_SIZE];
+    int _queued;
+    AX12Request *volatile _posted; // pushed by Post(), last first
+    AX12Request *_held;            // posted, waiting for room in the queue
+    AX12Request *_held_last;
+    int _held_count;
+    void *volatile _owner;         // thread sleeping in Idle()
+    AX12Request *_current;
+    bool _probing; // a PING of AX12Bus::Probe() is in flight
+    uint32_t _sequence;
+    bool _drop_late[AX12_PRIO_CLASSES];
+    bool _reserved;
+    uint32_t _reserve_at;
+    int _reserve_priority;
+    AX12SchedulerStats _stats;
+
+    void collect(void);
+    int select(uint32_t now);
+    int start(AX12Request &request);
+    void complete(AX12Request &request, int result);
+    void remove(int index);
+};
+
+#endif
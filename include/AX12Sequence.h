@@ -0,0 +1,204 @@
+/**
+ * @file AX12Sequence.h
+ * @author joebarteam11
+ * @brief Keyframe sequences compiled from text, played at a fixed tick
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+#ifndef MBED_AX12SEQUENCE_H
+#define MBED_AX12SEQUENCE_H
+
+#include "AX12MultiBus.h"
+
+#define AX12_SEQ_VERSION 1
+#define AX12_SEQ_HEADER 6 // bytes before the IDs of the joints
+
+// Records
+#define AX12_SEQ_END 0x00
+#define AX12_SEQ_KEY 0x01    // ticks (16 bits), interpolation, mask, goal of each joint of the mask
+#define AX12_SEQ_SPEED 0x02  // mask, moving speed of each joint of the mask
+#define AX12_SEQ_TORQUE 0x03 // mask, torque limit of each joint of the mask
+#define AX12_SEQ_FREE 0x04   // mask : torque off, until the next goal of the joint
+#define AX12_SEQ_WAIT 0x05   // ticks
+#define AX12_SEQ_SETTLE 0x06 // mask, ticks at most : until the joints of the mask stop moving
+#define AX12_SEQ_REPEAT 0x07 // count (0 forever) of the records up to the next AX12_SEQ_NEXT
+#define AX12_SEQ_NEXT 0x08   // offset of the first record after the AX12_SEQ_REPEAT
+
+// Interpolations of AX12_SEQ_KEY
+#define AX12_SEQ_STEP 0   // goal sent at once, with the speed of the last AX12_SEQ_SPEED (0 : none)
+#define AX12_SEQ_LINEAR 1 // constant speed
+#define AX12_SEQ_SMOOTH 2 // 3t^2 - 2t^3 : starts and stops at zero speed
+
+// Headroom given to the servo over the speed of the interpolation : speed + speed / 8 + AX12_SEQ_MIN_SPEED
+#define AX12_SEQ_MIN_SPEED 8
+
+/** Where AX12_CompileSequence() stopped
+ */
+struct AX12SequenceError {
+    int line;            // 1 for the first line, 0 if the text is fine
+    const char *message;
+};
+
+/** Compile the text description of a sequence
+ *
+ * One command per line, '#' starts a comment, times are in ms unless they
+ * end with "us" or "s", positions in ticks unless they end with "deg":
+ * @code
+ * period 10                    # tick of the sequencer, ms, before "joints" (10 if not given)
+ * joints 1 2 3                 # IDs, at most AX12_SEQ_MAX_JOINTS, before the first command
+ * speed all=300                # moving speed (AX12_REG_MOVING_SPEED), "all" or id=value
+ * torque 1=800 3=600           # torque limit (AX12_REG_TORQUE_LIMIT)
+ * key 1000 smooth 1=512 2=150deg   # to these goals in 1 s : step, linear (if not given) or smooth
+ * wait 200
+ * settle 2s all                # until the joints stop moving, at most 2 s
+ * repeat 3                     # 0 repeats forever, one level
+ *   key 500 linear 1=300
+ *   key 500 linear 1=700
+ * end
+ * free 3                       # torque off
+ * @endcode
+ *
+ * Times are rounded to whole ticks.
+ *
+ * @param out where the sequence is written
+ * @param size of \p out, bytes
+ * @param error line and reason of a failure, may be 0
+ * @returns size of the sequence, bytes, AX12_ERR_ARG if the text is wrong, AX12_ERR_LENGTH if \p out is too small
+ */
+int AX12_CompileSequence(const char *text, uint8_t *out, int size, AX12SequenceError *error = 0);
+
+/** Counters, reset by Play()
+ */
+struct AX12SequenceStats {
+    uint32_t ticks;   // ticks run
+    uint32_t writes;  // SYNC_WRITE calls, one packet per bus each
+    uint32_t reads;   // position or moving reads (start of a sequence, settle)
+    uint32_t starved; // ticks the next record was not received yet
+    uint32_t late;    // settles over before the joints stopped
+};
+
+/** Plays compiled sequences, every Step() that is due runs one tick
+ *
+ * Storage, little endian: 'A' 'S', version, number of joints, tick (100
+ * us), the IDs, then records, each an opcode followed by its parameters
+ * (AX12_SEQ_*). A mask is one bit per joint, in the order of the IDs, on
+ * (joints + 7) / 8 bytes. A sequence ends with AX12_SEQ_END.
+ *
+ * A keyframe interpolates the goals of the joints of its mask from their
+ * set points to its goals over its ticks; each tick sends the goal and the
+ * moving speed of all of them in one SYNC_WRITE per bus, the speed matching
+ * the step so that the servos follow without stopping at each tick. Speed,
+ * torque and free records are one SYNC_WRITE per bus as well.
+ *
+ * No allocation: the sequence is read where it is (RAM or flash), the state
+ * is AX12_SEQ_MAX_JOINTS set points. Play() while a sequence plays swaps it
+ * at once, the joints starting from where they are; Queue() chains the next
+ * one at the end of the current one. A sequence received while it plays
+ * (from a serial link) is given with the bytes received so far, and
+ * Extend() each time more arrive: a tick whose record is not complete yet
+ * holds the joints and is counted in Stats().starved.
+ *
+ * Example:
+ * @code
+ * static uint8_t wave[256];
+ * int size = AX12_CompileSequence(text, wave, sizeof(wave));   // or compiled on the host
+ * AX12Sequencer sequencer(joints);
+ *
+ * sequencer.Play(wave, size);
+ * while (sequencer.Step() >= 0) {
+ *     ThisThread::sleep_for(std::chrono::microseconds(sequencer.Due()));
+ * }
+ * @endcode
+ */
+class AX12Sequencer {
+
+public:
+    /** @param joints buses the servos are placed on
+     */
+    AX12Sequencer(AX12MultiBus &joints);
+
+    /** Play a sequence now, instead of the one playing
+     *
+     * The set points of the joints the two sequences share are kept, the
+     * positions of the others are read.
+     *
+     * @param data a sequence, as AX12_CompileSequence() wrote it
+     * @param size bytes of \p data available, see Extend()
+     * @returns AX12_OK, AX12_ERR_ARG if \p data is not a sequence
+     */
+    int Play(const uint8_t *data, int size);
+
+    /** Play a sequence when the current one ends, at once if none plays
+     *
+     * @returns AX12_OK, AX12_ERR_ARG if \p data is not a sequence
+     */
+    int Queue(const uint8_t *data, int size);
+
+    /** More bytes of the sequence playing were received, \p size in all
+     */
+    void Extend(int size);
+
+    /** Run the next tick if it is due
+     *
+     * @returns 1 if a tick was run, 0 if not due, AX12_ERR_LENGTH once the
+     *          sequence is over, AX12_ERR_ARG if a record is wrong (stopped)
+     */
+    int Step(void);
+
+    /** @returns time until the next Step() is due, us
+     */
+    uint32_t Due(void);
+
+    /** Stop where the joints are, the next sequence queued is dropped
+     */
+    void Stop(void);
+
+    bool Playing(void);
+
+    /** @returns set point of joint \p index of the sequence, ticks
+     */
+    uint16_t Goal(int index);
+
+    uint32_t Period(void);
+
+    const AX12SequenceStats &Stats(void);
+
+private :
+
+    AX12MultiBus &_joints;
+    bool _playing;
+    const uint8_t *_data;
+    int _size;
+    int _at;          // next record
+    int _count;
+    uint8_t _ids[AX12_SEQ_MAX_JOINTS];
+    uint16_t _goals[AX12_SEQ_MAX_JOINTS]; // set points
+    uint16_t _from[AX12_SEQ_MAX_JOINTS];  // set points at the start of the keyframe
+    uint16_t _to[AX12_SEQ_MAX_JOINTS];
+    uint16_t _speeds[AX12_SEQ_MAX_JOINTS]; // of the last speed record, 0 (no control) if none
+    uint8_t _mask[(AX12_SEQ_MAX_JOINTS + 7) / 8]; // joints of the keyframe or the settle
+    uint8_t _type;
+    uint16_t _ticks;  // of the keyframe, the wait or the settle
+    uint16_t _n;      // ticks done
+    uint8_t _record;  // keyframe, wait or settle going on, AX12_SEQ_END if none
+    int _loop;        // first record of the repeat, -1 outside
+    int _left;        // repeats left, 0 forever
+    const uint8_t *_queued;
+    int _queued_size;
+    uint32_t _period;
+    uint32_t _next;
+    uint32_t _speed_factor; // Q16, ticks per tick to AX12_REG_MOVING_SPEED units
+    AX12SequenceStats _stats;
+
+    int start(const uint8_t *data, int size);
+    int run(void);
+    int interpolate(void);
+    int settle(void);
+    int write(int reg, const uint8_t *mask, const uint8_t *values, int width);
+    int length(int at);
+};
+
+#endif
@@ -0,0 +1,141 @@
+/**
+ * @file AX12Simulation.h
+ * @author joebarteam11
+ * @brief Physics of the AX12 for the emulated chains, and simulations run in parallel
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+#ifndef MBED_AX12SIMULATION_H
+#define MBED_AX12SIMULATION_H
+
+#include "AX12Emulator.h"
+
+#define AX12_SIM_TICK_RAD 0.0051182f // 300 degrees over 1023 ticks
+
+#ifndef AX12_SIM_OVERLOAD_MS
+#define AX12_SIM_OVERLOAD_MS 500 // output saturated with the horn stalled before the overload alarm
+#endif
+
+/** Motor, gear train and load of a servo, at the horn
+ */
+struct AX12MotorModel {
+    float stall_torque;       // N.m, 12 V, full output
+    float free_speed;         // rad/s, 12 V, no load
+    float inertia;            // kg.m2, gear train and what the horn carries
+    float friction;           // N.m, dry friction of the gear train
+    float damping;            // N.m per rad/s
+    float winding;            // ohm, motor and driver : stall current is 12 V / winding
+    float thermal_resistance; // degrees C per W, motor to air
+    float thermal_time;       // s, time constant of the heating
+    float ambient;            // degrees C
+};
+
+/** AX-12A from its datasheet : 1.5 N.m, 59 rpm, 1.5 A at 12 V
+ */
+extern const AX12MotorModel AX12_MOTOR_AX12A;
+
+/** Physics of one emulated servo
+ *
+ * The firmware is modelled as the AX-12 manual describes it: a set point
+ * moving towards the goal at the moving speed (at once if 0), the output
+ * given by the compliance margins and slopes and the punch, limited by the
+ * torque limit and the max torque, open loop in wheel mode. The output
+ * drives a DC motor (torque falling linearly with the speed, both scaled by
+ * the voltage register) against the inertia, the dry and viscous friction,
+ * the resistance of the servo (an obstacle, as for the ideal servo) and
+ * \p external (a weight on the horn).
+ *
+ * The servo reports what it would: present position (with \p noise ticks of
+ * potentiometer noise), speed, load (the output), moving, temperature (the
+ * Joule losses heating the motor), and the status packets carry the alarms:
+ * angle (goal out of the CW/CCW limits, the goal is then clamped), voltage,
+ * overheating above the temperature limit, overload when the output is
+ * saturated and the horn stalled for AX12_SIM_OVERLOAD_MS. An alarm of
+ * AX12_REG_ALARM_SHUTDOWN sets the torque limit to 0, as the servo does.
+ *
+ * The motion is integrated at a fixed step of AX12_SIM_STEP_US whatever the
+ * traffic on the bus, and the noise comes from \p seed: a simulation is
+ * repeated exactly. A servo at rest with no output costs nothing per step.
+ *
+ * Example:
+ * @code
+ * AX12VirtualClock clock;
+ * AX12EmulatedBus chain(clock);
+ * AX12ServoDynamics dynamics(AX12_MOTOR_AX12A, 1);
+ *
+ * dynamics.Attach(*chain.Attach(1));
+ * dynamics.external = -0.3f;          // 0.3 N.m pulling CW
+ * @endcode
+ */
+class AX12ServoDynamics : public AX12ServoPhysics {
+
+public:
+    /** @param model motor of the servo
+     *  @param seed start of the pseudo-random sequence of the noise and the spread
+     *  @param spread relative deviation of the stall torque, free speed and friction from \p model, drawn from \p seed
+     */
+    AX12ServoDynamics(const AX12MotorModel &model = AX12_MOTOR_AX12A, uint32_t seed = 1, float spread = 0);
+
+    /** Drive \p servo, from its present position, at rest, at ambient temperature
+     */
+    void Attach(AX12EmulatedServo &servo);
+
+    virtual void Advance(AX12EmulatedServo &servo, uint64_t ns);
+
+    /** @returns the model, with the spread drawn
+     */
+    const AX12MotorModel &Model(void);
+
+    float Position(void);    // ticks, 0 to 1228.8 over a whole turn (past 1023 : the dead zone)
+    float Velocity(void);    // ticks/s, CCW positive
+    float Output(void);      // -1 (full CW) to 1 (full CCW)
+    float Temperature(void); // degrees C
+    float Current(void);     // A
+
+    float external; // N.m on the horn from outside, CCW positive
+    int noise;      // potentiometer noise, +/- ticks
+
+private :
+
+    AX12MotorModel _model;
+    uint32_t _random;
+    uint64_t _pending;   // ns not integrated yet, less than a step
+    double _angle;       // rad, CCW positive, over one turn
+    float _velocity;     // rad/s
+    float _set;          // set point, ticks
+    float _output;
+    float _temperature;
+    float _current;
+    uint32_t _saturated; // steps the output has been saturated with the horn stalled
+    int _reported;       // position register written last, to see a write from outside
+    bool _rest;          // nothing moves nor drives : the next steps would change nothing but the temperature
+
+    uint32_t random(void);
+    void step(AX12EmulatedServo &servo, float dt);
+    void report(AX12EmulatedServo &servo);
+};
+
+#if !defined(__MBED__)
+
+/** A simulation of a batch, given its index
+ */
+typedef void (*AX12SimulationRun)(int index, void *context);
+
+/** Run \p runs independent simulations on several threads
+ *
+ * \p run is called once for each index from 0 to \p runs - 1, from any of the
+ * threads; each run must own its virtual clock, chains and servos, and store
+ * its results at its index. The results do not depend on the number of
+ * threads, only on what each run does with its index (its seed).
+ *
+ * @param threads threads to use, 0 for one per core (at most AX12_SIM_MAX_THREADS)
+ * @returns number of threads used
+ */
+int AX12_RunSimulations(int runs, AX12SimulationRun run, void *context, int threads = 0);
+
+#endif
+
+#endif
@@ -0,0 +1,161 @@
+/**
+ * @file AX12Stall.h
+ * @author joebarteam11
+ * @brief Stall and collision detection, with an automatic reaction
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+#ifndef MBED_AX12STALL_H
+#define MBED_AX12STALL_H
+
+#include "AX12MultiBus.h"
+
+// Events
+#define AX12_STALL_NONE 0
+#define AX12_STALL_STALLED 1  // the servo pushes but does not move any more
+#define AX12_STALL_COLLISION 2 // sudden rise of the load while moving
+
+// Reactions
+#define AX12_STALL_REPORT 0     // nothing written, see Event()
+#define AX12_STALL_CUT_TORQUE 1 // AX12_REG_ENABLE_TORQUE = 0, as AX12::SetTorque(false)
+#define AX12_STALL_REVERSE 2    // turn the other way at half the speed, as AX12::SetCRSpeed(-speed / 2)
+#define AX12_STALL_HOLD 3       // stop where it is, torque kept : speed 0 in wheel mode, goal = position otherwise
+
+/** Watches moving servos and stops them on contact
+ *
+ * Each Tick() reads present position, speed and load of every servo given a
+ * speed (6 bytes, one batch in parallel on the buses) and compares them with
+ * the command:
+ *  - a stall is a speed and a travel below a share of the command while the
+ *    load is well above the load of free motion, for a few ticks in a row;
+ *  - a collision is a sudden jump of the load above the load of free motion
+ *    (from a normal load to the jump in one tick), while the servo slows down
+ *    or for a few ticks in a row, so that a wrong load value is not taken for
+ *    a contact. A load growing slowly ends as a stall, not as a collision.
+ * The load of free motion is learnt while the servo moves freely. The ticks
+ * after a new command are not checked, the servo accelerates.
+ *
+ * On an event the reaction is written at once, in the same Tick(), and the
+ * servo is not checked again until it is given a new command.
+ *
+ * Example:
+ * @code
+ * AX12StallDetector contact(joints);
+ * int gripper = contact.Add(3);
+ *
+ * contact.SetAction(AX12_STALL_HOLD);
+ * contact.SetSpeed(gripper, 0.5);   // close, wheel mode
+ * while (contact.Event(gripper) == AX12_STALL_NONE) {
+ *     contact.Tick();               // every control tick
+ *     ThisThread::sleep_for(10ms);
+ * }
+ * @endcode
+ */
+class AX12StallDetector {
+
+public:
+    /** @param joints buses the servos are placed on
+     */
+    AX12StallDetector(AX12MultiBus &joints);
+
+    /** Watch a servo
+     *
+     * @returns index of the joint, -1 if AX12_STALL_MAX_JOINTS is reached
+     */
+    int Add(int id);
+
+    /** Turn a joint in wheel mode, same value as AX12::SetCRSpeed()
+     *
+     * @param speed -1.0 (CW) to 1.0 (CCW), 0 to stop
+     * @returns the result of the write
+     */
+    int SetSpeed(int joint, float speed);
+
+    /** Move a joint in position mode
+     *
+     * @param goal goal position, ticks
+     * @param speed moving speed register, 1 to 1023
+     */
+    int Move(int joint, int goal, int speed);
+
+    /** Report a command written by other means (same values as the registers)
+     *
+     * @param wheel true for a wheel mode speed, \p goal is ignored then
+     */
+    void Command(int joint, bool wheel, int speed, int goal = 0);
+
+    /** Read the moving joints, detect and react
+     *
+     * @returns number of events of this tick
+     */
+    int Tick(void);
+
+    /** @returns the last event of a joint, AX12_STALL_NONE until a new command
+     */
+    int Event(int joint);
+
+    /** @returns AX12Clock time of the read that saw the event, us
+     */
+    uint32_t EventTime(int joint);
+
+    /** Forget the event of a joint, it is checked again with its present command
+     */
+    void Clear(int joint);
+
+    /** Reaction to an event, AX12_STALL_REPORT by default
+     */
+    void SetAction(int action);
+
+    /** Detection thresholds
+     *
+     * @param speed_percent below this share of the command, the servo is slowed down (40)
+     * @param load_margin load above the free motion load of a pushing servo (150)
+     * @param jump load above the free motion load of a collision (300)
+     * @param confirm ticks in a row of a stall, or of a jump while the speed holds (3)
+     * @param grace ticks not checked after a new command (3)
+     */
+    void SetThresholds(int speed_percent, int load_margin, int jump, int confirm, int grace);
+
+    uint32_t Ticks(void);
+    uint32_t Events(void);
+
+private :
+
+    struct Joint {
+        uint8_t id;
+        bool wheel;
+        int16_t speed;    // signed command, CCW positive, register units
+        int16_t goal;
+        uint8_t grace;
+        uint8_t count;    // ticks in a row looking stalled
+        uint8_t jumps;    // ticks in a row since a sudden load jump
+        bool heavy;       // load of the previous tick above the margin
+        bool known;       // position of the previous tick is valid
+        int16_t position;
+        int32_t free;     // load of free motion, 4 bits of fraction
+        uint8_t event;
+        uint32_t time;
+    };
+
+    AX12MultiBus &_joints;
+    Joint _list[AX12_STALL_MAX_JOINTS];
+    int _count;
+    int _action;
+    int _speed_percent;
+    int _margin;
+    int _jump;
+    int _confirm;
+    int _grace;
+    bool _started;
+    uint32_t _last;  // time of the previous Tick() read
+    uint32_t _ticks;
+    uint32_t _events;
+
+    int check(Joint &j, const uint8_t *data, uint32_t elapsed);
+    void react(Joint &j, int position);
+};
+
+#endif
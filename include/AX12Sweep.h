@@ -0,0 +1,120 @@
+/**
+ * @file AX12Sweep.h
+ * @author joebarteam11
+ * @brief The same registers of many servos, read back to back
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+#ifndef MBED_AX12SWEEP_H
+#define MBED_AX12SWEEP_H
+
+#include "AX12Bus.h"
+
+#ifndef AX12_SWEEP_MARGIN_US
+#define AX12_SWEEP_MARGIN_US 200 // on top of the reply time of each servo, instead of the timeout of the bus
+#endif
+
+/** Counters, reset with AX12ReadSweep::ResetStats()
+ */
+struct AX12SweepStats {
+    uint32_t sweeps;   // sweeps over
+    uint32_t reads;    // servos that replied
+    uint32_t failures; // servos without a valid reply
+    uint32_t last_us;  // length of the last sweep
+};
+
+/** Reads the same registers of a list of servos, one READ_DATA after the other
+ *
+ * Protocol 1.0 has no SYNC_READ on the AX-12: each servo is one READ_DATA
+ * and its status packet. The sweep sends the next READ_DATA from the Poll()
+ * that sees the last byte of a reply, so the bus goes from one transaction
+ * to the next without waiting for the caller, and the deadline of each read
+ * is the reply time of the servo plus SetMargin() instead of the timeout of
+ * the bus: a missing servo costs one reply time, and a quarantined one
+ * nothing.
+ *
+ * Each servo gets its own result: the error byte of its status packet
+ * (>= 0, 0 when fine) or an AX12_ERR_* code. Its bytes are at
+ * data[index * length] and are only valid if the result is >= 0.
+ *
+ * The sweep owns the bus while it runs: nothing else may start a
+ * transaction on it until Poll() stops returning AX12_BUSY.
+ *
+ * Example:
+ * @code
+ * AX12ReadSweep sweep(bus);
+ * const uint8_t ids[] = {1, 2, 3, 4, 5, 6};
+ * uint8_t positions[6 * 2];
+ * int results[6];
+ *
+ * sweep.Read(ids, 6, AX12_REG_POSITION, 2, positions, results);
+ * for (int i = 0; i < 6; i++) {
+ *     if (results[i] >= 0) {
+ *         printf("%d : %d\n", ids[i], positions[2 * i] | positions[2 * i + 1] << 8);
+ *     }
+ * }
+ * @endcode
+ */
+class AX12ReadSweep {
+
+public:
+    AX12ReadSweep(AX12Bus &bus);
+
+    /** Start a sweep, the buffers must live until it is over
+     *
+     * @param ids servos, in the order they are read
+     * @param count number of servos
+     * @param start first register
+     * @param length bytes per servo
+     * @param data \p count blocks of \p length bytes
+     * @param results \p count results
+     * @returns AX12_BUSY if started, same as Poll() if over at once, AX12_ERR_ARG if the bus or the sweep is in use
+     */
+    int Begin(const uint8_t *ids, int count, int start, int length, uint8_t *data, int *results);
+
+    /** Make the sweep progress, never blocks
+     *
+     * @returns AX12_BUSY while in flight, then the number of servos without a valid reply
+     */
+    int Poll(void);
+
+    /** Block until the sweep is over, sleeping in the port as AX12Bus::Wait()
+     *
+     * @returns same as Poll()
+     */
+    int Wait(void);
+
+    /** Begin() then Wait()
+     */
+    int Read(const uint8_t *ids, int count, int start, int length, uint8_t *data, int *results);
+
+    /** Time allowed after the computed end of each reply, AX12_SWEEP_MARGIN_US by default
+     */
+    void SetMargin(uint32_t us);
+
+    const AX12SweepStats &Stats(void);
+    void ResetStats(void);
+
+private :
+
+    AX12Bus &_bus;
+    const uint8_t *_ids;
+    int _count;
+    int _index; // servo in flight, _count when over
+    uint8_t _start;
+    uint8_t _length;
+    uint8_t *_data;
+    int *_results;
+    int _failed;
+    uint32_t _begun;
+    uint32_t _margin;
+    AX12SweepStats _stats;
+
+    int launch(void);
+    int next(int result);
+};
+
+#endif
@@ -0,0 +1,170 @@
+/**
+ * @file AX12Teach.h
+ * @author joebarteam11
+ * @brief Teach and replay of multi-joint motions, stored delta encoded in a few KB
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+#ifndef MBED_AX12TEACH_H
+#define MBED_AX12TEACH_H
+
+#include "AX12MultiBus.h"
+
+#ifndef AX12_TEACH_PERIOD_US
+#define AX12_TEACH_PERIOD_US 20000 // default sampling period, 50 Hz
+#endif
+
+#ifndef AX12_TEACH_DEADBAND
+#define AX12_TEACH_DEADBAND 1 // ticks a stored position may differ from the one read (noise of the potentiometer)
+#endif
+
+#define AX12_TEACH_VERSION 1
+#define AX12_TEACH_HEADER 10 // bytes before the IDs of the joints
+
+/** Records motions posed by hand and plays them back
+ *
+ * Teach() cuts the torque of the joints, then every Sample() that is due
+ * reads all their positions in one batch per bus and appends one frame to
+ * the buffer of the caller. Play() plays a recording back: every Step()
+ * that is due decodes the next frame and sends its goals in one SYNC_WRITE
+ * per bus, at the period it was recorded at. A recording can be played
+ * from RAM or from flash (any readable address), as it was written.
+ *
+ * Storage, little endian: 'A' 'T', version, number of joints, period
+ * (100 us), number of frames (32 bits), the IDs, the first frame in full
+ * (2 bytes per joint), then codes predicting each joint at the speed of
+ * the two frames before it (x = 2 x1 - x0):
+ * - 0x00-0x7F: 1 to 128 frames all on the prediction
+ * - 0x80-0xBF: 1 to 64 frames off the prediction for the same joints, a
+ *   bit mask of these joints (1 bit per joint), then per frame the residual
+ *   of each of them in a 4 bits zigzag code (15 escapes to a 16 bits value
+ *   after the codes of the frame).
+ * - 0xC0-0xFF: the same for the joints of the previous mask, not repeated.
+ *
+ * Residuals within AX12_TEACH_DEADBAND are taken as 0: the stored motion
+ * stays within that many ticks of the positions read, and the still or
+ * steadily moving joints cost nothing. A pause is one byte per 128 frames.
+ *
+ * Example:
+ * @code
+ * static uint8_t motion[4096];
+ * AX12Recorder recorder(joints);
+ * const uint8_t arm[6] = {1, 2, 3, 4, 5, 6};
+ *
+ * recorder.Teach(arm, 6, motion, sizeof(motion));   // torque off, 50 Hz
+ * while (!button) {
+ *     recorder.Sample();
+ * }
+ * int size = recorder.Stop();                       // bytes used
+ *
+ * recorder.Play(motion, size);                      // torque on
+ * while (recorder.Step() >= 0) {
+ * }
+ * @endcode
+ */
+class AX12Recorder {
+
+public:
+    /** @param joints buses the servos are placed on
+     */
+    AX12Recorder(AX12MultiBus &joints);
+
+    /** Start a recording: the torque of the joints is cut, the first frame is taken at once
+     *
+     * @param ids joints recorded, at most AX12_TEACH_MAX_JOINTS
+     * @param buffer where the recording is written, kept until Stop()
+     * @param size of \p buffer, bytes
+     * @param period_us sampling period, 100 us to 6.5 s
+     * @returns AX12_OK, AX12_ERR_ARG, or the error of the torque write
+     */
+    int Teach(const uint8_t *ids, int count, uint8_t *buffer, int size, uint32_t period_us = AX12_TEACH_PERIOD_US);
+
+    /** Record a frame if one is due
+     *
+     * @returns 1 if a frame was recorded, 0 if not due, AX12_ERR_LENGTH
+     *          if the buffer is full (the recording is stopped)
+     */
+    int Sample(void);
+
+    /** End the recording
+     *
+     * @returns the size of the recording, bytes
+     */
+    int Stop(void);
+
+    /** Start playing a recording: the first frame is sent, with the torque
+     *
+     * The joints go to the first frame at their moving speed, give them the
+     * time to get there before the first Step().
+     *
+     * @param data a recording, as Teach() wrote it
+     * @param size of \p data, bytes
+     * @returns AX12_OK, AX12_ERR_ARG if \p data is not a recording
+     */
+    int Play(const uint8_t *data, int size);
+
+    /** Send the next frame if one is due
+     *
+     * @returns 1 if a frame was sent, 0 if not due, AX12_ERR_LENGTH at the
+     *          end of the recording (or of a truncated one)
+     */
+    int Step(void);
+
+    /** @returns time until the next Sample() or Step() is due, us
+     */
+    uint32_t Due(void);
+
+    bool Recording(void);
+    bool Playing(void);
+
+    int Frames(void);    // frames recorded, or sent so far
+    int Size(void);      // bytes of the recording so far
+    int Failed(void);    // reads without reply while recording, the previous position is kept
+    uint32_t Period(void);
+
+    /** @returns positions of the last frame recorded or sent, ticks
+     */
+    const uint16_t *Positions(void);
+
+private :
+
+    enum State {
+        IDLE,
+        RECORDING,
+        PLAYING,
+    };
+
+    AX12MultiBus &_joints;
+    State _state;
+    int _count;
+    uint8_t _ids[AX12_TEACH_MAX_JOINTS];
+    int16_t _x0[AX12_TEACH_MAX_JOINTS]; // frame before the last
+    int16_t _x1[AX12_TEACH_MAX_JOINTS]; // last frame
+    uint16_t _positions[AX12_TEACH_MAX_JOINTS];
+
+    uint8_t *_buffer;
+    const uint8_t *_data;
+    int _size;
+    int _length; // bytes written or read
+    int _frames;
+    int _total;  // frames of the recording played
+    int _run;    // frames on the prediction, not yet written or still to send
+    int _group;  // frames in the group of the mask, written or still to send
+    int _group_at; // code of the group being written
+    uint8_t _group_code;
+    uint8_t _mask[(AX12_TEACH_MAX_JOINTS + 7) / 8];
+    int _failed;
+    uint32_t _period;
+    uint32_t _next;
+
+    int predict(int joint);
+    void advance(const int16_t *x);
+    void flush(void);
+    int encode(const uint16_t *positions);
+    int decode(void);
+};
+
+#endif
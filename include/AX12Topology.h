@@ -0,0 +1,220 @@
+/**
+ * @file AX12Topology.h
+ * @author joebarteam11
+ * @brief Servos of a chain kept in flash, checked at startup instead of searched
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+#ifndef MBED_AX12TOPOLOGY_H
+#define MBED_AX12TOPOLOGY_H
+
+#include "AX12Bus.h"
+
+#ifndef AX12_TOPOLOGY_CHUNK
+#define AX12_TOPOLOGY_CHUNK 8 // servos read by one sweep of the search, 24 bytes of stack each
+#endif
+
+#define AX12_TOPOLOGY_MAGIC 0x41583132 // "AX12"
+
+/** Where the cache is kept between two boots
+ *
+ * AX12FlashStorage keeps it in a sector of the internal flash of the board,
+ * AX12FileStorage in a file on a host. Any other memory (EEPROM, FRAM, a
+ * file system) only has to implement these two calls.
+ */
+class AX12Storage {
+
+public:
+    virtual ~AX12Storage() {}
+
+    /** Copy \p size bytes written before by write()
+     *
+     * @returns 0, or a negative value if nothing can be read (the content is then checked anyway)
+     */
+    virtual int read(void *data, uint32_t size) = 0;
+
+    /** Replace what is stored by \p size bytes
+     *
+     * @returns 0, or a negative value on failure
+     */
+    virtual int write(const void *data, uint32_t size) = 0;
+};
+
+/** One servo of the cache: its EEPROM block as it was read
+ *
+ * Model, firmware, ID, baud code, return delay, angle limits, temperature and
+ * voltage limits, max torque, status return level and alarms, at their
+ * addresses in the control table (AX12_REG_MODEL to AX12_REG_ALARM_SHUTDOWN).
+ */
+struct AX12TopologyServo {
+    uint8_t eeprom[AX12_EEPROM_SIZE];
+
+    int Id(void) const { return eeprom[AX12_REG_ID]; }
+    int Code(void) const { return eeprom[AX12_REG_BAUD]; }
+    int Model(void) const { return eeprom[AX12_REG_MODEL] | eeprom[AX12_REG_MODEL + 1] << 8; }
+};
+
+/** What AX12Topology::Start() did
+ */
+struct AX12TopologyReport {
+    bool cached;       // the cache matched the chain, no search
+    int servos;
+    int updated;       // servos whose EEPROM settings changed since the cache was written
+    uint16_t packets;  // READ_DATA sent
+    bool saved;        // the cache was written to the storage
+    uint32_t elapsed_us;
+};
+
+/** The servos of a chain, found once and kept in a storage
+ *
+ * Start() reads the cache from the storage and checks it with one sweep of
+ * READ_DATA of the EEPROM block of the servos it lists, at their bit rates:
+ * a few milliseconds. Only when a servo does not answer, or answers with
+ * another model, ID or baud code, does it fall back to Discover(), which
+ * reads every ID at every standard bit rate (seconds), and the cache is
+ * written again. Settings that changed (a limit written since) are updated in
+ * the cache without a search. A servo added to the chain is not seen by the
+ * check: call Discover() after changing the chain.
+ *
+ * The storage is only written when its content changes.
+ *
+ * Example:
+ * @code
+ * AX12FlashStorage flash;              // last sector of the internal flash
+ * AX12Topology topology(bus, flash);
+ * AX12TopologyReport report;
+ *
+ * if (topology.Start(report) == AX12_OK) {
+ *     printf("%d servos in %lu us%s\n", report.servos, report.elapsed_us, report.cached ? "" : " (searched)");
+ * }
+ * @endcode
+ */
+class AX12Topology {
+
+public:
+    AX12Topology(AX12Bus &bus, AX12Storage &storage);
+
+    /** Load the cache and check it, search the chain if it does not match
+     *
+     * The port is left at the bit rate of the first servo.
+     *
+     * @returns AX12_OK, AX12_ERR_TIMEOUT if no servo answers
+     */
+    int Start(AX12TopologyReport &report);
+
+    /** Read every ID at every standard bit rate, fastest first
+     *
+     * @returns number of servos found (at most AX12_TOPOLOGY_MAX_SERVOS are kept)
+     */
+    int Discover(void);
+
+    /** Check the servos of the cache with one sweep per bit rate
+     *
+     * @returns AX12_OK, or AX12_ERR_ID if a servo is missing or another one answers in its place
+     */
+    int Verify(void);
+
+    /** Read the cache from the storage
+     *
+     * @returns AX12_OK, AX12_ERR_CHECKSUM if the storage holds no valid cache
+     */
+    int Load(void);
+
+    /** Write the cache to the storage, if it differs from what is stored
+     *
+     * @returns AX12_OK, or AX12_ERR_UNREACHABLE if the storage failed
+     */
+    int Save(void);
+
+    /** @returns number of servos in the cache
+     */
+    int Servos(void);
+
+    /** @returns servo \p index (0 to Servos() - 1)
+     */
+    const AX12TopologyServo &Servo(int index);
+
+    /** @returns index of the servo with ID \p id, -1 if it is not in the cache
+     */
+    int Find(int id);
+
+    /** Forget every servo, the storage is left as it is
+     */
+    void Clear(void);
+
+private :
+
+    struct Image {
+        uint32_t magic;
+        uint16_t size;  // of the image, a cache of another build is not read
+        uint16_t count;
+        AX12TopologyServo servos[AX12_TOPOLOGY_MAX_SERVOS];
+        uint32_t checksum;
+    };
+
+    AX12Bus &_bus;
+    AX12Storage &_storage;
+    Image _image;
+    uint32_t _stored; // checksum of the cache in the storage, 0 if unknown
+    bool _written;
+    uint16_t _packets;
+    int _updated;
+
+    int sweep(int code, const uint8_t *ids, int count, bool discover);
+    static uint32_t checksum(const Image &image);
+};
+
+#if defined(__MBED__)
+
+#include "mbed.h"
+
+#ifndef AX12_FLASH_CHUNK
+#define AX12_FLASH_CHUNK 64 // bytes programmed at once, a multiple of the page size of the flash
+#endif
+
+/** AX12Storage in a sector of the internal flash
+ *
+ * The sector must be kept out of the application, for instance by lowering
+ * the ROM size of the linker script (target.restrict_size in mbed_app.json).
+ */
+class AX12FlashStorage : public AX12Storage {
+
+public:
+    /** @param address start of the sector, 0 for the last sector of the flash
+     */
+    AX12FlashStorage(uint32_t address = 0);
+
+    virtual int read(void *data, uint32_t size);
+    virtual int write(const void *data, uint32_t size);
+
+private :
+
+    FlashIAP _flash;
+    uint32_t _address;
+
+    int open(void);
+};
+
+#else
+
+/** AX12Storage in a file of the host
+ */
+class AX12FileStorage : public AX12Storage {
+
+public:
+    AX12FileStorage(const char *path);
+
+    virtual int read(void *data, uint32_t size);
+    virtual int write(const void *data, uint32_t size);
+
+private :
+
+    const char *_path;
+};
+
+#endif
+
+#endif
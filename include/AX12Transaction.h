@@ -0,0 +1,127 @@
+/**
+ * @file AX12Transaction.h
+ * @author joebarteam11
+ * @brief Coordinated writes on many servos, executed together by one ACTION
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+#ifndef MBED_AX12TRANSACTION_H
+#define MBED_AX12TRANSACTION_H
+
+#include "AX12MultiBus.h"
+
+struct AX12TransactionStats {
+    uint32_t commits;
+    uint32_t aborts;
+    uint32_t prepare_us;  // time taken by the REG_WRITEs of the last transaction
+    uint32_t skew_us;     // estimated time between the first and the last servo executing the last
+                          // transaction : start of each ACTION plus its wire time, not measured
+    uint32_t max_skew_us;
+};
+
+/** Register writes staged on many servos and executed at the same instant
+ *
+ * Each servo receives its writes in a REG_WRITE, which it keeps without
+ * executing it, then one broadcast ACTION per bus makes every servo execute
+ * its write when the ACTION packet ends. The servos of one bus move together,
+ * the buses are apart by at most the time of one ACTION packet.
+ *
+ * A servo keeps one registered instruction only: the writes staged on one
+ * servo must cover contiguous registers (they are merged into one REG_WRITE).
+ *
+ * The REG_WRITEs are sent by Prepare() (or by Commit() if not done before),
+ * in parallel on the buses. With the servos configured to answer READ and
+ * PING only (AX12_REG_STATUS_RETURN = 1, and AX12Bus::SetStatusReturn(1)),
+ * they are sent back to back without any status packet.
+ *
+ * Example:
+ * @code
+ * AX12Transaction move(joints);
+ *
+ * move.Stage(1, AX12_REG_GOAL_POSITION, 4, goal_and_speed);
+ * move.Stage(2, AX12_REG_TORQUE_LIMIT, 2, limit);
+ * move.Prepare();           // REG_WRITEs, ahead of time
+ * ...
+ * move.Commit();            // both servos change at the same time
+ * @endcode
+ */
+class AX12Transaction {
+
+public:
+    /** @param joints buses the servos are placed on
+     */
+    AX12Transaction(AX12MultiBus &joints);
+
+    /** Add a write to the transaction
+     *
+     * @param id servo ID, placed on a bus of the controller
+     * @param start first register
+     * @param length number of bytes
+     * @returns AX12_OK, AX12_ERR_ARG if the servo is not placed, if the write
+     *          is not contiguous with the one already staged on the servo or
+     *          if AX12_TRANSACTION_MAX_SERVOS or AX12_TRANSACTION_MAX_LENGTH is reached
+     */
+    int Stage(int id, int start, int length, const uint8_t *data);
+
+    /** Send the REG_WRITEs not sent yet
+     *
+     * @returns AX12_OK or the first error (AX12_ERR_ARG if a bus refuses a
+     *          REG_WRITE, busy or too small), the transaction can still be aborted
+     */
+    int Prepare(void);
+
+    /** Execute the transaction: Prepare() then one ACTION per bus
+     *
+     * The servos not in the transaction execute their own registered write,
+     * if any.
+     *
+     * @returns AX12_OK, or the error of Prepare() (nothing executed, the
+     *          transaction is kept), or the first error of an ACTION (the
+     *          other buses may have executed, the transaction is kept for
+     *          Abort() and the stats are not updated)
+     */
+    int Commit(void);
+
+    /** Drop the transaction
+     *
+     * A REG_WRITE already sent cannot be taken back: it is replaced by a
+     * REG_WRITE of the value the LED register already has, so that the next
+     * ACTION does not change anything.
+     *
+     * @returns AX12_OK or the first error while replacing the REG_WRITEs
+     */
+    int Abort(void);
+
+    /** @returns number of servos in the transaction
+     */
+    int Staged(void);
+
+    /** @returns true if every REG_WRITE of the transaction has been sent
+     */
+    bool Prepared(void);
+
+    const AX12TransactionStats &Stats(void);
+    void ResetStats(void);
+
+private :
+
+    struct Entry {
+        uint8_t id;
+        uint8_t start;
+        uint8_t length;
+        bool sent;
+        uint8_t data[AX12_TRANSACTION_MAX_LENGTH];
+    };
+
+    AX12MultiBus &_joints;
+    Entry _entries[AX12_TRANSACTION_MAX_SERVOS];
+    int _count;
+    AX12TransactionStats _stats;
+
+    void clear(void);
+};
+
+#endif
@@ -0,0 +1,139 @@
+/**
+ * @file AX12Watch.h
+ * @author joebarteam11
+ * @brief Registers watched at a rate, read with as few packets as the addresses allow
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+#ifndef MBED_AX12WATCH_H
+#define MBED_AX12WATCH_H
+
+#include "AX12Scheduler.h"
+
+#ifndef AX12_WATCH_MAX_GAP
+#define AX12_WATCH_MAX_GAP 6 // unwatched bytes read to join two ranges, cheaper than a packet of 14 bytes
+#endif
+
+/** Called with every value read of a watched register
+ */
+typedef void (*AX12WatchCallback)(uint8_t id, uint8_t reg, uint16_t value, void *context);
+
+/** Counters, reset with AX12Watcher::ResetStats()
+ */
+struct AX12WatchStats {
+    uint32_t reads;   // values given to the watches
+    uint32_t packets; // READ_DATA sent
+    uint32_t saved;   // READ_DATA the watches would have sent one by one, less the ones sent
+    uint32_t bytes;   // register bytes read, unwatched gaps included
+    uint32_t errors;  // packets without a valid reply, their watches are read again at the next cycle
+};
+
+/** Reads the registers watched by many consumers in the fewest packets
+ *
+ * Each watch is a register of 1 or 2 bytes of a servo, read every
+ * \p period_us into a variable or a callback. Each Poll() takes the watches
+ * that are due, groups them by servo and joins the ranges that overlap or
+ * are at most AX12_WATCH_MAX_GAP bytes apart into one READ_DATA, up to
+ * AX12_WATCH_MAX_SPAN bytes; the watches not due yet inside a range are read
+ * with it for free. The reads go through the scheduler at the telemetry
+ * priority, and the next Poll() after a reply hands the values to every
+ * watch of its range. Position, speed, load, voltage, temperature and moving
+ * (0x24-0x2E) watched by four consumers are one packet of 11 bytes instead
+ * of six.
+ *
+ * Example:
+ * @code
+ * AX12Watcher watch(sched);
+ * volatile uint16_t position, moving;
+ *
+ * watch.Watch(3, AX12_REG_POSITION, 2, 10000, &position);   // 100 Hz
+ * watch.Watch(3, AX12_REG_MOVING, 1, 20000, &moving);       // 50 Hz, same packet
+ * watch.Watch(3, AX12_REG_TEMP, 1, 1000000, onTemp, 0);     // 1 Hz, every 100th packet
+ * while (true) {
+ *     watch.Poll();
+ *     sched.Poll();
+ * }
+ * @endcode
+ */
+class AX12Watcher {
+
+public:
+    /** @param sched scheduler of the bus the servos are on, polled by the same thread
+     */
+    AX12Watcher(AX12Scheduler &sched);
+
+    /** Watch a register into a variable
+     *
+     * @param length 1 or 2 bytes
+     * @param period_us time between two reads
+     * @returns handle of the watch, AX12_ERR_ARG, or AX12_BUSY if AX12_WATCH_MAX watches are set
+     */
+    int Watch(int id, int reg, int length, uint32_t period_us, volatile uint16_t *variable);
+
+    /** Watch a register into a callback, called from Poll()
+     */
+    int Watch(int id, int reg, int length, uint32_t period_us, AX12WatchCallback callback, void *context);
+
+    /** Stop a watch, its read in flight is still taken
+     */
+    void Unwatch(int handle);
+
+    /** Bytes of unwatched registers read to join two ranges, 0 joins the adjacent ones only, -1 joins none
+     */
+    void SetMaxGap(int bytes);
+
+    /** Hand the replies in to the watches and send the reads that are due
+     *
+     * @returns number of packets sent
+     */
+    int Poll(void);
+
+    /** @returns time until a watch is due or a reply is in, us
+     */
+    uint32_t Due(void);
+
+    /** @returns last value read of a watch
+     */
+    uint16_t Value(int handle);
+
+    const AX12WatchStats &Stats(void);
+    void ResetStats(void);
+
+private :
+
+    struct Entry {
+        uint8_t id;
+        uint8_t reg;
+        uint8_t length;
+        bool used;
+        int8_t read;  // packet in flight the watch is in, -1 if none
+        bool due;     // selected for the next packet
+        uint16_t value;
+        uint32_t period;
+        uint32_t next;
+        volatile uint16_t *variable;
+        AX12WatchCallback callback;
+        void *context;
+    };
+
+    struct Read {
+        AX12Request request;
+        uint8_t data[AX12_WATCH_MAX_SPAN];
+        bool busy;
+    };
+
+    AX12Scheduler &_sched;
+    Entry _watches[AX12_WATCH_MAX];
+    Read _reads[AX12_WATCH_MAX_READS];
+    int _gap;
+    AX12WatchStats _stats;
+
+    int add(int id, int reg, int length, uint32_t period_us);
+    void collect(void);
+    int send(int first, uint32_t now);
+};
+
+#endif
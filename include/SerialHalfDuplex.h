@@ -24,15 +24,19 @@
 #ifndef MBED_SERIALHALFDUPLEX_H
 #define MBED_SERIALHALFDUPLEX_H
 
-#define BUF_SIZE 16
-
 #include "device.h"
+#include "AX12Config.h"
+#include "AX12Port.h"
 
 #if 1
 
 #include "SerialBase.h"
+#include "Timeout.h"
 #include "PinNames.h"
 #include "PeripheralNames.h"
+#if MBED_CONF_RTOS_PRESENT
+#include "rtos/EventFlags.h"
+#endif
 
 namespace mbed {
 
@@ -76,7 +80,7 @@ namespace mbed {
  *
  * For Simplex and Full-Duplex Serial communication, see <Serial>
  */
-class SerialHalfDuplex : public SerialBase {
+class SerialHalfDuplex : public SerialBase, public AX12Port {
 
 public:
     /* Constructor: SerialHalfDuplex
@@ -196,13 +200,41 @@ Serial::Even, Serial::Forced1, Serial::Forced0; default = Serial::None)
     virtual int putc(int c);
     virtual int getc(int i);
 
+    /* Functions: AX12Port
+     *  Interrupt driven packet transmission, used by AX12Bus. send() returns
+     *  at once, each byte is sent when the echo of the previous one comes back
+     *  on the RX pin, then the line is released for the reply. wait() puts
+     *  the calling thread to sleep until the next byte or the deadline.
+     */
+    virtual int send(const uint8_t *data, int length);
+    virtual bool sending(void);
+    virtual int receive(uint8_t *data, int length);
+    virtual void flush(void);
+    virtual int baudrate(void);
+    virtual int set_baudrate(int baud);
+    virtual bool line_error(void);
+    virtual bool wait(uint32_t us);
+
 private :
 
     PinName     _txpin;
-    int buf[BUF_SIZE];
-    short idx;
+    uint8_t buf[AX12_SERIAL_BUF_SIZE];
+    volatile short idx;
+    volatile short _rd;
+    const uint8_t *_tx;
+    volatile int _tx_length;
+    volatile int _tx_sent;
+    volatile int _tx_echoed;
+    volatile bool _line_error;
+    Timeout _timeout;
+#if MBED_CONF_RTOS_PRESENT
+    rtos::EventFlags _events;
+#else
+    volatile bool _wake;
+#endif
     virtual void RXinterrupt(void);
-    virtual bool eraseBuffer(int *buffer);
+    void wake(void);
+    virtual bool eraseBuffer(uint8_t *buffer);
 }; // End class SerialHalfDuplex
 
 } // End namespace
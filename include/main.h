@@ -13,6 +13,9 @@
 
 #include "mbed.h"
 #include "AX12.h"
+#include "AX12Bus.h"
+#include "AX12Baud.h"
+#include "AX12Topology.h"
 
 #define TX D1
 #define RX D0
@@ -27,6 +30,14 @@
 #define CLOSING_SPEED 0.9 //[0.0 ; 1.0]
 #define DISABLE false
 
+// Secteur de flash du cache du bus : juste après l'application, que target.restrict_size de mbed_app.json
+// arrête avant lui (F303K8 : page de 2 Ko en 0x0800F800 sur 64 Ko ; F446RE : secteur de 128 Ko en 0x08060000)
+#if defined(MBED_APP_START) && defined(MBED_APP_SIZE)
+#define TOPOLOGY_FLASH_ADDRESS (MBED_APP_START + MBED_APP_SIZE)
+#else
+#define TOPOLOGY_FLASH_ADDRESS 0 // dernier secteur de la flash, à réserver pour une autre carte
+#endif
+
 
 
 AX12 *Motor=NULL;
@@ -42,6 +53,37 @@ void initMotor(int baud, int ID = MOTORID){
 }
 
 
+/**
+ * @brief Fonction qui initialise le servomoteur à l'ID et au baud rate retrouvés sur le bus, sans les supposer
+ * 
+ * Le dernier état connu du bus est gardé dans le secteur de flash TOPOLOGY_FLASH_ADDRESS, réservé par
+ * mbed_app.json : au démarrage il est vérifié en quelques millisecondes, le bus n'est parcouru en entier
+ * (quelques secondes) que s'il a changé
+ * 
+ * @return l'ID du servomoteur, 0 si aucun ne répond (initialisé alors avec MOTORID et AX12_BAUD)
+ */
+int initMotorFromCache(){
+    int baud = AX12_BAUD;
+    int ID = 0;
+    {
+        SerialHalfDuplex serial(TX, RX, AX12_BAUD);
+        AX12Bus bus(serial);
+        AX12FlashStorage flash(TOPOLOGY_FLASH_ADDRESS);
+        AX12Topology topology(bus, flash);
+        AX12TopologyReport report;
+
+        if (topology.Start(report) == AX12_OK) {
+            ID = topology.Servo(0).Id();
+            baud = AX12_BaudFromCode(topology.Servo(0).Code());
+            printf("%d servomoteur(s) en %lu ms%s\n", report.servos, (unsigned long)report.elapsed_us / 1000,
+                   report.cached ? "" : " (bus parcouru)");
+        }
+    }
+    initMotor(baud, ID ? ID : MOTORID);
+    return ID;
+}
+
+
 /**
  * @brief Fonction permettant d'enclencher un Timer
  * 
@@ -105,6 +147,74 @@ void factoryReset(){
     }//reset motors ID to 1
 }
 
+/**
+ * @brief Fonction qui passe le servomoteur au baud rate le plus rapide qui fonctionne sans erreur
+ * 
+ * @param baud baud rate actuel du servomoteur
+ * @param ID ID du servomoteur
+ * @return le baud rate obtenu, 0 si le servomoteur ne répond plus
+ */
+int negotiateMotorBaud(int baud, int ID = MOTORID){
+    SerialHalfDuplex serial(TX, RX, baud);
+    AX12Bus bus(serial);
+    AX12BaudNegotiator negotiator(bus);
+    const uint8_t ids[1] = {(uint8_t)ID};
+
+    int r = negotiator.Negotiate(ids, 1);
+    for (int i = 0; i < negotiator.Steps(); i++) {
+        const AX12BaudStep &step = negotiator.Step(i);
+        printf("%7d bps : %lu ppm d'erreurs, %lu octets/s\n", step.baud, (unsigned long)step.error_ppm,
+               (unsigned long)step.throughput);
+    }
+    return (r == AX12_OK) ? serial.baudrate() : 0;
+}
+
+/**
+ * @brief Fonction qui mesure le temps CPU d'une lecture de position, en attente active puis en dormant pendant la réponse
+ * 
+ * @param baud baud rate actuel du servomoteur
+ * @param ID ID du servomoteur
+ * @param n nombre de lectures de chaque mesure
+ */
+void measureMotorCpu(int baud, int ID = MOTORID, int n = 1000){
+    SerialHalfDuplex serial(TX, RX, baud);
+    AX12Bus bus(serial);
+    uint8_t data[2];
+
+    for (int sleep = 0; sleep < 2; sleep++) {
+        bus.SetSleep(sleep);
+        bus.ResetStats();
+        for (int i = 0; i < n; i++) {
+            bus.Read(ID, AX12_REG_POSITION, 2, data);
+        }
+        const AX12BusStats &stats = bus.Stats();
+        unsigned long count = stats.transactions ? stats.transactions : 1;
+        printf("%s : %lu us par transaction, dont %lu us de CPU (%lu timeouts)\n", sleep ? "sommeil       " : "attente active",
+               (unsigned long)stats.busy_us / count, (unsigned long)(stats.busy_us - stats.idle_us) / count,
+               (unsigned long)stats.timeouts);
+    }
+}
+
+/**
+ * @brief Fonction qui affiche les événements enregistrés par la librairie depuis le dernier appel (compiler avec -DAX12_LOG_LEVEL=1 à 3)
+ * 
+ * @attention À appeler en dehors des boucles de commande : c'est ici que le printf bloque, pas pendant les transactions
+ */
+void printMotorLog(){
+    AX12LogEntry entries[8];
+    char text[96];
+    int n;
+    while ((n = AX12Log::system().Read(entries, 8)) > 0) {
+        for (int i = 0; i < n; i++) {
+            AX12Log::Format(entries[i], text, sizeof(text));
+            printf("%s\n", text);
+        }
+    }
+    if (AX12Log::system().Lost()) {
+        printf("%lu événements perdus\n", (unsigned long)AX12Log::system().Lost());
+    }
+}
+
 void setMotorBaud(int baud){
     AX12 servo(TX, RX, BROADCAST, AX12_BASE_BAUD);
     servo.SetMode(1); //See AX12 documentation or AX12.h
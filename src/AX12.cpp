@@ -23,18 +23,19 @@
 #include "mbed.h"
 #include "AX12.h"
 
+#include <string.h>
+
 AX12::AX12(PinName tx, PinName rx, int ID, int baud)
-        : _ax12(tx,rx,baud) 
+        : _ax12(tx,rx,baud), _bus(_ax12), _batch(_bus, &_held, 1)
 {
+    _batching = false;
     _baud = baud;
     _ID = ID;
     _ax12.baud(_baud);
 }
 
 int AX12::FactoryReset (void) {
-    #ifdef AX12_DEBUG
-        printf("Resetting to factory...\n");
-    #endif
+    AX12_LOG(AX12_LOG_INFO, AX12_EV_FACTORY_RESET, _ID, 0, 0);
 
     return (write(_ID, 0, 1, 0, 2));
 }
@@ -43,6 +44,11 @@ int AX12::FactoryReset (void) {
 //  1 = Rotational -1 to 1 speed
 int AX12::SetMode(int mode) {
 
+    ScopedLock<PlatformMutex> lock(_lock);
+
+    // CW and CCW limits in one packet, the speed in a second one
+    bool batching = _batching;
+    _batching = true;
     if (mode == 1) { // set CR
         SetCWLimit(0);
         SetCCWLimit(0);
@@ -52,7 +58,8 @@ int AX12::SetMode(int mode) {
         SetCCWLimit(300);
         SetCRSpeed(0.0);
     }
-    return(0);
+    _batching = batching;
+    return (batching ? 0 : Flush());
 }
 
 
@@ -64,16 +71,14 @@ int AX12::SetGoal(int degrees, int flags) {
     char reg_flag = 0;
     char data[2];
 
-    // set the flag is only the register bit is set in the flag
-    if (flags == 0x2) {
+    // set the flag if the register bit is set in the flags
+    if (flags & 0x2) {
         reg_flag = 1;
     }
 
     // 1023 / 300 * degrees
     short goal = (1023 * degrees) / 300;
-    if (AX12_DEBUG) {
-        printf("SetGoal to 0x%x\n",goal);
-    }
+    AX12_LOG(AX12_LOG_INFO, AX12_EV_SET_GOAL, _ID, goal, 0);
 
     data[0] = goal & 0xff; // bottom 8 bits
     data[1] = goal >> 8;   // top 8 bits
@@ -81,7 +86,7 @@ int AX12::SetGoal(int degrees, int flags) {
     // write the packet, return the error code
     int rVal = write(_ID, AX12_REG_GOAL_POSITION, 2, data, reg_flag);
 
-    if (flags == 1) {
+    if ((flags & 0x1) && !reg_flag) {
         // block until it comes to a halt
         while (isMoving()) {}
     }
@@ -94,9 +99,7 @@ int AX12::SetBaud (int baud) {
     char data[1];
     data[0] = baud;
 
-#ifdef AX12_DEBUG
-    printf("Setting Baud rate to %d\n",baud);
-#endif
+    AX12_LOG(AX12_LOG_INFO, AX12_EV_SET_BAUD, 0xFE, baud, 0);
 
     return (write(0xFE, AX12_REG_BAUD, 1, data));
 
@@ -133,9 +136,7 @@ int AX12::SetCWLimit (int degrees) {
     // 1023 / 300 * degrees
     short limit = (1023 * degrees) / 300;
 
-    if (AX12_DEBUG) {
-        printf("SetCWLimit to 0x%x\n",limit);
-    }
+    AX12_LOG(AX12_LOG_INFO, AX12_EV_SET_CW_LIMIT, _ID, limit, 0);
 
     data[0] = limit & 0xff; // bottom 8 bits
     data[1] = limit >> 8;   // top 8 bits
@@ -152,9 +153,7 @@ int AX12::SetCCWLimit (int degrees) {
     // 1023 / 300 * degrees
     short limit = (1023 * degrees) / 300;
 
-    if (AX12_DEBUG) {
-        printf("SetCCWLimit to 0x%x\n",limit);
-    }
+    AX12_LOG(AX12_LOG_INFO, AX12_EV_SET_CCW_LIMIT, _ID, limit, 0);
 
     data[0] = limit & 0xff; // bottom 8 bits
     data[1] = limit >> 8;   // top 8 bits
@@ -168,9 +167,7 @@ int AX12::SetTorque (bool state){
     char data[1];
     data[0] = state;
 
-    if(AX12_DEBUG){
-        printf("Setting torque to %i\n",state);
-    }
+    AX12_LOG(AX12_LOG_INFO, AX12_EV_SET_TORQUE, _ID, state, 0);
     // write the packet, return the error code
     return (write(_ID, AX12_REG_ENABLE_TORQUE, 1, data));
 }
@@ -179,9 +176,7 @@ int AX12::SetMaxTorque (float percentage) {
     char data[2];
     short limit = 1023 * (float)percentage;
 
-    if (AX12_DEBUG) {
-        printf("SetMaxTorque to 0x%x\n",limit);
-    }
+    AX12_LOG(AX12_LOG_INFO, AX12_EV_SET_MAX_TORQUE, _ID, limit, 0);
 
     data[0] = limit & 0xff; // bottom 8 bits
     data[1] = limit >> 8;   // top 8 bits
@@ -195,9 +190,7 @@ int AX12::SetID (int NewID, int CurrentID) {
 
     char data[1];
     data[0] = NewID;
-    if (AX12_DEBUG) {
-        printf("Setting ID from 0x%x to 0x%x\n",CurrentID,NewID);
-    }
+    AX12_LOG(AX12_LOG_INFO, AX12_EV_SET_ID, CurrentID, NewID, 0);
     return (write(CurrentID, AX12_REG_ID, 1, data));
 
 }
@@ -214,65 +207,18 @@ int AX12::isMoving(void) {
 
 void AX12::trigger(void) {
 
-    char TxBuf[16];
-    char sum = 0;
+    ScopedLock<PlatformMutex> lock(_lock);
 
-    if (AX12_TRIGGER_DEBUG) {
-        printf("\nTriggered\n");
-    }
-
-    // Build the TxPacket first in RAM, then we'll send in one go
-    if (AX12_TRIGGER_DEBUG) {
-        printf("\nTrigger Packet\n  Header : 0xFF, 0xFF\n");
-    }
-
-    TxBuf[0] = 0xFF;
-    TxBuf[1] = 0xFF;
-
-    // ID - Broadcast
-    TxBuf[2] = 0xFE;
-    sum += TxBuf[2];
-
-    if (AX12_TRIGGER_DEBUG) {
-        printf("  ID : %d\n",TxBuf[2]);
-    }
-
-    // Length
-    TxBuf[3] = 0x02;
-    sum += TxBuf[3];
-    if (AX12_TRIGGER_DEBUG) {
-        printf("  Length %d\n",TxBuf[3]);
-    }
-
-    // Instruction - ACTION
-    TxBuf[4] = 0x04;
-    sum += TxBuf[4];
-    if (AX12_TRIGGER_DEBUG) {
-        printf("  Instruction 0x%X\n",TxBuf[5]);
-    }
-
-    // Checksum
-    TxBuf[5] = 0xFF - sum;
-    if (AX12_TRIGGER_DEBUG) {
-        printf("  Checksum 0x%X\n",TxBuf[5]);
-    }
+    AX12_LOG(AX12_LOG_INFO, AX12_EV_TRIGGER, 0xFE, 0, 0);
 
-    // Transmit the packet in one burst with no pausing
-    for (int i = 0; i < 6 ; i++) {
-        _ax12.putc(TxBuf[i]);
-    }
-    // This is a broadcast packet, so there will be no reply
-
-    return;
+    // Broadcast ACTION, there will be no reply
+    _batch.Flush();
+    _bus.Action();
 }
 
 
 float AX12::GetPosition(void) {
 
-    if (AX12_DEBUG) {
-        printf("\nGetPosition(%d)",_ID);
-    }
-
     char data[2];
 
     int ErrorCode = read(_ID, AX12_REG_POSITION, 2, data);
@@ -285,9 +231,6 @@ float AX12::GetPosition(void) {
 
 float AX12::GetTemp (void) {
 
-    if (AX12_DEBUG) {
-        printf("\nGetTemp(%d)",_ID);
-    }
     char data[1];
     int ErrorCode = read(_ID, AX12_REG_TEMP, 1, data);
     float temp = data[0];
@@ -296,9 +239,6 @@ float AX12::GetTemp (void) {
 
 
 float AX12::GetVolts (void) {
-    if (AX12_DEBUG) {
-        printf("\nGetVolts(%d)",_ID);
-    }
     char data[1];
     int ErrorCode = read(_ID, AX12_REG_VOLTS, 1, data);
     float volts = data[0]/10.0;
@@ -308,255 +248,105 @@ float AX12::GetVolts (void) {
 
 float AX12::GetLoad (void) {
 
-    if (AX12_DEBUG) {
-        printf("\nGetLoad(%d)",_ID);
-    }
-
     char data[2];
 
     int ErrorCode = read(_ID, AX12_REG_LOAD, 2, data);
-    short val = data[0] + (data[1] << 8);
+    // char is signed : a low byte above 127 used to give a wrong value
+    uint16_t val = (uint8_t)data[0] | ((uint8_t)data[1] << 8);
     if(AX12_CALIB){
             printf("Raw value: %i\n",val);
         }
-    if (val <=1023) {
-        if(AX12_DEBUG){
-            printf("CounterClockwise: %i\n",val);
-        }
-        return (-val/1023.0);
-    }
-    else {
-        if(AX12_DEBUG){
-            printf("Clockwise: %i\n",val);
-        }
-        return ((val-1024.0)/1023.0);
-    }
+    int load = AX12_LoadFromRegister(val);
+    AX12_LOG(AX12_LOG_INFO, AX12_EV_LOAD, _ID, 0, load);
+    return (load/1023.0);
 
 }
 
 
-int AX12::read(int ID, int start, int bytes, char* data) {
-
-    char PacketLength = 0x4;
-    char TxBuf[16];
-    char sum = 0;
-    char Status[16];
-
-    Status[4] = 0xFE; // return code
-
-    if (AX12_READ_DEBUG) {
-        printf("\nread(%d,0x%x,%d,data)\n",ID,start,bytes);
-    }
+void AX12::SetBatching(bool on) {
+    ScopedLock<PlatformMutex> lock(_lock);
+    _batching = on;
+}
 
-    // Build the TxPacket first in RAM, then we'll send in one go
-    if (AX12_READ_DEBUG) {
-        printf("\nInstruction Packet\n  Header : 0xFF, 0xFF\n");
-    }
+int AX12::Flush(void) {
+    ScopedLock<PlatformMutex> lock(_lock);
+    return _batch.Flush();
+}
 
-    TxBuf[0] = 0xff;
-    TxBuf[1] = 0xff;
 
-    // ID
-    TxBuf[2] = ID;
-    sum += TxBuf[2];
-    if (AX12_READ_DEBUG) {
-        printf("  ID : %d\n",TxBuf[2]);
-    }
+int AX12::read(int ID, int start, int bytes, char* data) {
 
-    // Packet Length
-    TxBuf[3] = PacketLength;    // Length = 4 ; 2 + 1 (start) = 1 (bytes)
-    sum += TxBuf[3];            // Accululate the packet sum
-    if (AX12_READ_DEBUG) {
-        printf("  Length : 0x%x\n",TxBuf[3]);
+    if (bytes < 0 || start + bytes > AX12_TABLE_SIZE) {
+        return AX12_ERR_ARG;
     }
 
-    // Instruction - Read
-    TxBuf[4] = 0x2;
-    sum += TxBuf[4];
-    if (AX12_READ_DEBUG) {
-        printf("  Instruction : 0x%x\n",TxBuf[4]);
-    }
+    AX12_LOG(AX12_LOG_DEBUG, AX12_EV_READ, ID, start | (bytes << 8), 0);
 
-    // Start Address
-    TxBuf[5] = start;
-    sum += TxBuf[5];
-    if (AX12_READ_DEBUG) {
-        printf("  Start Address : 0x%x\n",TxBuf[5]);
-    }
+    ScopedLock<PlatformMutex> lock(_lock);
 
-    // Bytes to read
-    TxBuf[6] = bytes;
-    sum += TxBuf[6];
-    if (AX12_READ_DEBUG) {
-        printf("  No bytes : 0x%x\n",TxBuf[6]);
+    // A quarantined servo whose back-off is over is pinged first, see AX12Bus::Probe()
+    if (_bus.Probe() == AX12_BUSY) {
+        _bus.Wait();
     }
 
-    // Checksum
-    TxBuf[7] = 0xFF - sum;
-    if (AX12_READ_DEBUG) {
-        printf("  Checksum : 0x%x\n",TxBuf[7]);
+    // The writes held go first : the read sees them
+    if (_batch.Pending()) {
+        _batch.Flush();
     }
 
-    // Transmit the packet in one burst with no pausing
-    for (int i = 0; i<8 ; i++) {
-        _ax12.putc(TxBuf[i]);
+    // Ends with the last byte of the reply, or one packet time after the line went quiet
+    int result = _bus.Read(ID, start, bytes, (uint8_t *)data);
+    if (result < 0) {
+        memset(data, 0, bytes); // nothing of a bad reply
     }
 
-    // Wait for the bytes to be transmitted
-    wait_us(20);
-
-    // Skip if the read was to the broadcast address
-    if (_ID != 0xFE) {
-        
-        // Receive the Status packet 6+ number of bytes read
-        //ThisThread::sleep_for(100ms);
-        wait_us(100*1000);
-        for (int i=0; i<(6+bytes) ; i++){          
-            Status[i] = (char)_ax12.getc(i);
-        }
-
-        // Copy the data from Status into data for return
-        for (int i=0; i < Status[3]-2 ; i++) {
-            data[i] = Status[5+i];
-        }
-
-        if (AX12_READ_DEBUG) {
-            printf("\nStatus Packet\n");
-            printf("  Header : 0x%x\n",Status[0]);
-            printf("  Header : 0x%x\n",Status[1]);
-            printf("  ID : 0x%x\n",Status[2]);
-            printf("  Length : 0x%x\n",Status[3]);
-            printf("  Error Code : 0x%x\n",Status[4]);
-
-            for (int i=0; i < Status[3]-2 ; i++) {
-                printf("  Data : 0x%x\n",Status[5+i]);
-            }
-
-            printf("  Checksum : 0x%x\n",Status[5+(Status[3]-2)]);
-        }
+    // The first two bytes read, little endian as the registers
+    AX12_LOG(AX12_LOG_DEBUG, AX12_EV_READ_DONE, ID,
+             ((bytes > 0) ? (uint8_t)data[0] : 0) | ((bytes > 1) ? (uint8_t)data[1] << 8 : 0), result);
 
-    } // if (ID!=0xFE)
-
-    return(Status[4]);
+    return(result);
 }
 
 
 int AX12:: write(int ID, int start, int bytes, char* data, int flag) {
-// 0xff, 0xff, ID, Length, Intruction(write), Address, Param(s), Checksum
-
-    char TxBuf[16];
-    char sum = 0;
-    char Status[6];
-
-    if (AX12_WRITE_DEBUG) {
-        printf("\nwrite(%d,0x%x,%d,data,%d)\n",ID,start,bytes,flag);
-    }
-
-    // Build the TxPacket first in RAM, then we'll send in one go
-    if (AX12_WRITE_DEBUG) {
-        printf("\nInstruction Packet\n  Header : 0xFF, 0xFF\n");
-    }
-
-    TxBuf[0] = 0xff;
-    TxBuf[1] = 0xff;
-
-    // ID
-    TxBuf[2] = ID;
-    sum += TxBuf[2];
 
-    if (AX12_WRITE_DEBUG) {
-        printf("  ID : %d\n",TxBuf[2]);
+    if (bytes < 0 || start + bytes > AX12_TABLE_SIZE) {
+        return AX12_ERR_ARG;
     }
 
-    // packet Length
-    TxBuf[3] = 3+bytes;
-    sum += TxBuf[3];
+    AX12_LOG(AX12_LOG_DEBUG, AX12_EV_WRITE, ID, start | (bytes << 8), flag);
 
-    if (AX12_WRITE_DEBUG) {
-        printf("  Length : %d\n",TxBuf[3]);
-    }
+    ScopedLock<PlatformMutex> lock(_lock);
 
-    // Instruction
-    if (flag == 1) {
-        TxBuf[4]=0x04;
-        sum += TxBuf[4];
-    } else {
-        TxBuf[4]=0x03;
-        sum += TxBuf[4];
+    if (_bus.Probe() == AX12_BUSY) {
+        _bus.Wait();
     }
 
-    if (AX12_WRITE_DEBUG) {
-        printf("  Instruction : 0x%x\n",TxBuf[4]);
-    }
-
-    // Start Address
-    TxBuf[5] = start;
-    sum += TxBuf[5];
-    if (AX12_WRITE_DEBUG) {
-        printf("  Start : 0x%x\n",TxBuf[5]);
-    }
-
-    // data
-    for (char i=0; i<bytes ; i++) {
-        TxBuf[6+i] = data[i];
-        sum += TxBuf[6+i];
-        if (AX12_WRITE_DEBUG) {
-            printf("  Data : 0x%x\n",TxBuf[6+i]);
-        }
-    }
-
-    // checksum
-    TxBuf[6+bytes] = 0xFF - sum;
-    if (AX12_WRITE_DEBUG) {
-        printf("  Checksum : 0x%x\n",TxBuf[6+bytes]);
-    }
-    
-    int count = 7+bytes;
-
-    if(flag == 2){
-        TxBuf[0]=0xFF;
-        TxBuf[1]=0xFF;
-        TxBuf[2]=_ID;
-        TxBuf[3]=0x02;
-        TxBuf[4]=0x06;
-        TxBuf[5]=0xFF-(TxBuf[2]+TxBuf[3]+TxBuf[4]);
-        count = 6;
-    }
-
-    // Transmit the packet in one burst with no pausing
-    for (int i = 0; i < count ; i++) {
-        int retu = _ax12.putc(TxBuf[i]);
-    }
-
-    // Wait for data to transmit
-    wait_us(20);
-
-    // make sure we have a valid return
-    Status[4]=0x00;
-
-    // we'll only get a reply if it was not broadcast
-    if (_ID!=0xFE) {
-
-        // response is always 6 bytes
-        // 0xFF, 0xFF, ID, Length Error, Param(s) Checksum
-        //ThisThread::sleep_for(100ms);
-        wait_us(100*1000);
-        for (int i=0; i < 6 ; i++) {
-            Status[i] = (char)_ax12.getc(i);
+    int result;
+    if (_batching && flag == 0) {
+        // Held, merged with the other writes by Flush()
+        result = _batch.Write(ID, start, bytes, (const uint8_t *)data);
+    } else if (flag == 2) {
+        // RESET : back to the factory settings
+        _batch.Flush();
+        _batch.Forget(ID);
+        if (!_bus.Packet(ID, AX12_INST_RESET, 0)) {
+            return AX12_BUSY;
         }
-        
-        // Build the TxPacket first in RAM, then we'll send in one go
-        if (AX12_WRITE_DEBUG) {
-            printf("\nStatus Packet\n  Header : 0x%X, 0x%X\n",Status[0],Status[1]);
-            printf("  ID : %d\n",Status[2]);
-            printf("  Length : %d\n",Status[3]);
-            printf("  Error : 0x%x\n",Status[4]);
-            printf("  Checksum : 0x%x\n",Status[5]);
+        result = _bus.Start();
+        result = (result == AX12_BUSY) ? _bus.Wait() : result;
+    } else {
+        _batch.Flush();
+        result = _bus.Write(ID, start, bytes, (const uint8_t *)data, flag == 1);
+        // Known to the batch, unless it waits for an ACTION
+        if (result == AX12_OK && flag == 0 && start > AX12_REG_BAUD) {
+            _batch.Learn(ID, start, bytes, (const uint8_t *)data);
+        } else {
+            _batch.Forget(ID);
         }
-
-
     }
 
-    return(Status[4]); // return error code
+    AX12_LOG(AX12_LOG_DEBUG, AX12_EV_WRITE_DONE, ID, 0, result);
 
-}
\ No newline at end of file
+    return(result); // return error code
+}
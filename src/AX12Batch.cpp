@@ -0,0 +1,351 @@
+/**
+ * @file AX12Batch.cpp
+ * @author joebarteam11
+ * @brief Register writes gathered during a control tick, sent in the fewest packets
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+#include "AX12Batch.h"
+
+#include <string.h>
+
+// Bits \p from to \p from + \p count - 1
+static uint32_t AX12_BatchMask(int from, int count)
+{
+    return ((count >= 32) ? 0xFFFFFFFF : ((1UL << count) - 1)) << from;
+}
+
+static int AX12_BatchLow(uint32_t mask)
+{
+    int n = 0;
+    while (!(mask & 1)) {
+        mask >>= 1;
+        n++;
+    }
+    return n;
+}
+
+static int AX12_BatchHigh(uint32_t mask)
+{
+    int n = -1;
+    while (mask) {
+        mask >>= 1;
+        n++;
+    }
+    return n;
+}
+
+// Goal and speed : writing them enables the torque, once the whole packet is written
+#define AX12_BATCH_MOTION (0xFULL << AX12_REG_GOAL_POSITION)
+
+// Registers which change what a goal or speed write does : torque enable, CW and CCW limits (wheel mode)
+#define AX12_BATCH_MODE ((1ULL << AX12_REG_ENABLE_TORQUE) | (0xFULL << AX12_REG_CW_LIMIT))
+
+// Registers the servo changes by itself (torque and torque limit cut by an alarm), read only (model,
+// firmware, calibration), or with a side effect : never written again to fill a hole. Nor is the EEPROM
+// below 0x18 : each write wears it, and a stale value there outlives a power cycle
+#define AX12_BATCH_VOLATILE \
+    (((1ULL << AX12_EEPROM_SIZE) - 1) | (1ULL << AX12_REG_ENABLE_TORQUE) | AX12_BATCH_MOTION \
+     | (0x3ULL << AX12_REG_TORQUE_LIMIT) | (((1ULL << 11) - 1) << AX12_REG_POSITION))
+
+// Bytes of the window from \p base that may be written again with a known value
+static uint32_t AX12_BatchRewritable(int base, uint32_t known)
+{
+    return known & ~(uint32_t)(AX12_BATCH_VOLATILE >> base);
+}
+
+// First register of a window holding \p start, as far in the table as it goes
+static int AX12_BatchBase(int start)
+{
+    int base = AX12_TABLE_SIZE - AX12_BATCH_SPAN;
+    return (start < base) ? start : (base < 0) ? 0 : base;
+}
+
+AX12WriteBatch::AX12WriteBatch(AX12Bus &bus, AX12BatchEntry *entries, int count)
+    : _bus(bus)
+{
+    _entries = entries;
+    _count = (count < 0) ? 0 : (count > AX12_BATCH_MAX_SERVOS) ? AX12_BATCH_MAX_SERVOS : count;
+    for (int i = 0; i < _count; i++) {
+        _entries[i].used = false;
+    }
+    _staged = 0;
+    _first = 0;
+    _window = 0;
+    ResetStats();
+}
+
+int AX12WriteBatch::Write(int id, int start, int length, const uint8_t *data)
+{
+    if (id < 0 || id > AX12_BROADCAST_ID || start < 0 || length <= 0 || start + length > AX12_TABLE_SIZE
+        || length > AX12_BATCH_SPAN) {
+        return AX12_ERR_ARG;
+    }
+
+    // Changes the addressing of the chain (or no entry to hold it) : never held
+    if (id == AX12_BROADCAST_ID || (start <= AX12_REG_BAUD && start + length > AX12_REG_ID) || _count == 0) {
+        int result = Flush();
+        int direct = _bus.Write(id, start, length, data);
+        _stats.writes++;
+        _stats.packets++;
+        if (id == AX12_BROADCAST_ID) {
+            for (int i = 0; i < _count; i++) {
+                _entries[i].used = false;
+            }
+        } else {
+            Forget(id);
+        }
+        return (result != AX12_OK) ? result : direct;
+    }
+
+    int result = AX12_OK;
+    Entry *e = find(id, true);
+    if (!e) {
+        result = Flush();
+        e = find(id, true);
+    }
+
+    // Out of the window of the servo : its staged writes first, then the window moves over the write
+    if (!e->known) {
+        e->base = AX12_BatchBase(start);
+    } else if (start < e->base || start + length > e->base + AX12_BATCH_SPAN) {
+        if (e->dirty) {
+            result = flush(*e);
+        }
+        int base = (start < e->base) ? AX12_BatchBase(start) : start + length - AX12_BATCH_SPAN;
+        int shift = base - e->base;
+        int keep = AX12_BATCH_SPAN - ((shift < 0) ? -shift : shift); // bytes in both windows
+        if (keep <= 0) {
+            e->known = 0;
+        } else if (shift > 0) {
+            memmove(e->data, &e->data[shift], keep);
+            e->known >>= shift;
+        } else {
+            memmove(&e->data[-shift], e->data, keep);
+            e->known <<= -shift;
+        }
+        e->known &= AX12_BatchMask(0, AX12_BATCH_SPAN);
+        e->base = base;
+    }
+
+    // A hole of unknown bytes between the staged bytes and these, or a mode change : the staged ones first
+    uint32_t bytes = AX12_BatchMask(start - e->base, length);
+    uint32_t dirty = e->dirty | bytes;
+    int lo = AX12_BatchLow(dirty);
+    uint32_t span = AX12_BatchMask(lo, AX12_BatchHigh(dirty) - lo + 1);
+    // A mode write after a goal or speed staged : in one packet, the servo would apply the goal in the new mode
+    bool mode = (bytes & (uint32_t)(AX12_BATCH_MODE >> e->base)) && (e->dirty & (uint32_t)(AX12_BATCH_MOTION >> e->base));
+    if (e->dirty && (mode || (span & ~(AX12_BatchRewritable(e->base, e->known) | e->dirty | bytes)))) {
+        int r = flush(*e);
+        result = (result != AX12_OK) ? result : r;
+        dirty = bytes;
+    }
+
+    memcpy(&e->data[start - e->base], data, length);
+    e->known |= bytes;
+    e->dirty = dirty;
+    if (_staged == 0) {
+        _first = _bus.Clock().now_us();
+    }
+    _staged++;
+    _stats.writes++;
+    return result;
+}
+
+int AX12WriteBatch::WriteWord(int id, int start, uint16_t value)
+{
+    uint8_t data[2] = {(uint8_t)(value & 0xFF), (uint8_t)(value >> 8)};
+    return Write(id, start, 2, data);
+}
+
+int AX12WriteBatch::Flush(void)
+{
+    int result = AX12_OK;
+    Entry *group[AX12_BATCH_MAX_SERVOS];
+
+    while (true) {
+        // The widest range left leads a group
+        Entry *lead = 0;
+        int width = 0;
+        for (int i = 0; i < _count; i++) {
+            Entry &e = _entries[i];
+            if (e.used && e.dirty) {
+                int w = AX12_BatchHigh(e.dirty) - AX12_BatchLow(e.dirty) + 1;
+                if (w > width) {
+                    lead = &e;
+                    width = w;
+                }
+            }
+        }
+        if (!lead) {
+            break;
+        }
+        int lo = lead->base + AX12_BatchLow(lead->dirty);
+        int hi = lead->base + AX12_BatchHigh(lead->dirty) + 1;
+
+        // Every servo whose staged bytes are inside it, and which knows the rest of it
+        int count = 0;
+        for (int i = 0; i < _count; i++) {
+            Entry &e = _entries[i];
+            if (!e.used || !e.dirty || lo < e.base || hi > e.base + AX12_BATCH_SPAN) {
+                continue;
+            }
+            uint32_t range = AX12_BatchMask(lo - e.base, hi - lo);
+            if ((e.dirty & ~range) == 0 && (range & ~(AX12_BatchRewritable(e.base, e.known) | e.dirty)) == 0) {
+                group[count++] = &e;
+            }
+        }
+        int r = send(group, count, lo, hi);
+        result = (result != AX12_OK) ? result : r;
+    }
+    _staged = 0;
+    return result;
+}
+
+void AX12WriteBatch::SetWindow(uint32_t us)
+{
+    _window = us;
+}
+
+int AX12WriteBatch::Poll(void)
+{
+    if (_window && _staged && AX12Clock::reached(_bus.Clock().now_us(), _first + _window)) {
+        return Flush();
+    }
+    return AX12_OK;
+}
+
+void AX12WriteBatch::Learn(int id, int start, int length, const uint8_t *data)
+{
+    Entry *e = find(id, true);
+    if (!e) {
+        return;
+    }
+    if (!e->known) {
+        e->base = AX12_BatchBase(start);
+    }
+    // Only what falls in the window, staged bytes keep their value
+    for (int n = 0; n < length; n++) {
+        int i = start + n - e->base;
+        if (i >= 0 && i < AX12_BATCH_SPAN && !(e->dirty & (1UL << i))) {
+            e->data[i] = data[n];
+            e->known |= 1UL << i;
+        }
+    }
+}
+
+void AX12WriteBatch::Forget(int id)
+{
+    Entry *e = find(id, false);
+    if (e) {
+        e->used = false;
+    }
+}
+
+int AX12WriteBatch::Pending(void)
+{
+    int n = 0;
+    for (int i = 0; i < _count; i++) {
+        n += (_entries[i].used && _entries[i].dirty);
+    }
+    return n;
+}
+
+const AX12BatchStats &AX12WriteBatch::Stats(void)
+{
+    return _stats;
+}
+
+void AX12WriteBatch::ResetStats(void)
+{
+    memset(&_stats, 0, sizeof(_stats));
+}
+
+// Entry of a servo, a new one (in a free slot, or a slot with nothing staged) if \p create
+AX12WriteBatch::Entry *AX12WriteBatch::find(int id, bool create)
+{
+    Entry *free = 0;
+
+    for (int i = 0; i < _count; i++) {
+        Entry &e = _entries[i];
+        if (e.used && e.id == id) {
+            return &e;
+        }
+        if (!free && !e.used) {
+            free = &e;
+        }
+    }
+    for (int i = 0; i < _count && !free; i++) {
+        if (!_entries[i].dirty) {
+            free = &_entries[i];
+        }
+    }
+    if (!create || !free) {
+        return 0;
+    }
+    free->id = id;
+    free->used = true;
+    free->base = 0;
+    free->known = 0;
+    free->dirty = 0;
+    return free;
+}
+
+// Staged bytes of one servo, out of turn
+int AX12WriteBatch::flush(Entry &e)
+{
+    Entry *group = &e;
+    int lo = e.base + AX12_BatchLow(e.dirty);
+    int hi = e.base + AX12_BatchHigh(e.dirty) + 1;
+
+    _stats.early++;
+    return send(&group, 1, lo, hi);
+}
+
+// One WRITE_DATA, or SYNC_WRITEs as large as the packet allows
+int AX12WriteBatch::send(Entry **group, int count, int lo, int hi)
+{
+    int length = hi - lo;
+    int per_packet = (AX12_BUS_PACKET_SIZE - AX12_PACKET_OVERHEAD - 2) / (1 + length); // at least 1, see AX12Config.h
+    int result = AX12_OK;
+
+    for (int first = 0; first < count; first += per_packet) {
+        int n = (count - first < per_packet) ? count - first : per_packet;
+        int r;
+        if (n == 1) {
+            Entry &e = *group[first];
+            r = _bus.Write(e.id, lo, length, &e.data[lo - e.base]);
+        } else {
+            uint8_t *p = _bus.Packet(AX12_BROADCAST_ID, AX12_INST_SYNC_WRITE, 2 + n * (1 + length));
+            if (!p) {
+                r = AX12_BUSY;
+            } else {
+                *p++ = lo;
+                *p++ = length;
+                for (int k = first; k < first + n; k++) {
+                    *p++ = group[k]->id;
+                    memcpy(p, &group[k]->data[lo - group[k]->base], length);
+                    p += length;
+                }
+                r = _bus.Start();
+                r = (r == AX12_BUSY) ? _bus.Wait() : r;
+            }
+            _stats.syncs++;
+        }
+        _stats.packets++;
+
+        // Not sure what the servos hold now
+        for (int k = first; k < first + n; k++) {
+            group[k]->dirty = 0;
+            if (r != AX12_OK) {
+                group[k]->known = 0;
+            }
+        }
+        result = (result != AX12_OK) ? result : r;
+    }
+    _stats.saved = (_stats.writes > _stats.packets) ? _stats.writes - _stats.packets : 0;
+    return result;
+}
@@ -0,0 +1,198 @@
+/**
+ * @file AX12Baud.cpp
+ * @author joebarteam11
+ * @brief Negotiation of the fastest reliable bit rate of a chain
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+#include "AX12Baud.h"
+
+// Standard codes, slowest first : 9615, 19231, 57143, 117647, 200000, 250000, 400000, 500000, 1000000 bps
+static const uint8_t CODES[AX12_BAUD_CODES] = {0xCF, 0x67, 0x22, 0x10, 0x09, 0x07, 0x04, 0x03, 0x01};
+
+#define REVERT_REPEAT 3 // SYNC_WRITE has no reply, a revert is sent several times
+
+AX12BaudNegotiator::AX12BaudNegotiator(AX12Bus &bus)
+    : _bus(bus)
+{
+    _threshold = 0;
+    _reads = AX12_BAUD_PROBE_READS;
+    _fastest = 0x01;
+    _code = -1;
+    _count = 0;
+}
+
+void AX12BaudNegotiator::SetThreshold(uint32_t ppm)
+{
+    _threshold = ppm;
+}
+
+void AX12BaudNegotiator::SetProbeReads(int reads)
+{
+    _reads = (reads > 0) ? reads : 1;
+}
+
+void AX12BaudNegotiator::SetFastest(int code)
+{
+    _fastest = code;
+}
+
+int AX12BaudNegotiator::Negotiate(const uint8_t *ids, int count)
+{
+    _count = 0;
+    if (count <= 0 || _bus.Port().set_baudrate(_bus.Port().baudrate()) != 0) {
+        return AX12_ERR_ARG;
+    }
+
+    AX12BaudStep &present = _steps[_count++];
+    Probe(ids, count, present);
+    _code = present.code;
+    if (!present.passed) {
+        return AX12_ERR_TIMEOUT;
+    }
+
+    int baud = present.baud;
+    for (int i = 0; i < AX12_BAUD_CODES; i++) {
+        if (CODES[i] < _fastest || AX12_BaudFromCode(CODES[i]) <= baud) {
+            continue;
+        }
+        if (Switch(ids, count, CODES[i]) != AX12_OK) {
+            return recover(ids, count, _code);
+        }
+
+        AX12BaudStep &step = _steps[_count++];
+        Probe(ids, count, step);
+        if (!step.passed) {
+            return recover(ids, count, _code);
+        }
+        _code = CODES[i];
+    }
+    return AX12_OK;
+}
+
+void AX12BaudNegotiator::Probe(const uint8_t *ids, int count, AX12BaudStep &step)
+{
+    uint8_t data[AX12_EEPROM_SIZE];
+    uint32_t bytes = 0;
+
+    step.baud = _bus.Port().baudrate();
+    step.code = CodeOf(step.baud);
+    step.attempts = 0;
+    step.errors = 0;
+
+    uint32_t start = _bus.Clock().now_us();
+    for (int r = 0; r < _reads; r++) {
+        for (int i = 0; i < count; i++) {
+            step.attempts++;
+            // A servo answering with the wrong ID or baud code is a corrupted reply too
+            if (_bus.Read(ids[i], AX12_REG_MODEL, AX12_EEPROM_SIZE, data) != AX12_OK
+                || data[AX12_REG_ID] != ids[i] || data[AX12_REG_BAUD] != step.code) {
+                step.errors++;
+            } else {
+                bytes += AX12_EEPROM_SIZE;
+            }
+        }
+    }
+    uint32_t elapsed = _bus.Clock().now_us() - start;
+
+    step.error_ppm = (uint32_t)((uint64_t)step.errors * 1000000 / step.attempts);
+    step.throughput = elapsed ? (uint32_t)((uint64_t)bytes * 1000000 / elapsed) : 0;
+    step.passed = (step.error_ppm <= _threshold);
+}
+
+// SYNC_WRITE of the baud register, split if the chain does not fit in one packet
+void AX12BaudNegotiator::send(const uint8_t *ids, int count, int code)
+{
+    const int per_packet = (AX12_BUS_PACKET_SIZE - AX12_PACKET_OVERHEAD - 2) / 2;
+    uint8_t values[per_packet];
+
+    for (int i = 0; i < per_packet; i++) {
+        values[i] = code;
+    }
+    for (int i = 0; i < count; i += per_packet) {
+        int n = (count - i < per_packet) ? count - i : per_packet;
+        _bus.SyncWrite(AX12_REG_BAUD, 1, &ids[i], values, n);
+    }
+}
+
+int AX12BaudNegotiator::Switch(const uint8_t *ids, int count, int code)
+{
+    send(ids, count, code);
+    if (_bus.Port().set_baudrate(AX12_BaudFromCode(code)) != 0) {
+        return AX12_ERR_ARG;
+    }
+    _bus.Clock().wait_us(AX12_BAUD_SETTLE_US);
+    _bus.Port().flush();
+    return AX12_OK;
+}
+
+bool AX12BaudNegotiator::answer(const uint8_t *ids, int count)
+{
+    for (int i = 0; i < count; i++) {
+        int r = AX12_ERR_TIMEOUT;
+        for (int t = 0; t < REVERT_REPEAT && r != AX12_OK; t++) {
+            r = _bus.Ping(ids[i]);
+        }
+        if (r != AX12_OK) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Bring every servo back to a code known to work, wherever it is
+int AX12BaudNegotiator::recover(const uint8_t *ids, int count, int code)
+{
+    // Most of the time the revert gets through at the failing bit rate
+    for (int t = 0; t < REVERT_REPEAT; t++) {
+        send(ids, count, code);
+    }
+    if (Switch(ids, 0, code) == AX12_OK && answer(ids, count)) { // 0 servos : the port only
+        return AX12_OK;
+    }
+
+    // Some servos missed it: send it again at every standard bit rate
+    for (int i = 0; i < AX12_BAUD_CODES; i++) {
+        if (CODES[i] == code || _bus.Port().set_baudrate(AX12_BaudFromCode(CODES[i])) != 0) {
+            continue;
+        }
+        for (int t = 0; t < REVERT_REPEAT; t++) {
+            send(ids, count, code);
+        }
+    }
+    if (Switch(ids, 0, code) == AX12_OK && answer(ids, count)) {
+        return AX12_OK;
+    }
+    return AX12_ERR_TIMEOUT;
+}
+
+int AX12BaudNegotiator::Code(void)
+{
+    return _code;
+}
+
+int AX12BaudNegotiator::Steps(void)
+{
+    return _count;
+}
+
+const AX12BaudStep &AX12BaudNegotiator::Step(int index)
+{
+    return _steps[index];
+}
+
+int AX12BaudNegotiator::CodeOf(int baud)
+{
+    int best = 1;
+    for (int code = 1; code < 0xFF; code++) {
+        int d = AX12_BaudFromCode(code) - baud;
+        int b = AX12_BaudFromCode(best) - baud;
+        if ((d < 0 ? -d : d) < (b < 0 ? -b : b)) {
+            best = code;
+        }
+    }
+    return best;
+}
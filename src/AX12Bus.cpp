@@ -0,0 +1,495 @@
+/**
+ * @file AX12Bus.cpp
+ * @author joebarteam11
+ * @brief Packet layer of one Dynamixel chain (Protocol 1.0)
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+#include "AX12Bus.h"
+#include "AX12Log.h"
+
+#include <string.h>
+
+AX12Bus::AX12Bus(AX12Port &port, AX12Clock &clock)
+    : _port(port), _clock(clock)
+{
+    _tx_length = 0;
+    _reply = 0;
+    _reply_length = 0;
+    _expect_reply = false;
+    _state = IDLE;
+    _parser = RX_HEADER1;
+    _result = AX12_OK;
+    _start = 0;
+    _deadline = 0;
+    _heard = 0;
+    _replied = false;
+    _return_delay = AX12_DEFAULT_RETURN_DELAY_US;
+    _timeout = AX12_BUS_TIMEOUT_US;
+    _silence = AX12_BUS_SILENCE_US;
+    _sleep = true;
+    _status_return = 2;
+    memset(_quarantine, 0, sizeof(_quarantine));
+    ResetStats();
+}
+
+uint8_t *AX12Bus::Packet(int id, int instruction, int count)
+{
+    if (_state != IDLE || count < 0 || count + AX12_PACKET_OVERHEAD > AX12_BUS_PACKET_SIZE) {
+        return 0;
+    }
+
+    _tx[0] = 0xFF;
+    _tx[1] = 0xFF;
+    _tx[2] = id;
+    _tx[3] = count + 2; // instruction + params + checksum
+    _tx[4] = instruction;
+    _tx_length = count + AX12_PACKET_OVERHEAD;
+
+    return &_tx[5];
+}
+
+int AX12Bus::Start(uint8_t *reply, int reply_length)
+{
+    if (_state != IDLE || _tx_length == 0) {
+        return AX12_ERR_ARG;
+    }
+
+    // No reply will come : the transaction is over at once, Poll() gives the result
+    if (Quarantined(_tx[2])) {
+        _tx_length = 0;
+        _stats.refused++;
+        _result = AX12_ERR_UNREACHABLE;
+        return _result;
+    }
+    return transmit(reply, reply_length);
+}
+
+int AX12Bus::transmit(uint8_t *reply, int reply_length)
+{
+    _tx[_tx_length - 1] = AX12_Checksum(_tx, _tx_length);
+
+    _expect_reply = ExpectsReply(_tx[2], _tx[4]);
+
+    _reply = reply;
+    _reply_length = reply_length;
+    _parser = RX_HEADER1;
+    _port.flush();
+
+    // Nothing went out : the transaction is over at once, Poll() gives the result
+    if (_port.send(_tx, _tx_length) < 0) {
+        _tx_length = 0;
+        _stats.line_errors++;
+        _result = AX12_ERR_LINE;
+        return _result;
+    }
+
+    _start = _clock.now_us();
+    _replied = false;
+    _deadline = _start + WireTime(_tx_length) + _timeout;
+    if (_expect_reply) {
+        // A USB adapter may hold the reply for its latency timer, see quiet()
+        _deadline += _return_delay + WireTime(AX12_PACKET_OVERHEAD + reply_length) + _port.latency();
+    }
+    _state = SENDING;
+    _stats.transactions++;
+    _stats.tx_bytes += _tx_length;
+
+    return AX12_BUSY;
+}
+
+int AX12Bus::Poll(void)
+{
+    if (_state == IDLE) {
+        return _result;
+    }
+
+    uint8_t chunk[16];
+    int n;
+    while (_state != IDLE && (n = _port.receive(chunk, sizeof(chunk))) > 0) {
+        _stats.rx_bytes += n;
+        _heard = _clock.now_us();
+        _replied = true;
+        for (int i = 0; i < n; i++) {
+            if (parse(chunk[i])) {
+                break;
+            }
+        }
+    }
+
+    if (_state == SENDING && !_port.sending()) {
+        if (_port.line_error()) {
+            // The servos may have read another packet : do not wait for its reply
+            _stats.line_errors++;
+            finish(AX12_ERR_LINE);
+        } else if (_expect_reply) {
+            _state = RECEIVING;
+            _heard = _clock.now_us() + _return_delay;
+        } else {
+            finish(AX12_OK);
+        }
+    }
+
+    if (_state == RECEIVING) {
+        uint32_t now = _clock.now_us();
+        if (_port.line_error()) {
+            _stats.line_errors++;
+            finish(AX12_ERR_LINE);
+        } else if (_silence && AX12Clock::reached(now, quiet())) {
+            // Nothing, or the line went quiet in the middle of the reply
+            if (_replied) {
+                _stats.errors++;
+                finish(AX12_ERR_LENGTH);
+            } else {
+                _stats.timeouts++;
+                finish(AX12_ERR_TIMEOUT);
+            }
+        }
+    }
+
+    if (_state != IDLE && AX12Clock::reached(_clock.now_us(), _deadline)) {
+        _stats.timeouts++;
+        finish(AX12_ERR_TIMEOUT);
+    }
+
+    return (_state == IDLE) ? _result : AX12_BUSY;
+}
+
+bool AX12Bus::Busy(void)
+{
+    return Poll() == AX12_BUSY;
+}
+
+int AX12Bus::Wait(void)
+{
+    int result;
+    uint32_t step = WireTime(1);
+
+    while ((result = Poll()) == AX12_BUSY) {
+        // Sleep in the port until something happens if it can, a byte time at a time otherwise
+        uint32_t now = _clock.now_us();
+        uint32_t end = until();
+        uint32_t left = AX12Clock::reached(now, end) ? 0 : end - now;
+        if (_sleep && _port.wait(left)) {
+            _stats.idle_us += _clock.now_us() - now;
+        } else {
+            _clock.wait_us(step);
+        }
+    }
+    return result;
+}
+
+// Time the reply is over if nothing more comes : a byte late by the silence
+uint32_t AX12Bus::quiet(void)
+{
+    return _heard + WireTime(1) + _silence + _port.latency();
+}
+
+// Time Poll() must look at the transaction again
+uint32_t AX12Bus::until(void)
+{
+    if (_state == RECEIVING && _silence) {
+        uint32_t t = quiet();
+        return AX12Clock::reached(t, _deadline) ? _deadline : t;
+    }
+    return _deadline;
+}
+
+// Status packet : 0xFF, 0xFF, ID, Length, Error, Param(s), Checksum
+// returns true once the transaction is over
+bool AX12Bus::parse(uint8_t c)
+{
+    switch (_parser) {
+    case RX_HEADER1:
+        if (c == 0xFF) {
+            _parser = RX_HEADER2;
+        }
+        break;
+    case RX_HEADER2:
+        _parser = (c == 0xFF) ? RX_ID : RX_HEADER1;
+        break;
+    case RX_ID:
+        if (c != 0xFF) { // extra 0xFF are part of the header
+            _rx_id = c;
+            _rx_sum = c;
+            _parser = RX_LENGTH;
+        }
+        break;
+    case RX_LENGTH:
+        _rx_sum += c;
+        _rx_params = c - 2;
+        if (_rx_params != _reply_length) {
+            _stats.errors++;
+            finish(AX12_ERR_LENGTH);
+            return true;
+        }
+        _parser = RX_ERROR;
+        break;
+    case RX_ERROR:
+        _rx_sum += c;
+        _rx_error = c;
+        _rx_count = 0;
+        _parser = (_rx_params > 0) ? RX_PARAMS : RX_CHECKSUM;
+        break;
+    case RX_PARAMS:
+        _rx_sum += c;
+        if (_reply) {
+            _reply[_rx_count] = c;
+        }
+        if (++_rx_count == _rx_params) {
+            _parser = RX_CHECKSUM;
+        }
+        break;
+    case RX_CHECKSUM:
+        _parser = RX_HEADER1;
+        if ((uint8_t)(0xFF - _rx_sum) != c) {
+            _stats.errors++;
+            finish(AX12_ERR_CHECKSUM);
+        } else if (_rx_id != _tx[2]) {
+            _stats.errors++;
+            finish(AX12_ERR_ID);
+        } else {
+            finish(_rx_error);
+        }
+        return true;
+    }
+    return false;
+}
+
+void AX12Bus::finish(int result)
+{
+    // Resynchronize : whatever is left of a bad reply must not reach the next transaction
+    if (result < 0) {
+        _port.flush();
+        AX12_LOG(AX12_LOG_ERROR, AX12_EV_BUS_FAILED, _tx[2], _tx[4], result);
+    }
+    if (_expect_reply) {
+        track(_tx[2], result);
+    }
+    _result = result;
+    _state = IDLE;
+    _tx_length = 0;
+    _stats.busy_us += _clock.now_us() - _start;
+}
+
+// Count the replies a servo misses in a row, quarantine it past AX12_BUS_FAILURES
+void AX12Bus::track(int id, int result)
+{
+    Quarantine *q = 0;
+    Quarantine *free = 0;
+    for (int i = 0; i < AX12_BUS_MAX_QUARANTINE; i++) {
+        if (_quarantine[i].failures == 0) {
+            free = free ? free : &_quarantine[i];
+        } else if (_quarantine[i].id == id) {
+            q = &_quarantine[i];
+        }
+    }
+
+    // Any byte back, even a bad one : the servo is there
+    if (result != AX12_ERR_TIMEOUT || _replied) {
+        if (q) {
+            q->failures = 0;
+        }
+        return;
+    }
+    if (!q) {
+        if (!free) {
+            return; // full, the servo keeps its timeouts
+        }
+        q = free;
+        q->id = id;
+        q->backoff = 0;
+    }
+
+    // Quarantined now, or a PING of the back-off missed
+    if (q->failures < AX12_BUS_FAILURES) {
+        q->failures++;
+    }
+    if (q->failures == AX12_BUS_FAILURES) {
+        uint32_t wait = AX12_BUS_BACKOFF_US << q->backoff;
+        if (wait < AX12_BUS_BACKOFF_MAX_US) {
+            q->backoff++;
+        } else {
+            wait = AX12_BUS_BACKOFF_MAX_US;
+        }
+        q->probe = _clock.now_us() + wait;
+        AX12_LOG(AX12_LOG_ERROR, AX12_EV_QUARANTINE, id, q->failures, wait);
+    }
+}
+
+int AX12Bus::Probe(void)
+{
+    if (_state != IDLE) {
+        return AX12_OK;
+    }
+    uint32_t now = _clock.now_us();
+    for (int i = 0; i < AX12_BUS_MAX_QUARANTINE; i++) {
+        Quarantine &q = _quarantine[i];
+        if (q.failures == AX12_BUS_FAILURES && AX12Clock::reached(now, q.probe)) {
+            Packet(q.id, AX12_INST_PING, 0);
+            _stats.probes++;
+            return transmit(0, 0);
+        }
+    }
+    return AX12_OK;
+}
+
+bool AX12Bus::Quarantined(int id)
+{
+    for (int i = 0; i < AX12_BUS_MAX_QUARANTINE; i++) {
+        if (_quarantine[i].failures == AX12_BUS_FAILURES && _quarantine[i].id == id) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void AX12Bus::Release(int id)
+{
+    for (int i = 0; i < AX12_BUS_MAX_QUARANTINE; i++) {
+        if (_quarantine[i].id == id) {
+            _quarantine[i].failures = 0;
+        }
+    }
+}
+
+int AX12Bus::Ping(int id)
+{
+    if (!Packet(id, AX12_INST_PING, 0)) {
+        return AX12_BUSY;
+    }
+    int result = Start();
+    return (result == AX12_BUSY) ? Wait() : result;
+}
+
+int AX12Bus::Read(int id, int start, int length, uint8_t *data)
+{
+    uint8_t *p = Packet(id, AX12_INST_READ, 2);
+    if (!p) {
+        return AX12_BUSY;
+    }
+    p[0] = start;
+    p[1] = length;
+    int result = Start(data, length);
+    return (result == AX12_BUSY) ? Wait() : result;
+}
+
+int AX12Bus::Write(int id, int start, int length, const uint8_t *data, bool registered)
+{
+    uint8_t *p = Packet(id, registered ? AX12_INST_REG_WRITE : AX12_INST_WRITE, 1 + length);
+    if (!p) {
+        return AX12_BUSY;
+    }
+    p[0] = start;
+    memcpy(&p[1], data, length);
+    int result = Start();
+    return (result == AX12_BUSY) ? Wait() : result;
+}
+
+int AX12Bus::SyncWrite(int start, int length, const uint8_t *ids, const uint8_t *data, int count)
+{
+    uint8_t *p = Packet(AX12_BROADCAST_ID, AX12_INST_SYNC_WRITE, 2 + count * (1 + length));
+    if (!p) {
+        return AX12_BUSY;
+    }
+    *p++ = start;
+    *p++ = length;
+    for (int i = 0; i < count; i++) {
+        *p++ = ids[i];
+        memcpy(p, &data[i * length], length);
+        p += length;
+    }
+    int result = Start();
+    return (result == AX12_BUSY) ? Wait() : result;
+}
+
+int AX12Bus::Action(void)
+{
+    if (!Packet(AX12_BROADCAST_ID, AX12_INST_ACTION, 0)) {
+        return AX12_BUSY;
+    }
+    int result = Start();
+    return (result == AX12_BUSY) ? Wait() : result;
+}
+
+void AX12Bus::SetReturnDelay(uint32_t us)
+{
+    _return_delay = us;
+}
+
+void AX12Bus::SetStatusReturn(int level)
+{
+    _status_return = level;
+}
+
+void AX12Bus::SetTimeout(uint32_t us)
+{
+    _timeout = us;
+}
+
+uint32_t AX12Bus::Timeout(void)
+{
+    return _timeout;
+}
+
+void AX12Bus::SetSilence(uint32_t us)
+{
+    _silence = us;
+}
+
+void AX12Bus::SetSleep(bool sleep)
+{
+    _sleep = sleep;
+}
+
+uint32_t AX12Bus::WireTime(int bytes)
+{
+    // 10 bits per byte : start, 8 data, stop
+    uint32_t baud = _port.baudrate();
+    return (uint32_t)(((uint64_t)bytes * 10000000ULL + baud - 1) / baud);
+}
+
+uint32_t AX12Bus::Estimate(int id, int instruction, int count, int reply_length)
+{
+    uint32_t t = WireTime(count + AX12_PACKET_OVERHEAD);
+    if (ExpectsReply(id, instruction)) {
+        t += _return_delay + WireTime(reply_length + AX12_PACKET_OVERHEAD);
+    }
+    return t;
+}
+
+// Decide if a status packet will come back, see AX12_REG_STATUS_RETURN
+bool AX12Bus::ExpectsReply(int id, int instruction)
+{
+    if (id == AX12_BROADCAST_ID) {
+        return false;
+    } else if (instruction == AX12_INST_PING) {
+        return true;
+    } else if (instruction == AX12_INST_READ) {
+        return (_status_return >= 1);
+    }
+    return (_status_return >= 2);
+}
+
+const AX12BusStats &AX12Bus::Stats(void)
+{
+    return _stats;
+}
+
+void AX12Bus::ResetStats(void)
+{
+    memset(&_stats, 0, sizeof(_stats));
+}
+
+AX12Port &AX12Bus::Port(void)
+{
+    return _port;
+}
+
+AX12Clock &AX12Bus::Clock(void)
+{
+    return _clock;
+}
@@ -0,0 +1,57 @@
+/**
+ * @file AX12Clock.cpp
+ * @author joebarteam11
+ * @brief System time base of the AX12 bus layer
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+#include "AX12Clock.h"
+
+#if defined(__MBED__)
+
+#include "mbed.h"
+
+class AX12SystemClock : public AX12Clock {
+
+public:
+    virtual uint32_t now_us(void)
+    {
+        return us_ticker_read();
+    }
+
+    virtual void wait_us(uint32_t us)
+    {
+        ::wait_us(us);
+    }
+};
+
+#else
+
+#include <chrono>
+#include <thread>
+
+class AX12SystemClock : public AX12Clock {
+
+public:
+    virtual uint32_t now_us(void)
+    {
+        return (uint32_t)std::chrono::duration_cast<std::chrono::microseconds>(
+                   std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    virtual void wait_us(uint32_t us)
+    {
+        std::this_thread::sleep_for(std::chrono::microseconds(us));
+    }
+};
+
+#endif
+
+AX12Clock &AX12Clock::system(void)
+{
+    static AX12SystemClock clock;
+    return clock;
+}
@@ -0,0 +1,310 @@
+/**
+ * @file AX12Coroutine.cpp
+ * @author joebarteam11
+ * @brief C++20 coroutines over AX12Bus, for host controllers
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+#include "AX12Coroutine.h"
+
+#if defined(__cpp_impl_coroutine) && __cplusplus >= 202002L
+
+#include <new>
+#include <string.h>
+
+// Each frame starts with the allocator it comes from
+static const size_t FRAME_HEADER = alignof(std::max_align_t);
+
+void *AX12Task::promise_type::operator new(size_t size)
+{
+    AX12FrameAllocator *allocator = AX12FrameAllocator::current;
+    unsigned char *p = (unsigned char *)(allocator ? allocator->allocate(size + FRAME_HEADER)
+                                                   : ::operator new(size + FRAME_HEADER));
+    *(AX12FrameAllocator **)p = allocator;
+    return p + FRAME_HEADER;
+}
+
+void AX12Task::promise_type::operator delete(void *frame, size_t size)
+{
+    unsigned char *p = (unsigned char *)frame - FRAME_HEADER;
+    AX12FrameAllocator *allocator = *(AX12FrameAllocator **)p;
+    if (allocator) {
+        allocator->deallocate(p, size + FRAME_HEADER);
+    } else {
+        ::operator delete(p, size + FRAME_HEADER);
+    }
+}
+
+AX12Task::~AX12Task()
+{
+    if (_handle) {
+        _handle.destroy();
+    }
+}
+
+
+void AX12Operation::await_suspend(std::coroutine_handle<> h)
+{
+    _handle = h;
+    _executor.enqueue(this);
+}
+
+
+AX12Executor::AX12Executor(AX12Bus &bus)
+    : _bus(bus)
+{
+    for (int i = 0; i < AX12_CORO_MAX_TASKS; i++) {
+        _tasks[i] = nullptr;
+    }
+    _head = _tail = 0;
+    _current = 0;
+    _sleeping = 0;
+    _ready = 0;
+}
+
+AX12Executor::~AX12Executor()
+{
+    for (int i = 0; i < AX12_CORO_MAX_TASKS; i++) {
+        if (_tasks[i]) {
+            _tasks[i].destroy();
+        }
+    }
+}
+
+int AX12Executor::Spawn(AX12Task task)
+{
+    for (int i = 0; i < AX12_CORO_MAX_TASKS; i++) {
+        if (!_tasks[i]) {
+            _tasks[i] = task._handle;
+            task._handle = nullptr;
+            _tasks[i].resume();
+            return AX12_OK;
+        }
+    }
+    return AX12_ERR_ARG;
+}
+
+AX12Operation AX12Executor::Ping(int id, uint32_t within_us)
+{
+    AX12Operation op(*this, AX12Operation::PING);
+    op._id = id;
+    op._has_deadline = (within_us != 0);
+    op._deadline = _bus.Clock().now_us() + within_us;
+    return op;
+}
+
+AX12Operation AX12Executor::Read(int id, int start, int length, uint8_t *data, uint32_t within_us)
+{
+    AX12Operation op(*this, AX12Operation::READ);
+    op._id = id;
+    op._start = start;
+    op._length = length;
+    op._data = data;
+    op._has_deadline = (within_us != 0);
+    op._deadline = _bus.Clock().now_us() + within_us;
+    return op;
+}
+
+AX12Operation AX12Executor::Write(int id, int start, int length, const uint8_t *data, uint32_t within_us)
+{
+    AX12Operation op(*this, AX12Operation::WRITE);
+    op._id = id;
+    op._start = start;
+    op._length = length;
+    op._source = data;
+    op._has_deadline = (within_us != 0);
+    op._deadline = _bus.Clock().now_us() + within_us;
+    return op;
+}
+
+AX12Operation AX12Executor::SyncWrite(int start, int length, const uint8_t *ids, const uint8_t *data,
+                                      int count, uint32_t within_us)
+{
+    AX12Operation op(*this, AX12Operation::SYNC_WRITE);
+    op._id = AX12_BROADCAST_ID;
+    op._start = start;
+    op._length = length;
+    op._ids = ids;
+    op._source = data;
+    op._count = count;
+    op._has_deadline = (within_us != 0);
+    op._deadline = _bus.Clock().now_us() + within_us;
+    return op;
+}
+
+AX12Operation AX12Executor::Sleep(uint32_t us)
+{
+    AX12Operation op(*this, AX12Operation::SLEEP);
+    op._deadline = _bus.Clock().now_us() + us;
+    return op;
+}
+
+void AX12Executor::enqueue(AX12Operation *op)
+{
+    op->_next = 0;
+    if (op->_kind == AX12Operation::SLEEP) {
+        op->_next = _sleeping;
+        _sleeping = op;
+    } else if (_tail) {
+        _tail->_next = op;
+        _tail = op;
+    } else {
+        _head = _tail = op;
+    }
+}
+
+// Build the packet of an operation and start it, false if it cannot be sent
+int AX12Executor::start(AX12Operation *op)
+{
+    uint8_t *p;
+
+    switch (op->_kind) {
+    case AX12Operation::PING:
+        if (!_bus.Packet(op->_id, AX12_INST_PING, 0)) {
+            return AX12_ERR_ARG;
+        }
+        return _bus.Start();
+    case AX12Operation::READ:
+        if (!(p = _bus.Packet(op->_id, AX12_INST_READ, 2))) {
+            return AX12_ERR_ARG;
+        }
+        p[0] = op->_start;
+        p[1] = op->_length;
+        return _bus.Start(op->_data, op->_length);
+    case AX12Operation::WRITE:
+        if (!(p = _bus.Packet(op->_id, AX12_INST_WRITE, 1 + op->_length))) {
+            return AX12_ERR_ARG;
+        }
+        p[0] = op->_start;
+        memcpy(&p[1], op->_source, op->_length);
+        return _bus.Start();
+    case AX12Operation::SYNC_WRITE:
+        if (!(p = _bus.Packet(AX12_BROADCAST_ID, AX12_INST_SYNC_WRITE, 2 + op->_count * (1 + op->_length)))) {
+            return AX12_ERR_ARG;
+        }
+        *p++ = op->_start;
+        *p++ = op->_length;
+        for (int i = 0; i < op->_count; i++) {
+            *p++ = op->_ids[i];
+            memcpy(p, &op->_source[i * op->_length], op->_length);
+            p += op->_length;
+        }
+        return _bus.Start();
+    default:
+        return AX12_ERR_ARG;
+    }
+}
+
+void AX12Executor::done(AX12Operation *op, int result)
+{
+    op->_result = result;
+    op->_next = _ready;
+    _ready = op;
+}
+
+uint32_t AX12Executor::Step(void)
+{
+    uint32_t now = _bus.Clock().now_us();
+
+    // Bus : finish the current transaction, start the next one
+    if (_current) {
+        int r = _bus.Poll();
+        if (r != AX12_BUSY) {
+            done(_current, r);
+            _current = 0;
+        }
+    }
+    while (!_current && _head) {
+        AX12Operation *op = _head;
+        _head = op->_next;
+        if (!_head) {
+            _tail = 0;
+        }
+        if (op->_has_deadline && AX12Clock::reached(now, op->_deadline)) {
+            done(op, AX12_ERR_DEADLINE);
+        } else {
+            int r = start(op);
+            if (r == AX12_BUSY) {
+                _current = op;
+            } else {
+                done(op, r);
+            }
+        }
+    }
+
+    // Sleeps over
+    AX12Operation **link = &_sleeping;
+    while (*link) {
+        AX12Operation *op = *link;
+        if (AX12Clock::reached(now, op->_deadline)) {
+            *link = op->_next;
+            done(op, AX12_OK);
+        } else {
+            link = &op->_next;
+        }
+    }
+
+    // Resume the tasks, they may await new operations
+    AX12Operation *ready = _ready;
+    _ready = 0;
+    bool resumed = (ready != 0);
+    while (ready) {
+        AX12Operation *op = ready;
+        ready = op->_next; // the operation dies with the co_await once resumed
+        op->_handle.resume();
+    }
+
+    for (int i = 0; i < AX12_CORO_MAX_TASKS; i++) {
+        if (_tasks[i] && _tasks[i].done()) {
+            _tasks[i].destroy();
+            _tasks[i] = nullptr;
+        }
+    }
+
+    // Time to the next event
+    if (resumed || (!_current && _head)) {
+        return 0;
+    }
+    uint32_t next = AX12_CORO_IDLE;
+    if (_current) {
+        next = _bus.WireTime(1);
+    }
+    now = _bus.Clock().now_us();
+    for (AX12Operation *op = _sleeping; op; op = op->_next) {
+        uint32_t left = AX12Clock::reached(now, op->_deadline) ? 0 : op->_deadline - now;
+        next = (left < next) ? left : next;
+    }
+    return next;
+}
+
+void AX12Executor::Run(void)
+{
+    while (Tasks() > 0) {
+        uint32_t t = Step();
+        if (t == AX12_CORO_IDLE) {
+            break; // tasks left waiting on something else than this executor
+        }
+        if (t > 0 && !_bus.Port().wait(t)) {
+            _bus.Clock().wait_us(t);
+        }
+    }
+}
+
+int AX12Executor::Tasks(void)
+{
+    int n = 0;
+    for (int i = 0; i < AX12_CORO_MAX_TASKS; i++) {
+        n += (bool)_tasks[i];
+    }
+    return n;
+}
+
+AX12Bus &AX12Executor::Bus(void)
+{
+    return _bus;
+}
+
+#endif
@@ -0,0 +1,541 @@
+/**
+ * @file AX12Emulator.cpp
+ * @author joebarteam11
+ * @brief Host emulation of a chain of AX12 servos, on a virtual clock
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+#include "AX12Emulator.h"
+
+#include <string.h>
+
+AX12VirtualClock::AX12VirtualClock()
+{
+    _now = 0;
+}
+
+uint32_t AX12VirtualClock::now_us(void)
+{
+    return (uint32_t)_now;
+}
+
+void AX12VirtualClock::wait_us(uint32_t us)
+{
+    _now += us;
+}
+
+uint64_t AX12VirtualClock::Elapsed(void)
+{
+    return _now;
+}
+
+
+AX12EmulatedServo::AX12EmulatedServo()
+{
+    Reset();
+    physics = 0;
+}
+
+// Factory control table of an AX-12A
+void AX12EmulatedServo::Reset(int id)
+{
+    memset(table, 0, sizeof(table));
+    table[AX12_REG_MODEL] = 12;
+    table[AX12_REG_FIRMWARE] = 24;
+    table[AX12_REG_ID] = id;
+    table[AX12_REG_BAUD] = 0x01;
+    table[AX12_REG_RETURN_DELAY] = 250;
+    SetWord(AX12_REG_CCW_LIMIT, 1023);
+    table[AX12_REG_TEMP_LIMIT] = 70;
+    table[AX12_REG_MIN_VOLTS] = 60;
+    table[AX12_REG_MAX_VOLTS] = 140;
+    SetWord(AX12_REG_MAX_TORQUE, 1023);
+    table[AX12_REG_STATUS_RETURN] = 2;
+    table[AX12_REG_ALARM_LED] = 0x24;
+    table[AX12_REG_ALARM_SHUTDOWN] = 0x24;
+    table[0x1A] = 1;  // CW compliance margin
+    table[0x1B] = 1;  // CCW compliance margin
+    table[0x1C] = 32; // CW compliance slope
+    table[0x1D] = 32; // CCW compliance slope
+    SetWord(AX12_REG_TORQUE_LIMIT, 1023);
+    SetWord(AX12_REG_GOAL_POSITION, 512);
+    SetWord(AX12_REG_POSITION, 512);
+    table[AX12_REG_VOLTS] = 120;
+    table[AX12_REG_TEMP] = 30;
+    SetWord(AX12_REG_PUNCH, 32);
+    _registered_length = 0;
+    _position = 512;
+    packets = 0;
+    speed_scale = 1.0f;
+    written = 0;
+    load = 0;
+    load_noise = 0;
+    load_spikes = 0;
+    resistance = 0;
+    unplugged = false;
+    alarms = 0;
+    dead_zone = false;
+    travel = 0;
+    _driving = false;
+    _noise = 0x9E3779B9 ^ id;
+}
+
+int AX12EmulatedServo::Id(void)
+{
+    return table[AX12_REG_ID];
+}
+
+int AX12EmulatedServo::Baudrate(void)
+{
+    return AX12_BaudFromCode(table[AX12_REG_BAUD]);
+}
+
+uint16_t AX12EmulatedServo::Word(int reg)
+{
+    return table[reg] | (table[reg + 1] << 8);
+}
+
+void AX12EmulatedServo::SetWord(int reg, uint16_t value)
+{
+    table[reg] = value & 0xff;
+    table[reg + 1] = value >> 8;
+}
+
+// Load register as the servo would measure it now
+void AX12EmulatedServo::sampleLoad(void)
+{
+    _noise ^= _noise << 13;
+    _noise ^= _noise >> 17;
+    _noise ^= _noise << 5;
+
+    int value = load;
+    if (_noise % 1000000 < load_spikes) {
+        value = (int)((_noise >> 8) % 2047) - 1023;
+    } else if (load_noise > 0) {
+        value += (int)((_noise >> 8) % (2 * load_noise + 1)) - load_noise;
+    }
+    value = (value > 1023) ? 1023 : (value < -1023) ? -1023 : value;
+    SetWord(AX12_REG_LOAD, (value > 0) ? (value | AX12_LOAD_CW) : -value);
+}
+
+// Position register as read now : the potentiometer gives anything in the dead zone
+void AX12EmulatedServo::samplePosition(void)
+{
+    if (!dead_zone || _position < 1023.5f) {
+        return;
+    }
+    _noise ^= _noise << 13;
+    _noise ^= _noise >> 17;
+    _noise ^= _noise << 5;
+    SetWord(AX12_REG_POSITION, (_noise >> 8) & 0x3FF);
+}
+
+void AX12EmulatedServo::Advance(uint64_t ns)
+{
+    if (physics) {
+        physics->Advance(*this, ns);
+        return;
+    }
+
+    // Present position changed from outside (test setup)
+    bool blind = dead_zone && _position >= 1023.5f;
+    if (!blind && (int)(_position + 0.5f) != Word(AX12_REG_POSITION)) {
+        _position = Word(AX12_REG_POSITION);
+    }
+
+    int goal = Word(AX12_REG_GOAL_POSITION);
+    bool wheel = (Word(AX12_REG_CW_LIMIT) == 0 && Word(AX12_REG_CCW_LIMIT) == 0);
+    int command = Word(AX12_REG_MOVING_SPEED);
+
+    if (!table[AX12_REG_ENABLE_TORQUE] || (wheel && (command & 0x3FF) == 0)
+        || (!wheel && (int)(_position + 0.5f) == goal)) {
+        _position = (int)(_position + 0.5f);
+        SetWord(AX12_REG_SPEED, 0);
+        table[AX12_REG_MOVING] = 0;
+        if (_driving && (wheel || !table[AX12_REG_ENABLE_TORQUE])) {
+            load = 0; // the motor lets go
+        }
+        _driving = false;
+        return;
+    }
+
+    int speed = command & 0x3FF;
+    if (speed == 0) {
+        speed = 0x3FF; // no speed control, full speed
+    }
+
+    // The resistance slows the servo down, up to a stall once it reaches the torque limit
+    float limit = Word(AX12_REG_TORQUE_LIMIT) / 1023.0f;
+    float free = (limit > 0) ? 1.0f - resistance / limit : 0;
+    free = (free < 0) ? 0 : free;
+
+    // CCW turns towards increasing positions
+    bool cw;
+    float step = speed * AX12_SPEED_UNIT_TICKS * 1e-9f * speed_scale * free * ns;
+    if (wheel) {
+        float turn = dead_zone ? 1228.8f : 1024.0f;
+        cw = (command & AX12_SPEED_CW) != 0;
+        _position += cw ? -step : step;
+        _position -= turn * (int)(_position / turn);
+        _position += (_position < 0) ? turn : 0;
+        travel += cw ? -step : step;
+    } else {
+        float distance = goal - _position;
+        cw = (distance < 0);
+        if (distance > step) {
+            _position += step;
+        } else if (distance < -step) {
+            _position -= step;
+        } else {
+            _position = goal;
+        }
+    }
+
+    int present = (int)(speed * speed_scale * free + 0.5f);
+    present = (present > 0x3FF) ? 0x3FF : present;
+    if (!dead_zone || _position < 1023.5f) {
+        SetWord(AX12_REG_POSITION, (int)(_position + 0.5f) & 0x3FF);
+    }
+    SetWord(AX12_REG_SPEED, cw ? (present | AX12_SPEED_CW) : present);
+    table[AX12_REG_MOVING] = 1;
+
+    // Driving load : friction growing with the speed, plus the resistance
+    int driving = speed / 8 + (int)(resistance * 1023);
+    driving = (driving > 1023) ? 1023 : driving;
+    load = cw ? driving : -driving;
+    _driving = true;
+}
+
+
+AX12EmulatedBus::AX12EmulatedBus(AX12VirtualClock &clock, int baud)
+    : _clock(clock)
+{
+    _baud = baud;
+    _clean_baud = 1000000;
+    _noise_ppm = 0;
+    _noise = 1;
+    _count = 0;
+    _tx_length = 0;
+    _tx_end = 0;
+    _pending = false;
+    _line_error = false;
+    _rx_length = 0;
+    _rx_read = 0;
+    _rx_start = 0;
+    _physics = 0;
+}
+
+AX12EmulatedServo *AX12EmulatedBus::Attach(int id)
+{
+    if (_count >= AX12_EMU_MAX_SERVOS) {
+        return 0;
+    }
+    AX12EmulatedServo &servo = _servos[_count++];
+    servo.Reset(id);
+    servo.physics = 0;
+    _physics = _clock.Elapsed() * 1000;
+    return &servo;
+}
+
+AX12EmulatedServo *AX12EmulatedBus::Servo(int id)
+{
+    for (int i = 0; i < _count; i++) {
+        if (_servos[i].Id() == id) {
+            return &_servos[i];
+        }
+    }
+    return 0;
+}
+
+AX12EmulatedServo &AX12EmulatedBus::ServoAt(int index)
+{
+    return _servos[index];
+}
+
+int AX12EmulatedBus::Servos(void)
+{
+    return _count;
+}
+
+int AX12EmulatedBus::send(const uint8_t *data, int length)
+{
+    Update();
+    if (_pending || length > AX12_EMU_PACKET_SIZE) {
+        return -1;
+    }
+
+    memcpy(_tx, data, length);
+    corrupt(_tx, length);
+    _line_error = (memcmp(_tx, data, length) != 0);
+    _tx_length = length;
+    _tx_end = _clock.Elapsed() * 1000 + length * byteTime();
+    _pending = true;
+    _rx_length = 0; // a new packet cuts any pending reply
+    _rx_read = 0;
+    return length;
+}
+
+bool AX12EmulatedBus::line_error(void)
+{
+    return _line_error;
+}
+
+bool AX12EmulatedBus::sending(void)
+{
+    Update();
+    return _pending;
+}
+
+int AX12EmulatedBus::receive(uint8_t *data, int length)
+{
+    Update();
+    if (_rx_read >= _rx_length) {
+        return 0;
+    }
+
+    uint64_t now = _clock.Elapsed() * 1000;
+    if (now < _rx_start) {
+        return 0;
+    }
+
+    // Bytes whose stop bit has been received
+    int available = (int)((now - _rx_start) / byteTime());
+    if (available > _rx_length) {
+        available = _rx_length;
+    }
+
+    int n = 0;
+    while (_rx_read < available && n < length) {
+        data[n++] = _rx[_rx_read++];
+    }
+    return n;
+}
+
+void AX12EmulatedBus::flush(void)
+{
+    Update();
+    _rx_read = _rx_length;
+}
+
+int AX12EmulatedBus::baudrate(void)
+{
+    return _baud;
+}
+
+int AX12EmulatedBus::set_baudrate(int baud)
+{
+    Update();
+    if (baud <= 0 || _pending) {
+        return -1;
+    }
+    _baud = baud;
+    _rx_read = _rx_length; // a reply on the way is lost
+    return 0;
+}
+
+void AX12EmulatedBus::SetLineQuality(int clean_baud, uint32_t ppm, uint32_t seed)
+{
+    _clean_baud = clean_baud;
+    _noise_ppm = ppm;
+    _noise = seed ? seed : 1;
+}
+
+void AX12EmulatedBus::corrupt(uint8_t *data, int length)
+{
+    if (_baud <= _clean_baud || _clean_baud >= 1000000) {
+        return;
+    }
+    uint32_t ppm = (uint32_t)((uint64_t)_noise_ppm * (_baud - _clean_baud) / (1000000 - _clean_baud));
+
+    for (int i = 0; i < length; i++) {
+        // xorshift32
+        _noise ^= _noise << 13;
+        _noise ^= _noise >> 17;
+        _noise ^= _noise << 5;
+        if (_noise % 1000000 < ppm) {
+            data[i] ^= 1 << (_noise >> 29);
+        }
+    }
+}
+
+// Execute the packet being sent once it is completely on the wire
+void AX12EmulatedBus::Update(void)
+{
+    uint64_t now = _clock.Elapsed() * 1000;
+
+    if (_pending && now >= _tx_end) {
+        advance(_tx_end);
+        _pending = false;
+        execute(_tx, _tx_length);
+    }
+    advance(now);
+}
+
+void AX12EmulatedBus::advance(uint64_t until)
+{
+    if (until > _physics) {
+        for (int i = 0; i < _count; i++) {
+            _servos[i].Advance(until - _physics);
+        }
+        _physics = until;
+    }
+}
+
+// Duration of one byte in nanoseconds
+uint64_t AX12EmulatedBus::byteTime(void)
+{
+    return 10000000000ULL / _baud;
+}
+
+void AX12EmulatedBus::execute(const uint8_t *packet, int length)
+{
+    if (length < AX12_PACKET_OVERHEAD || packet[0] != 0xFF || packet[1] != 0xFF
+        || packet[3] + 4 != length) {
+        return; // garbage, nobody answers
+    }
+
+    int id = packet[2];
+    int instruction = packet[4];
+    const uint8_t *params = &packet[5];
+    int count = length - AX12_PACKET_OVERHEAD;
+    bool broadcast = (id == AX12_BROADCAST_ID);
+
+    for (int i = 0; i < _count; i++) {
+        AX12EmulatedServo &servo = _servos[i];
+
+        // Off the chain, or listening at another speed : it only sees noise
+        if (servo.unplugged || servo.Baudrate() != _baud) {
+            continue;
+        }
+
+        if (instruction == AX12_INST_SYNC_WRITE && broadcast) {
+            if (count < 2 || AX12_Checksum(packet, length) != packet[length - 1]) {
+                continue;
+            }
+            int start = params[0];
+            int bytes = params[1];
+            for (int p = 2; p + 1 + bytes <= count; p += 1 + bytes) {
+                if (params[p] == servo.Id()) {
+                    servo.packets++;
+                    write(servo, start, &params[p + 1], bytes);
+                }
+            }
+            continue;
+        }
+
+        if (!broadcast && servo.Id() != id) {
+            continue;
+        }
+        servo.packets++;
+
+        if (AX12_Checksum(packet, length) != packet[length - 1]) {
+            if (!broadcast) {
+                reply(servo, AX12_ERROR_CHECKSUM, 0, 0);
+            }
+            continue;
+        }
+
+        int error = 0;
+        int status = servo.table[AX12_REG_STATUS_RETURN];
+        uint8_t data[AX12_TABLE_SIZE];
+        int reply_count = 0;
+        bool answer = (status >= 2);
+
+        switch (instruction) {
+        case AX12_INST_PING:
+            answer = true;
+            break;
+        case AX12_INST_READ:
+            answer = (status >= 1);
+            if (count != 2 || params[0] + params[1] > AX12_TABLE_SIZE) {
+                error = AX12_ERROR_RANGE;
+            } else {
+                reply_count = params[1];
+                if (params[0] <= AX12_REG_LOAD + 1 && params[0] + reply_count > AX12_REG_LOAD) {
+                    servo.sampleLoad();
+                }
+                if (params[0] <= AX12_REG_POSITION + 1 && params[0] + reply_count > AX12_REG_POSITION) {
+                    servo.samplePosition();
+                }
+                memcpy(data, &servo.table[params[0]], reply_count);
+            }
+            break;
+        case AX12_INST_WRITE:
+            error = (count < 2) ? AX12_ERROR_INSTRUCTION : write(servo, params[0], &params[1], count - 1);
+            break;
+        case AX12_INST_REG_WRITE:
+            if (count < 2 || count > AX12_TABLE_SIZE) {
+                error = AX12_ERROR_INSTRUCTION;
+            } else {
+                memcpy(servo._registered, params, count);
+                servo._registered_length = count;
+                servo.table[AX12_REG_REGISTERED] = 1;
+            }
+            break;
+        case AX12_INST_ACTION:
+            if (servo._registered_length > 0) {
+                write(servo, servo._registered[0], &servo._registered[1], servo._registered_length - 1);
+                servo._registered_length = 0;
+                servo.table[AX12_REG_REGISTERED] = 0;
+            }
+            break;
+        case AX12_INST_RESET:
+            servo.Reset();
+            break;
+        default:
+            error = AX12_ERROR_INSTRUCTION;
+            break;
+        }
+
+        if (answer && !broadcast) {
+            reply(servo, error, data, reply_count);
+        }
+    }
+}
+
+int AX12EmulatedBus::write(AX12EmulatedServo &servo, int start, const uint8_t *data, int length)
+{
+    if (start + length > AX12_TABLE_SIZE) {
+        return AX12_ERROR_RANGE;
+    }
+
+    int error = 0;
+    for (int i = 0; i < length; i++) {
+        int reg = start + i;
+        // Model, firmware and the present values are read only
+        if (reg <= AX12_REG_FIRMWARE || (reg >= AX12_REG_POSITION && reg < AX12_REG_MOVING)) {
+            error = AX12_ERROR_RANGE;
+            continue;
+        }
+        servo.table[reg] = data[i];
+    }
+    servo.written = _tx_end;
+
+    // A new goal, or a new speed in wheel mode, enables the torque
+    bool wheel = (servo.Word(AX12_REG_CW_LIMIT) == 0 && servo.Word(AX12_REG_CCW_LIMIT) == 0);
+    int reg = wheel ? AX12_REG_MOVING_SPEED : AX12_REG_GOAL_POSITION;
+    if (start <= reg + 1 && start + length > reg) {
+        servo.table[AX12_REG_ENABLE_TORQUE] = 1;
+    }
+    return error;
+}
+
+void AX12EmulatedBus::reply(AX12EmulatedServo &servo, int error, const uint8_t *params, int count)
+{
+    _rx[0] = 0xFF;
+    _rx[1] = 0xFF;
+    _rx[2] = servo.Id();
+    _rx[3] = count + 2;
+    _rx[4] = error | servo.alarms;
+    if (count > 0) {
+        memcpy(&_rx[5], params, count); // params is 0 for a status without parameters
+    }
+    _rx_length = count + AX12_PACKET_OVERHEAD;
+    _rx[_rx_length - 1] = AX12_Checksum(_rx, _rx_length);
+    corrupt(_rx, _rx_length);
+    _rx_read = 0;
+    _rx_start = _tx_end + servo.table[AX12_REG_RETURN_DELAY] * 2000ULL;
+}
@@ -0,0 +1,235 @@
+/**
+ * @file AX12Estimator.cpp
+ * @author joebarteam11
+ * @brief Prediction of the servo positions between two reads
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+#include "AX12Estimator.h"
+
+#include <math.h>
+
+AX12Estimator::AX12Estimator()
+{
+    _known = false;
+    _origin = 0;
+    _bound = 0;
+    _since = 0;
+    _goal = -1;
+    _speed = 0;
+    _gain = 1.0f;
+    _error = AX12_ESTIMATOR_INIT_ERROR;
+    _read = 0;
+    _predicted = 0;
+    _reached = false;
+}
+
+// Signed distance predicted from _origin at time now
+float AX12Estimator::travel(uint32_t now, bool *reached)
+{
+    float distance = (_goal < 0) ? 0 : _goal - _origin;
+    float step = _speed * _gain * (uint32_t)(now - _since);
+
+    *reached = (fabsf(distance) <= step);
+    if (*reached) {
+        return distance;
+    }
+    return (distance > 0) ? step : -step;
+}
+
+// Move the origin of the prediction to now
+void AX12Estimator::roll(uint32_t now)
+{
+    bool reached;
+    float t = travel(now, &reached);
+
+    _bound = Uncertainty(now);
+    _origin += t;
+    _predicted += t;
+    _reached = _reached || reached;
+    _since = now;
+}
+
+void AX12Estimator::Command(uint32_t now, int goal, int speed)
+{
+    roll(now);
+    speed &= 0x3FF;
+    _goal = goal;
+    _speed = (speed ? speed : 0x3FF) * AX12_SPEED_UNIT_TICKS * 1e-6f;
+}
+
+void AX12Estimator::Measure(uint32_t now, int position, int speed)
+{
+    if (_known) {
+        roll(now);
+
+        if (fabsf(_predicted) > 8) {
+            // The displacement only tells the speed if the prediction did not
+            // stop on a goal
+            float ratio = (position - _read) / _predicted;
+            if (!_reached && ratio > 0.3f && ratio < 2.0f) {
+                _gain += 0.3f * (_gain * ratio - _gain);
+            }
+            // Twice the residual, less the tick of rounding of the read
+            float residual = fabsf(position - _origin) - 1;
+            float error = 2 * (residual > 0 ? residual : 0) / fabsf(_predicted);
+            _error += 0.2f * (error - _error);
+        }
+
+        // The present speed gives the gain directly
+        int commanded = (int)(_speed / (AX12_SPEED_UNIT_TICKS * 1e-6f) + 0.5f);
+        if (speed > 0 && (speed & 0x3FF) && commanded > 0) {
+            _gain += 0.3f * ((float)(speed & 0x3FF) / commanded - _gain);
+        }
+
+        if (_error < AX12_ESTIMATOR_MIN_ERROR) {
+            _error = AX12_ESTIMATOR_MIN_ERROR;
+        } else if (_error > 1.0f) {
+            _error = 1.0f;
+        }
+    }
+
+    if (_goal < 0) {
+        _goal = position;
+    }
+    _known = true;
+    _origin = position;
+    _read = position;
+    _bound = AX12_ESTIMATOR_BASE;
+    _since = now;
+    _predicted = 0;
+    _reached = false;
+}
+
+float AX12Estimator::Position(uint32_t now)
+{
+    bool reached;
+    return _origin + travel(now, &reached);
+}
+
+float AX12Estimator::Uncertainty(uint32_t now)
+{
+    if (!_known) {
+        return 1023;
+    }
+
+    bool reached;
+    float t = travel(now, &reached);
+
+    // Even at the slowest speed assumed the servo is on its goal by now
+    float slowest = _speed * _gain * (1 - _error) * (uint32_t)(now - _since);
+    if (reached && _goal >= 0 && slowest >= fabsf(_goal - _origin) + _bound) {
+        return AX12_ESTIMATOR_BASE;
+    }
+    return _bound + _error * fabsf(t);
+}
+
+bool AX12Estimator::NeedsRead(uint32_t now, float tolerance)
+{
+    return Uncertainty(now) > tolerance;
+}
+
+float AX12Estimator::Gain(void)
+{
+    return _gain;
+}
+
+float AX12Estimator::Error(void)
+{
+    return _error;
+}
+
+
+AX12Tracker::AX12Tracker(AX12MultiBus &joints, float tolerance)
+    : _joints(joints)
+{
+    _tolerance = tolerance;
+    _count = 0;
+    _reads = 0;
+}
+
+int AX12Tracker::Add(int id)
+{
+    if (_count >= AX12_TRACKER_MAX_JOINTS) {
+        return -1;
+    }
+    _ids[_count] = id;
+    _estimators[_count] = AX12Estimator();
+    return _count++;
+}
+
+void AX12Tracker::Command(int joint, int goal, int speed)
+{
+    _estimators[joint].Command(_joints.Clock().now_us(), goal, speed);
+}
+
+int AX12Tracker::Refresh(void)
+{
+    bool selected[AX12_TRACKER_MAX_JOINTS];
+    uint32_t now = _joints.Clock().now_us();
+
+    for (int i = 0; i < _count; i++) {
+        selected[i] = _estimators[i].NeedsRead(now, _tolerance);
+    }
+    return read(selected);
+}
+
+float AX12Tracker::Position(int joint)
+{
+    if (_estimators[joint].NeedsRead(_joints.Clock().now_us(), _tolerance)) {
+        bool selected[AX12_TRACKER_MAX_JOINTS] = {false};
+        selected[joint] = true;
+        read(selected);
+    }
+    return _estimators[joint].Position(_joints.Clock().now_us());
+}
+
+float AX12Tracker::Uncertainty(int joint)
+{
+    return _estimators[joint].Uncertainty(_joints.Clock().now_us());
+}
+
+AX12Estimator &AX12Tracker::Joint(int joint)
+{
+    return _estimators[joint];
+}
+
+uint32_t AX12Tracker::Reads(void)
+{
+    return _reads;
+}
+
+// Read position and speed (0x24-0x27) of the selected joints in one batch
+int AX12Tracker::read(const bool *selected)
+{
+    uint8_t ids[AX12_TRACKER_MAX_JOINTS];
+    int joint[AX12_TRACKER_MAX_JOINTS];
+    uint8_t data[4 * AX12_TRACKER_MAX_JOINTS];
+    int results[AX12_TRACKER_MAX_JOINTS];
+    int count = 0;
+
+    for (int i = 0; i < _count; i++) {
+        if (selected[i]) {
+            joint[count] = i;
+            ids[count++] = _ids[i];
+        }
+    }
+    if (count == 0) {
+        return 0;
+    }
+
+    _joints.ReadAll(AX12_REG_POSITION, 4, ids, data, results, count);
+    _reads += count;
+
+    uint32_t now = _joints.Clock().now_us();
+    for (int k = 0; k < count; k++) {
+        if (results[k] == AX12_OK) {
+            const uint8_t *d = &data[4 * k];
+            _estimators[joint[k]].Measure(now, d[0] | (d[1] << 8), d[2] | (d[3] << 8));
+        }
+    }
+    return count;
+}
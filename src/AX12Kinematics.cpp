@@ -0,0 +1,372 @@
+/**
+ * @file AX12Kinematics.cpp
+ * @author joebarteam11
+ * @brief Forward and inverse kinematics of legs and arms in fixed point, in servo ticks
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+#include "AX12Kinematics.h"
+
+// sin of a quarter turn in 64 steps, Q15
+static const uint16_t AX12_KIN_SINE[65] = {
+        0,   804,  1608,  2411,  3212,  4011,  4808,  5602,
+     6393,  7180,  7962,  8740,  9512, 10279, 11039, 11793,
+    12540, 13279, 14010, 14733, 15447, 16151, 16846, 17531,
+    18205, 18868, 19520, 20160, 20788, 21403, 22006, 22595,
+    23170, 23732, 24279, 24812, 25330, 25833, 26320, 26791,
+    27246, 27684, 28106, 28511, 28899, 29269, 29622, 29957,
+    30274, 30572, 30853, 31114, 31357, 31581, 31786, 31972,
+    32138, 32286, 32413, 32522, 32610, 32679, 32729, 32758,
+    32768,
+};
+
+// atan(2^-i), 2^24 for one turn
+static const int32_t AX12_KIN_ATAN[16] = {
+    2097152, 1238021, 654136, 332050, 166669, 83416, 41718, 20860,
+      10430,    5215,   2608,   1304,    652,   326,   163,    81,
+};
+
+#define CORDIC_GAIN 652032874 // product of cos(atan(2^-i)), Q30
+#define TICKS_PER_ANGLE 19642  // 1023 / 300 degrees, in turns / 65536, Q20
+#define ANGLE_PER_TICK 13667   // inverse, Q8
+
+// sin of 0 to a quarter turn (0 to 16384)
+static int32_t quarter(uint32_t a)
+{
+    uint32_t i = a >> 8;
+    int32_t s = AX12_KIN_SINE[i];
+    if (i < 64) {
+        s += ((AX12_KIN_SINE[i + 1] - s) * (int32_t)(a & 0xFF)) >> 8;
+    }
+    return s;
+}
+
+int32_t AX12_Sin(int32_t angle)
+{
+    uint32_t a = (uint32_t)angle & 0xFFFF;
+    uint32_t x = a & 0x3FFF;
+
+    switch (a >> 14) {
+    case 0:
+        return quarter(x);
+    case 1:
+        return quarter(0x4000 - x);
+    case 2:
+        return -quarter(x);
+    default:
+        return -quarter(0x4000 - x);
+    }
+}
+
+int32_t AX12_Cos(int32_t angle)
+{
+    return AX12_Sin(angle + AX12_KIN_TURN / 4);
+}
+
+int32_t AX12_Atan2(int64_t y, int64_t x, int64_t *magnitude)
+{
+    if (x == 0 && y == 0) {
+        if (magnitude) {
+            *magnitude = 0;
+        }
+        return 0;
+    }
+
+    // Largest coordinate between 2^28 and 2^29, the gain of 1.65 stays below 2^31
+    uint64_t m = (uint64_t)(x < 0 ? -x : x) | (uint64_t)(y < 0 ? -y : y);
+    int shift = 35 - __builtin_clzll(m); // bits above 29
+    int32_t xi = (int32_t)((shift >= 0) ? x >> shift : x * ((int64_t)1 << -shift));
+    int32_t yi = (int32_t)((shift >= 0) ? y >> shift : y * ((int64_t)1 << -shift));
+
+    // Left half plane : a quarter turn first
+    int32_t a = 0;
+    if (xi < 0) {
+        int32_t t = xi;
+        if (yi >= 0) {
+            xi = yi;
+            yi = -t;
+            a = 1 << 22;
+        } else {
+            xi = -yi;
+            yi = t;
+            a = -(1 << 22);
+        }
+    }
+
+    // Turn the vector onto the x axis, summing the angles
+    for (int i = 0; i < 16; i++) {
+        int32_t dx = xi >> i;
+        int32_t dy = yi >> i;
+        if (yi > 0) {
+            xi += dy;
+            yi -= dx;
+            a += AX12_KIN_ATAN[i];
+        } else {
+            xi -= dy;
+            yi += dx;
+            a -= AX12_KIN_ATAN[i];
+        }
+    }
+
+    if (magnitude) {
+        int64_t r = (int64_t)xi * CORDIC_GAIN;
+        int s = 30 - shift;
+        *magnitude = (s > 0) ? (r + ((int64_t)1 << (s - 1))) >> s : r * ((int64_t)1 << -s);
+    }
+    return (a + 128) >> 8;
+}
+
+int AX12_AngleToTicks(int32_t angle)
+{
+    return (angle * TICKS_PER_ANGLE + (1 << 19)) >> 20;
+}
+
+int32_t AX12_TicksToAngle(int ticks)
+{
+    return (ticks * ANGLE_PER_TICK + 128) >> 8;
+}
+
+// Integer square root, one bit per iteration
+static uint32_t root(uint32_t v)
+{
+    uint32_t r = 0;
+    uint32_t bit = 1UL << 30;
+
+    while (bit > v) {
+        bit >>= 2;
+    }
+    while (bit) {
+        if (v >= r + bit) {
+            v -= r + bit;
+            r = (r >> 1) + bit;
+        } else {
+            r >>= 1;
+        }
+        bit >>= 2;
+    }
+    return r;
+}
+
+
+AX12Limb::AX12Limb()
+{
+    AX12Point origin = {0, 0, 0};
+
+    SetLayout(AX12_KIN_PLANAR2, 0, AX12_KIN_MM(100), AX12_KIN_MM(100));
+    SetMount(origin, 0);
+    _knee_up = false;
+    for (int j = 0; j < 3; j++) {
+        SetJoint(j, j + 1);
+    }
+}
+
+void AX12Limb::SetLayout(int layout, int32_t coxa, int32_t femur, int32_t tibia)
+{
+    _layout = layout;
+    _coxa = (layout == AX12_KIN_LEG3) ? coxa : 0;
+    _femur = femur;
+    _tibia = tibia;
+}
+
+void AX12Limb::SetMount(const AX12Point &origin, int32_t yaw)
+{
+    _origin = origin;
+    _cos = AX12_Cos(yaw);
+    _sin = AX12_Sin(yaw);
+}
+
+void AX12Limb::SetKneeUp(bool up)
+{
+    _knee_up = up;
+}
+
+void AX12Limb::SetJoint(int joint, int id, int center, bool reversed, int min, int max)
+{
+    Joint &j = _joints[joint];
+    j.id = id;
+    j.center = center;
+    j.reversed = reversed;
+    j.min = min;
+    j.max = max;
+}
+
+int AX12Limb::Joints(void)
+{
+    return (_layout == AX12_KIN_LEG3) ? 3 : 2;
+}
+
+int AX12Limb::Id(int joint)
+{
+    return _joints[joint].id;
+}
+
+int AX12Limb::angle(int joint, int ticks)
+{
+    const Joint &j = _joints[joint];
+    int offset = ticks - j.center;
+    return AX12_TicksToAngle(j.reversed ? -offset : offset);
+}
+
+void AX12Limb::Forward(const uint16_t *ticks, AX12Point &end)
+{
+    int n = 0;
+    int32_t yaw = 0;
+    if (_layout == AX12_KIN_LEG3) {
+        yaw = angle(n, ticks[n]);
+        n++;
+    }
+    int32_t femur = angle(n, ticks[n]);
+    int32_t tibia = femur + angle(n + 1, ticks[n + 1]);
+
+    // In the plane of the limb : reach and height
+    int64_t d = ((int64_t)_coxa << 15) + (int64_t)_femur * AX12_Cos(femur) + (int64_t)_tibia * AX12_Cos(tibia);
+    int64_t z = (int64_t)_femur * AX12_Sin(femur) + (int64_t)_tibia * AX12_Sin(tibia);
+    d >>= 15;
+
+    // Limb frame, then body frame
+    int64_t x = (d * AX12_Cos(yaw)) >> 15;
+    int64_t y = (d * AX12_Sin(yaw)) >> 15;
+    end.x = _origin.x + (int32_t)((x * _cos - y * _sin) >> 15);
+    end.y = _origin.y + (int32_t)((x * _sin + y * _cos) >> 15);
+    end.z = _origin.z + (int32_t)(z >> 15);
+}
+
+int AX12Limb::Inverse(const AX12Point &end, uint16_t *ticks)
+{
+    // Body frame to limb frame
+    int64_t dx = end.x - _origin.x;
+    int64_t dy = end.y - _origin.y;
+    int64_t z = end.z - _origin.z;
+    int64_t x = (dx * _cos + dy * _sin) >> 15;
+    int64_t y = (dy * _cos - dx * _sin) >> 15;
+
+    // Reach in the plane of the limb with 8 more bits : near a stretched knee
+    // 1/16 mm less on the reach changes the knee by a few ticks
+    int32_t angles[3];
+    int n = 0;
+    int64_t d = x * 256;
+    if (_layout == AX12_KIN_LEG3) {
+        angles[n++] = AX12_Atan2(y * 256, x * 256, &d);
+        d -= (int64_t)_coxa << 8;
+    }
+
+    // Law of cosines : c = 2 femur tibia cos(knee), tan(knee / 2) = sqrt((a - c) / (a + c))
+    int64_t a = 2 * (int64_t)_femur * _tibia;
+    int64_t c = ((d * d + (1 << 15)) >> 16) + z * z - (int64_t)_femur * _femur - (int64_t)_tibia * _tibia;
+    if (c > a || c < -a) {
+        return AX12_ERROR_RANGE;
+    }
+    int32_t knee = 2 * AX12_Atan2(root((uint32_t)(a - c)), root((uint32_t)(a + c)));
+    knee = _knee_up ? knee : -knee;
+
+    // Femur : direction of the target less the angle the tibia adds
+    int64_t s = (int64_t)_tibia * AX12_Sin(knee);
+    int64_t k = ((int64_t)_femur << 15) + (int64_t)_tibia * AX12_Cos(knee);
+    angles[n++] = AX12_Atan2(z * 256, d) - AX12_Atan2(s, k);
+    angles[n++] = knee;
+
+    uint16_t goals[3];
+    for (int i = 0; i < n; i++) {
+        const Joint &j = _joints[i];
+        int offset = AX12_AngleToTicks((int16_t)angles[i]);
+        int goal = j.center + (j.reversed ? -offset : offset);
+        if (goal < j.min || goal > j.max) {
+            return AX12_ERROR_ANGLE;
+        }
+        goals[i] = goal;
+    }
+    for (int i = 0; i < n; i++) {
+        ticks[i] = goals[i];
+    }
+    return AX12_OK;
+}
+
+
+AX12Kinematics::AX12Kinematics(AX12MultiBus &joints)
+    : _joints(joints)
+{
+    _count = 0;
+    _joint_count = 0;
+}
+
+int AX12Kinematics::Add(const AX12Limb &limb)
+{
+    if (_count >= AX12_KIN_MAX_LIMBS) {
+        return -1;
+    }
+    _limbs[_count] = limb;
+    _results[_count] = AX12_OK;
+    _solved[_count] = false;
+    _first[_count] = _joint_count;
+    for (int j = 0; j < _limbs[_count].Joints(); j++) {
+        _ids[_joint_count] = _limbs[_count].Id(j);
+        _goals[_joint_count++] = 512;
+    }
+    return _count++;
+}
+
+AX12Limb &AX12Kinematics::Limb(int limb)
+{
+    return _limbs[limb];
+}
+
+int AX12Kinematics::Solve(const AX12Point *ends)
+{
+    int solved = 0;
+
+    for (int i = 0; i < _count; i++) {
+        _results[i] = _limbs[i].Inverse(ends[i], &_goals[_first[i]]);
+        if (_results[i] == AX12_OK) {
+            _solved[i] = true;
+            solved++;
+        }
+    }
+    return solved;
+}
+
+int AX12Kinematics::Send(void)
+{
+    uint8_t ids[3 * AX12_KIN_MAX_LIMBS];
+    uint16_t goals[3 * AX12_KIN_MAX_LIMBS];
+    int n = 0;
+
+    for (int i = 0; i < _count; i++) {
+        if (!_solved[i]) {
+            continue;
+        }
+        for (int j = 0; j < _limbs[i].Joints(); j++) {
+            ids[n] = _limbs[i].Id(j);
+            goals[n++] = _goals[_first[i] + j];
+        }
+    }
+    return n ? _joints.SetGoals(ids, goals, n) : AX12_OK;
+}
+
+int AX12Kinematics::Tick(const AX12Point *ends)
+{
+    Solve(ends);
+    return Send();
+}
+
+int AX12Kinematics::Result(int limb)
+{
+    return _results[limb];
+}
+
+int AX12Kinematics::Joints(void)
+{
+    return _joint_count;
+}
+
+const uint8_t *AX12Kinematics::Ids(void)
+{
+    return _ids;
+}
+
+const uint16_t *AX12Kinematics::Goals(void)
+{
+    return _goals;
+}
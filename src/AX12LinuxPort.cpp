@@ -0,0 +1,257 @@
+/**
+ * @file AX12LinuxPort.cpp
+ * @author joebarteam11
+ * @brief AX12Port on a Linux tty (USB-serial half duplex adapter)
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+#if defined(__linux__)
+
+#include "AX12LinuxPort.h"
+#include "AX12Protocol.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <poll.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+// termios2 (any bit rate with BOTHER), the glibc <termios.h> cannot be included with it
+#include <asm/termbits.h>
+#include <linux/serial.h>
+
+AX12LinuxPort::AX12LinuxPort()
+{
+    _fd = -1;
+    _baud = 0;
+    _options = 0;
+    _tx = 0;
+    _tx_length = 0;
+    _tx_written = 0;
+    _tx_end = 0;
+    _echo = 0;
+}
+
+AX12LinuxPort::~AX12LinuxPort()
+{
+    Close();
+}
+
+int AX12LinuxPort::Open(const char *path, int baud, int options)
+{
+    Close();
+
+    _fd = ::open(path, O_RDWR | O_NOCTTY | O_NONBLOCK);
+    if (_fd < 0) {
+        return AX12_ERR_ARG;
+    }
+    _options = options;
+
+    struct termios2 tio;
+    if (ioctl(_fd, TCGETS2, &tio) < 0) {
+        Close();
+        return AX12_ERR_ARG;
+    }
+
+    // Raw mode : no line discipline, no flow control, 8N1, reads never block
+    tio.c_iflag &= ~(IGNBRK | BRKINT | PARMRK | ISTRIP | INLCR | IGNCR | ICRNL | IXON | IXOFF | IXANY);
+    tio.c_oflag &= ~OPOST;
+    tio.c_lflag &= ~(ECHO | ECHONL | ICANON | ISIG | IEXTEN);
+    tio.c_cflag &= ~(CSIZE | PARENB | CSTOPB | CRTSCTS);
+    tio.c_cflag |= CS8 | CLOCAL | CREAD;
+    tio.c_cc[VMIN] = 0;
+    tio.c_cc[VTIME] = 0;
+    if (ioctl(_fd, TCSETS2, &tio) < 0 || SetBaudrate(baud) != AX12_OK) {
+        Close();
+        return AX12_ERR_ARG;
+    }
+
+    if (options & AX12_LINUX_LOW_LATENCY) {
+        lowLatency(path);
+    }
+    ioctl(_fd, TCFLSH, TCIOFLUSH);
+    return AX12_OK;
+}
+
+void AX12LinuxPort::Close(void)
+{
+    if (_fd >= 0) {
+        ::close(_fd);
+    }
+    _fd = -1;
+    _tx_length = 0;
+    _tx_written = 0;
+    _echo = 0;
+}
+
+int AX12LinuxPort::SetBaudrate(int baud)
+{
+    struct termios2 tio;
+
+    if (_fd < 0 || baud <= 0 || ioctl(_fd, TCGETS2, &tio) < 0) {
+        return AX12_ERR_ARG;
+    }
+    tio.c_cflag &= ~(CBAUD | (CBAUD << IBSHIFT));
+    tio.c_cflag |= BOTHER | (BOTHER << IBSHIFT);
+    tio.c_ispeed = baud;
+    tio.c_ospeed = baud;
+    if (ioctl(_fd, TCSETS2, &tio) < 0) {
+        return AX12_ERR_ARG;
+    }
+    _baud = baud;
+    return AX12_OK;
+}
+
+int AX12LinuxPort::Fd(void)
+{
+    return _fd;
+}
+
+// Best effort, the flags are silently ignored by the drivers that do not know them
+void AX12LinuxPort::lowLatency(const char *path)
+{
+    struct serial_struct serial;
+    if (ioctl(_fd, TIOCGSERIAL, &serial) == 0) {
+        serial.flags |= ASYNC_LOW_LATENCY;
+        ioctl(_fd, TIOCSSERIAL, &serial);
+    }
+
+    // FTDI adapters hold the received bytes up to 16 ms by default
+    char device[PATH_MAX];
+    if (realpath(path, device)) {
+        const char *name = strrchr(device, '/');
+        char timer[PATH_MAX + 64];
+        snprintf(timer, sizeof(timer), "/sys/bus/usb-serial/devices/%s/latency_timer", name ? name + 1 : device);
+        FILE *f = fopen(timer, "w");
+        if (f) {
+            fputs("1", f);
+            fclose(f);
+        }
+    }
+}
+
+uint64_t AX12LinuxPort::now(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+int AX12LinuxPort::send(const uint8_t *data, int length)
+{
+    if (_fd < 0 || sending()) {
+        return -1;
+    }
+
+    // The whole packet in one syscall, the rest later if the kernel buffer is full
+    int n = ::write(_fd, data, length);
+    if (n < 0) {
+        if (errno != EAGAIN) {
+            return -1;
+        }
+        n = 0;
+    }
+    _tx = data;
+    _tx_length = length;
+    _tx_written = n;
+    _tx_end = now() + (uint64_t)length * 10000000000ULL / _baud;
+    if (_options & AX12_LINUX_ECHO) {
+        _echo += length;
+    }
+    return length;
+}
+
+bool AX12LinuxPort::sending(void)
+{
+    if (_tx_written < _tx_length) {
+        int n = ::write(_fd, _tx + _tx_written, _tx_length - _tx_written);
+        if (n > 0) {
+            _tx_written += n;
+            uint64_t end = now() + (uint64_t)n * 10000000000ULL / _baud;
+            _tx_end = (end > _tx_end) ? end : _tx_end;
+        }
+        if (_tx_written < _tx_length) {
+            return true;
+        }
+    }
+    return now() < _tx_end;
+}
+
+int AX12LinuxPort::receive(uint8_t *data, int length)
+{
+    if (_fd < 0) {
+        return 0;
+    }
+
+    for (;;) {
+        int n = ::read(_fd, data, length);
+        if (n <= 0) {
+            return 0;
+        }
+        // Local echo of the adapter first
+        int drop = (n < _echo) ? n : _echo;
+        _echo -= drop;
+        if (drop < n) {
+            memmove(data, data + drop, n - drop);
+            return n - drop;
+        }
+    }
+}
+
+void AX12LinuxPort::flush(void)
+{
+    // Read rather than TCFLSH : the echo bytes dropped here are accounted for
+    uint8_t junk[64];
+    while (receive(junk, sizeof(junk)) > 0) {
+    }
+}
+
+int AX12LinuxPort::baudrate(void)
+{
+    return _baud;
+}
+
+int AX12LinuxPort::set_baudrate(int baud)
+{
+    return SetBaudrate(baud);
+}
+
+uint32_t AX12LinuxPort::latency(void)
+{
+    // Latency timer of the FTDI adapters, see lowLatency()
+    return (_options & AX12_LINUX_LOW_LATENCY) ? 1000 : 16000;
+}
+
+bool AX12LinuxPort::wait(uint32_t us)
+{
+    if (_fd < 0) {
+        return false;
+    }
+
+    // Wake up at the end of the transmission too, AX12Bus moves on to the reply then
+    uint64_t t = now();
+    uint64_t until = t + us * 1000ULL;
+    if (_tx_length > 0 && t < _tx_end && _tx_end < until) {
+        until = _tx_end;
+    }
+
+    struct pollfd p;
+    p.fd = _fd;
+    p.events = POLLIN | ((_tx_written < _tx_length) ? POLLOUT : 0);
+    p.revents = 0;
+
+    struct timespec timeout;
+    timeout.tv_sec = (until - t) / 1000000000ULL;
+    timeout.tv_nsec = (until - t) % 1000000000ULL;
+    ppoll(&p, 1, &timeout, 0);
+    return true;
+}
+
+#endif
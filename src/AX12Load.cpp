@@ -0,0 +1,217 @@
+/**
+ * @file AX12Load.cpp
+ * @author joebarteam11
+ * @brief Load (torque) sampling of many servos, filtered and decimated in fixed point
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+#include "AX12Load.h"
+
+AX12LoadFilter::AX12LoadFilter()
+{
+    Configure(3, 2, 4);
+}
+
+void AX12LoadFilter::Configure(int median, int shift, int decimation)
+{
+    median = (median < 1) ? 1 : (median > AX12_LOAD_MEDIAN_MAX) ? AX12_LOAD_MEDIAN_MAX : median;
+    _median = median | 1; // odd, the median is a sample
+    _shift = (shift < 0) ? 0 : (shift > 8) ? 8 : shift;
+    _decimation = (decimation < 1) ? 1 : decimation;
+    Reset();
+}
+
+void AX12LoadFilter::Reset(void)
+{
+    _filled = 0;
+    _next = 0;
+    _phase = 0;
+    _primed = false;
+    _average = 0;
+}
+
+bool AX12LoadFilter::Push(int load, int &output)
+{
+    int x = load;
+
+    if (_median > 1) {
+        _window[_next] = load;
+        _next = (_next + 1) % _median;
+        _filled += (_filled < _median);
+
+        // Insertion sort of a copy, the window holds a few samples
+        int16_t sorted[AX12_LOAD_MEDIAN_MAX];
+        for (int i = 0; i < _filled; i++) {
+            int16_t v = _window[i];
+            int j = i;
+            for (; j > 0 && sorted[j - 1] > v; j--) {
+                sorted[j] = sorted[j - 1];
+            }
+            sorted[j] = v;
+        }
+        x = sorted[_filled / 2];
+    }
+
+    if (!_primed) {
+        _average = x * 256;
+        _primed = true;
+    } else {
+        _average += (x * 256 - _average) >> _shift;
+    }
+
+    if (++_phase < _decimation) {
+        return false;
+    }
+    _phase = 0;
+    output = Value();
+    return true;
+}
+
+int AX12LoadFilter::Value(void)
+{
+    return (_average + 128) >> 8;
+}
+
+
+AX12LoadSampler::AX12LoadSampler(AX12MultiBus &joints)
+    : _joints(joints)
+{
+    _count = 0;
+    _budget = 100;
+    _started = false;
+    _last = 0;
+    _next = 0;
+    _period = 0;
+    _samples = 0;
+    _errors = 0;
+    _overruns = 0;
+}
+
+int AX12LoadSampler::Add(int id)
+{
+    if (_count >= AX12_LOAD_MAX_JOINTS) {
+        return -1;
+    }
+    _ids[_count] = id;
+    _filters[_count].Reset();
+    _rings[_count].head = 0;
+    _rings[_count].count = 0;
+    return _count++;
+}
+
+void AX12LoadSampler::SetFilter(int median, int shift, int decimation)
+{
+    for (int i = 0; i < AX12_LOAD_MAX_JOINTS; i++) {
+        _filters[i].Configure(median, shift, decimation);
+    }
+}
+
+AX12LoadFilter &AX12LoadSampler::Filter(int joint)
+{
+    return _filters[joint];
+}
+
+void AX12LoadSampler::SetBudget(int percent)
+{
+    _budget = (percent < 1) ? 1 : (percent > 100) ? 100 : percent;
+}
+
+int AX12LoadSampler::Poll(void)
+{
+    uint8_t data[2 * AX12_LOAD_MAX_JOINTS];
+    int results[AX12_LOAD_MAX_JOINTS];
+    AX12Clock &clock = _joints.Clock();
+
+    uint32_t start = clock.now_us();
+    if (_count == 0 || (_started && !AX12Clock::reached(start, _next))) {
+        return 0;
+    }
+
+    _joints.ReadAll(AX12_REG_LOAD, 2, _ids, data, results, _count);
+    uint32_t end = clock.now_us();
+
+    for (int k = 0; k < _count; k++) {
+        int output;
+        // Alarm bits in the status do not make the load wrong
+        if (results[k] < 0) {
+            _errors++;
+            continue;
+        }
+        _samples++;
+        if (!_filters[k].Push(AX12_LoadFromRegister(data[2 * k] | (data[2 * k + 1] << 8)), output)) {
+            continue;
+        }
+
+        Ring &ring = _rings[k];
+        AX12LoadSample &s = ring.samples[(ring.head + ring.count) % AX12_LOAD_RING_SIZE];
+        s.time = end;
+        s.load = output;
+        if (ring.count < AX12_LOAD_RING_SIZE) {
+            ring.count++;
+        } else {
+            ring.head = (ring.head + 1) % AX12_LOAD_RING_SIZE;
+            _overruns++;
+        }
+    }
+
+    // Average period between batches, 1/8 of the new one
+    if (_started) {
+        uint32_t period = (start - _last) << 4;
+        _period = _period ? _period + ((int32_t)(period - _period) >> 3) : period;
+    }
+    _started = true;
+    _last = start;
+    _next = start + (uint32_t)((uint64_t)(end - start) * 100 / _budget);
+    return _count;
+}
+
+uint32_t AX12LoadSampler::Due(void)
+{
+    uint32_t now = _joints.Clock().now_us();
+    return (!_started || AX12Clock::reached(now, _next)) ? 0 : _next - now;
+}
+
+int AX12LoadSampler::Available(int joint)
+{
+    return _rings[joint].count;
+}
+
+bool AX12LoadSampler::Pop(int joint, AX12LoadSample &sample)
+{
+    Ring &ring = _rings[joint];
+    if (ring.count == 0) {
+        return false;
+    }
+    sample = ring.samples[ring.head];
+    ring.head = (ring.head + 1) % AX12_LOAD_RING_SIZE;
+    ring.count--;
+    return true;
+}
+
+int AX12LoadSampler::Latest(int joint)
+{
+    return _filters[joint].Value();
+}
+
+uint32_t AX12LoadSampler::Rate(void)
+{
+    return _period ? (uint32_t)(16000000ULL / _period) : 0;
+}
+
+uint32_t AX12LoadSampler::Samples(void)
+{
+    return _samples;
+}
+
+uint32_t AX12LoadSampler::Errors(void)
+{
+    return _errors;
+}
+
+uint32_t AX12LoadSampler::Overruns(void)
+{
+    return _overruns;
+}
@@ -0,0 +1,180 @@
+/**
+ * @file AX12Log.cpp
+ * @author joebarteam11
+ * @brief Binary event log, recorded in RAM from the hot path and formatted later
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+#include "AX12Log.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#if defined(__MBED__)
+
+#include "mbed.h"
+
+// core_util_atomic : LDREX/STREX, or a critical section on the Cortex-M0
+static uint32_t reserve(volatile uint32_t *head)
+{
+    return core_util_atomic_fetch_add_u32(head, 1);
+}
+
+static void publish(volatile uint32_t *seq, uint32_t value)
+{
+    core_util_atomic_store_u32(seq, value);
+}
+
+static uint32_t published(volatile uint32_t *seq)
+{
+    return core_util_atomic_load_u32(seq);
+}
+
+#else
+
+static uint32_t reserve(volatile uint32_t *head)
+{
+    return __atomic_fetch_add(head, 1, __ATOMIC_RELAXED);
+}
+
+// The fields are written after the sequence number is cleared and read before it is checked again
+static void publish(volatile uint32_t *seq, uint32_t value)
+{
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    __atomic_store_n(seq, value, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+}
+
+static uint32_t published(volatile uint32_t *seq)
+{
+    __atomic_thread_fence(__ATOMIC_ACQUIRE);
+    return __atomic_load_n(seq, __ATOMIC_ACQUIRE);
+}
+
+#endif
+
+// Text of each event : ID, argument and value follow in this order, the argument is left out of the second group
+static const char *const AX12_LOG_FORMATS[AX12_EV_COUNT] = {
+    "-",
+    "servo %u : instruction 0x%02x failed, result %ld",
+    "servo %u : %u replies missed, quarantined, PING in %ld us",
+    "servo %u : factory reset",
+    "servo %u : baud code %u",
+    "servo %u : ID set to %u",
+    "servo %u : goal 0x%x",
+    "servo %u : CW limit 0x%x",
+    "servo %u : CCW limit 0x%x",
+    "servo %u : torque %u",
+    "servo %u : max torque 0x%x",
+    "trigger (broadcast ACTION)",
+    "servo %u : load %ld",
+    "servo %u : read, start | bytes << 8 = 0x%04x",
+    "servo %u : read data 0x%04x..., result %ld",
+    "servo %u : write, start | bytes << 8 = 0x%04x, flag %ld",
+    "servo %u : write done, result %ld",
+};
+
+static bool without_arg(int event)
+{
+    return event == AX12_EV_LOAD || event == AX12_EV_WRITE_DONE;
+}
+
+AX12Log::AX12Log()
+{
+    memset(_ring, 0, sizeof(_ring));
+    _head = 0;
+    _tail = 0;
+    _lost = 0;
+    _level = AX12_LOG_LEVEL;
+    _clock = 0;
+}
+
+AX12Log &AX12Log::system(void)
+{
+    static AX12Log log;
+    return log;
+}
+
+void AX12Log::SetLevel(int level)
+{
+    _level = (level < AX12_LOG_OFF) ? AX12_LOG_OFF : (level > AX12_LOG_LEVEL) ? AX12_LOG_LEVEL : level;
+}
+
+void AX12Log::SetClock(AX12Clock &clock)
+{
+    _clock = &clock;
+}
+
+void AX12Log::Record(uint8_t event, uint8_t id, uint16_t arg, int32_t value)
+{
+    uint32_t n = reserve(&_head);
+    AX12LogEntry &e = _ring[n % AX12_LOG_SIZE];
+
+    // Marked as being written, a reader skips it until the new sequence number is in
+    publish(&e.seq, 0);
+    e.time = _clock ? _clock->now_us() : AX12Clock::system().now_us();
+    e.event = event;
+    e.id = id;
+    e.arg = arg;
+    e.value = value;
+    publish(&e.seq, n + 1);
+}
+
+int AX12Log::Read(AX12LogEntry *entries, int max)
+{
+    int n = 0;
+
+    while (n < max && _tail != _head) {
+        // Overwritten before this call
+        if (_head - _tail > AX12_LOG_SIZE) {
+            _lost += _head - _tail - AX12_LOG_SIZE;
+            _tail = _head - AX12_LOG_SIZE;
+        }
+        AX12LogEntry &e = _ring[_tail % AX12_LOG_SIZE];
+        uint32_t seq = published(&e.seq);
+        if (seq == 0 || (int32_t)(seq - (_tail + 1)) < 0) {
+            break; // still being written
+        }
+        if (seq == _tail + 1) {
+            entries[n] = e;
+            // Overwritten while copied : dropped
+            if (published(&e.seq) == seq) {
+                n++;
+                _tail++;
+                continue;
+            }
+        }
+        _lost++;
+        _tail++;
+    }
+    return n;
+}
+
+uint32_t AX12Log::Lost(void)
+{
+    return _lost;
+}
+
+uint32_t AX12Log::Recorded(void)
+{
+    return _head;
+}
+
+int AX12Log::Format(const AX12LogEntry &entry, char *text, int size)
+{
+    int n = snprintf(text, size, "%10lu us  ", (unsigned long)entry.time);
+    if (n < 0 || n >= size) {
+        return n;
+    }
+    if (entry.event >= AX12_EV_COUNT) {
+        return n + snprintf(text + n, size - n, "event %u ?", entry.event);
+    }
+    const char *format = AX12_LOG_FORMATS[entry.event];
+    if (without_arg(entry.event)) {
+        return n + snprintf(text + n, size - n, format, (unsigned)entry.id, (long)entry.value);
+    }
+    return n + snprintf(text + n, size - n, format, (unsigned)entry.id, (unsigned)entry.arg, (long)entry.value);
+}
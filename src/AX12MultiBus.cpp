@@ -0,0 +1,267 @@
+/**
+ * @file AX12MultiBus.cpp
+ * @author joebarteam11
+ * @brief Several AX12 chains driven in parallel from one controller
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+#include "AX12MultiBus.h"
+
+#include <string.h>
+
+AX12MultiBus::AX12MultiBus(AX12Clock &clock)
+    : _clock(clock)
+{
+    _count = 0;
+    memset(_placement, AX12_UNPLACED, sizeof(_placement));
+}
+
+int AX12MultiBus::AddBus(AX12Bus &bus)
+{
+    if (_count >= AX12_MAX_BUSES) {
+        return -1;
+    }
+    _buses[_count] = &bus;
+    return _count++;
+}
+
+int AX12MultiBus::Buses(void)
+{
+    return _count;
+}
+
+AX12Bus &AX12MultiBus::Bus(int index)
+{
+    return *_buses[index];
+}
+
+AX12Clock &AX12MultiBus::Clock(void)
+{
+    return _clock;
+}
+
+int AX12MultiBus::Place(int id, int bus)
+{
+    if (id < 0 || id >= AX12_BROADCAST_ID || (bus != AX12_UNPLACED && (bus < 0 || bus >= _count))) {
+        return AX12_ERR_ARG;
+    }
+    _placement[id] = bus;
+    return AX12_OK;
+}
+
+int AX12MultiBus::BusOf(int id)
+{
+    if (id < 0 || id >= AX12_BROADCAST_ID || _placement[id] == AX12_UNPLACED) {
+        return -1;
+    }
+    return _placement[id];
+}
+
+int AX12MultiBus::Balance(const uint8_t *ids, int count, const uint8_t *weights)
+{
+    uint32_t load[AX12_MAX_BUSES] = {0};
+    bool placed[AX12_BROADCAST_ID] = {false};
+
+    if (_count == 0 || count > AX12_BROADCAST_ID) {
+        return AX12_ERR_ARG;
+    }
+
+    // Longest processing time first : take the heaviest servo left and put
+    // it on the bus with the smallest load
+    for (int n = 0; n < count; n++) {
+        int pick = -1;
+        for (int i = 0; i < count; i++) {
+            if (placed[i]) {
+                continue;
+            }
+            if (pick < 0 || (weights && weights[i] > weights[pick])) {
+                pick = i;
+            }
+        }
+
+        int bus = 0;
+        for (int b = 1; b < _count; b++) {
+            if (load[b] < load[bus]) {
+                bus = b;
+            }
+        }
+
+        placed[pick] = true;
+        load[bus] += weights ? weights[pick] : 1;
+        if (Place(ids[pick], bus) != AX12_OK) {
+            return AX12_ERR_ARG;
+        }
+    }
+    return AX12_OK;
+}
+
+int AX12MultiBus::SyncWrite(int start, int length, const uint8_t *ids, const uint8_t *data, int count)
+{
+    int result = AX12_OK;
+    bool started[AX12_MAX_BUSES];
+
+    // A servo on no bus gets nothing : the others are still written
+    for (int i = 0; i < count; i++) {
+        if (BusOf(ids[i]) < 0) {
+            result = AX12_ERR_ARG;
+        }
+    }
+
+    // Build and send one SYNC_WRITE per bus, without waiting in between
+    for (int b = 0; b < _count; b++) {
+        started[b] = false;
+        int servos = 0;
+        for (int i = 0; i < count; i++) {
+            servos += (BusOf(ids[i]) == b);
+        }
+        if (servos == 0) {
+            continue;
+        }
+
+        uint8_t *p = _buses[b]->Packet(AX12_BROADCAST_ID, AX12_INST_SYNC_WRITE, 2 + servos * (1 + length));
+        if (!p) {
+            result = (result == AX12_OK) ? AX12_ERR_ARG : result;
+            continue;
+        }
+        *p++ = start;
+        *p++ = length;
+        for (int i = 0; i < count; i++) {
+            if (BusOf(ids[i]) == b) {
+                *p++ = ids[i];
+                memcpy(p, &data[i * length], length);
+                p += length;
+            }
+        }
+        int r = _buses[b]->Start();
+        if (r == AX12_BUSY) {
+            started[b] = true;
+        } else if (result == AX12_OK) {
+            result = r;
+        }
+    }
+
+    uint32_t t;
+    while ((t = step()) != 0) {
+        _clock.wait_us(t);
+    }
+
+    // Only the buses written now : an idle bus gives the result of its last transaction
+    for (int b = 0; b < _count; b++) {
+        if (!started[b]) {
+            continue;
+        }
+        int r = _buses[b]->Poll();
+        if (r != AX12_OK && result == AX12_OK) {
+            result = r;
+        }
+    }
+    return result;
+}
+
+int AX12MultiBus::SetGoals(const uint8_t *ids, const uint16_t *goals, int count)
+{
+    uint8_t data[2 * AX12_BROADCAST_ID];
+
+    if (count > AX12_BROADCAST_ID) {
+        return AX12_ERR_ARG;
+    }
+    for (int i = 0; i < count; i++) {
+        data[2 * i] = goals[i] & 0xff;  // bottom 8 bits
+        data[2 * i + 1] = goals[i] >> 8; // top 8 bits
+    }
+    return SyncWrite(AX12_REG_GOAL_POSITION, 2, ids, data, count);
+}
+
+int AX12MultiBus::ReadAll(int start, int length, const uint8_t *ids, uint8_t *data, int *results, int count)
+{
+    int next[AX12_MAX_BUSES];   // next servo to read on each bus
+    int current[AX12_MAX_BUSES]; // servo being read on each bus, -1 if none
+    int ok = 0;
+
+    for (int b = 0; b < _count; b++) {
+        next[b] = 0;
+        current[b] = -1;
+    }
+    if (results) {
+        for (int i = 0; i < count; i++) {
+            results[i] = AX12_ERR_ARG; // not placed
+        }
+    }
+
+    bool active = true;
+    while (active) {
+        bool progress = false;
+        active = false;
+
+        for (int b = 0; b < _count; b++) {
+            AX12Bus &bus = *_buses[b];
+
+            if (current[b] >= 0) {
+                int r = bus.Poll();
+                if (r == AX12_BUSY) {
+                    active = true;
+                    continue;
+                }
+                if (results) {
+                    results[current[b]] = r;
+                }
+                ok += (r == AX12_OK);
+                current[b] = -1;
+                progress = true;
+            }
+
+            // Start the next read of this bus right away
+            while (next[b] < count && BusOf(ids[next[b]]) != b) {
+                next[b]++;
+            }
+            if (next[b] < count) {
+                int i = next[b]++;
+                uint8_t *p = bus.Packet(ids[i], AX12_INST_READ, 2);
+                if (p) {
+                    p[0] = start;
+                    p[1] = length;
+                    bus.Start(&data[i * length], length);
+                    current[b] = i;
+                }
+                active = true;
+                progress = true;
+            }
+        }
+
+        if (active && !progress) {
+            _clock.wait_us(step());
+        }
+    }
+    return ok;
+}
+
+int AX12MultiBus::GetPositions(const uint8_t *ids, uint16_t *positions, int count)
+{
+    uint8_t data[2 * AX12_BROADCAST_ID];
+
+    if (count > AX12_BROADCAST_ID) {
+        return AX12_ERR_ARG;
+    }
+    int ok = ReadAll(AX12_REG_POSITION, 2, ids, data, 0, count);
+    for (int i = 0; i < count; i++) {
+        positions[i] = data[2 * i] | (data[2 * i + 1] << 8);
+    }
+    return ok;
+}
+
+// Shortest byte time of the busy buses, 0 if none is busy
+uint32_t AX12MultiBus::step(void)
+{
+    uint32_t step = 0;
+
+    for (int b = 0; b < _count; b++) {
+        if (_buses[b]->Busy()) {
+            uint32_t t = _buses[b]->WireTime(1);
+            step = (step == 0 || t < step) ? t : step;
+        }
+    }
+    return step;
+}
@@ -0,0 +1,242 @@
+/**
+ * @file AX12Odometry.cpp
+ * @author joebarteam11
+ * @brief Distance turned by servos in wheel mode, across the dead zone of the position
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+#include "AX12Odometry.h"
+
+#include <stdlib.h>
+
+#define SPEED_UNIT 5820 // AX12_SPEED_UNIT_TICKS in 1/10 tick/s, Q8
+#define DEAD_ZONE 10235 // 1023.5 ticks, 1/10 tick : start of the dead zone
+
+AX12Odometry::AX12Odometry(AX12MultiBus &joints)
+    : _joints(joints)
+{
+    _count = 0;
+    _reads = 0;
+    _rejected = 0;
+}
+
+int AX12Odometry::Add(int id)
+{
+    if (_count >= AX12_ODO_MAX_JOINTS) {
+        return -1;
+    }
+    Joint &j = _list[_count];
+    j.id = id;
+    j.known = false;
+    j.suspect = false;
+    j.command = 0;
+    j.gain = 4096;
+    j.position = 0;
+    j.count = 0;
+    j.velocity = 0;
+    j.carried = 0;
+    j.time = 0;
+    j.since = 0;
+    j.next = _joints.Clock().now_us();
+    return _count++;
+}
+
+int AX12Odometry::SetSpeed(int joint, float speed)
+{
+    // Same encoding as AX12::SetCRSpeed()
+    int value = (int)(0x3ff * ((speed < 0) ? -speed : speed));
+    value = (value > 0x3ff) ? 0x3ff : value;
+    if (speed < 0) {
+        value |= AX12_SPEED_CW;
+    }
+    uint8_t data[2] = {(uint8_t)(value & 0xff), (uint8_t)(value >> 8)};
+
+    Command(joint, value);
+    int id = _list[joint].id;
+    return _joints.Bus(_joints.BusOf(id)).Write(id, AX12_REG_MOVING_SPEED, 2, data);
+}
+
+void AX12Odometry::Command(int joint, int speed)
+{
+    Joint &j = _list[joint];
+    uint32_t now = _joints.Clock().now_us();
+
+    // The travel so far belongs to the previous speed
+    if (j.known || j.suspect) {
+        j.carried = (int32_t)predict(j, now);
+        j.since = now;
+    }
+    j.command = (speed & AX12_SPEED_CW) ? -(speed & 0x3FF) : (speed & 0x3FF);
+    j.next = now; // read soon at the new pace
+}
+
+int32_t AX12Odometry::speed(const Joint &j)
+{
+    return j.command ? (int32_t)(((int64_t)j.command * SPEED_UNIT * j.gain) >> 20) : j.velocity;
+}
+
+// Travel since the last trusted read
+int64_t AX12Odometry::predict(const Joint &j, uint32_t now)
+{
+    return j.carried + (int64_t)speed(j) * (int32_t)(now - j.since) / 1000000;
+}
+
+void AX12Odometry::update(Joint &j, int position, uint32_t now)
+{
+    uint32_t elapsed = now - j.time;
+    int64_t predicted = predict(j, now);
+
+    // Where the servo should be : not trusted in or near the dead zone
+    int32_t margin = AX12_ODO_MARGIN * 10 + (int32_t)(llabs(predicted) / 4);
+    int32_t expected = (int32_t)((j.position * 10 + predicted) % AX12_ODO_TURN);
+    expected += (expected < 0) ? AX12_ODO_TURN : 0;
+    if (j.known && (expected >= DEAD_ZONE - margin || expected < margin - (AX12_ODO_TURN - DEAD_ZONE))) {
+        _rejected++;
+        return;
+    }
+
+    // Among the travels one turn apart, the closest to the prediction
+    int64_t raw = (position - j.position) * 10;
+    int64_t turns = (predicted - raw) / AX12_ODO_TURN;
+    int64_t rest = (predicted - raw) % AX12_ODO_TURN;
+    turns += (rest > AX12_ODO_TURN / 2) - (rest < -AX12_ODO_TURN / 2);
+    int64_t travel = raw + turns * AX12_ODO_TURN;
+
+    // Far from the prediction : a wrong read, unless the next one agrees
+    bool far = llabs(travel - predicted) > AX12_ODO_STEP * 10 + llabs(predicted) / 2;
+    if (!j.known && (!j.suspect || far)) {
+        // The first read may come from the dead zone, it waits for a second one that agrees
+        j.suspect = true;
+        j.position = position;
+        j.carried = 0;
+        j.time = now;
+        j.since = now;
+        return;
+    }
+    if (far && !j.suspect) {
+        j.suspect = true;
+        _rejected++;
+        return;
+    }
+    j.known = true;
+    j.suspect = false;
+
+    if (elapsed) {
+        int32_t measured = (int32_t)(travel * 1000000 / elapsed);
+        j.velocity += (measured - j.velocity) / 4;
+
+        // Gain of the command, from the moves at one speed long enough to tell
+        int64_t nominal = (int64_t)j.command * SPEED_UNIT * elapsed / 256000000;
+        if (j.command && j.since == j.time && llabs(nominal) >= 100) {
+            int32_t gain = (int32_t)(travel * 4096 / nominal);
+            gain = (gain < 0) ? 0 : (gain > 8192) ? 8192 : gain;
+            j.gain += (gain - j.gain) / 4;
+        }
+    }
+    j.count += travel;
+    j.position = position;
+    j.carried = 0;
+    j.time = now;
+    j.since = now;
+}
+
+void AX12Odometry::schedule(Joint &j, uint32_t now)
+{
+    int32_t v = abs(speed(j));
+    uint32_t period = AX12_ODO_MAX_US;
+
+    // AX12_ODO_STEP ticks at the present speed, at once to confirm a first read
+    if (!j.known) {
+        period = AX12_ODO_MIN_US;
+    } else if (v > 0) {
+        uint64_t p = (uint64_t)AX12_ODO_STEP * 10 * 1000000 / v;
+        period = (p < AX12_ODO_MIN_US) ? AX12_ODO_MIN_US : (p > AX12_ODO_MAX_US) ? AX12_ODO_MAX_US : (uint32_t)p;
+    }
+    j.next = now + period;
+}
+
+int AX12Odometry::Poll(void)
+{
+    uint8_t ids[AX12_ODO_MAX_JOINTS];
+    int index[AX12_ODO_MAX_JOINTS];
+    uint8_t data[2 * AX12_ODO_MAX_JOINTS];
+    int results[AX12_ODO_MAX_JOINTS];
+    int n = 0;
+
+    uint32_t now = _joints.Clock().now_us();
+    for (int i = 0; i < _count; i++) {
+        if (AX12Clock::reached(now, _list[i].next)) {
+            index[n] = i;
+            ids[n++] = _list[i].id;
+        }
+    }
+    if (n == 0) {
+        return 0;
+    }
+
+    _joints.ReadAll(AX12_REG_POSITION, 2, ids, data, results, n);
+    uint32_t end = _joints.Clock().now_us();
+
+    for (int k = 0; k < n; k++) {
+        Joint &j = _list[index[k]];
+        _reads++;
+        if (results[k] < 0) {
+            _rejected++;
+        } else {
+            update(j, data[2 * k] | (data[2 * k + 1] << 8), end);
+        }
+        schedule(j, end);
+    }
+    return n;
+}
+
+uint32_t AX12Odometry::Due(void)
+{
+    uint32_t now = _joints.Clock().now_us();
+    uint32_t due = AX12_ODO_MAX_US;
+
+    for (int i = 0; i < _count; i++) {
+        if (AX12Clock::reached(now, _list[i].next)) {
+            return 0;
+        }
+        due = (_list[i].next - now < due) ? _list[i].next - now : due;
+    }
+    return due;
+}
+
+int64_t AX12Odometry::Ticks(int joint)
+{
+    const Joint &j = _list[joint];
+    if (!j.known) {
+        return 0;
+    }
+    return (j.count + predict(j, _joints.Clock().now_us())) / 10;
+}
+
+int64_t AX12Odometry::Measured(int joint)
+{
+    return _list[joint].count / 10;
+}
+
+float AX12Odometry::Velocity(int joint)
+{
+    return _list[joint].velocity / 10.0f;
+}
+
+float AX12Odometry::Gain(int joint)
+{
+    return _list[joint].gain / 4096.0f;
+}
+
+uint32_t AX12Odometry::Reads(void)
+{
+    return _reads;
+}
+
+uint32_t AX12Odometry::Rejected(void)
+{
+    return _rejected;
+}
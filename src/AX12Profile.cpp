@@ -0,0 +1,253 @@
+/**
+ * @file AX12Profile.cpp
+ * @author joebarteam11
+ * @brief Trapezoidal and S-curve velocity profiles streamed to the servos
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+#include "AX12Profile.h"
+
+#include <math.h>
+
+// Distance travelled while accelerating with the jerk limited S ramp (the
+// acceleration rises then falls linearly), normalized to 65535 at the end of
+// the ramp, for 64 steps of the ramp duration
+static const uint16_t AX12_SCURVE_RAMP[65] = {
+        0,     0,     3,     9,    21,    42,    72,   114,
+      171,   243,   333,   444,   576,   732,   915,  1125,
+     1365,  1638,  1944,  2286,  2667,  3087,  3549,  4056,
+     4608,  5208,  5859,  6561,  7317,  8130,  9000,  9930,
+    10922, 11978, 13096, 14273, 15509, 16801, 18146, 19544,
+    20992, 22487, 24029, 25615, 27242, 28910, 30616, 32357,
+    34133, 35940, 37778, 39644, 41535, 43451, 45389, 47346,
+    49322, 51314, 53319, 55337, 57364, 59400, 61442, 63487,
+    65535,
+};
+
+AX12Profile::AX12Profile()
+{
+    _from = 0;
+    _distance = 0;
+    _direction = 1;
+    _type = AX12_PROFILE_TRAPEZOID;
+    _velocity = 0;
+    _accel = 0;
+    _total = 0;
+    _n = 0;
+    _last = 0;
+    _speed = 0;
+    _speed_factor = 0;
+}
+
+void AX12Profile::Plan(int from, int to, float velocity, float acceleration, float jerk, uint32_t period_us)
+{
+    float T = period_us * 1e-6f;
+    float D = (float)((to > from) ? to - from : from - to);
+
+    // Limits per tick
+    float v = velocity * T;
+    float a = acceleration * T * T;
+    float j = jerk * T * T * T;
+
+    _from = from << 16;
+    _distance = (D > 0) ? (int32_t)D << 16 : 0;
+    _direction = (to >= from) ? 1 : -1;
+    _type = (jerk > 0) ? AX12_PROFILE_SCURVE : AX12_PROFILE_TRAPEZOID;
+    _n = 0;
+    _last = 0;
+
+    // Q16 ticks per tick to moving speed units, Q16 factor
+    _speed_factor = (uint32_t)(65536.0f / (T * AX12_SPEED_UNIT_TICKS));
+
+    if (_distance == 0 || v <= 0 || a <= 0) {
+        _total = 0;
+        _accel = 0;
+        _velocity = 0;
+        return;
+    }
+
+    // Ramp duration at full speed, then lower the speed if the move is too
+    // short to reach it. The S ramp reaches 2v/t of acceleration and 4v/t^2
+    // of jerk.
+    float t;
+    if (_type == AX12_PROFILE_TRAPEZOID) {
+        t = v / a;
+        if (v * t > D) {
+            v = sqrtf(D * a);
+            t = v / a;
+        }
+    } else {
+        t = fmaxf(2 * v / a, 2 * sqrtf(v / j));
+        if (v * t > D) {
+            v = fminf(sqrtf(D * a / 2), cbrtf(D * D * j / 4));
+            t = fmaxf(2 * v / a, 2 * sqrtf(v / j));
+        }
+    }
+
+    int accel = (int)ceilf(t);
+    if (accel < 1) {
+        accel = 1;
+    }
+    int cruise = (int)ceilf((D - v * accel) / v);
+    if (cruise < 0) {
+        cruise = 0;
+    }
+    if (2 * accel + cruise > 0xFFFF) {
+        cruise = 0xFFFF - 2 * accel;
+    }
+
+    // Whole number of ticks per phase, the distance fixes the cruise velocity
+    _accel = accel;
+    _total = 2 * accel + cruise;
+    _velocity = _distance / (accel + cruise);
+}
+
+// Distance travelled after n ticks of the acceleration phase, Q16 ticks
+int32_t AX12Profile::ramp(uint32_t n)
+{
+    if (_type == AX12_PROFILE_TRAPEZOID) {
+        // v/t * n^2 / 2
+        return (int32_t)(((int64_t)_velocity * n * n) / (2 * _accel));
+    }
+
+    // v * t / 2 * S(n / t), S interpolated from the table
+    uint32_t x = n * 64;
+    uint32_t i = x / _accel;
+    uint32_t frac = ((x % _accel) << 16) / _accel;
+    uint32_t s = AX12_SCURVE_RAMP[i];
+    if (i < 64) {
+        s += ((AX12_SCURVE_RAMP[i + 1] - s) * frac) >> 16;
+    }
+    return (int32_t)(((int64_t)_velocity * _accel * s) / (2 * 65535));
+}
+
+bool AX12Profile::Step(uint16_t *goal, uint16_t *speed)
+{
+    if (_n >= _total) {
+        return false;
+    }
+
+    uint32_t n = ++_n;
+    int32_t p;
+
+    if (n <= _accel) {
+        p = ramp(n);
+    } else if (n <= (uint32_t)(_total - _accel)) {
+        p = ((int64_t)_velocity * _accel) / 2 + _velocity * (n - _accel);
+    } else {
+        p = _distance - ramp(_total - n);
+    }
+    if (n == _total || p > _distance) {
+        p = _distance;
+    }
+
+    // The servo has one tick to cover the distance of this step
+    uint32_t v = (uint32_t)(((uint64_t)(p - _last) * _speed_factor) >> 32);
+    v += v / 8 + AX12_PROFILE_MIN_SPEED;
+    _last = p;
+
+    int32_t position = (_from + _direction * p + 0x8000) >> 16;
+    *goal = (position < 0) ? 0 : (position > 1023 ? 1023 : position);
+    *speed = _speed = (v > 1023) ? 1023 : v;
+    return true;
+}
+
+bool AX12Profile::Moving(void)
+{
+    return _n < _total;
+}
+
+int AX12Profile::Duration(void)
+{
+    return _total;
+}
+
+int AX12Profile::Position(void)
+{
+    return (_from + _direction * _last + 0x8000) >> 16;
+}
+
+int AX12Profile::Speed(void)
+{
+    return _speed;
+}
+
+int AX12Profile::Target(void)
+{
+    return (_from + _direction * _distance + 0x8000) >> 16;
+}
+
+int AX12Profile::Type(void)
+{
+    return _type;
+}
+
+
+AX12ProfileGenerator::AX12ProfileGenerator(AX12MultiBus &joints, uint32_t period_us)
+    : _joints(joints)
+{
+    _period = period_us;
+    _count = 0;
+}
+
+int AX12ProfileGenerator::Add(int id, int position)
+{
+    if (_count >= AX12_PROFILE_MAX_JOINTS) {
+        return -1;
+    }
+    _ids[_count] = id;
+    _profiles[_count].Plan(position, position, 0, 0, 0, _period);
+    return _count++;
+}
+
+int AX12ProfileGenerator::Move(int joint, int target, float velocity, float acceleration, float jerk)
+{
+    if (joint < 0 || joint >= _count) {
+        return AX12_ERR_ARG;
+    }
+    AX12Profile &profile = _profiles[joint];
+    profile.Plan(profile.Position(), target, velocity, acceleration, jerk, _period);
+    return AX12_OK;
+}
+
+int AX12ProfileGenerator::Tick(void)
+{
+    uint8_t ids[AX12_PROFILE_MAX_JOINTS];
+    uint8_t data[4 * AX12_PROFILE_MAX_JOINTS];
+    int moving = 0;
+
+    for (int i = 0; i < _count; i++) {
+        uint16_t goal, speed;
+        if (_profiles[i].Step(&goal, &speed)) {
+            uint8_t *d = &data[4 * moving];
+            ids[moving++] = _ids[i];
+            d[0] = goal & 0xff;  // goal position
+            d[1] = goal >> 8;
+            d[2] = speed & 0xff; // moving speed
+            d[3] = speed >> 8;
+        }
+    }
+
+    if (moving == 0) {
+        return AX12_OK;
+    }
+    return _joints.SyncWrite(AX12_REG_GOAL_POSITION, 4, ids, data, moving);
+}
+
+bool AX12ProfileGenerator::Moving(void)
+{
+    for (int i = 0; i < _count; i++) {
+        if (_profiles[i].Moving()) {
+            return true;
+        }
+    }
+    return false;
+}
+
+AX12Profile &AX12ProfileGenerator::Joint(int joint)
+{
+    return _profiles[joint];
+}
@@ -0,0 +1,251 @@
+/**
+ * @file AX12Provision.cpp
+ * @author joebarteam11
+ * @brief Declarative EEPROM configuration of many servos, only the differences are written
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+#include "AX12Provision.h"
+
+#include <string.h>
+
+#define BIT(reg) ((uint32_t)1 << (reg))
+#define LAST_REGISTERS (BIT(AX12_REG_ID) | BIT(AX12_REG_BAUD)) // written once everything else is
+
+// Writable EEPROM registers: ID to alarm shutdown, without the reserved 0x0A
+static const uint32_t WRITABLE = (BIT(AX12_REG_ALARM_SHUTDOWN + 1) - BIT(AX12_REG_ID)) & ~BIT(0x0A);
+
+AX12EepromProfile::AX12EepromProfile(int id)
+{
+    _id = id;
+    _origin = id;
+    _taken = false;
+    memset(_values, 0, sizeof(_values));
+    _mask = 0;
+    _pending = 0;
+    result = AX12_OK;
+    changed = 0;
+}
+
+int AX12EepromProfile::Set(int reg, int value)
+{
+    if (reg < 0 || reg >= AX12_EEPROM_SIZE || !(WRITABLE & BIT(reg)) || value < 0 || value > 0xFF) {
+        return AX12_ERR_ARG;
+    }
+    _values[reg] = value;
+    _mask |= BIT(reg);
+    return AX12_OK;
+}
+
+int AX12EepromProfile::SetWord(int reg, int value)
+{
+    if (reg + 1 >= AX12_EEPROM_SIZE || !(WRITABLE & BIT(reg + 1)) || value < 0 || value > 0xFFFF) {
+        return AX12_ERR_ARG;
+    }
+    Set(reg, value & 0xff);
+    return Set(reg + 1, value >> 8);
+}
+
+bool AX12EepromProfile::Has(int reg)
+{
+    return reg >= 0 && reg < AX12_EEPROM_SIZE && (_mask & BIT(reg));
+}
+
+int AX12EepromProfile::Id(void)
+{
+    return _id;
+}
+
+
+AX12Provisioner::AX12Provisioner(AX12Bus &bus)
+    : _bus(bus)
+{
+}
+
+int AX12Provisioner::Apply(AX12EepromProfile *profiles, int count, AX12ProvisionReport &report)
+{
+    uint32_t start = _bus.Clock().now_us();
+    int baud = -1;
+
+    memset(&report, 0, sizeof(report));
+    report.servos = count;
+    for (int i = 0; i < count; i++) {
+        AX12EepromProfile &p = profiles[i];
+        if (p.Has(AX12_REG_BAUD)) {
+            if (baud >= 0 && p._values[AX12_REG_BAUD] != baud) {
+                return AX12_ERR_ARG;
+            }
+            baud = p._values[AX12_REG_BAUD];
+        }
+        p._origin = p._id;
+        p._taken = false;
+        p._pending = 0;
+        p.result = AX12_ERR_TIMEOUT;
+        p.changed = 0;
+    }
+
+    for (int round = 0; round < AX12_PROVISION_ROUNDS; round++) {
+        bool writing = false;
+
+        // Read and compare the servos not verified yet
+        for (int i = 0; i < count; i++) {
+            AX12EepromProfile &p = profiles[i];
+            if (p.result == AX12_OK) {
+                continue;
+            }
+            p.result = read(p, report);
+            if (p.result == AX12_OK && p._pending) {
+                p.result = AX12_ERROR_RANGE;
+                writing = true;
+            }
+        }
+        if (!writing || round == AX12_PROVISION_ROUNDS - 1) {
+            break;
+        }
+
+        write(profiles, count, ~LAST_REGISTERS, report);
+
+        // New IDs, one servo at a time so that a taken ID is seen
+        for (int i = 0; i < count; i++) {
+            AX12EepromProfile &p = profiles[i];
+            if (!(p._pending & BIT(AX12_REG_ID))) {
+                continue;
+            }
+            p._pending &= ~BIT(AX12_REG_ID);
+            if (_bus.Ping(p._values[AX12_REG_ID]) == AX12_OK) {
+                p._taken = true;
+                p._mask &= ~BIT(AX12_REG_ID);
+                continue;
+            }
+            _bus.Write(p._id, AX12_REG_ID, 1, &p._values[AX12_REG_ID]);
+            report.writes++;
+            p._id = p._values[AX12_REG_ID];
+            p.changed++;
+            report.changed++;
+        }
+
+        // New baud rate, the port follows
+        bool rebaud = false;
+        for (int i = 0; i < count; i++) {
+            rebaud |= (profiles[i]._pending & BIT(AX12_REG_BAUD)) != 0;
+        }
+        if (rebaud) {
+            write(profiles, count, BIT(AX12_REG_BAUD), report);
+            _bus.Port().set_baudrate(AX12_BaudFromCode(baud));
+        }
+
+        _bus.Clock().wait_us(AX12_PROVISION_SETTLE_US);
+        _bus.Port().flush();
+    }
+
+    int first = AX12_OK;
+    for (int i = 0; i < count; i++) {
+        AX12EepromProfile &p = profiles[i];
+        if (p._taken) {
+            p._mask |= BIT(AX12_REG_ID);
+            if (p.result == AX12_OK) {
+                p.result = AX12_ERR_ID;
+            }
+        }
+        report.verified += (p.result == AX12_OK);
+        if (first == AX12_OK) {
+            first = p.result;
+        }
+    }
+    report.elapsed_us = _bus.Clock().now_us() - start;
+    return first;
+}
+
+// Read the EEPROM block of a servo and mark the registers that differ from its profile
+int AX12Provisioner::read(AX12EepromProfile &p, AX12ProvisionReport &report)
+{
+    uint8_t data[AX12_EEPROM_SIZE];
+
+    report.reads++;
+    int r = _bus.Read(p._id, AX12_REG_MODEL, AX12_EEPROM_SIZE, data);
+    if (r < 0 && p._id != p._origin) {
+        // The new ID did not make it
+        report.reads++;
+        r = _bus.Read(p._origin, AX12_REG_MODEL, AX12_EEPROM_SIZE, data);
+        if (r >= 0) {
+            p._id = p._origin;
+        }
+    }
+
+    // Alarm bits (voltage, overheating...) do not make the data wrong
+    if (r < 0 || (r & (AX12_ERROR_CHECKSUM | AX12_ERROR_INSTRUCTION))) {
+        return (r < 0) ? r : AX12_ERR_CHECKSUM;
+    }
+
+    p._pending = 0;
+    for (int reg = 0; reg < AX12_EEPROM_SIZE; reg++) {
+        if ((p._mask & BIT(reg)) && data[reg] != p._values[reg]) {
+            p._pending |= BIT(reg);
+        }
+    }
+    return AX12_OK;
+}
+
+// Write the pending \p registers of every servo, one packet per range shared by several servos
+void AX12Provisioner::write(AX12EepromProfile *profiles, int count, uint32_t registers,
+                            AX12ProvisionReport &report)
+{
+    uint8_t ids[AX12_BUS_PACKET_SIZE];
+    uint8_t data[AX12_BUS_PACKET_SIZE];
+
+    for (int s = 0; s < count; s++) {
+        uint32_t left;
+        while ((left = profiles[s]._pending & registers) != 0) {
+            // First run of consecutive registers of this servo
+            int start = 0;
+            while (!(left & BIT(start))) {
+                start++;
+            }
+            int length = 0;
+            while (start + length < AX12_EEPROM_SIZE && (left & BIT(start + length))) {
+                length++;
+            }
+            uint32_t run = (BIT(length) - 1) << start;
+            uint32_t around = run | BIT(start + length) | (start ? BIT(start - 1) : 0);
+
+            // Servos with exactly the same run
+            int sharing = 0;
+            for (int t = s; t < count; t++) {
+                sharing += ((profiles[t]._pending & registers & around) == run);
+            }
+
+            if (sharing == 1) {
+                AX12EepromProfile &p = profiles[s];
+                _bus.Write(p._id, start, length, &p._values[start]);
+                report.writes++;
+                p._pending &= ~run;
+                p.changed += length;
+                report.changed += length;
+                continue;
+            }
+
+            const int per_packet = (AX12_BUS_PACKET_SIZE - AX12_PACKET_OVERHEAD - 2) / (1 + length);
+            int n = 0;
+            for (int t = s; t < count; t++) {
+                AX12EepromProfile &p = profiles[t];
+                if ((p._pending & registers & around) != run) {
+                    continue;
+                }
+                ids[n] = p._id;
+                memcpy(&data[n * length], &p._values[start], length);
+                n++;
+                p._pending &= ~run;
+                p.changed += length;
+                report.changed += length;
+                if (n == per_packet || --sharing == 0) {
+                    _bus.SyncWrite(start, length, ids, data, n);
+                    report.sync_writes++;
+                    n = 0;
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,130 @@
+/**
+ * @file AX12PtyChain.cpp
+ * @author joebarteam11
+ * @brief Emulated AX12 chain behind a pseudo-terminal, stand-in for a USB adapter
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+#if defined(__linux__)
+
+#include "AX12PtyChain.h"
+
+#include <chrono>
+#include <fcntl.h>
+#include <poll.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+// Write to the master side, the bytes are lost if the slave side is closed
+static void emit(int fd, const uint8_t *data, int length)
+{
+    if (write(fd, data, length) < 0) {
+        return;
+    }
+}
+
+AX12PtyChain::AX12PtyChain(int baud, bool echo)
+    : _chain(_clock, baud)
+{
+    _echo = echo;
+    _running = false;
+    _path[0] = 0;
+
+    _master = posix_openpt(O_RDWR | O_NOCTTY);
+    if (_master < 0 || grantpt(_master) < 0 || unlockpt(_master) < 0
+        || ptsname_r(_master, _path, sizeof(_path)) != 0) {
+        if (_master >= 0) {
+            close(_master);
+        }
+        _master = -1;
+        _path[0] = 0;
+        return;
+    }
+    fcntl(_master, F_SETFL, fcntl(_master, F_GETFL) | O_NONBLOCK);
+}
+
+AX12PtyChain::~AX12PtyChain()
+{
+    Stop();
+    if (_master >= 0) {
+        close(_master);
+    }
+}
+
+const char *AX12PtyChain::Path(void)
+{
+    return _path[0] ? _path : 0;
+}
+
+AX12EmulatedBus &AX12PtyChain::Emulator(void)
+{
+    return _chain;
+}
+
+int AX12PtyChain::Start(void)
+{
+    if (_master < 0 || _running) {
+        return AX12_ERR_ARG;
+    }
+    _running = true;
+    _thread = std::thread(&AX12PtyChain::serve, this);
+    return AX12_OK;
+}
+
+void AX12PtyChain::Stop(void)
+{
+    if (_running) {
+        _running = false;
+        _thread.join();
+    }
+}
+
+void AX12PtyChain::serve(void)
+{
+    uint8_t packet[AX12_EMU_PACKET_SIZE];
+    uint8_t buffer[AX12_EMU_PACKET_SIZE];
+    int have = 0;
+    std::chrono::steady_clock::time_point origin = std::chrono::steady_clock::now();
+
+    while (_running) {
+        // The virtual clock follows the real time
+        uint64_t real = std::chrono::duration_cast<std::chrono::microseconds>(
+                            std::chrono::steady_clock::now() - origin).count();
+        if (real > _clock.Elapsed()) {
+            _clock.wait_us((uint32_t)(real - _clock.Elapsed()));
+        }
+
+        int n = read(_master, buffer, sizeof(buffer));
+        if (n > 0 && _echo) {
+            emit(_master, buffer, n);
+        }
+        for (int i = 0; i < n; i++) {
+            uint8_t c = buffer[i];
+            // Resynchronize on the 0xFF 0xFF header
+            if ((have < 2 && c != 0xFF) || (have == 2 && c == 0xFF)) {
+                have = (c == 0xFF) ? have : 0;
+                continue;
+            }
+            packet[have++] = c;
+            if (have >= 4 && have == packet[3] + 4) {
+                _chain.send(packet, have);
+                have = 0;
+            }
+        }
+
+        n = _chain.receive(buffer, sizeof(buffer));
+        if (n > 0) {
+            emit(_master, buffer, n);
+        }
+
+        // Short sleep : the status bytes are released as the virtual time goes on
+        struct pollfd p = {_master, POLLIN, 0};
+        struct timespec timeout = {0, 20000};
+        ppoll(&p, 1, &timeout, 0);
+    }
+}
+
+#endif
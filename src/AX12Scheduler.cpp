@@ -0,0 +1,677 @@
+/**
+ * @file AX12Scheduler.cpp
+ * @author joebarteam11
+ * @brief Priority and deadline aware scheduling of the transactions of a bus
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+#include "AX12Scheduler.h"
+
+#include <string.h>
+
+#if defined(__MBED__)
+
+#include "mbed.h"
+
+// Lock free list of the posted requests : LDREX/STREX, or a critical section on the Cortex-M0
+static bool push(AX12Request *volatile *list, AX12Request **head, AX12Request *request)
+{
+    return core_util_atomic_cas_ptr((void *volatile *)list, (void **)head, request);
+}
+
+static void *exchange(void *volatile *p, void *value)
+{
+    return core_util_atomic_exchange_ptr(p, value);
+}
+
+static void *load(void *const volatile *p)
+{
+    return core_util_atomic_load_ptr(p);
+}
+
+static void publish(volatile int *result, int value)
+{
+    core_util_atomic_store_s32((volatile int32_t *)result, value);
+}
+
+static int published(volatile int *result)
+{
+    return core_util_atomic_load_s32((const volatile int32_t *)result);
+}
+
+#if MBED_CONF_RTOS_PRESENT
+
+// A thread is woken by a flag : set before it waits, the flag is kept and the wait returns at once
+static void *waiter(void)
+{
+    return core_util_is_isr_active() ? 0 : (void *)ThisThread::get_id();
+}
+
+static void wake(void *thread)
+{
+    osThreadFlagsSet((osThreadId_t)thread, AX12_SCHED_THREAD_FLAG);
+}
+
+static void wait_flag(void *thread, uint32_t us)
+{
+    (void)thread; // the calling thread
+    if (us == 0) {
+        ThisThread::flags_wait_any(AX12_SCHED_THREAD_FLAG);
+    } else {
+        ThisThread::flags_wait_any_for(AX12_SCHED_THREAD_FLAG, std::chrono::milliseconds((us + 999) / 1000));
+    }
+}
+
+// Flag and result with the kernel locked : the poster runs once both are in, it may then free the
+// request and end. Publishing is the last access to the request and to the thread.
+static void release(volatile int *result, int value, void *thread)
+{
+    bool isr = core_util_is_isr_active();
+    int32_t lock = isr ? 0 : osKernelLock();
+    if (thread) {
+        wake(thread);
+    }
+    publish(result, value);
+    if (!isr) {
+        osKernelRestoreLock(lock);
+    }
+}
+
+#else
+
+// Without the RTOS the requests are posted by interrupts, nobody waits
+static void *waiter(void)
+{
+    return 0;
+}
+
+static void wake(void *thread)
+{
+    (void)thread;
+}
+
+static void wait_flag(void *thread, uint32_t us)
+{
+    (void)thread;
+    (void)us;
+}
+
+static void release(volatile int *result, int value, void *thread)
+{
+    (void)thread;
+    publish(result, value);
+}
+
+#endif
+
+#else
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+#define AX12_SCHED_HOST_YIELDS 16
+
+// Sequentially consistent : Post() and Idle() each write then read what the other wrote
+static bool push(AX12Request *volatile *list, AX12Request **head, AX12Request *request)
+{
+    return __atomic_compare_exchange_n(list, head, request, true, __ATOMIC_SEQ_CST, __ATOMIC_RELAXED);
+}
+
+static void *exchange(void *volatile *p, void *value)
+{
+    return __atomic_exchange_n(p, value, __ATOMIC_SEQ_CST);
+}
+
+static void *load(void *const volatile *p)
+{
+    return __atomic_load_n(p, __ATOMIC_SEQ_CST);
+}
+
+static void publish(volatile int *result, int value)
+{
+    __atomic_store_n(result, value, __ATOMIC_RELEASE);
+}
+
+static int published(volatile int *result)
+{
+    return __atomic_load_n(result, __ATOMIC_ACQUIRE);
+}
+
+// Thread flag of the host : one per thread, kept until the thread waits. The waiter yields a few
+// times before it sleeps, the reply is often in by then and neither side enters the kernel.
+struct AX12Waiter {
+    std::mutex lock;
+    std::condition_variable woken;
+    std::atomic<bool> flag;
+    std::atomic<bool> asleep;
+    std::atomic<int> pinned; // release() in progress : the thread does not end before it is over
+
+    ~AX12Waiter()
+    {
+        while (pinned) {
+            std::this_thread::yield();
+        }
+    }
+};
+
+static void *waiter(void)
+{
+    static thread_local AX12Waiter self;
+    return &self;
+}
+
+static void wake(void *thread)
+{
+    AX12Waiter *w = (AX12Waiter *)thread;
+    w->flag = true;
+    if (w->asleep) {
+        std::lock_guard<std::mutex> hold(w->lock);
+        w->woken.notify_one();
+    }
+}
+
+static void wait_flag(void *thread, uint32_t us)
+{
+    AX12Waiter *w = (AX12Waiter *)thread;
+    for (int n = 0; n < AX12_SCHED_HOST_YIELDS; n++) {
+        if (w->flag.exchange(false)) {
+            return;
+        }
+        std::this_thread::yield();
+    }
+    std::unique_lock<std::mutex> hold(w->lock);
+    w->asleep = true;
+    if (us == 0) {
+        w->woken.wait(hold, [w]() { return w->flag.load(); });
+    } else {
+        w->woken.wait_for(hold, std::chrono::microseconds(us), [w]() { return w->flag.load(); });
+    }
+    w->asleep = false;
+    w->flag = false;
+}
+
+// The thread is pinned before the result is in : it may see it and end, its flag stays until woken.
+// The flag comes after the result, never consumed before it can be seen. Nothing of the request is
+// touched after publishing.
+static void release(volatile int *result, int value, void *thread)
+{
+    AX12Waiter *w = (AX12Waiter *)thread;
+    if (w) {
+        w->pinned++;
+    }
+    publish(result, value);
+    if (w) {
+        wake(w);
+        w->pinned--;
+    }
+}
+
+#endif
+
+AX12Request::AX12Request()
+{
+    id = 0;
+    instruction = AX12_INST_PING;
+    start = 0;
+    length = 0;
+    count = 0;
+    priority = AX12_PRIO_TELEMETRY;
+    data = 0;
+    has_deadline = false;
+    deadline = 0;
+    done = 0;
+    context = 0;
+    result = AX12_OK;
+    finished = 0;
+    _next = 0;
+    _waiter = 0;
+    _sequence = 0;
+    _estimate = 0;
+    _started = 0;
+    _deferred = false;
+}
+
+void AX12Request::Read(int id, int start, int length, uint8_t *data, int priority)
+{
+    this->id = id;
+    this->instruction = AX12_INST_READ;
+    this->start = start;
+    this->length = length;
+    this->data = data;
+    this->priority = priority;
+}
+
+void AX12Request::Write(int id, int start, int length, uint8_t *data, int priority, bool registered)
+{
+    this->id = id;
+    this->instruction = registered ? AX12_INST_REG_WRITE : AX12_INST_WRITE;
+    this->start = start;
+    this->length = length;
+    this->data = data;
+    this->priority = priority;
+}
+
+void AX12Request::Before(uint32_t now, uint32_t us)
+{
+    has_deadline = true;
+    deadline = now + us;
+}
+
+bool AX12Request::Done(void)
+{
+    return published(&result) != AX12_BUSY;
+}
+
+int AX12Request::Wait(void)
+{
+    void *self = waiter();
+
+    while (published(&result) == AX12_BUSY) {
+        if (self && self == _waiter) {
+            wait_flag(self, 0);
+        } else {
+            AX12Clock::system().wait_us(10);
+        }
+    }
+    return result;
+}
+
+// Number of parameters of the instruction packet of a request
+static int AX12_RequestParams(const AX12Request &request)
+{
+    switch (request.instruction) {
+    case AX12_INST_READ:
+        return 2;
+    case AX12_INST_WRITE:
+    case AX12_INST_REG_WRITE:
+        return 1 + request.length;
+    case AX12_INST_SYNC_WRITE:
+        return 2 + request.count * (1 + request.length);
+    default:
+        return 0;
+    }
+}
+
+
+AX12Scheduler::AX12Scheduler(AX12Bus &bus)
+    : _bus(bus)
+{
+    _queued = 0;
+    _posted = 0;
+    _held = 0;
+    _held_last = 0;
+    _held_count = 0;
+    _owner = 0;
+    _current = 0;
+    _probing = false;
+    _sequence = 0;
+    _drop_late[AX12_PRIO_MOTION] = false;
+    _drop_late[AX12_PRIO_CONFIG] = false;
+    _drop_late[AX12_PRIO_TELEMETRY] = true;
+    _reserved = false;
+    _reserve_at = 0;
+    _reserve_priority = AX12_PRIO_MOTION;
+    ResetStats();
+}
+
+int AX12Scheduler::Submit(AX12Request &request)
+{
+    if (_queued >= AX12_SCHED_QUEUE_SIZE || request.priority >= AX12_PRIO_CLASSES) {
+        return AX12_BUSY;
+    }
+    request.result = AX12_BUSY;
+    request._waiter = 0;
+    request._sequence = _sequence++;
+    request._deferred = false;
+    _queue[_queued++] = &request;
+    return AX12_OK;
+}
+
+int AX12Scheduler::Post(AX12Request &request)
+{
+    if (request.priority >= AX12_PRIO_CLASSES) {
+        return AX12_ERR_ARG;
+    }
+    request.result = AX12_BUSY;
+    request._waiter = waiter();
+
+    AX12Request *head = (AX12Request *)load((void *volatile *)&_posted);
+    do {
+        request._next = head;
+    } while (!push(&_posted, &head, &request));
+
+    // First of the list : the owner may be asleep in Idle()
+    void *owner = load(&_owner);
+    if (!head && owner) {
+        wake(owner);
+    }
+    return AX12_OK;
+}
+
+void AX12Scheduler::Idle(uint32_t us)
+{
+    void *self = waiter();
+
+    if (!self) {
+        _bus.Clock().wait_us(us);
+        return;
+    }
+    exchange(&_owner, self);
+    if (!load((void *volatile *)&_posted)) {
+        wait_flag(self, us);
+    }
+}
+
+int AX12Scheduler::Cancel(AX12Request &request)
+{
+    bool found = false;
+
+    collect();
+    for (int i = 0; i < _queued && !found; i++) {
+        if (_queue[i] == &request) {
+            remove(i);
+            found = true;
+        }
+    }
+    for (AX12Request *r = _held, *before = 0; r && !found; before = r, r = r->_next) {
+        if (r == &request) {
+            (before ? before->_next : _held) = r->_next;
+            _held_last = (_held_last == r) ? before : _held_last;
+            _held_count--;
+            found = true;
+        }
+    }
+    if (!found) {
+        return AX12_ERR_ARG;
+    }
+
+    // Over as well : the callback hears of it, as from complete()
+    if (request.done) {
+        request.done(&request, AX12_ERR_ARG, request.context);
+    }
+    release(&request.result, AX12_ERR_ARG, request._waiter);
+    return AX12_OK;
+}
+
+int AX12Scheduler::Poll(void)
+{
+    collect();
+
+    if (_probing) {
+        if (_bus.Poll() == AX12_BUSY) {
+            return Pending();
+        }
+        _probing = false;
+    }
+
+    if (_current) {
+        int result = _bus.Poll();
+        if (result == AX12_BUSY) {
+            return Pending();
+        }
+        AX12Request *request = _current;
+        _current = 0;
+        complete(*request, result);
+        collect();
+    }
+
+    while (!_current && _queued > 0) {
+        uint32_t now = _bus.Clock().now_us();
+
+        if (_reserved && AX12Clock::reached(now, _reserve_at)) {
+            _reserved = false;
+        }
+
+        int i = select(now);
+        if (i < 0) {
+            break; // everything left is deferred
+        }
+        AX12Request &request = *_queue[i];
+        remove(i);
+
+        // Stale : it would end after its deadline
+        if (request.has_deadline && _drop_late[request.priority]
+            && !AX12Clock::reached(request.deadline, now + request._estimate)) {
+            _stats.dropped[request.priority]++;
+            complete(request, AX12_ERR_DEADLINE);
+            continue;
+        }
+
+        int started = start(request);
+        if (started != AX12_BUSY) {
+            complete(request, started);
+            continue;
+        }
+        _current = &request;
+    }
+
+    // Idle time : one PING to a quarantined servo whose back-off is over
+    if (!_current && _queued == 0 && !_reserved && _bus.Probe() == AX12_BUSY) {
+        _probing = true;
+    }
+    return Pending();
+}
+
+int AX12Scheduler::Run(AX12Request &request)
+{
+    int result = Submit(request);
+    if (result != AX12_OK) {
+        return result;
+    }
+    while (Poll() > 0 && request.result == AX12_BUSY) {
+        _bus.Clock().wait_us(_bus.WireTime(1));
+    }
+    return request.result;
+}
+
+void AX12Scheduler::Flush(void)
+{
+    while (Poll() > 0) {
+        _bus.Clock().wait_us(_bus.WireTime(1));
+    }
+}
+
+void AX12Scheduler::Reserve(uint32_t at, int priority)
+{
+    _reserved = true;
+    _reserve_at = at;
+    _reserve_priority = priority;
+}
+
+void AX12Scheduler::SetDropLate(int priority, bool drop)
+{
+    if (priority >= 0 && priority < AX12_PRIO_CLASSES) {
+        _drop_late[priority] = drop;
+    }
+}
+
+uint32_t AX12Scheduler::Estimate(const AX12Request &request)
+{
+    int reply = (request.instruction == AX12_INST_READ) ? request.length : 0;
+    return _bus.Estimate(request.id, request.instruction, AX12_RequestParams(request), reply);
+}
+
+int AX12Scheduler::Pending(void)
+{
+    return _queued + _held_count + (_current ? 1 : 0);
+}
+
+AX12Bus &AX12Scheduler::Bus(void)
+{
+    return _bus;
+}
+
+const AX12SchedulerStats &AX12Scheduler::Stats(void)
+{
+    return _stats;
+}
+
+void AX12Scheduler::ResetStats(void)
+{
+    memset(&_stats, 0, sizeof(_stats));
+}
+
+// Posted requests into the queue, in the order of the posts
+void AX12Scheduler::collect(void)
+{
+    AX12Request *list = (AX12Request *)exchange((void *volatile *)&_posted, 0);
+
+    // Pushed last first : reversed
+    AX12Request *first = 0;
+    while (list) {
+        AX12Request *next = list->_next;
+        list->_next = first;
+        first = list;
+        list = next;
+    }
+    if (first) {
+        if (_held) {
+            _held_last->_next = first;
+        } else {
+            _held = first;
+        }
+        for (AX12Request *r = first; r; r = r->_next) {
+            _held_last = r;
+            _held_count++;
+        }
+    }
+
+    while (_held && _queued < AX12_SCHED_QUEUE_SIZE) {
+        AX12Request &request = *_held;
+        _held = request._next;
+        _held_count--;
+        request._next = 0;
+        request._sequence = _sequence++;
+        request._deferred = false;
+        _queue[_queued++] = &request;
+    }
+    if (!_held) {
+        _held_last = 0;
+    }
+}
+
+// Index of the next request to start, -1 if none can start now
+int AX12Scheduler::select(uint32_t now)
+{
+    int best = -1;
+
+    for (int i = 0; i < _queued; i++) {
+        AX12Request &r = *_queue[i];
+        r._estimate = Estimate(r);
+
+        // Would still hold the bus when the reserved slot begins
+        if (_reserved && r.priority > _reserve_priority
+            && !AX12Clock::reached(_reserve_at, now + r._estimate)) {
+            if (!r._deferred) {
+                r._deferred = true;
+                _stats.deferred[r.priority]++;
+            }
+            continue;
+        }
+
+        if (best < 0) {
+            best = i;
+            continue;
+        }
+
+        AX12Request &b = *_queue[best];
+        if (r.priority != b.priority) {
+            if (r.priority < b.priority) {
+                best = i;
+            }
+        } else if (r.has_deadline != b.has_deadline) {
+            if (r.has_deadline) {
+                best = i;
+            }
+        } else if (r.has_deadline && r.deadline != b.deadline) {
+            if ((int32_t)(r.deadline - b.deadline) < 0) {
+                best = i;
+            }
+        } else if ((int32_t)(r._sequence - b._sequence) < 0) {
+            best = i;
+        }
+    }
+    return best;
+}
+
+int AX12Scheduler::start(AX12Request &request)
+{
+    uint8_t *p = _bus.Packet(request.id, request.instruction, AX12_RequestParams(request));
+    if (!p) {
+        return AX12_ERR_ARG;
+    }
+
+    switch (request.instruction) {
+    case AX12_INST_READ:
+        p[0] = request.start;
+        p[1] = request.length;
+        break;
+    case AX12_INST_WRITE:
+    case AX12_INST_REG_WRITE:
+        p[0] = request.start;
+        memcpy(&p[1], request.data, request.length);
+        break;
+    case AX12_INST_SYNC_WRITE:
+        p[0] = request.start;
+        p[1] = request.length;
+        memcpy(&p[2], request.data, request.count * (1 + request.length));
+        break;
+    default:
+        break;
+    }
+
+    request._started = _bus.Clock().now_us();
+    if (request.instruction == AX12_INST_READ) {
+        return _bus.Start(request.data, request.length);
+    }
+    return _bus.Start();
+}
+
+void AX12Scheduler::complete(AX12Request &request, int result)
+{
+    int prio = request.priority;
+
+    request.finished = _bus.Clock().now_us();
+
+    void *waiter = request._waiter;
+
+    if (result != AX12_ERR_DEADLINE && result != AX12_ERR_ARG) {
+        _stats.completed[prio]++;
+
+        int32_t error = (int32_t)(request.finished - request._started) - (int32_t)request._estimate;
+        if (result != AX12_ERR_TIMEOUT) {
+            error = (error < 0) ? -error : error;
+            if (error > _stats.max_estimate_error_us) {
+                _stats.max_estimate_error_us = error;
+            }
+        }
+
+        if (request.has_deadline && !AX12Clock::reached(request.deadline, request.finished)) {
+            uint32_t late = request.finished - request.deadline;
+            _stats.missed[prio]++;
+            if (late > _stats.max_late_us[prio]) {
+                _stats.max_late_us[prio] = late;
+            }
+        }
+    }
+
+    // The callback first : the poster may free the request as soon as the result is in
+    if (request.done) {
+        request.done(&request, result, request.context);
+    }
+    release(&request.result, result, waiter);
+}
+
+void AX12Scheduler::remove(int index)
+{
+    for (int i = index; i < _queued - 1; i++) {
+        _queue[i] = _queue[i + 1];
+    }
+    _queued--;
+}
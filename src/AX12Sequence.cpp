@@ -0,0 +1,851 @@
+/**
+ * @file AX12Sequence.cpp
+ * @author joebarteam11
+ * @brief Keyframe sequences compiled from text, played at a fixed tick
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+#include "AX12Sequence.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#define MASK_BYTES ((_count + 7) / 8)
+
+#define SEQ_LINE 256   // characters of a line of text
+#define SEQ_TOKENS 48  // words of a line
+
+static uint16_t get16(const uint8_t *p)
+{
+    return p[0] | (p[1] << 8);
+}
+
+static bool masked(const uint8_t *mask, int joint)
+{
+    return (mask[joint / 8] >> (joint % 8)) & 1;
+}
+
+// Joints of a mask, among the first \p count
+static int AX12_SeqWidth(const uint8_t *mask, int count)
+{
+    int width = 0;
+    for (int i = 0; i < count; i++) {
+        width += masked(mask, i);
+    }
+    return width;
+}
+
+static bool AX12_SeqHeader(const uint8_t *data, int size)
+{
+    return data && size >= AX12_SEQ_HEADER && data[0] == 'A' && data[1] == 'S' && data[2] == AX12_SEQ_VERSION
+           && data[3] > 0 && data[3] <= AX12_SEQ_MAX_JOINTS && get16(&data[4]) != 0
+           && size >= AX12_SEQ_HEADER + data[3];
+}
+
+AX12Sequencer::AX12Sequencer(AX12MultiBus &joints)
+    : _joints(joints)
+{
+    _playing = false;
+    _data = 0;
+    _size = 0;
+    _at = 0;
+    _count = 0;
+    _type = AX12_SEQ_STEP;
+    _ticks = 0;
+    _n = 0;
+    _record = AX12_SEQ_END;
+    _loop = -1;
+    _left = 0;
+    _queued = 0;
+    _queued_size = 0;
+    _period = 0;
+    _next = 0;
+    _speed_factor = 0;
+    memset(_mask, 0, sizeof(_mask));
+    memset(&_stats, 0, sizeof(_stats));
+}
+
+int AX12Sequencer::Play(const uint8_t *data, int size)
+{
+    if (!AX12_SeqHeader(data, size)) {
+        return AX12_ERR_ARG;
+    }
+    memset(&_stats, 0, sizeof(_stats));
+    _queued = 0;
+    start(data, size);
+    _next = _joints.Clock().now_us();
+    return AX12_OK;
+}
+
+int AX12Sequencer::Queue(const uint8_t *data, int size)
+{
+    if (!_playing) {
+        return Play(data, size);
+    }
+    if (!AX12_SeqHeader(data, size)) {
+        return AX12_ERR_ARG;
+    }
+    _queued = data;
+    _queued_size = size;
+    return AX12_OK;
+}
+
+void AX12Sequencer::Extend(int size)
+{
+    if (size > _size) {
+        _size = size;
+    }
+}
+
+int AX12Sequencer::Step(void)
+{
+    if (!_playing) {
+        return AX12_ERR_LENGTH;
+    }
+    uint32_t now = _joints.Clock().now_us();
+    if (!AX12Clock::reached(now, _next)) {
+        return 0;
+    }
+    _next += _period;
+    if (AX12Clock::reached(now, _next)) {
+        _next = now + _period; // late by more than a tick : the rate starts again from now
+    }
+    _stats.ticks++;
+
+    switch (_record) {
+    case AX12_SEQ_KEY:
+        if (_type != AX12_SEQ_STEP) {
+            return interpolate();
+        }
+        // A step keyframe waits for its ticks
+        // fall through
+    case AX12_SEQ_WAIT:
+        if (++_n >= _ticks) {
+            _record = AX12_SEQ_END;
+        }
+        return 1;
+    case AX12_SEQ_SETTLE:
+        return settle();
+    }
+    return run();
+}
+
+uint32_t AX12Sequencer::Due(void)
+{
+    uint32_t now = _joints.Clock().now_us();
+    if (!_playing || AX12Clock::reached(now, _next)) {
+        return 0;
+    }
+    return _next - now;
+}
+
+void AX12Sequencer::Stop(void)
+{
+    _playing = false;
+    _queued = 0;
+}
+
+bool AX12Sequencer::Playing(void)
+{
+    return _playing;
+}
+
+uint16_t AX12Sequencer::Goal(int index)
+{
+    return (index >= 0 && index < _count) ? _goals[index] : 0;
+}
+
+uint32_t AX12Sequencer::Period(void)
+{
+    return _period;
+}
+
+const AX12SequenceStats &AX12Sequencer::Stats(void)
+{
+    return _stats;
+}
+
+// Joints of the sequence, the set points of those already playing kept, the others read
+int AX12Sequencer::start(const uint8_t *data, int size)
+{
+    int count = data[3];
+    const uint8_t *ids = &data[AX12_SEQ_HEADER];
+    uint16_t goals[AX12_SEQ_MAX_JOINTS];
+    uint16_t speeds[AX12_SEQ_MAX_JOINTS];
+    uint8_t unknown[AX12_SEQ_MAX_JOINTS];
+    uint8_t where[AX12_SEQ_MAX_JOINTS];
+    int missing = 0;
+
+    for (int i = 0; i < count; i++) {
+        int j = 0;
+        while (j < _count && _ids[j] != ids[i]) {
+            j++;
+        }
+        speeds[i] = (j < _count) ? _speeds[j] : 0;
+        if (j < _count) {
+            goals[i] = _goals[j];
+        } else {
+            unknown[missing] = ids[i];
+            where[missing++] = i;
+        }
+    }
+    if (missing) {
+        uint8_t positions[2 * AX12_SEQ_MAX_JOINTS];
+        int results[AX12_SEQ_MAX_JOINTS];
+        _joints.ReadAll(AX12_REG_POSITION, 2, unknown, positions, results, missing);
+        _stats.reads++;
+        for (int k = 0; k < missing; k++) {
+            goals[where[k]] = (results[k] >= 0) ? get16(&positions[2 * k]) & 0x3FF : 512;
+        }
+    }
+
+    _count = count;
+    memcpy(_ids, ids, count);
+    memcpy(_goals, goals, count * sizeof(goals[0]));
+    memcpy(_speeds, speeds, count * sizeof(speeds[0]));
+    _data = data;
+    _size = size;
+    _at = AX12_SEQ_HEADER + count;
+    _record = AX12_SEQ_END;
+    _loop = -1;
+    _period = get16(&data[4]) * 100;
+    _speed_factor = (uint32_t)(65536.0f * 1000000.0f / _period / AX12_SPEED_UNIT_TICKS);
+    _playing = true;
+    return AX12_OK;
+}
+
+// Bytes of the record at \p at, 0 if it is not all received, AX12_ERR_ARG if it is not a record
+int AX12Sequencer::length(int at)
+{
+    if (at >= _size) {
+        return 0;
+    }
+    const uint8_t *r = &_data[at];
+    int left = _size - at;
+    int length;
+
+    switch (r[0]) {
+    case AX12_SEQ_END:
+        return 1;
+    case AX12_SEQ_KEY:
+        length = 4 + MASK_BYTES;
+        if (left >= length) {
+            length += 2 * AX12_SeqWidth(&r[4], _count); // the mask is there : so is the size of the goals
+        }
+        break;
+    case AX12_SEQ_SPEED:
+    case AX12_SEQ_TORQUE:
+        length = 1 + MASK_BYTES;
+        if (left >= length) {
+            length += 2 * AX12_SeqWidth(&r[1], _count);
+        }
+        break;
+    case AX12_SEQ_FREE:
+        length = 1 + MASK_BYTES;
+        break;
+    case AX12_SEQ_WAIT:
+    case AX12_SEQ_NEXT:
+        length = 3;
+        break;
+    case AX12_SEQ_SETTLE:
+        length = 3 + MASK_BYTES;
+        break;
+    case AX12_SEQ_REPEAT:
+        length = 2;
+        break;
+    default:
+        return AX12_ERR_ARG;
+    }
+    return (left < length) ? 0 : length;
+}
+
+// Records up to the next one that takes time
+int AX12Sequencer::run(void)
+{
+    bool looped = false;
+
+    while (true) {
+        int length = this->length(_at);
+        if (length == 0) {
+            _stats.starved++;
+            return 1;
+        }
+        if (length < 0) {
+            _playing = false;
+            return AX12_ERR_ARG;
+        }
+        const uint8_t *r = &_data[_at];
+        _at += length;
+
+        switch (r[0]) {
+        case AX12_SEQ_END:
+            if (_queued) {
+                start(_queued, _queued_size);
+                _queued = 0;
+                continue;
+            }
+            _playing = false;
+            return AX12_ERR_LENGTH;
+
+        case AX12_SEQ_KEY: {
+            const uint8_t *goals = &r[4 + MASK_BYTES];
+            _ticks = get16(&r[1]);
+            _type = r[3];
+            _n = 0;
+            memcpy(_mask, &r[4], MASK_BYTES);
+            for (int i = 0; i < _count; i++) {
+                if (masked(_mask, i)) {
+                    _from[i] = _goals[i];
+                    _to[i] = get16(goals) & 0x3FF;
+                    goals += 2;
+                }
+            }
+            if (_type != AX12_SEQ_STEP && _ticks > 0) {
+                _record = AX12_SEQ_KEY;
+                return interpolate();
+            }
+            // At once, with the speed of the last speed record : the interpolations changed it since
+            uint8_t data[4 * AX12_SEQ_MAX_JOINTS];
+            int n = 0;
+            for (int i = 0; i < _count; i++) {
+                if (masked(_mask, i)) {
+                    _goals[i] = _to[i];
+                    data[n++] = _to[i] & 0xFF;
+                    data[n++] = _to[i] >> 8;
+                    data[n++] = _speeds[i] & 0xFF;
+                    data[n++] = _speeds[i] >> 8;
+                }
+            }
+            write(AX12_REG_GOAL_POSITION, _mask, data, 4);
+            if (_ticks == 0) {
+                continue;
+            }
+            _record = (_ticks > 1) ? AX12_SEQ_KEY : AX12_SEQ_END;
+            _n = 1;
+            return 1;
+        }
+
+        case AX12_SEQ_SPEED:
+            for (int i = 0, k = 0; i < _count; i++) {
+                if (masked(&r[1], i)) {
+                    _speeds[i] = get16(&r[1 + MASK_BYTES + 2 * k++]);
+                }
+            }
+            // fall through
+        case AX12_SEQ_TORQUE:
+            write((r[0] == AX12_SEQ_SPEED) ? AX12_REG_MOVING_SPEED : AX12_REG_TORQUE_LIMIT, &r[1], &r[1 + MASK_BYTES], 2);
+            continue;
+
+        case AX12_SEQ_FREE: {
+            uint8_t off[AX12_SEQ_MAX_JOINTS] = {0};
+            write(AX12_REG_ENABLE_TORQUE, &r[1], off, 1);
+            continue;
+        }
+
+        case AX12_SEQ_WAIT:
+            _ticks = get16(&r[1]);
+            if (_ticks == 0) {
+                continue;
+            }
+            _record = (_ticks > 1) ? AX12_SEQ_WAIT : AX12_SEQ_END;
+            _n = 1;
+            return 1;
+
+        case AX12_SEQ_SETTLE:
+            memcpy(_mask, &r[1], MASK_BYTES);
+            _ticks = get16(&r[1 + MASK_BYTES]);
+            _n = 0;
+            _record = AX12_SEQ_SETTLE;
+            return settle();
+
+        case AX12_SEQ_REPEAT:
+            _left = r[1];
+            _loop = _at;
+            continue;
+
+        case AX12_SEQ_NEXT:
+            if (_loop >= 0 && (_left == 0 || --_left > 0)) {
+                // Repeated forever without taking any time : would never return
+                if (_left == 0 && looped) {
+                    _playing = false;
+                    return AX12_ERR_ARG;
+                }
+                looped = true;
+                _at = _loop;
+            } else {
+                _loop = -1;
+            }
+            continue;
+        }
+    }
+}
+
+// Next tick of a linear or smooth keyframe : goal and speed of its joints in one SYNC_WRITE per bus
+int AX12Sequencer::interpolate(void)
+{
+    uint8_t ids[AX12_SEQ_MAX_JOINTS];
+    uint8_t data[4 * AX12_SEQ_MAX_JOINTS];
+    int n = 0;
+
+    _n++;
+    uint32_t f = ((uint32_t)_n << 16) / _ticks; // Q16, 1.0 on the last tick
+    if (_type == AX12_SEQ_SMOOTH) {
+        f = (uint32_t)((((uint64_t)f * f) >> 16) * (3 * 65536 - 2 * f) >> 16);
+    }
+
+    for (int i = 0; i < _count; i++) {
+        if (!masked(_mask, i)) {
+            continue;
+        }
+        int distance = _to[i] - _from[i];
+        int goal = _from[i] + (int)(((int64_t)distance * f + 32768) >> 16);
+        int step = abs(goal - _goals[i]);
+        uint32_t speed = ((uint32_t)step * _speed_factor) >> 16;
+        speed += speed / 8 + AX12_SEQ_MIN_SPEED;
+        speed = (speed > 1023) ? 1023 : speed;
+        _goals[i] = goal;
+
+        ids[n] = _ids[i];
+        data[4 * n] = goal & 0xFF;
+        data[4 * n + 1] = goal >> 8;
+        data[4 * n + 2] = speed & 0xFF;
+        data[4 * n + 3] = speed >> 8;
+        n++;
+    }
+    if (_n >= _ticks) {
+        _record = AX12_SEQ_END;
+    }
+    if (n == 0) {
+        return 1;
+    }
+    _stats.writes++;
+    _joints.SyncWrite(AX12_REG_GOAL_POSITION, 4, ids, data, n); // no status : a lost packet is caught up next tick
+    return 1;
+}
+
+// Next tick of a settle : over once none of its joints moves, or at its last tick
+int AX12Sequencer::settle(void)
+{
+    uint8_t ids[AX12_SEQ_MAX_JOINTS];
+    uint8_t moving[AX12_SEQ_MAX_JOINTS];
+    int results[AX12_SEQ_MAX_JOINTS];
+    int n = 0;
+
+    _n++;
+    for (int i = 0; i < _count; i++) {
+        if (masked(_mask, i)) {
+            ids[n++] = _ids[i];
+        }
+    }
+    bool still = true;
+    if (n > 0) {
+        _joints.ReadAll(AX12_REG_MOVING, 1, ids, moving, results, n);
+        _stats.reads++;
+        for (int k = 0; k < n; k++) {
+            still = still && results[k] >= 0 && !moving[k];
+        }
+    }
+    if (still) {
+        _record = AX12_SEQ_END;
+    } else if (_n >= _ticks) {
+        _record = AX12_SEQ_END;
+        _stats.late++;
+    }
+    return 1;
+}
+
+// Same register of the joints of \p mask, \p values holding \p width bytes for each of them in turn
+int AX12Sequencer::write(int reg, const uint8_t *mask, const uint8_t *values, int width)
+{
+    uint8_t ids[AX12_SEQ_MAX_JOINTS];
+    int n = 0;
+
+    for (int i = 0; i < _count; i++) {
+        if (masked(mask, i)) {
+            ids[n++] = _ids[i];
+        }
+    }
+    if (n == 0) {
+        return AX12_OK;
+    }
+    _stats.writes++;
+    return _joints.SyncWrite(reg, width, ids, values, n);
+}
+
+// Compiler
+
+struct AX12SeqText {
+    uint8_t *out;
+    int size;
+    int at;           // bytes written, counted past \p size as well
+    uint32_t period;  // us
+    int count;        // joints, 0 before "joints"
+    uint8_t ids[AX12_SEQ_MAX_JOINTS];
+    int repeat;       // offset after the AX12_SEQ_REPEAT, -1 outside
+    bool forever;
+    bool timed;       // a record of the repeat takes time
+};
+
+static void AX12_SeqPut(AX12SeqText &t, int byte)
+{
+    if (t.at < t.size) {
+        t.out[t.at] = byte;
+    }
+    t.at++;
+}
+
+static void AX12_SeqPut16(AX12SeqText &t, int value)
+{
+    AX12_SeqPut(t, value & 0xFF);
+    AX12_SeqPut(t, value >> 8);
+}
+
+static void AX12_SeqPutMask(AX12SeqText &t, const uint8_t *mask)
+{
+    for (int i = 0; i < (t.count + 7) / 8; i++) {
+        AX12_SeqPut(t, mask[i]);
+    }
+}
+
+static bool AX12_SeqNumber(const char *word, double &value, const char **unit)
+{
+    char *end;
+    value = strtod(word, &end);
+    *unit = end;
+    return end != word;
+}
+
+// Time in ticks, rounded, "ms" if no unit
+static bool AX12_SeqTime(const AX12SeqText &t, const char *word, uint32_t &ticks)
+{
+    double value;
+    const char *unit;
+    if (!AX12_SeqNumber(word, value, &unit) || value < 0) {
+        return false;
+    }
+    if (!strcmp(unit, "us")) {
+    } else if (!strcmp(unit, "s")) {
+        value *= 1000000.0;
+    } else if (!*unit || !strcmp(unit, "ms")) {
+        value *= 1000.0;
+    } else {
+        return false;
+    }
+    value = value / t.period + 0.5;
+    if (value > 0xFFFFFFFFu) {
+        return false;
+    }
+    ticks = (uint32_t)value;
+    return true;
+}
+
+static int AX12_SeqJoint(const AX12SeqText &t, int id)
+{
+    for (int i = 0; i < t.count; i++) {
+        if (t.ids[i] == id) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+static bool AX12_SeqId(const char *word, int &id)
+{
+    char *end;
+    long value = strtol(word, &end, 10);
+    id = (int)value;
+    return end != word && !*end && value >= 0 && value < AX12_BROADCAST_ID;
+}
+
+// Joints listed by \p words, or "all"
+static const char *AX12_SeqList(const AX12SeqText &t, char **words, int n, uint8_t *mask)
+{
+    memset(mask, 0, (AX12_SEQ_MAX_JOINTS + 7) / 8);
+    if (n == 1 && !strcmp(words[0], "all")) {
+        memset(mask, 0xFF, (t.count + 7) / 8);
+        return 0;
+    }
+    if (n == 0) {
+        return "joints expected";
+    }
+    for (int k = 0; k < n; k++) {
+        int id, joint;
+        if (!AX12_SeqId(words[k], id) || (joint = AX12_SeqJoint(t, id)) < 0) {
+            return "not a joint";
+        }
+        mask[joint / 8] |= 1 << (joint % 8);
+    }
+    return 0;
+}
+
+// "all=value" or "id=value" words, positions if \p position ("deg" allowed), register values up to 1023 otherwise
+static const char *AX12_SeqValues(const AX12SeqText &t, char **words, int n, bool position, uint8_t *mask,
+                                  uint16_t *values)
+{
+    memset(mask, 0, (AX12_SEQ_MAX_JOINTS + 7) / 8);
+    if (n == 0) {
+        return "id=value expected";
+    }
+    for (int k = 0; k < n; k++) {
+        char *equal = strchr(words[k], '=');
+        double value;
+        const char *unit;
+        if (!equal) {
+            return "id=value expected";
+        }
+        *equal = 0;
+        if (!AX12_SeqNumber(equal + 1, value, &unit)) {
+            return "not a number";
+        }
+        if (position && !strcmp(unit, "deg")) {
+            value = value * 1023.0 / 300.0;
+        } else if (*unit) {
+            return "unknown unit";
+        }
+        value += 0.5;
+        if (value < 0 || value >= 1024) {
+            return "out of 0 to 1023";
+        }
+
+        int first = 0, last = t.count - 1;
+        if (strcmp(words[k], "all")) {
+            int id;
+            if (!AX12_SeqId(words[k], id) || (first = last = AX12_SeqJoint(t, id)) < 0) {
+                return "not a joint";
+            }
+        }
+        for (int i = first; i <= last; i++) {
+            mask[i / 8] |= 1 << (i % 8);
+            values[i] = (uint16_t)value;
+        }
+    }
+    return 0;
+}
+
+static void AX12_SeqPutValues(AX12SeqText &t, const uint8_t *mask, const uint16_t *values)
+{
+    AX12_SeqPutMask(t, mask);
+    for (int i = 0; i < t.count; i++) {
+        if (masked(mask, i)) {
+            AX12_SeqPut16(t, values[i]);
+        }
+    }
+}
+
+// One line, split in words
+static const char *AX12_SeqLine(AX12SeqText &t, char **words, int n)
+{
+    const char *command = words[0];
+    uint8_t mask[(AX12_SEQ_MAX_JOINTS + 7) / 8];
+    uint16_t values[AX12_SEQ_MAX_JOINTS];
+    uint32_t ticks;
+    const char *error;
+
+    if (!strcmp(command, "period")) {
+        if (t.count) {
+            return "period after joints";
+        }
+        double ms;
+        const char *unit;
+        if (n != 2 || !AX12_SeqNumber(words[1], ms, &unit) || *unit || ms < 0.1 || ms > 6553.5) {
+            return "period 0.1 to 6553.5 ms expected";
+        }
+        t.period = (uint32_t)(ms * 10.0 + 0.5) * 100;
+        return 0;
+    }
+    if (!strcmp(command, "joints")) {
+        if (t.count) {
+            return "joints given twice";
+        }
+        if (n < 2 || n - 1 > AX12_SEQ_MAX_JOINTS) {
+            return "1 to AX12_SEQ_MAX_JOINTS joints expected";
+        }
+        for (int k = 1; k < n; k++) {
+            int id;
+            if (!AX12_SeqId(words[k], id)) {
+                return "not an ID";
+            }
+            if (AX12_SeqJoint(t, id) >= 0) {
+                return "ID given twice";
+            }
+            t.ids[t.count++] = id;
+        }
+        AX12_SeqPut(t, 'A');
+        AX12_SeqPut(t, 'S');
+        AX12_SeqPut(t, AX12_SEQ_VERSION);
+        AX12_SeqPut(t, t.count);
+        AX12_SeqPut16(t, t.period / 100);
+        for (int i = 0; i < t.count; i++) {
+            AX12_SeqPut(t, t.ids[i]);
+        }
+        return 0;
+    }
+    if (!t.count) {
+        return "joints first";
+    }
+
+    if (!strcmp(command, "key")) {
+        int type = AX12_SEQ_LINEAR;
+        int first = 2;
+        if (n < 3 || !AX12_SeqTime(t, words[1], ticks)) {
+            return "key <time> [step|linear|smooth] id=position...";
+        }
+        if (ticks > 0xFFFF) {
+            return "keyframe too long";
+        }
+        if (!strcmp(words[2], "step")) {
+            type = AX12_SEQ_STEP;
+            first++;
+        } else if (!strcmp(words[2], "linear")) {
+            first++;
+        } else if (!strcmp(words[2], "smooth")) {
+            type = AX12_SEQ_SMOOTH;
+            first++;
+        }
+        if ((error = AX12_SeqValues(t, &words[first], n - first, true, mask, values))) {
+            return error;
+        }
+        AX12_SeqPut(t, AX12_SEQ_KEY);
+        AX12_SeqPut16(t, ticks);
+        AX12_SeqPut(t, type);
+        AX12_SeqPutValues(t, mask, values);
+        t.timed = t.timed || ticks > 0;
+        return 0;
+    }
+    if (!strcmp(command, "speed") || !strcmp(command, "torque")) {
+        if ((error = AX12_SeqValues(t, &words[1], n - 1, false, mask, values))) {
+            return error;
+        }
+        AX12_SeqPut(t, (command[0] == 's') ? AX12_SEQ_SPEED : AX12_SEQ_TORQUE);
+        AX12_SeqPutValues(t, mask, values);
+        return 0;
+    }
+    if (!strcmp(command, "free")) {
+        if ((error = AX12_SeqList(t, &words[1], n - 1, mask))) {
+            return error;
+        }
+        AX12_SeqPut(t, AX12_SEQ_FREE);
+        AX12_SeqPutMask(t, mask);
+        return 0;
+    }
+    if (!strcmp(command, "wait")) {
+        if (n != 2 || !AX12_SeqTime(t, words[1], ticks)) {
+            return "wait <time>";
+        }
+        t.timed = t.timed || ticks > 0;
+        while (ticks > 0) {
+            uint32_t part = (ticks > 0xFFFF) ? 0xFFFF : ticks;
+            AX12_SeqPut(t, AX12_SEQ_WAIT);
+            AX12_SeqPut16(t, part);
+            ticks -= part;
+        }
+        return 0;
+    }
+    if (!strcmp(command, "settle")) {
+        if (n < 3 || !AX12_SeqTime(t, words[1], ticks)) {
+            return "settle <time> ids|all";
+        }
+        if ((error = AX12_SeqList(t, &words[2], n - 2, mask))) {
+            return error;
+        }
+        ticks = (ticks < 1) ? 1 : (ticks > 0xFFFF) ? 0xFFFF : ticks;
+        AX12_SeqPut(t, AX12_SEQ_SETTLE);
+        AX12_SeqPutMask(t, mask);
+        AX12_SeqPut16(t, ticks);
+        t.timed = true;
+        return 0;
+    }
+    if (!strcmp(command, "repeat")) {
+        double count;
+        const char *unit;
+        if (t.repeat >= 0) {
+            return "repeat in a repeat";
+        }
+        if (n != 2 || !AX12_SeqNumber(words[1], count, &unit) || *unit || count < 0 || count > 255
+            || count != (int)count) {
+            return "repeat 0 to 255";
+        }
+        AX12_SeqPut(t, AX12_SEQ_REPEAT);
+        AX12_SeqPut(t, (int)count);
+        t.repeat = t.at;
+        t.forever = (count == 0);
+        t.timed = false;
+        return 0;
+    }
+    if (!strcmp(command, "end")) {
+        if (t.repeat < 0) {
+            return "end without repeat";
+        }
+        if (t.forever && !t.timed) {
+            return "repeat forever that takes no time";
+        }
+        AX12_SeqPut(t, AX12_SEQ_NEXT);
+        AX12_SeqPut16(t, t.repeat);
+        t.repeat = -1;
+        return 0;
+    }
+    return "unknown command";
+}
+
+int AX12_CompileSequence(const char *text, uint8_t *out, int size, AX12SequenceError *error)
+{
+    AX12SeqText t;
+    char line[SEQ_LINE];
+    char *words[SEQ_TOKENS];
+    const char *failure = 0;
+    int number = 0;
+
+    t.out = out;
+    t.size = size;
+    t.at = 0;
+    t.period = 10000;
+    t.count = 0;
+    t.repeat = -1;
+    t.forever = false;
+    t.timed = false;
+
+    while (*text && !failure) {
+        int length = strcspn(text, "\n");
+        number++;
+        if (length >= SEQ_LINE) {
+            failure = "line too long";
+            break;
+        }
+        memcpy(line, text, length);
+        line[length] = 0;
+        text += length + (text[length] == '\n');
+
+        char *comment = strchr(line, '#');
+        if (comment) {
+            *comment = 0;
+        }
+        int n = 0;
+        for (char *word = strtok(line, " \t\r"); word; word = strtok(0, " \t\r")) {
+            if (n == SEQ_TOKENS) {
+                failure = "too many words";
+                break;
+            }
+            words[n++] = word;
+        }
+        if (n > 0 && !failure) {
+            failure = AX12_SeqLine(t, words, n);
+        }
+    }
+    if (!failure && !t.count) {
+        failure = "no joints";
+    } else if (!failure && t.repeat >= 0) {
+        failure = "repeat without end";
+    }
+    if (error) {
+        error->line = failure ? number : 0;
+        error->message = failure;
+    }
+    if (failure) {
+        return AX12_ERR_ARG;
+    }
+    AX12_SeqPut(t, AX12_SEQ_END);
+    return (t.at > size) ? AX12_ERR_LENGTH : t.at;
+}
@@ -0,0 +1,316 @@
+/**
+ * @file AX12Simulation.cpp
+ * @author joebarteam11
+ * @brief Physics of the AX12 for the emulated chains, and simulations run in parallel
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+#include "AX12Simulation.h"
+
+#include <math.h>
+
+#if !defined(__MBED__)
+#include <atomic>
+#include <thread>
+#endif
+
+#define STEP_NS (AX12_SIM_STEP_US * 1000ULL)
+#define TURN_TICKS 1228.8f // 360 degrees
+#define TURN_RAD (TURN_TICKS * AX12_SIM_TICK_RAD)
+
+// Compliance registers, between torque enable / LED and the goal
+#define COMPLIANCE_CW_MARGIN 0x1A
+#define COMPLIANCE_CCW_MARGIN 0x1B
+#define COMPLIANCE_CW_SLOPE 0x1C
+#define COMPLIANCE_CCW_SLOPE 0x1D
+
+// Read at every step : kept inline
+static inline int word(const uint8_t *table, int reg)
+{
+    return table[reg] | (table[reg + 1] << 8);
+}
+
+const AX12MotorModel AX12_MOTOR_AX12A = {
+    1.5f,   // stall torque, N.m
+    6.18f,  // free speed, rad/s (59 rpm)
+    0.005f, // inertia of the gear train at the horn, kg.m2
+    0.03f,  // dry friction, N.m
+    0.002f, // viscous friction, N.m per rad/s
+    8.0f,   // winding, ohm : 1.5 A at 12 V
+    4.0f,   // thermal resistance, degrees C per W
+    180.0f, // thermal time constant, s
+    25.0f,  // ambient, degrees C
+};
+
+AX12ServoDynamics::AX12ServoDynamics(const AX12MotorModel &model, uint32_t seed, float spread)
+{
+    _model = model;
+    _random = seed ? seed : 1;
+    for (int i = 0; i < 3; i++) {
+        float deviation = spread * ((random() % 2001) / 1000.0f - 1.0f);
+        float &value = (i == 0) ? _model.stall_torque : (i == 1) ? _model.free_speed : _model.friction;
+        value *= 1.0f + deviation;
+    }
+    external = 0;
+    noise = 0;
+    _pending = 0;
+    _angle = 0;
+    _velocity = 0;
+    _set = 0;
+    _output = 0;
+    _temperature = _model.ambient;
+    _current = 0;
+    _saturated = 0;
+    _reported = -1;
+    _rest = false;
+}
+
+void AX12ServoDynamics::Attach(AX12EmulatedServo &servo)
+{
+    int position = servo.Word(AX12_REG_POSITION);
+    servo.physics = this;
+    _angle = position * AX12_SIM_TICK_RAD;
+    _set = position;
+    _velocity = 0;
+    _output = 0;
+    _current = 0;
+    _temperature = _model.ambient;
+    _saturated = 0;
+    _pending = 0;
+    _reported = position;
+    servo.table[AX12_REG_TEMP] = (int)(_temperature + 0.5f);
+}
+
+const AX12MotorModel &AX12ServoDynamics::Model(void)
+{
+    return _model;
+}
+
+float AX12ServoDynamics::Position(void)
+{
+    return (float)(_angle / AX12_SIM_TICK_RAD);
+}
+
+float AX12ServoDynamics::Velocity(void)
+{
+    return _velocity / AX12_SIM_TICK_RAD;
+}
+
+float AX12ServoDynamics::Output(void)
+{
+    return _output;
+}
+
+float AX12ServoDynamics::Temperature(void)
+{
+    return _temperature;
+}
+
+float AX12ServoDynamics::Current(void)
+{
+    return _current;
+}
+
+// xorshift32
+uint32_t AX12ServoDynamics::random(void)
+{
+    _random ^= _random << 13;
+    _random ^= _random >> 17;
+    _random ^= _random << 5;
+    return _random;
+}
+
+void AX12ServoDynamics::Advance(AX12EmulatedServo &servo, uint64_t ns)
+{
+    // Present position changed from outside (test setup)
+    if (servo.Word(AX12_REG_POSITION) != _reported && !(servo.dead_zone && servo._position >= 1023.5f)) {
+        _angle = servo.Word(AX12_REG_POSITION) * AX12_SIM_TICK_RAD;
+        _set = servo.Word(AX12_REG_POSITION);
+        _velocity = 0;
+    }
+
+    _pending += ns;
+    uint64_t steps = _pending / STEP_NS;
+    _pending -= steps * STEP_NS;
+    if (steps == 0) {
+        return;
+    }
+
+    // The control table may have changed : at least one step before resting
+    _rest = false;
+    while (steps > 0 && !_rest) {
+        step(servo, AX12_SIM_STEP_US * 1e-6f);
+        steps--;
+    }
+    if (steps > 0) {
+        // Nothing moves nor drives : only the motor cools down
+        float keep = powf(1.0f - AX12_SIM_STEP_US * 1e-6f / _model.thermal_time, (float)steps);
+        _temperature = _model.ambient + (_temperature - _model.ambient) * keep;
+    }
+    report(servo);
+}
+
+void AX12ServoDynamics::step(AX12EmulatedServo &servo, float dt)
+{
+    uint8_t *table = servo.table;
+    float position = (float)(_angle / AX12_SIM_TICK_RAD);
+    float volts = table[AX12_REG_VOLTS] / 120.0f;
+    int max = word(table, AX12_REG_TORQUE_LIMIT);
+    max = (word(table, AX12_REG_MAX_TORQUE) < max) ? word(table, AX12_REG_MAX_TORQUE) : max;
+    float limit = (max > 1023) ? 1.0f : max / 1023.0f;
+    bool wheel = (word(table, AX12_REG_CW_LIMIT) == 0 && word(table, AX12_REG_CCW_LIMIT) == 0);
+    bool torque = table[AX12_REG_ENABLE_TORQUE] != 0;
+    bool reached = true;
+    uint8_t alarms = 0;
+    float u = 0;
+
+    if (!torque || wheel) {
+        _set = position;
+        if (torque) {
+            int command = word(table, AX12_REG_MOVING_SPEED);
+            u = (command & 0x3FF) / 1023.0f;
+            u = (command & AX12_SPEED_CW) ? -u : u;
+        }
+    } else {
+        int goal = word(table, AX12_REG_GOAL_POSITION);
+        int cw = word(table, AX12_REG_CW_LIMIT), ccw = word(table, AX12_REG_CCW_LIMIT);
+        if (goal < cw || goal > ccw) {
+            alarms |= AX12_ERROR_ANGLE;
+            goal = (goal < cw) ? cw : ccw;
+        }
+
+        // The set point moves to the goal at the moving speed
+        int speed = word(table, AX12_REG_MOVING_SPEED) & 0x3FF;
+        float move = speed ? speed * AX12_SPEED_UNIT_TICKS * dt : 1024.0f;
+        float distance = goal - _set;
+        _set = (distance > move) ? _set + move : (distance < -move) ? _set - move : goal;
+        reached = (_set == goal);
+
+        // Compliance : nothing within the margin, then the punch and the slope up to the full output
+        float e = _set - position;
+        float margin = table[(e > 0) ? COMPLIANCE_CCW_MARGIN : COMPLIANCE_CW_MARGIN];
+        float slope = table[(e > 0) ? COMPLIANCE_CCW_SLOPE : COMPLIANCE_CW_SLOPE];
+        float error = fabsf(e) - margin;
+        if (error > 0) {
+            u = word(table, AX12_REG_PUNCH) / 1023.0f + error / ((slope > 1) ? slope : 1);
+            u = (u > 1) ? 1 : u;
+            u = (e > 0) ? u : -u;
+        }
+        reached = reached && fabsf(goal - position) <= margin;
+    }
+    u = (u > limit) ? limit : (u < -limit) ? -limit : u;
+    _output = u;
+
+    // DC motor : the torque falls with the speed, both scale with the supply; off, it turns free
+    float torque_motor = torque ? _model.stall_torque * (u * volts - _velocity / _model.free_speed) : 0;
+    float drive = torque_motor - _model.damping * _velocity + external;
+    float dry = _model.friction + servo.resistance * _model.stall_torque;
+
+    if (_velocity == 0 && fabsf(drive) <= dry) {
+        _rest = (u == 0 && reached);
+    } else {
+        float direction = (_velocity != 0) ? ((_velocity > 0) ? 1.0f : -1.0f) : ((drive > 0) ? 1.0f : -1.0f);
+        float velocity = _velocity + (drive - dry * direction) / _model.inertia * dt;
+        _velocity = (_velocity != 0 && velocity * _velocity < 0) ? 0 : velocity; // stopped by the friction
+    }
+    // Over a whole turn, as the potentiometer sees it
+    _angle += _velocity * dt;
+    if (_angle < 0) {
+        _angle += TURN_RAD;
+    } else if (_angle >= TURN_RAD) {
+        _angle -= TURN_RAD;
+    }
+    servo.travel += _velocity * dt / AX12_SIM_TICK_RAD;
+
+    // Joule losses heat the motor
+    _current = torque_motor / _model.stall_torque * (12.0f / _model.winding);
+    float steady = _model.ambient + _current * _current * _model.winding * _model.thermal_resistance;
+    _temperature += (steady - _temperature) * dt / _model.thermal_time;
+
+    // Saturated with the horn stalled
+    if (limit > 0 && fabsf(u) >= limit && fabsf(_velocity) < 10 * AX12_SIM_TICK_RAD) {
+        _saturated++;
+    } else {
+        _saturated = 0;
+    }
+    if (_saturated >= AX12_SIM_OVERLOAD_MS * 1000 / AX12_SIM_STEP_US) {
+        alarms |= AX12_ERROR_OVERLOAD;
+    }
+    if (table[AX12_REG_VOLTS] < table[AX12_REG_MIN_VOLTS] || table[AX12_REG_VOLTS] > table[AX12_REG_MAX_VOLTS]) {
+        alarms |= AX12_ERROR_VOLTAGE;
+    }
+    if (_temperature > table[AX12_REG_TEMP_LIMIT]) {
+        alarms |= AX12_ERROR_OVERHEAT;
+    }
+    if (alarms & table[AX12_REG_ALARM_SHUTDOWN]) {
+        servo.SetWord(AX12_REG_TORQUE_LIMIT, 0);
+    }
+    servo.alarms = alarms;
+    table[AX12_REG_MOVING] = !reached || _velocity != 0 || (wheel && u != 0);
+}
+
+// Present values of the control table
+void AX12ServoDynamics::report(AX12EmulatedServo &servo)
+{
+    float wrapped = (float)(_angle / AX12_SIM_TICK_RAD);
+    int position;
+
+    servo._position = wrapped;
+    if (wrapped < 1023.5f) {
+        position = (int)(wrapped + 0.5f);
+        if (noise > 0) {
+            position += (int)(random() % (2 * noise + 1)) - noise;
+            position = (position < 0) ? 0 : (position > 1023) ? 1023 : position;
+        }
+    } else {
+        // Between 300 and 360 degrees the potentiometer reads anything (dead_zone) or its nearest end
+        position = (wrapped < (1023.0f + TURN_TICKS) / 2) ? 1023 : 0;
+    }
+    servo.SetWord(AX12_REG_POSITION, position);
+    _reported = position;
+
+    int speed = (int)(fabsf(_velocity) / AX12_SIM_TICK_RAD / AX12_SPEED_UNIT_TICKS + 0.5f);
+    speed = (speed > 0x3FF) ? 0x3FF : speed;
+    servo.SetWord(AX12_REG_SPEED, (_velocity < 0) ? (speed | AX12_SPEED_CW) : speed);
+    servo.load = (int)(-_output * 1023); // CW positive, as read
+    servo.table[AX12_REG_TEMP] = (_temperature > 255) ? 255 : (int)(_temperature + 0.5f);
+    if (_temperature <= servo.table[AX12_REG_TEMP_LIMIT]) {
+        servo.alarms &= ~AX12_ERROR_OVERHEAT; // cooled down while resting
+    }
+}
+
+#if !defined(__MBED__)
+
+int AX12_RunSimulations(int runs, AX12SimulationRun run, void *context, int threads)
+{
+    if (threads <= 0) {
+        threads = (int)std::thread::hardware_concurrency();
+        threads = (threads > 0) ? threads : 1;
+    }
+    threads = (threads > runs) ? runs : threads;
+    threads = (threads > AX12_SIM_MAX_THREADS) ? AX12_SIM_MAX_THREADS : threads;
+    threads = (threads < 1) ? 1 : threads;
+
+    // Each thread takes the next run left : the slow ones do not hold the others
+    std::atomic<int> next(0);
+    auto work = [&]() {
+        int index;
+        while ((index = next++) < runs) {
+            run(index, context);
+        }
+    };
+    std::thread pool[AX12_SIM_MAX_THREADS];
+    for (int t = 1; t < threads; t++) {
+        pool[t] = std::thread(work);
+    }
+    work();
+    for (int t = 1; t < threads; t++) {
+        pool[t].join();
+    }
+    return threads;
+}
+
+#endif
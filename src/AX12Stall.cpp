@@ -0,0 +1,267 @@
+/**
+ * @file AX12Stall.cpp
+ * @author joebarteam11
+ * @brief Stall and collision detection, with an automatic reaction
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+#include "AX12Stall.h"
+
+#include <stdlib.h>
+
+#define BACKOFF 20 // ticks a position mode servo moves back on AX12_STALL_REVERSE
+
+AX12StallDetector::AX12StallDetector(AX12MultiBus &joints)
+    : _joints(joints)
+{
+    _count = 0;
+    _action = AX12_STALL_REPORT;
+    _started = false;
+    _last = 0;
+    _ticks = 0;
+    _events = 0;
+    SetThresholds(40, 150, 300, 3, 3);
+}
+
+int AX12StallDetector::Add(int id)
+{
+    if (_count >= AX12_STALL_MAX_JOINTS) {
+        return -1;
+    }
+    Joint &j = _list[_count];
+    j.id = id;
+    Command(_count, true, 0);
+    return _count++;
+}
+
+int AX12StallDetector::SetSpeed(int joint, float speed)
+{
+    // Same encoding as AX12::SetCRSpeed()
+    int value = (int)(0x3ff * ((speed < 0) ? -speed : speed));
+    value = (value > 0x3ff) ? 0x3ff : value;
+    if (speed < 0) {
+        value |= AX12_SPEED_CW;
+    }
+    uint8_t data[2] = {(uint8_t)(value & 0xff), (uint8_t)(value >> 8)};
+
+    Command(joint, true, value);
+    int id = _list[joint].id;
+    return _joints.Bus(_joints.BusOf(id)).Write(id, AX12_REG_MOVING_SPEED, 2, data);
+}
+
+int AX12StallDetector::Move(int joint, int goal, int speed)
+{
+    uint8_t data[4] = {(uint8_t)(goal & 0xff), (uint8_t)(goal >> 8), (uint8_t)(speed & 0xff), (uint8_t)(speed >> 8)};
+
+    Command(joint, false, speed, goal);
+    int id = _list[joint].id;
+    return _joints.Bus(_joints.BusOf(id)).Write(id, AX12_REG_GOAL_POSITION, 4, data);
+}
+
+void AX12StallDetector::Command(int joint, bool wheel, int speed, int goal)
+{
+    Joint &j = _list[joint];
+    int magnitude = speed & 0x3FF;
+
+    j.wheel = wheel;
+    j.speed = (wheel && (speed & AX12_SPEED_CW)) ? -magnitude : magnitude;
+    j.goal = goal;
+    j.grace = _grace;
+    j.count = 0;
+    j.jumps = 0;
+    j.heavy = false;
+    j.known = false;
+    j.free = -1;
+    j.event = AX12_STALL_NONE;
+    j.time = 0;
+}
+
+int AX12StallDetector::Tick(void)
+{
+    uint8_t ids[AX12_STALL_MAX_JOINTS];
+    int index[AX12_STALL_MAX_JOINTS];
+    uint8_t data[6 * AX12_STALL_MAX_JOINTS];
+    int results[AX12_STALL_MAX_JOINTS];
+    int n = 0;
+
+    for (int i = 0; i < _count; i++) {
+        if (_list[i].speed != 0 && _list[i].event == AX12_STALL_NONE) {
+            index[n] = i;
+            ids[n++] = _list[i].id;
+        }
+    }
+    _ticks++;
+    if (n == 0) {
+        _started = false;
+        return 0;
+    }
+
+    // Position, speed and load in one read
+    _joints.ReadAll(AX12_REG_POSITION, 6, ids, data, results, n);
+    uint32_t now = _joints.Clock().now_us();
+    uint32_t elapsed = _started ? now - _last : 0;
+    _started = true;
+    _last = now;
+
+    int events = 0;
+    for (int k = 0; k < n; k++) {
+        Joint &j = _list[index[k]];
+        if (results[k] < 0) {
+            j.known = false;
+            continue;
+        }
+        int event = check(j, &data[6 * k], elapsed);
+        if (event != AX12_STALL_NONE) {
+            j.event = event;
+            j.time = now;
+            _events++;
+            events++;
+            react(j, data[6 * k] | (data[6 * k + 1] << 8));
+        }
+    }
+    return events;
+}
+
+int AX12StallDetector::check(Joint &j, const uint8_t *data, uint32_t elapsed)
+{
+    int position = data[0] | (data[1] << 8);
+    int present = (data[2] | (data[3] << 8)) & 0x3FF;
+    int load = abs(AX12_LoadFromRegister(data[4] | (data[5] << 8)));
+    int command = abs(j.speed);
+
+    // A servo holding its goal may be pushed, it is not stalled
+    if (!j.wheel && abs(position - j.goal) <= 2) {
+        j.known = false;
+        return AX12_STALL_NONE;
+    }
+
+    // Travel since the previous read, through the wrap of wheel mode
+    int moved = -1;
+    if (j.known && elapsed) {
+        moved = abs(position - j.position);
+        moved = (j.wheel && moved > 512) ? 1024 - moved : moved;
+    }
+    j.position = position;
+    j.known = true;
+
+    // Slowed down : both the speed register and the travel, when long enough to tell
+    bool slow = present * 100 < command * _speed_percent;
+    float expected = command * AX12_SPEED_UNIT_TICKS * elapsed * 1e-6f;
+    if (moved >= 0 && expected >= 4) {
+        slow = slow && moved * 100 < expected * _speed_percent;
+    }
+
+    if (j.free < 0) {
+        j.free = load << 4;
+    }
+    if (j.grace) {
+        j.grace--;
+        j.free += ((load << 4) - j.free) >> 2;
+        return AX12_STALL_NONE;
+    }
+
+    int free = j.free >> 4;
+    bool heavy = load >= free + _margin;
+    bool jump = load >= free + _jump;
+
+    // A jump counts only when the previous load was normal, or when it goes on
+    j.jumps = (jump && (j.jumps || !j.heavy)) ? j.jumps + 1 : 0;
+    j.count = (slow && heavy) ? j.count + 1 : 0;
+    j.heavy = heavy;
+
+    int event = AX12_STALL_NONE;
+    if (j.jumps && (slow || j.jumps >= _confirm)) {
+        event = AX12_STALL_COLLISION;
+    } else if (j.count >= _confirm) {
+        event = AX12_STALL_STALLED;
+    }
+
+    if (!heavy && !slow) {
+        j.free += ((load << 4) - j.free) >> 3;
+    }
+    return event;
+}
+
+void AX12StallDetector::react(Joint &j, int position)
+{
+    AX12Bus &bus = _joints.Bus(_joints.BusOf(j.id));
+    uint8_t data[2];
+    int value;
+
+    switch (_action) {
+    case AX12_STALL_CUT_TORQUE:
+        data[0] = 0;
+        bus.Write(j.id, AX12_REG_ENABLE_TORQUE, 1, data);
+        break;
+    case AX12_STALL_REVERSE:
+        if (j.wheel) {
+            value = abs(j.speed) / 2;
+            value |= (j.speed > 0) ? AX12_SPEED_CW : 0;
+            data[0] = value & 0xff;
+            data[1] = value >> 8;
+            bus.Write(j.id, AX12_REG_MOVING_SPEED, 2, data);
+        } else {
+            value = position + ((j.goal > position) ? -BACKOFF : BACKOFF);
+            value = (value < 0) ? 0 : (value > 1023) ? 1023 : value;
+            data[0] = value & 0xff;
+            data[1] = value >> 8;
+            bus.Write(j.id, AX12_REG_GOAL_POSITION, 2, data);
+        }
+        break;
+    case AX12_STALL_HOLD:
+        data[0] = j.wheel ? 0 : (position & 0xff);
+        data[1] = j.wheel ? 0 : (position >> 8);
+        bus.Write(j.id, j.wheel ? AX12_REG_MOVING_SPEED : AX12_REG_GOAL_POSITION, 2, data);
+        break;
+    default:
+        break;
+    }
+}
+
+int AX12StallDetector::Event(int joint)
+{
+    return _list[joint].event;
+}
+
+uint32_t AX12StallDetector::EventTime(int joint)
+{
+    return _list[joint].time;
+}
+
+void AX12StallDetector::Clear(int joint)
+{
+    Joint &j = _list[joint];
+    j.event = AX12_STALL_NONE;
+    j.grace = _grace;
+    j.count = 0;
+    j.jumps = 0;
+    j.heavy = false;
+    j.known = false;
+}
+
+void AX12StallDetector::SetAction(int action)
+{
+    _action = action;
+}
+
+void AX12StallDetector::SetThresholds(int speed_percent, int load_margin, int jump, int confirm, int grace)
+{
+    _speed_percent = speed_percent;
+    _margin = load_margin;
+    _jump = jump;
+    _confirm = (confirm < 1) ? 1 : confirm;
+    _grace = grace;
+}
+
+uint32_t AX12StallDetector::Ticks(void)
+{
+    return _ticks;
+}
+
+uint32_t AX12StallDetector::Events(void)
+{
+    return _events;
+}
@@ -0,0 +1,131 @@
+/**
+ * @file AX12Sweep.cpp
+ * @author joebarteam11
+ * @brief The same registers of many servos, read back to back
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+#include "AX12Sweep.h"
+
+#include <string.h>
+
+AX12ReadSweep::AX12ReadSweep(AX12Bus &bus)
+    : _bus(bus)
+{
+    _ids = 0;
+    _count = 0;
+    _index = 0;
+    _start = 0;
+    _length = 0;
+    _data = 0;
+    _results = 0;
+    _failed = 0;
+    _begun = 0;
+    _margin = AX12_SWEEP_MARGIN_US;
+    ResetStats();
+}
+
+int AX12ReadSweep::Begin(const uint8_t *ids, int count, int start, int length, uint8_t *data, int *results)
+{
+    if (!ids || !data || !results || count < 0 || start < 0 || length <= 0 || start + length > 0x100) {
+        return AX12_ERR_ARG;
+    }
+    if (_index < _count || _bus.Busy()) {
+        return AX12_ERR_ARG;
+    }
+
+    _ids = ids;
+    _count = count;
+    _index = 0;
+    _start = start;
+    _length = length;
+    _data = data;
+    _results = results;
+    _failed = 0;
+    _begun = _bus.Clock().now_us();
+    if (count == 0) {
+        _stats.sweeps++;
+        _stats.last_us = 0;
+        return 0;
+    }
+    return next(launch());
+}
+
+int AX12ReadSweep::Poll(void)
+{
+    if (_index >= _count) {
+        return _failed;
+    }
+    return next(_bus.Poll());
+}
+
+int AX12ReadSweep::Wait(void)
+{
+    int result;
+    while ((result = Poll()) == AX12_BUSY) {
+        _bus.Wait();
+    }
+    return result;
+}
+
+int AX12ReadSweep::Read(const uint8_t *ids, int count, int start, int length, uint8_t *data, int *results)
+{
+    int result = Begin(ids, count, start, length, data, results);
+    return (result == AX12_BUSY) ? Wait() : result;
+}
+
+void AX12ReadSweep::SetMargin(uint32_t us)
+{
+    _margin = us;
+}
+
+const AX12SweepStats &AX12ReadSweep::Stats(void)
+{
+    return _stats;
+}
+
+void AX12ReadSweep::ResetStats(void)
+{
+    memset(&_stats, 0, sizeof(_stats));
+}
+
+// READ_DATA of the servo at _index, its deadline the end of its reply plus the margin
+int AX12ReadSweep::launch(void)
+{
+    uint8_t *p = _bus.Packet(_ids[_index], AX12_INST_READ, 2);
+    if (!p) {
+        return AX12_ERR_ARG;
+    }
+    p[0] = _start;
+    p[1] = _length;
+
+    uint32_t timeout = _bus.Timeout();
+    _bus.SetTimeout(_margin);
+    int result = _bus.Start(&_data[_index * _length], _length);
+    _bus.SetTimeout(timeout);
+    return result;
+}
+
+// Result of the servo at _index : the next READ_DATA leaves at once
+int AX12ReadSweep::next(int result)
+{
+    while (result != AX12_BUSY) {
+        _results[_index] = result;
+        if (result < 0) {
+            _failed++;
+            _stats.failures++;
+        } else {
+            _stats.reads++;
+        }
+        if (++_index == _count) {
+            _stats.sweeps++;
+            _stats.last_us = _bus.Clock().now_us() - _begun;
+            return _failed;
+        }
+        result = launch();
+    }
+    return AX12_BUSY;
+}
@@ -0,0 +1,456 @@
+/**
+ * @file AX12Teach.cpp
+ * @author joebarteam11
+ * @brief Teach and replay of multi-joint motions, stored delta encoded in a few KB
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+#include "AX12Teach.h"
+
+#include <string.h>
+
+#define MASK_BYTES ((_count + 7) / 8)
+#define RUN_MAX 128  // frames on the prediction in one code
+#define GROUP_MAX 64 // frames sharing a mask in one code
+#define CODE_GROUP 0x80 // a mask follows
+#define CODE_SAME 0xC0  // the mask of the previous group
+#define CODE_ESCAPE 15
+
+static void put16(uint8_t *p, int value)
+{
+    p[0] = value & 0xFF;
+    p[1] = (value >> 8) & 0xFF;
+}
+
+static int get16(const uint8_t *p)
+{
+    return p[0] | (p[1] << 8);
+}
+
+AX12Recorder::AX12Recorder(AX12MultiBus &joints)
+    : _joints(joints)
+{
+    _state = IDLE;
+    _count = 0;
+    _buffer = 0;
+    _data = 0;
+    _size = 0;
+    _length = 0;
+    _frames = 0;
+    _total = 0;
+    _run = 0;
+    _group = 0;
+    _group_at = 0;
+    _group_code = CODE_GROUP;
+    memset(_mask, 0, sizeof(_mask));
+    _failed = 0;
+    _period = AX12_TEACH_PERIOD_US;
+    _next = 0;
+}
+
+int AX12Recorder::Teach(const uint8_t *ids, int count, uint8_t *buffer, int size, uint32_t period_us)
+{
+    if (count <= 0 || count > AX12_TEACH_MAX_JOINTS || !buffer || size < AX12_TEACH_HEADER + 3 * count
+        || period_us < 100 || period_us / 100 > 0xFFFF) {
+        return AX12_ERR_ARG;
+    }
+    _state = IDLE;
+
+    // Free joints, to be posed by hand
+    uint8_t off[AX12_TEACH_MAX_JOINTS];
+    memset(off, 0, sizeof(off));
+    int r = _joints.SyncWrite(AX12_REG_ENABLE_TORQUE, 1, ids, off, count);
+    if (r != AX12_OK) {
+        return r;
+    }
+
+    _count = count;
+    memcpy(_ids, ids, count);
+    _buffer = buffer;
+    _data = buffer;
+    _size = size;
+    _period = period_us / 100 * 100;
+    buffer[0] = 'A';
+    buffer[1] = 'T';
+    buffer[2] = AX12_TEACH_VERSION;
+    buffer[3] = count;
+    put16(&buffer[4], _period / 100);
+    memset(&buffer[6], 0, 4); // frames, written by Stop()
+    memcpy(&buffer[AX12_TEACH_HEADER], ids, count);
+    _length = AX12_TEACH_HEADER + count;
+    _frames = 0;
+    _run = 0;
+    _group = 0;
+    memset(_mask, 0, sizeof(_mask));
+    _failed = 0;
+    for (int i = 0; i < count; i++) {
+        _positions[i] = 512;
+    }
+
+    _state = RECORDING;
+    _next = _joints.Clock().now_us();
+    return (Sample() < 0) ? AX12_ERR_LENGTH : AX12_OK;
+}
+
+// Constant speed from the two last frames, kept in the range of the positions
+int AX12Recorder::predict(int joint)
+{
+    int x = 2 * _x1[joint] - _x0[joint];
+    return (x < 0) ? 0 : (x > 1023) ? 1023 : x;
+}
+
+void AX12Recorder::advance(const int16_t *x)
+{
+    for (int i = 0; i < _count; i++) {
+        _x0[i] = _x1[i];
+        _x1[i] = x[i];
+        _positions[i] = x[i];
+    }
+}
+
+// Write the frames on the prediction counted so far, the byte is reserved
+void AX12Recorder::flush(void)
+{
+    if (_run) {
+        _buffer[_length++] = _run - 1;
+        _run = 0;
+    }
+}
+
+static bool masked(const uint8_t *mask, int joint)
+{
+    return (mask[joint / 8] >> (joint % 8)) & 1;
+}
+
+int AX12Recorder::encode(const uint16_t *positions)
+{
+    if (_frames == 0) {
+        if (_length + 2 * _count > _size) {
+            return AX12_ERR_LENGTH;
+        }
+        for (int i = 0; i < _count; i++) {
+            put16(&_buffer[_length], positions[i]);
+            _length += 2;
+            _x0[i] = _x1[i] = _positions[i] = positions[i];
+        }
+        _frames++;
+        return AX12_OK;
+    }
+
+    int16_t x[AX12_TEACH_MAX_JOINTS];
+    int16_t residuals[AX12_TEACH_MAX_JOINTS];
+    uint8_t mask[(AX12_TEACH_MAX_JOINTS + 7) / 8];
+    int k = 0;
+    memset(mask, 0, sizeof(mask));
+    for (int i = 0; i < _count; i++) {
+        int p = predict(i);
+        int r = positions[i] - p;
+        if (r >= -AX12_TEACH_DEADBAND && r <= AX12_TEACH_DEADBAND) {
+            r = 0;
+        } else {
+            mask[i / 8] |= 1 << (i % 8);
+            k++;
+        }
+        x[i] = p + r;
+        residuals[i] = r;
+    }
+
+    // On the prediction : counted, the byte of the run is reserved by its first frame
+    if (k == 0) {
+        if (_run == 0 && _length + 1 > _size) {
+            return AX12_ERR_LENGTH;
+        }
+        _group = 0;
+        _run++;
+        if (_run == RUN_MAX) {
+            flush();
+        }
+        advance(x);
+        _frames++;
+        return AX12_OK;
+    }
+
+    // The mask of the previous group if it covers the joints off the prediction, for at most one byte of zeros
+    // more : the joints of a gesture keep moving, the frames on the prediction in between do not cost a mask
+    int width = 0;
+    bool same = true;
+    for (int i = 0; i < _count; i++) {
+        if (masked(_mask, i)) {
+            width++;
+        } else if (masked(mask, i)) {
+            same = false;
+        }
+    }
+    same = same && (width + 1) / 2 <= (k + 1) / 2 + 1;
+    bool join = same && _group > 0 && _group < GROUP_MAX;
+    const uint8_t *use = same ? _mask : mask;
+    width = same ? width : k;
+
+    int length = (join ? 0 : 1) + (same ? 0 : MASK_BYTES) + (width + 1) / 2;
+    for (int i = 0; i < _count; i++) {
+        length += (masked(use, i) && (residuals[i] > 7 || residuals[i] < -7)) ? 2 : 0;
+    }
+    if (_length + (_run ? 1 : 0) + length > _size) {
+        return AX12_ERR_LENGTH;
+    }
+    flush();
+    if (!join) {
+        _group_at = _length;
+        _group_code = same ? CODE_SAME : CODE_GROUP;
+        _group = 0;
+        _length++;
+        if (!same) {
+            memcpy(_mask, mask, MASK_BYTES);
+            memcpy(&_buffer[_length], mask, MASK_BYTES);
+            _length += MASK_BYTES;
+        }
+    }
+    _buffer[_group_at] = _group_code | _group;
+    _group++;
+
+    // 4 bits zigzag codes of the joints of the mask, the first one in the low half of a byte, then the escaped values
+    uint8_t *p = &_buffer[_length];
+    uint8_t *escaped = p + (width + 1) / 2;
+    memset(p, 0, (width + 1) / 2);
+    for (int i = 0, j = 0; i < _count; i++) {
+        if (!masked(_mask, i)) {
+            continue;
+        }
+        int r = residuals[i];
+        int code = (r >= 0) ? 2 * r : -2 * r - 1;
+        if (code >= CODE_ESCAPE) {
+            code = CODE_ESCAPE;
+            put16(escaped, r);
+            escaped += 2;
+        }
+        p[j / 2] |= code << (4 * (j % 2));
+        j++;
+    }
+    _length = escaped - _buffer;
+    advance(x);
+    _frames++;
+    return AX12_OK;
+}
+
+int AX12Recorder::Sample(void)
+{
+    if (_state != RECORDING) {
+        return AX12_ERR_LENGTH;
+    }
+    uint32_t now = _joints.Clock().now_us();
+    if (!AX12Clock::reached(now, _next)) {
+        return 0;
+    }
+    _next += _period;
+    if (AX12Clock::reached(now, _next)) {
+        _next = now + _period; // late by more than a period : the rate starts again from now
+    }
+
+    uint8_t data[2 * AX12_TEACH_MAX_JOINTS];
+    int results[AX12_TEACH_MAX_JOINTS];
+    uint16_t positions[AX12_TEACH_MAX_JOINTS];
+    _joints.ReadAll(AX12_REG_POSITION, 2, _ids, data, results, _count);
+    for (int i = 0; i < _count; i++) {
+        if (results[i] < 0) {
+            positions[i] = _positions[i];
+            _failed++;
+        } else {
+            positions[i] = (data[2 * i] | (data[2 * i + 1] << 8)) & 0x3FF;
+        }
+    }
+
+    if (encode(positions) != AX12_OK) {
+        Stop();
+        return AX12_ERR_LENGTH;
+    }
+    return 1;
+}
+
+int AX12Recorder::Stop(void)
+{
+    if (_state == RECORDING) {
+        flush();
+        _buffer[6] = _frames & 0xFF;
+        _buffer[7] = (_frames >> 8) & 0xFF;
+        _buffer[8] = (_frames >> 16) & 0xFF;
+        _buffer[9] = (_frames >> 24) & 0xFF;
+    }
+    _state = IDLE;
+    return _length;
+}
+
+int AX12Recorder::Play(const uint8_t *data, int size)
+{
+    if (!data || size < AX12_TEACH_HEADER || data[0] != 'A' || data[1] != 'T' || data[2] != AX12_TEACH_VERSION
+        || data[3] == 0 || data[3] > AX12_TEACH_MAX_JOINTS || get16(&data[4]) == 0
+        || size < AX12_TEACH_HEADER + 3 * data[3]) {
+        return AX12_ERR_ARG;
+    }
+    _state = IDLE;
+    _count = data[3];
+    _period = get16(&data[4]) * 100;
+    _total = data[6] | (data[7] << 8) | (data[8] << 16) | ((uint32_t)data[9] << 24);
+    memcpy(_ids, &data[AX12_TEACH_HEADER], _count);
+    _data = data;
+    _size = size;
+    _length = AX12_TEACH_HEADER + _count;
+    _run = 0;
+    _group = 0;
+    memset(_mask, 0, sizeof(_mask));
+
+    int16_t x[AX12_TEACH_MAX_JOINTS];
+    for (int i = 0; i < _count; i++) {
+        x[i] = get16(&data[_length]) & 0x3FF;
+        _x1[i] = x[i];
+        _length += 2;
+    }
+    advance(x);
+    _frames = 1;
+
+    uint8_t on[AX12_TEACH_MAX_JOINTS];
+    memset(on, 1, sizeof(on));
+    _joints.SetGoals(_ids, _positions, _count);
+    _joints.SyncWrite(AX12_REG_ENABLE_TORQUE, 1, _ids, on, _count);
+
+    _state = PLAYING;
+    _next = _joints.Clock().now_us() + _period;
+    return AX12_OK;
+}
+
+int AX12Recorder::decode(void)
+{
+    int16_t x[AX12_TEACH_MAX_JOINTS];
+
+    if (_run == 0 && _group == 0) {
+        if (_length >= _size) {
+            return AX12_ERR_LENGTH;
+        }
+        int code = _data[_length++];
+        if (code < CODE_GROUP) {
+            _run = code + 1;
+        } else if (code >= CODE_SAME) {
+            _group = code - CODE_SAME + 1;
+        } else if (_length + MASK_BYTES <= _size) {
+            _group = code - CODE_GROUP + 1;
+            memcpy(_mask, &_data[_length], MASK_BYTES);
+            _length += MASK_BYTES;
+        } else {
+            return AX12_ERR_LENGTH; // cut
+        }
+    }
+
+    for (int i = 0; i < _count; i++) {
+        x[i] = predict(i);
+    }
+    if (_run > 0) {
+        _run--;
+        advance(x);
+        return AX12_OK;
+    }
+
+    // A frame of the group : 4 bits codes of the joints of the mask, escaped values
+    int width = 0;
+    for (int i = 0; i < _count; i++) {
+        width += masked(_mask, i);
+    }
+    const uint8_t *codes = &_data[_length];
+    const uint8_t *escaped = codes + (width + 1) / 2;
+    const uint8_t *end = _data + _size;
+    if (escaped > end) {
+        return AX12_ERR_LENGTH;
+    }
+    for (int i = 0, j = 0; i < _count; i++) {
+        if (!masked(_mask, i)) {
+            continue;
+        }
+        int code = (codes[j / 2] >> (4 * (j % 2))) & 0xF;
+        int r;
+        if (code == CODE_ESCAPE) {
+            if (escaped + 2 > end) {
+                return AX12_ERR_LENGTH;
+            }
+            r = (int16_t)get16(escaped);
+            escaped += 2;
+        } else {
+            r = (code & 1) ? -(code + 1) / 2 : code / 2;
+        }
+        int v = x[i] + r;
+        x[i] = (v < 0) ? 0 : (v > 1023) ? 1023 : v;
+        j++;
+    }
+    _length = escaped - _data;
+    _group--;
+    advance(x);
+    return AX12_OK;
+}
+
+int AX12Recorder::Step(void)
+{
+    if (_state != PLAYING) {
+        return AX12_ERR_LENGTH;
+    }
+    uint32_t now = _joints.Clock().now_us();
+    if (!AX12Clock::reached(now, _next)) {
+        return 0;
+    }
+    _next += _period;
+    if (AX12Clock::reached(now, _next)) {
+        _next = now + _period;
+    }
+
+    // A recording not closed by Stop() has no frame count : played to the end of the data
+    if ((_total && _frames >= _total) || decode() != AX12_OK) {
+        _state = IDLE;
+        return AX12_ERR_LENGTH;
+    }
+    _joints.SetGoals(_ids, _positions, _count);
+    _frames++;
+    return 1;
+}
+
+uint32_t AX12Recorder::Due(void)
+{
+    uint32_t now = _joints.Clock().now_us();
+    if (_state == IDLE || AX12Clock::reached(now, _next)) {
+        return 0;
+    }
+    return _next - now;
+}
+
+bool AX12Recorder::Recording(void)
+{
+    return _state == RECORDING;
+}
+
+bool AX12Recorder::Playing(void)
+{
+    return _state == PLAYING;
+}
+
+int AX12Recorder::Frames(void)
+{
+    return _frames;
+}
+
+int AX12Recorder::Size(void)
+{
+    return _length;
+}
+
+int AX12Recorder::Failed(void)
+{
+    return _failed;
+}
+
+uint32_t AX12Recorder::Period(void)
+{
+    return _period;
+}
+
+const uint16_t *AX12Recorder::Positions(void)
+{
+    return _positions;
+}
@@ -0,0 +1,306 @@
+/**
+ * @file AX12Topology.cpp
+ * @author joebarteam11
+ * @brief Servos of a chain kept in flash, checked at startup instead of searched
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+#include "AX12Topology.h"
+#include "AX12Sweep.h"
+
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+
+// Standard codes, fastest first : 1000000, 500000, 400000, 250000, 200000, 117647, 57143, 19231, 9615 bps
+static const uint8_t CODES[] = {0x01, 0x03, 0x04, 0x07, 0x09, 0x10, 0x22, 0x67, 0xCF};
+
+AX12Topology::AX12Topology(AX12Bus &bus, AX12Storage &storage)
+    : _bus(bus), _storage(storage)
+{
+    _stored = 0;
+    _written = false;
+    _packets = 0;
+    _updated = 0;
+    Clear();
+}
+
+int AX12Topology::Start(AX12TopologyReport &report)
+{
+    uint32_t begun = _bus.Clock().now_us();
+    _packets = 0;
+    _updated = 0;
+    _written = false;
+
+    int result = Load();
+    if (result == AX12_OK) {
+        result = Verify();
+    }
+    report.cached = (result == AX12_OK);
+    if (!report.cached) {
+        Discover();
+    }
+    if (!report.cached || _updated) {
+        Save();
+    }
+
+    if (_image.count > 0) {
+        _bus.Port().set_baudrate(AX12_BaudFromCode(_image.servos[0].Code()));
+    }
+    report.servos = _image.count;
+    report.updated = _updated;
+    report.packets = _packets;
+    report.saved = _written;
+    report.elapsed_us = _bus.Clock().now_us() - begun;
+    return (_image.count > 0) ? AX12_OK : AX12_ERR_TIMEOUT;
+}
+
+int AX12Topology::Discover(void)
+{
+    uint8_t ids[AX12_BROADCAST_ID];
+    for (int id = 0; id < AX12_BROADCAST_ID; id++) {
+        ids[id] = id;
+    }
+
+    Clear();
+    for (unsigned c = 0; c < sizeof(CODES); c++) {
+        sweep(CODES[c], ids, AX12_BROADCAST_ID, true);
+    }
+    return _image.count;
+}
+
+int AX12Topology::Verify(void)
+{
+    uint8_t ids[AX12_TOPOLOGY_MAX_SERVOS];
+    int missing = 0;
+
+    _updated = 0;
+    for (int i = 0; i < _image.count; i++) {
+        // One sweep per bit rate, at its first servo
+        int code = _image.servos[i].Code();
+        bool seen = false;
+        for (int j = 0; j < i && !seen; j++) {
+            seen = (_image.servos[j].Code() == code);
+        }
+        if (seen) {
+            continue;
+        }
+        int count = 0;
+        for (int j = i; j < _image.count; j++) {
+            if (_image.servos[j].Code() == code) {
+                ids[count++] = _image.servos[j].Id();
+            }
+        }
+        missing += sweep(code, ids, count, false);
+    }
+    return (missing || _image.count == 0) ? AX12_ERR_ID : AX12_OK;
+}
+
+int AX12Topology::Load(void)
+{
+    if (_storage.read(&_image, sizeof(_image)) != 0 || _image.magic != AX12_TOPOLOGY_MAGIC
+        || _image.size != sizeof(_image) || _image.count > AX12_TOPOLOGY_MAX_SERVOS
+        || _image.checksum != checksum(_image)) {
+        Clear();
+        _stored = 0;
+        return AX12_ERR_CHECKSUM;
+    }
+    _stored = _image.checksum;
+    return AX12_OK;
+}
+
+int AX12Topology::Save(void)
+{
+    _image.magic = AX12_TOPOLOGY_MAGIC;
+    _image.size = sizeof(_image);
+    _image.checksum = checksum(_image);
+
+    // Every erase wears the flash : only when something changed
+    if (_stored && _stored == _image.checksum) {
+        return AX12_OK;
+    }
+    if (_storage.write(&_image, sizeof(_image)) != 0) {
+        _stored = 0;
+        return AX12_ERR_UNREACHABLE;
+    }
+    _stored = _image.checksum;
+    _written = true;
+    return AX12_OK;
+}
+
+int AX12Topology::Servos(void)
+{
+    return _image.count;
+}
+
+const AX12TopologyServo &AX12Topology::Servo(int index)
+{
+    return _image.servos[(index >= 0 && index < _image.count) ? index : 0];
+}
+
+int AX12Topology::Find(int id)
+{
+    for (int i = 0; i < _image.count; i++) {
+        if (_image.servos[i].Id() == id) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+void AX12Topology::Clear(void)
+{
+    memset(&_image, 0, sizeof(_image));
+}
+
+// EEPROM blocks of \p ids at \p code, added to the cache or compared to it ; returns the servos missing
+int AX12Topology::sweep(int code, const uint8_t *ids, int count, bool discover)
+{
+    AX12ReadSweep reader(_bus);
+    uint8_t data[AX12_TOPOLOGY_CHUNK * AX12_EEPROM_SIZE];
+    int results[AX12_TOPOLOGY_CHUNK];
+    int missing = 0;
+
+    if (_bus.Port().set_baudrate(AX12_BaudFromCode(code)) != 0) {
+        return count;
+    }
+    for (int first = 0; first < count; first += AX12_TOPOLOGY_CHUNK) {
+        int n = (count - first < AX12_TOPOLOGY_CHUNK) ? count - first : AX12_TOPOLOGY_CHUNK;
+        reader.Read(&ids[first], n, AX12_REG_MODEL, AX12_EEPROM_SIZE, data, results);
+        _packets += n;
+
+        for (int k = 0; k < n; k++) {
+            const uint8_t *eeprom = &data[k * AX12_EEPROM_SIZE];
+            int id = ids[first + k];
+            if (results[k] < 0) {
+                _bus.Release(id); // an ID nobody has is not a servo to quarantine
+                missing++;
+                continue;
+            }
+            if (discover) {
+                if (_image.count < AX12_TOPOLOGY_MAX_SERVOS) {
+                    memcpy(_image.servos[_image.count++].eeprom, eeprom, AX12_EEPROM_SIZE);
+                }
+                continue;
+            }
+
+            // Same servo : same model, ID and bit rate ; the settings may have been written since
+            AX12TopologyServo *s = 0;
+            for (int i = 0; i < _image.count && !s; i++) {
+                if (_image.servos[i].Id() == id && _image.servos[i].Code() == code) {
+                    s = &_image.servos[i];
+                }
+            }
+            if (!s || memcmp(s->eeprom, eeprom, AX12_REG_BAUD + 1) != 0) {
+                missing++;
+            } else if (memcmp(s->eeprom, eeprom, AX12_EEPROM_SIZE) != 0) {
+                memcpy(s->eeprom, eeprom, AX12_EEPROM_SIZE);
+                _updated++;
+            }
+        }
+    }
+    return missing;
+}
+
+// CRC-32 (IEEE) of the image up to its checksum
+uint32_t AX12Topology::checksum(const Image &image)
+{
+    const uint8_t *p = (const uint8_t *)&image;
+    uint32_t crc = 0xFFFFFFFF;
+
+    for (size_t i = 0; i < offsetof(Image, checksum); i++) {
+        crc ^= p[i];
+        for (int b = 0; b < 8; b++) {
+            crc = (crc >> 1) ^ (0xEDB88320 & (0 - (crc & 1)));
+        }
+    }
+    return ~crc;
+}
+
+#if defined(__MBED__)
+
+AX12FlashStorage::AX12FlashStorage(uint32_t address)
+{
+    _address = address;
+}
+
+int AX12FlashStorage::read(void *data, uint32_t size)
+{
+    if (open() != 0) {
+        return -1;
+    }
+    int result = _flash.read(data, _address, size);
+    _flash.deinit();
+    return result;
+}
+
+int AX12FlashStorage::write(const void *data, uint32_t size)
+{
+    if (open() != 0) {
+        return -1;
+    }
+    uint32_t sector = _flash.get_sector_size(_address);
+    uint32_t page = _flash.get_page_size();
+    int result = -1;
+
+    if (size <= sector && page <= AX12_FLASH_CHUNK && AX12_FLASH_CHUNK % page == 0
+        && _flash.erase(_address, sector) == 0) {
+        // Programmed by whole pages, the end of the last one left erased
+        uint8_t chunk[AX12_FLASH_CHUNK];
+        result = 0;
+        for (uint32_t at = 0; at < size && result == 0; at += AX12_FLASH_CHUNK) {
+            uint32_t n = (size - at < AX12_FLASH_CHUNK) ? size - at : AX12_FLASH_CHUNK;
+            uint32_t padded = (n + page - 1) / page * page;
+            memcpy(chunk, (const uint8_t *)data + at, n);
+            memset(&chunk[n], 0xFF, padded - n);
+            result = _flash.program(chunk, _address + at, padded);
+        }
+    }
+    _flash.deinit();
+    return result;
+}
+
+int AX12FlashStorage::open(void)
+{
+    if (_flash.init() != 0) {
+        return -1;
+    }
+    if (_address == 0) {
+        uint32_t end = _flash.get_flash_start() + _flash.get_flash_size();
+        _address = end - _flash.get_sector_size(end - 1);
+    }
+    return 0;
+}
+
+#else
+
+AX12FileStorage::AX12FileStorage(const char *path)
+{
+    _path = path;
+}
+
+int AX12FileStorage::read(void *data, uint32_t size)
+{
+    FILE *f = fopen(_path, "rb");
+    if (!f) {
+        return -1;
+    }
+    size_t n = fread(data, 1, size, f);
+    fclose(f);
+    return (n == size) ? 0 : -1;
+}
+
+int AX12FileStorage::write(const void *data, uint32_t size)
+{
+    FILE *f = fopen(_path, "wb");
+    if (!f) {
+        return -1;
+    }
+    size_t n = fwrite(data, 1, size, f);
+    return (fclose(f) == 0 && n == size) ? 0 : -1;
+}
+
+#endif
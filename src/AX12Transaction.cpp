@@ -0,0 +1,253 @@
+/**
+ * @file AX12Transaction.cpp
+ * @author joebarteam11
+ * @brief Coordinated writes on many servos, executed together by one ACTION
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+#include "AX12Transaction.h"
+
+#include <string.h>
+
+AX12Transaction::AX12Transaction(AX12MultiBus &joints)
+    : _joints(joints)
+{
+    _count = 0;
+    ResetStats();
+}
+
+int AX12Transaction::Stage(int id, int start, int length, const uint8_t *data)
+{
+    if (_joints.BusOf(id) < 0 || length <= 0 || start + length > AX12_TABLE_SIZE) {
+        return AX12_ERR_ARG;
+    }
+
+    Entry *e = 0;
+    for (int i = 0; i < _count; i++) {
+        if (_entries[i].id == id) {
+            e = &_entries[i];
+        }
+    }
+
+    if (!e) {
+        if (_count >= AX12_TRANSACTION_MAX_SERVOS || length > AX12_TRANSACTION_MAX_LENGTH) {
+            return AX12_ERR_ARG;
+        }
+        e = &_entries[_count++];
+        e->id = id;
+        e->start = start;
+        e->length = length;
+        e->sent = false;
+        memcpy(e->data, data, length);
+        return AX12_OK;
+    }
+
+    // Merge with the write already staged, into one contiguous REG_WRITE
+    int first = (start < e->start) ? start : e->start;
+    int end = (start + length > e->start + e->length) ? start + length : e->start + e->length;
+    if (start > e->start + e->length || e->start > start + length
+        || end - first > AX12_TRANSACTION_MAX_LENGTH) {
+        return AX12_ERR_ARG;
+    }
+    memmove(&e->data[e->start - first], e->data, e->length);
+    memcpy(&e->data[start - first], data, length);
+    e->start = first;
+    e->length = end - first;
+    e->sent = false;
+    return AX12_OK;
+}
+
+int AX12Transaction::Prepare(void)
+{
+    int next[AX12_MAX_BUSES];    // next entry to send on each bus
+    int current[AX12_MAX_BUSES]; // entry being sent on each bus, -1 if none
+    int result = AX12_OK;
+    uint32_t begin = _joints._clock.now_us();
+
+    for (int b = 0; b < _joints._count; b++) {
+        next[b] = 0;
+        current[b] = -1;
+    }
+
+    bool active = true;
+    while (active) {
+        bool progress = false;
+        active = false;
+
+        for (int b = 0; b < _joints._count; b++) {
+            AX12Bus &bus = *_joints._buses[b];
+
+            if (current[b] >= 0) {
+                int r = bus.Poll();
+                if (r == AX12_BUSY) {
+                    active = true;
+                    continue;
+                }
+                if (r == AX12_OK) {
+                    _entries[current[b]].sent = true;
+                } else if (result == AX12_OK) {
+                    result = r;
+                }
+                current[b] = -1;
+                progress = true;
+            }
+
+            while (next[b] < _count
+                   && (_entries[next[b]].sent || _joints.BusOf(_entries[next[b]].id) != b)) {
+                next[b]++;
+            }
+            if (next[b] < _count) {
+                Entry &e = _entries[next[b]];
+                uint8_t *p = bus.Packet(e.id, AX12_INST_REG_WRITE, 1 + e.length);
+                if (p) {
+                    p[0] = e.start;
+                    memcpy(&p[1], e.data, e.length);
+                    bus.Start(); // a failed start is given by the next Poll()
+                    current[b] = next[b];
+                } else if (result == AX12_OK) {
+                    // Not sent : the entry stays unsent, the transaction cannot execute
+                    result = AX12_ERR_ARG;
+                }
+                next[b]++;
+                active = true;
+                progress = true;
+            }
+        }
+
+        if (active && !progress) {
+            _joints._clock.wait_us(_joints.step());
+        }
+    }
+
+    _stats.prepare_us = _joints._clock.now_us() - begin;
+    return result;
+}
+
+int AX12Transaction::Commit(void)
+{
+    int result = Prepare();
+    if (result != AX12_OK) {
+        return result;
+    }
+    if (_count == 0) {
+        return AX12_OK;
+    }
+
+    // One ACTION on every bus carrying the transaction, started back to back.
+    // The servos execute when the last byte of the ACTION is received.
+    bool started[AX12_MAX_BUSES];
+    bool first = true;
+    uint32_t earliest = 0, latest = 0;
+    for (int b = 0; b < _joints._count; b++) {
+        bool used = false;
+        for (int i = 0; i < _count; i++) {
+            used = used || (_joints.BusOf(_entries[i].id) == b);
+        }
+        started[b] = false;
+        if (!used) {
+            continue;
+        }
+        AX12Bus &bus = *_joints._buses[b];
+        if (!bus.Packet(AX12_BROADCAST_ID, AX12_INST_ACTION, 0)) {
+            result = (result == AX12_OK) ? AX12_ERR_ARG : result;
+            continue;
+        }
+        uint32_t at = _joints._clock.now_us() + bus.WireTime(AX12_PACKET_OVERHEAD);
+        int r = bus.Start();
+        if (r != AX12_BUSY) {
+            result = (result == AX12_OK) ? r : result;
+            continue;
+        }
+        started[b] = true;
+        if (first || (int32_t)(at - earliest) < 0) {
+            earliest = at;
+        }
+        if (first || (int32_t)(at - latest) > 0) {
+            latest = at;
+        }
+        first = false;
+    }
+
+    uint32_t t;
+    while ((t = _joints.step()) != 0) {
+        _joints._clock.wait_us(t);
+    }
+    for (int b = 0; b < _joints._count; b++) {
+        if (started[b]) {
+            int r = _joints._buses[b]->Poll();
+            result = (result == AX12_OK) ? r : result;
+        }
+    }
+
+    // Some buses may have executed : the entries are kept for Abort()
+    if (result != AX12_OK) {
+        return result;
+    }
+
+    _stats.skew_us = latest - earliest;
+    if (_stats.skew_us > _stats.max_skew_us) {
+        _stats.max_skew_us = _stats.skew_us;
+    }
+    _stats.commits++;
+    clear();
+    return AX12_OK;
+}
+
+int AX12Transaction::Abort(void)
+{
+    int result = AX12_OK;
+
+    for (int i = 0; i < _count; i++) {
+        Entry &e = _entries[i];
+        if (!e.sent) {
+            continue;
+        }
+        // Replace the pending REG_WRITE with one that changes nothing
+        AX12Bus &bus = _joints.Bus(_joints.BusOf(e.id));
+        uint8_t led;
+        int r = bus.Read(e.id, AX12_REG_LED, 1, &led);
+        if (r == AX12_OK) {
+            r = bus.Write(e.id, AX12_REG_LED, 1, &led, true);
+        }
+        if (r != AX12_OK && result == AX12_OK) {
+            result = r;
+        }
+    }
+
+    _stats.aborts++;
+    clear();
+    return result;
+}
+
+int AX12Transaction::Staged(void)
+{
+    return _count;
+}
+
+bool AX12Transaction::Prepared(void)
+{
+    for (int i = 0; i < _count; i++) {
+        if (!_entries[i].sent) {
+            return false;
+        }
+    }
+    return true;
+}
+
+const AX12TransactionStats &AX12Transaction::Stats(void)
+{
+    return _stats;
+}
+
+void AX12Transaction::ResetStats(void)
+{
+    memset(&_stats, 0, sizeof(_stats));
+}
+
+void AX12Transaction::clear(void)
+{
+    _count = 0;
+}
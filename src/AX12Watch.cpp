@@ -0,0 +1,266 @@
+/**
+ * @file AX12Watch.cpp
+ * @author joebarteam11
+ * @brief Registers watched at a rate, read with as few packets as the addresses allow
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+#include "AX12Watch.h"
+
+#include <string.h>
+
+AX12Watcher::AX12Watcher(AX12Scheduler &sched)
+    : _sched(sched)
+{
+    for (int i = 0; i < AX12_WATCH_MAX; i++) {
+        _watches[i].used = false;
+        _watches[i].read = -1;
+        _watches[i].due = false;
+    }
+    for (int k = 0; k < AX12_WATCH_MAX_READS; k++) {
+        _reads[k].busy = false;
+    }
+    _gap = AX12_WATCH_MAX_GAP;
+    ResetStats();
+}
+
+int AX12Watcher::Watch(int id, int reg, int length, uint32_t period_us, volatile uint16_t *variable)
+{
+    int handle = add(id, reg, length, period_us);
+    if (handle >= 0) {
+        _watches[handle].variable = variable;
+    }
+    return handle;
+}
+
+int AX12Watcher::Watch(int id, int reg, int length, uint32_t period_us, AX12WatchCallback callback, void *context)
+{
+    int handle = add(id, reg, length, period_us);
+    if (handle >= 0) {
+        _watches[handle].callback = callback;
+        _watches[handle].context = context;
+    }
+    return handle;
+}
+
+void AX12Watcher::Unwatch(int handle)
+{
+    if (handle >= 0 && handle < AX12_WATCH_MAX) {
+        _watches[handle].used = false;
+    }
+}
+
+void AX12Watcher::SetMaxGap(int bytes)
+{
+    _gap = (bytes < -1) ? -1 : bytes;
+}
+
+int AX12Watcher::Poll(void)
+{
+    collect();
+
+    uint32_t now = _sched.Bus().Clock().now_us();
+    for (int i = 0; i < AX12_WATCH_MAX; i++) {
+        Entry &w = _watches[i];
+        w.due = w.used && w.read < 0 && AX12Clock::reached(now, w.next);
+    }
+
+    int sent = 0;
+    for (int i = 0; i < AX12_WATCH_MAX; i++) {
+        if (!_watches[i].due) {
+            continue;
+        }
+        int n = send(i, now);
+        if (n < 0) {
+            break; // no packet or no room in the queue left, the rest at the next Poll()
+        }
+        sent += n;
+    }
+    for (int i = 0; i < AX12_WATCH_MAX; i++) {
+        _watches[i].due = false;
+    }
+    return sent;
+}
+
+uint32_t AX12Watcher::Due(void)
+{
+    uint32_t now = _sched.Bus().Clock().now_us();
+    uint32_t due = 0xFFFFFFFF;
+
+    // A reply to hand in
+    for (int k = 0; k < AX12_WATCH_MAX_READS; k++) {
+        if (_reads[k].busy && _reads[k].request.Done()) {
+            return 0;
+        }
+    }
+    for (int i = 0; i < AX12_WATCH_MAX; i++) {
+        const Entry &w = _watches[i];
+        if (!w.used || w.read >= 0) {
+            continue;
+        }
+        if (AX12Clock::reached(now, w.next)) {
+            return 0;
+        }
+        due = (w.next - now < due) ? w.next - now : due;
+    }
+    return due;
+}
+
+uint16_t AX12Watcher::Value(int handle)
+{
+    return (handle >= 0 && handle < AX12_WATCH_MAX) ? _watches[handle].value : 0;
+}
+
+const AX12WatchStats &AX12Watcher::Stats(void)
+{
+    return _stats;
+}
+
+void AX12Watcher::ResetStats(void)
+{
+    memset(&_stats, 0, sizeof(_stats));
+}
+
+int AX12Watcher::add(int id, int reg, int length, uint32_t period_us)
+{
+    if (id < 0 || id >= AX12_BROADCAST_ID || reg < 0 || (length != 1 && length != 2) || reg + length > 0x100
+        || length > AX12_WATCH_MAX_SPAN || period_us == 0) {
+        return AX12_ERR_ARG;
+    }
+    for (int i = 0; i < AX12_WATCH_MAX; i++) {
+        Entry &w = _watches[i];
+        if (w.used || w.read >= 0) {
+            continue;
+        }
+        w.id = id;
+        w.reg = reg;
+        w.length = length;
+        w.used = true;
+        w.due = false;
+        w.value = 0;
+        w.period = period_us;
+        w.next = _sched.Bus().Clock().now_us();
+        w.variable = 0;
+        w.callback = 0;
+        w.context = 0;
+        return i;
+    }
+    return AX12_BUSY;
+}
+
+// Replies in : values to the watches of each packet
+void AX12Watcher::collect(void)
+{
+    for (int k = 0; k < AX12_WATCH_MAX_READS; k++) {
+        Read &r = _reads[k];
+        if (!r.busy || !r.request.Done()) {
+            continue;
+        }
+        r.busy = false;
+        bool ok = (r.request.result == AX12_OK);
+        _stats.errors += !ok;
+
+        for (int i = 0; i < AX12_WATCH_MAX; i++) {
+            Entry &w = _watches[i];
+            if (w.read != k) {
+                continue;
+            }
+            w.read = -1;
+            if (!w.used) {
+                continue;
+            }
+            if (!ok) {
+                w.next = r.request.finished; // again at the next cycle
+                continue;
+            }
+            const uint8_t *p = &r.data[w.reg - r.request.start];
+            w.value = (w.length == 2) ? (uint16_t)(p[0] | p[1] << 8) : p[0];
+            _stats.reads++;
+            if (w.variable) {
+                *w.variable = w.value;
+            }
+            if (w.callback) {
+                w.callback(w.id, w.reg, w.value, w.context);
+            }
+        }
+    }
+}
+
+// Packets of the due watches of the servo of \p first, ranges joined in the order of the addresses
+int AX12Watcher::send(int first, uint32_t now)
+{
+    uint8_t id = _watches[first].id;
+    uint8_t order[AX12_WATCH_MAX];
+    int count = 0;
+
+    // Due watches of the servo, sorted by address
+    for (int i = first; i < AX12_WATCH_MAX; i++) {
+        const Entry &w = _watches[i];
+        if (!w.due || w.id != id) {
+            continue;
+        }
+        int at = count++;
+        while (at > 0 && _watches[order[at - 1]].reg > w.reg) {
+            order[at] = order[at - 1];
+            at--;
+        }
+        order[at] = i;
+    }
+
+    int sent = 0;
+    int from = 0;
+    while (from < count) {
+        int lo = _watches[order[from]].reg;
+        int hi = lo + _watches[order[from]].length;
+        int to = from + 1;
+        while (to < count && _gap >= 0) {
+            const Entry &w = _watches[order[to]];
+            int end = (w.reg + w.length > hi) ? w.reg + w.length : hi;
+            if (w.reg > hi + _gap || end - lo > AX12_WATCH_MAX_SPAN) {
+                break;
+            }
+            hi = end;
+            to++;
+        }
+
+        int k = 0;
+        while (k < AX12_WATCH_MAX_READS && _reads[k].busy) {
+            k++;
+        }
+        if (k == AX12_WATCH_MAX_READS) {
+            return sent ? sent : -1;
+        }
+        Read &r = _reads[k];
+        r.request.Read(id, lo, hi - lo, r.data, AX12_PRIO_TELEMETRY);
+        if (_sched.Submit(r.request) != AX12_OK) {
+            return sent ? sent : -1;
+        }
+        r.busy = true;
+
+        // The due watches of the range, and the others of the servo it covers for free
+        int served = 0; // due watches of the packet
+        for (int i = 0; i < AX12_WATCH_MAX; i++) {
+            Entry &w = _watches[i];
+            bool inside = w.used && w.id == id && w.read < 0 && w.reg >= lo && w.reg + w.length <= hi;
+            bool joined = false;
+            for (int j = from; j < to && !joined; j++) {
+                joined = (order[j] == i);
+            }
+            if (joined || (inside && _gap >= 0)) {
+                w.read = k;
+                w.due = false;
+                w.next = now + w.period;
+                served += joined;
+            }
+        }
+        _stats.packets++;
+        _stats.saved += served - 1;
+        _stats.bytes += hi - lo;
+        sent++;
+        from = to;
+    }
+    return sent;
+}
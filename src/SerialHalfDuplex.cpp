@@ -44,6 +44,15 @@ SerialHalfDuplex::SerialHalfDuplex(PinName tx, PinName rx, int baud)
     : SerialBase(tx, rx, baud)
 {
     idx = 0;
+    _rd = 0;
+    _tx = NULL;
+    _tx_length = 0;
+    _tx_sent = 0;
+    _tx_echoed = 0;
+    _line_error = false;
+#if !MBED_CONF_RTOS_PRESENT
+    _wake = false;
+#endif
     _txpin = tx;
     _baud = baud;
     DigitalIn TXPIN(_txpin);    // set as input
@@ -68,8 +77,8 @@ SerialHalfDuplex::SerialHalfDuplex(PinName tx, PinName rx, int baud)
  * 
  * @param buffer est un pointeur vers le buffer à modifier
  */
-bool SerialHalfDuplex::eraseBuffer(int *buffer){
-    for(int i=0; i<BUF_SIZE;i++){
+bool SerialHalfDuplex::eraseBuffer(uint8_t *buffer){
+    for(int i=0; i<AX12_SERIAL_BUF_SIZE;i++){
       buffer[i] = 0;
     }
     return true;
@@ -111,11 +120,47 @@ int SerialHalfDuplex::putc(int c){
  */
 void SerialHalfDuplex::RXinterrupt(void){
     while(readable()){
-        buf[idx] = _base_getc();
-        idx++;
+        int c = _base_getc();
+
+        // Echo d'un octet envoyé par send() : on envoie le suivant
+        if (_tx_echoed < _tx_length) {
+            // Un écho différent de l'octet envoyé : collision ou erreur de trame
+            if ((uint8_t)c != _tx[_tx_echoed]) {
+                _line_error = true;
+            }
+            _tx_echoed++;
+            if (_tx_sent < _tx_length) {
+                SerialBase::_base_putc(_tx[_tx_sent++]);
+            } else if (_tx_echoed == _tx_length) {
+                pin_function(_txpin, 0); // on libère la ligne pour la réponse
+                wake();
+            }
+            continue;
+        }
+
+        // Buffer plein : l'octet est perdu, la réponse ne sera pas complète
+        if ((idx + 1) % AX12_SERIAL_BUF_SIZE == _rd) {
+            _line_error = true;
+            continue;
+        }
+        buf[idx] = c;
+        idx = (idx + 1) % AX12_SERIAL_BUF_SIZE;
+        wake();
     }    
 }
 
+/**
+ * @brief Cette fonction réveille le thread endormi dans wait(). Elle est appelée en interruption :
+ * octet de la réponse reçu, fin de l'envoi ou fin du délai
+ */
+void SerialHalfDuplex::wake(void){
+#if MBED_CONF_RTOS_PRESENT
+    _events.set(1);
+#else
+    _wake = true;
+#endif
+}
+
 // Take a character into the reception buffer and replace it with à 'z'
 /**
  * @brief Cette fonction permet d'accéder au contenu du buffer de réception et remplace le caractère par un 'z' une fois la valeur récupérée
@@ -125,9 +170,136 @@ void SerialHalfDuplex::RXinterrupt(void){
  */
 int SerialHalfDuplex::getc(int i){
     idx = 0;  
+    _rd = 0;
+    if (i < 0 || i >= AX12_SERIAL_BUF_SIZE) {
+        return 0; // en dehors du buffer
+    }
     int retc = buf[i];
     buf[i]=0;
     return retc;    
 }
 
+/**
+ * @brief Cette fonction démarre l'envoi d'un paquet sans attendre la fin de la transmission.
+ * Les deux premiers octets sont écrits tout de suite, les suivants sont envoyés par RXinterrupt() à chaque écho reçu.
+ * 
+ * @param data octets à envoyer, ils doivent rester valides tant que sending() renvoie true
+ * @param length nombre d'octets
+ * @return \p length, ou -1 si un envoi est déjà en cours
+ */
+int SerialHalfDuplex::send(const uint8_t *data, int length){
+    if (sending() || length <= 0) {
+        return -1;
+    }
+
+    core_util_critical_section_enter();
+
+    idx = 0;
+    _rd = 0;
+    _tx = data;
+    _tx_length = length;
+    _tx_sent = 0;
+    _tx_echoed = 0;
+    _line_error = false;
+
+    serial_pinout_tx(_txpin);
+
+    // Un octet dans le registre à décalage, un dans le registre de données
+    SerialBase::_base_putc(_tx[_tx_sent++]);
+    if (_tx_sent < _tx_length && writeable()) {
+        SerialBase::_base_putc(_tx[_tx_sent++]);
+    }
+
+    core_util_critical_section_exit();
+
+    return length;
+}
+
+/**
+ * @return true tant que l'écho du dernier octet envoyé par send() n'est pas revenu
+ */
+bool SerialHalfDuplex::sending(void){
+    return _tx_echoed < _tx_length;
+}
+
+/**
+ * @brief Cette fonction copie les octets reçus depuis le dernier appel
+ * 
+ * @param data buffer de destination
+ * @param length taille du buffer de destination
+ * @return le nombre d'octets copiés
+ */
+int SerialHalfDuplex::receive(uint8_t *data, int length){
+    int n = 0;
+    while (_rd != idx && n < length) {
+        data[n++] = buf[_rd];
+        _rd = (_rd + 1) % AX12_SERIAL_BUF_SIZE;
+    }
+    return n;
+}
+
+/**
+ * @return true si la ligne a été perturbée depuis le dernier send() : écho différent de l'octet envoyé, ou octet reçu perdu (buffer plein)
+ */
+bool SerialHalfDuplex::line_error(void){
+    return _line_error;
+}
+
+/**
+ * @brief Cette fonction endort le thread appelant jusqu'au prochain octet reçu, la fin de l'envoi ou la fin du délai,
+ * au lieu d'attendre activement avec wait_us()
+ * 
+ * Avec le RTOS le thread attend un EventFlags et les autres threads tournent, sans RTOS le CPU dort (sleep)
+ * entre les interruptions. Le Timeout et l'interruption RX empêchent le sommeil profond : l'UART reste active.
+ * Un réveil de trop (octet arrivé avant l'appel) est sans conséquence, AX12Bus regarde l'état de la ligne à chaque retour.
+ * 
+ * @param us délai maximal (en us)
+ * @return true
+ */
+bool SerialHalfDuplex::wait(uint32_t us){
+    if (us == 0) {
+        return true;
+    }
+    _timeout.attach(callback(this, &SerialHalfDuplex::wake), std::chrono::microseconds(us));
+#if MBED_CONF_RTOS_PRESENT
+    _events.wait_any(1);
+#else
+    core_util_critical_section_enter();
+    while (!_wake) {
+        sleep_manager_sleep_auto(); // les interruptions réveillent le CPU même en section critique
+        core_util_critical_section_exit();
+        core_util_critical_section_enter();
+    }
+    _wake = false;
+    core_util_critical_section_exit();
+#endif
+    _timeout.detach();
+    return true;
+}
+
+/**
+ * @brief Cette fonction vide le buffer de réception
+ */
+void SerialHalfDuplex::flush(void){
+    core_util_critical_section_enter();
+    _rd = idx;
+    core_util_critical_section_exit();
+}
+
+/**
+ * @return la vitesse de communication (en bps)
+ */
+int SerialHalfDuplex::baudrate(void){
+    return _baud;
+}
+
+int SerialHalfDuplex::set_baudrate(int baud){
+    if (baud <= 0) {
+        return -1;
+    }
+    _baud = baud;
+    SerialBase::baud(_baud);
+    return 0;
+}
+
 } // End namespace
\ No newline at end of file
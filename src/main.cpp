@@ -7,6 +7,9 @@
 int main(void){
     //factoryReset(); // run this line code ALONE to reset all connected motors ID to 1 (factory reset), then reboot the servo by unpluging and repluging it
     //setMotorBaud(AX12_BAUD); // then run this line to change the baudrate of the motor to the one defined in main.h Servo needs to be rebooted after this line
+    //negotiateMotorBaud(AX12_BAUD); // or this one to move the motor to the fastest baudrate the wiring supports, the new one is printed
+    //measureMotorCpu(AX12_BAUD); // CPU time of a position read, busy waiting then sleeping during the reply
+    //initMotorFromCache(); // instead of initMotor() : ID and baudrate found on the bus, kept in flash for the next boot
     
     #if CONTINOUS_MODE
     //Test program in continuous mode
@@ -35,6 +38,7 @@ int main(void){
     // Print the load every 500ms
     while(1){
         printf("Load : %f\n", getMotorLoad());
+        printMotorLog(); // events of the library, with -DAX12_LOG_LEVEL=1 to 3
         ThisThread::sleep_for(500);
     }
     #endif